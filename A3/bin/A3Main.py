@@ -9,9 +9,17 @@ from asciimatics.widgets import Frame, ListBox, Layout, Divider, Button, Widget,
 from asciimatics.exceptions import ResizeScreenError, NextScene, StopApplication
 from asciimatics.scene import Scene
 import sqlite3
-from datetime import datetime
+import hashlib
+import threading
+import time
+import logging
+from datetime import datetime, timedelta
 
 
+# Errors go to the debug log rather than over the full-screen UI.
+logging.basicConfig(filename="debug_log.txt", level=logging.INFO,
+                    format="%(asctime)s %(levelname)s %(threadName)s: %(message)s")
+
 # Load the shared library using ctypes.
 try:
     libvc = ctypes.CDLL("./libvcparser.so")
@@ -23,6 +31,9 @@ except Exception as e:
 libvc.createCard.argtypes = [ctypes.c_char_p, ctypes.POINTER(c_void_p)]
 libvc.createCard.restype = ctypes.c_int
 
+libvc.createCardValidated.argtypes = [ctypes.c_char_p, ctypes.POINTER(c_void_p)]
+libvc.createCardValidated.restype = ctypes.c_int
+
 libvc.createMinimalCard.argtypes = [ctypes.POINTER(c_void_p), ctypes.c_char_p]
 libvc.createMinimalCard.restype = ctypes.c_int
 
@@ -47,96 +58,590 @@ libvc.annToString.restype = ctypes.c_char_p
 libvc.numPropsToString.argtypes = [c_void_p]
 libvc.numPropsToString.restype = ctypes.c_char_p
 
+# Mirrors CardSummary in VCSummary.h.
+class CardSummary(ctypes.Structure):
+    _fields_ = [("fn", ctypes.c_char * 256),
+                ("birthday", ctypes.c_char * 64),
+                ("anniversary", ctypes.c_char * 64),
+                ("numProps", ctypes.c_int),
+                ("error", ctypes.c_int)]
+
+libvc.summarizeCard.argtypes = [c_void_p, ctypes.POINTER(CardSummary)]
+libvc.summarizeCard.restype = ctypes.c_int
+
+libvc.summarizeFile.argtypes = [ctypes.c_char_p, ctypes.c_bool, ctypes.POINTER(CardSummary)]
+libvc.summarizeFile.restype = ctypes.c_int
+
+libvc.summarizeFiles.argtypes = [ctypes.POINTER(ctypes.c_char_p), ctypes.c_int, ctypes.c_bool,
+                                 ctypes.c_int, ctypes.POINTER(CardSummary)]
+libvc.summarizeFiles.restype = ctypes.c_int
+
+# Mirrors ScanTable in VCScan.h.
+class ScanTable(ctypes.Structure):
+    _fields_ = [("count", ctypes.c_int),
+                ("strings", c_void_p),
+                ("stringsSize", ctypes.c_size_t),
+                ("nameOff", ctypes.POINTER(ctypes.c_size_t)),
+                ("fnOff", ctypes.POINTER(ctypes.c_size_t)),
+                ("bdayOff", ctypes.POINTER(ctypes.c_size_t)),
+                ("annOff", ctypes.POINTER(ctypes.c_size_t)),
+                ("bdayYear", ctypes.POINTER(ctypes.c_int)),
+                ("bdayMonth", ctypes.POINTER(ctypes.c_int)),
+                ("bdayDay", ctypes.POINTER(ctypes.c_int)),
+                ("annYear", ctypes.POINTER(ctypes.c_int)),
+                ("annMonth", ctypes.POINTER(ctypes.c_int)),
+                ("annDay", ctypes.POINTER(ctypes.c_int)),
+                ("mtime", ctypes.POINTER(ctypes.c_longlong)),
+                ("size", ctypes.POINTER(ctypes.c_longlong)),
+                ("error", ctypes.POINTER(ctypes.c_int))]
+
+libvc.scanCardDirectory.argtypes = [ctypes.c_char_p, ctypes.c_int]
+libvc.scanCardDirectory.restype = ctypes.POINTER(ScanTable)
+
+libvc.scanCardFiles.argtypes = [ctypes.c_char_p, ctypes.POINTER(ctypes.c_char_p), ctypes.c_int, ctypes.c_int]
+libvc.scanCardFiles.restype = ctypes.POINTER(ScanTable)
+
+libvc.freeScanTable.argtypes = [ctypes.POINTER(ScanTable)]
+libvc.freeScanTable.restype = None
+
+# Mirrors CacheStats in VCCache.h.
+class CacheStats(ctypes.Structure):
+    _fields_ = [("hits", ctypes.c_ulonglong),
+                ("misses", ctypes.c_ulonglong),
+                ("evictions", ctypes.c_ulonglong),
+                ("entries", ctypes.c_int),
+                ("bytes", ctypes.c_size_t),
+                ("budget", ctypes.c_size_t)]
+
+libvc.createCardCache.argtypes = [ctypes.c_size_t]
+libvc.createCardCache.restype = c_void_p
+
+libvc.acquireCard.argtypes = [c_void_p, ctypes.c_char_p, ctypes.POINTER(c_void_p)]
+libvc.acquireCard.restype = ctypes.c_int
+
+libvc.handleCard.argtypes = [c_void_p]
+libvc.handleCard.restype = c_void_p
+
+libvc.releaseCardHandle.argtypes = [c_void_p, c_void_p]
+libvc.releaseCardHandle.restype = None
+
+libvc.invalidateCachedCard.argtypes = [c_void_p, ctypes.c_char_p]
+libvc.invalidateCachedCard.restype = None
+
+libvc.getCacheStats.argtypes = [c_void_p, ctypes.POINTER(CacheStats)]
+libvc.getCacheStats.restype = None
+
+# Mirrors WatchEvent in VCWatcher.h.
+WATCH_CREATED, WATCH_MODIFIED, WATCH_DELETED, WATCH_RESCAN = range(4)
+
+class WatchEvent(ctypes.Structure):
+    _fields_ = [("kind", ctypes.c_int),
+                ("name", ctypes.c_char * 256)]
+
+libvc.createCardWatcher.argtypes = [ctypes.c_char_p, ctypes.c_int]
+libvc.createCardWatcher.restype = c_void_p
+
+libvc.pollCardWatcher.argtypes = [c_void_p, ctypes.c_int, ctypes.POINTER(WatchEvent), ctypes.c_int]
+libvc.pollCardWatcher.restype = ctypes.c_int
+
+libvc.deleteCardWatcher.argtypes = [c_void_p]
+libvc.deleteCardWatcher.restype = None
+
+# On-disk contact database, kept in sync with the cards folder between runs.
+DB_FILE = "kadenuga.db"
+# Bump when the schema changes; older databases are rebuilt from the cards.
+SCHEMA_VERSION = 2
+CARD_EXTENSIONS = (".vcf", ".vcard")
+# Memory the parsed-card cache may use.
+CARD_CACHE_BUDGET = 32 * 1024 * 1024
+# Changes are applied once the cards folder has been quiet for this long.
+WATCH_DEBOUNCE_MS = 250
+# After a failed sync the watcher waits this long before rescanning the folder,
+# doubling the wait after each further failure up to WATCH_MAX_BACKOFF.
+WATCH_RETRY_SECONDS = 1
+WATCH_MAX_BACKOFF = 60
+# Cards parsed per committed batch during the initial load.  The first batch is
+# small so the list has something to show almost at once; later ones grow to
+# amortize the commit.
+FIRST_BATCH = 64
+MAX_BATCH = 2048
+# The card list only holds a window of file names around the selection, fetched
+# LIST_PAGE at a time with keyset queries, so its cost does not grow with the folder.
+LIST_PAGE = 200
+LIST_WINDOW = 3 * LIST_PAGE
+
+
+def month_day(month, day):
+    """Packs a month and day into the MMDD integer stored in the *_md columns."""
+    if month < 0 or day < 0:
+        return None
+    return month * 100 + day
+
+
+def scan_cards(folder, names=None):
+    """
+    Parses every card in folder (or only the given file names) with a single library call.
+    Returns a list of (file name, mtime, size, fn, birthday, anniversary, error,
+    bday_year, bday_md, ann_year, ann_md) tuples.
+    Dates are in ISO 8601 form, or None if absent.  Years are None when the card omits
+    them, and the MMDD values are None unless both month and day are known.
+    """
+    if names is None:
+        table_ptr = libvc.scanCardDirectory(folder.encode("utf-8"), 0)
+    else:
+        c_names = (ctypes.c_char_p * len(names))(*[n.encode("utf-8") for n in names])
+        table_ptr = libvc.scanCardFiles(folder.encode("utf-8"), c_names, len(names), 0)
+    if not table_ptr:
+        return []
+    try:
+        table = table_ptr.contents
+        # Each row stores name, fn, birthday and anniversary back to back.
+        fields = ctypes.string_at(table.strings, table.stringsSize).decode("utf-8", "replace").split("\0")
+        rows = []
+        for i in range(table.count):
+            name, fn, bday, ann = fields[4 * i:4 * i + 4]
+            bday_year = table.bdayYear[i]
+            ann_year = table.annYear[i]
+            rows.append((name, table.mtime[i], table.size[i], fn,
+                         bday or None, ann or None, table.error[i],
+                         bday_year if bday_year >= 0 else None,
+                         month_day(table.bdayMonth[i], table.bdayDay[i]),
+                         ann_year if ann_year >= 0 else None,
+                         month_day(table.annMonth[i], table.annDay[i])))
+        return rows
+    finally:
+        libvc.freeScanTable(table_ptr)
+
+
+def file_hash(path):
+    with open(path, "rb") as f:
+        return hashlib.blake2b(f.read(), digest_size=16).hexdigest()
+
+def format_time(mtime_ns):
+    return datetime.fromtimestamp(mtime_ns / 1e9).strftime("%Y-%m-%d %H:%M:%S")
+
+
+def sync_cards(db, folder, names=None, progress=None):
+    """
+    Reparses only the cards that were added or changed since the last sync and drops
+    the ones that were deleted.  With names, only those files are compared; otherwise
+    the whole folder is.
+    Without progress, everything is applied in a single transaction.  With it, the
+    parsed cards are committed in growing batches and progress(done, total) is called
+    after each one, so readers see the contacts as they arrive.
+    Returns the files that failed to parse or validate, as (file name, error code).
+    If the sync fails, the uncommitted changes are rolled back and the error is
+    raised for the caller to log and report; with progress, the batches committed
+    before it are kept.
+    """
+    on_disk = {}
+    if names is None:
+        with os.scandir(folder) as entries:
+            for entry in entries:
+                if entry.is_file() and entry.name.lower().endswith(CARD_EXTENSIONS):
+                    st = entry.stat()
+                    on_disk[entry.name] = (st.st_mtime_ns, st.st_size)
+        known = {row["file_name"]: row for row in db.execute(
+            "SELECT file_id, file_name, mtime_ns, file_size, content_hash FROM FILE")}
+    else:
+        for name in names:
+            try:
+                st = os.stat(os.path.join(folder, name))
+            except OSError:
+                continue
+            on_disk[name] = (st.st_mtime_ns, st.st_size)
+        known = {}
+        for name in names:
+            row = db.execute("""
+                SELECT file_id, file_name, mtime_ns, file_size, content_hash
+                FROM FILE WHERE file_name = ?
+            """, (name,)).fetchone()
+            if row is not None:
+                known[name] = row
+
+    to_parse = []
+    touched = []
+    hashes = {}
+    for name, (mtime_ns, size) in on_disk.items():
+        row = known.get(name)
+        if row is None:
+            # New file: hashed with its batch, so the first batch is not held up.
+            to_parse.append(name)
+            continue
+        if row["mtime_ns"] == mtime_ns and row["file_size"] == size:
+            continue
+        try:
+            digest = file_hash(os.path.join(folder, name))
+        except OSError:
+            # Deleted since it was listed; the next event or sync catches up.
+            continue
+        hashes[name] = digest
+        if row["file_size"] == size and row["content_hash"] == digest:
+            # Only the timestamp changed.
+            touched.append((mtime_ns, format_time(mtime_ns), row["file_id"]))
+        else:
+            to_parse.append(name)
+    removed = [(row["file_id"],) for name, row in known.items() if name not in on_disk]
+
+    to_parse.sort()
+    if progress is None:
+        batches = [to_parse]
+    else:
+        batches = []
+        start, size = 0, FIRST_BATCH
+        while start < len(to_parse):
+            batches.append(to_parse[start:start + size])
+            start += size
+            size = min(size * 2, MAX_BATCH)
+
+    creation_time = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
+    try:
+        db.executemany("DELETE FROM FILE WHERE file_id = ?", removed)
+        db.executemany(
+            "UPDATE FILE SET mtime_ns = ?, last_modified = ? WHERE file_id = ?", touched)
+        if progress is not None:
+            db.commit()
+            progress(0, len(to_parse))
+
+        done = 0
+        for batch in batches:
+            file_rows = []
+            contact_rows = []
+            for name in batch:
+                if name not in hashes:
+                    try:
+                        hashes[name] = file_hash(os.path.join(folder, name))
+                    except OSError:
+                        hashes[name] = None
+            if batch:
+                for row in scan_cards(folder, batch):
+                    name, _mtime, _size, fn, bday, ann, error, bday_year, bday_md, ann_year, ann_md = row
+                    mtime_ns, size = on_disk[name]
+                    file_rows.append((name, format_time(mtime_ns), creation_time,
+                                      mtime_ns, size, hashes[name], error))
+                    if error == 0:
+                        contact_rows.append((fn, bday, ann, bday_year, bday_md, ann_year, ann_md, name))
+
+            # Replaced files lose their old contacts through the cascade.
+            db.executemany("""
+                INSERT OR REPLACE INTO FILE (file_name, last_modified, creation_time,
+                                             mtime_ns, file_size, content_hash, parse_error)
+                VALUES (?, ?, ?, ?, ?, ?, ?)
+            """, file_rows)
+            db.executemany("""
+                INSERT INTO CONTACT (name, birthday, anniversary, bday_year, bday_md,
+                                     ann_year, ann_md, file_id)
+                SELECT ?, ?, ?, ?, ?, ?, ?, file_id FROM FILE WHERE file_name = ?
+            """, contact_rows)
+            done += len(batch)
+            if progress is not None:
+                db.commit()
+                progress(done, len(to_parse))
+        db.commit()
+    except Exception:
+        db.rollback()
+        raise
+
+    return [(row["file_name"], row["parse_error"]) for row in db.execute(
+        "SELECT file_name, parse_error FROM FILE WHERE parse_error != 0")]
+
+
+def open_worker_db(db_file):
+    """A connection for a background thread; sqlite3 connections cannot be shared."""
+    db = sqlite3.connect(db_file, timeout=30)
+    db.row_factory = sqlite3.Row
+    db.execute("PRAGMA foreign_keys = ON")
+    return db
+
+
+class CardLoader(threading.Thread):
+    """
+    Runs the startup sync in the background so the UI comes up at once.
+    Cards are committed in batches; generation changes after each one so the
+    list can tell when to refresh, and status() reports the progress.
+    """
+
+    def __init__(self, db_file, folder, on_done=None):
+        super().__init__(daemon=True)
+        self.db_file = db_file
+        self.folder = folder
+        self.on_done = on_done
+        self.finished = threading.Event()
+        self.generation = 0
+        self.done = 0
+        self.total = 0
+        self.started = None
+        # Why the sync stopped, if it failed; shown by status().
+        self.error = None
+
+    def _progress(self, done, total):
+        self.done = done
+        self.total = total
+        self.generation += 1
+
+    def rate(self):
+        """Cards parsed per second so far."""
+        if self.started is None or self.done == 0:
+            return 0.0
+        return self.done / max(time.monotonic() - self.started, 1e-6)
+
+    def status(self):
+        if self.error is not None:
+            return f"Loading stopped after {self.done} cards: {self.error}"
+        if self.finished.is_set():
+            return f"{self.done} cards loaded ({self.rate():.0f} cards/sec)" if self.done else ""
+        if self.total == 0:
+            return "Checking cards..."
+        return f"Loading {self.done}/{self.total} cards ({self.rate():.0f} cards/sec)"
+
+    def run(self):
+        db = open_worker_db(self.db_file)
+        self.started = time.monotonic()
+        rejected = []
+        try:
+            rejected = sync_cards(db, self.folder, progress=self._progress)
+        except (OSError, sqlite3.Error) as e:
+            # The batches committed so far stay, and the next sync picks up the rest.
+            logging.exception(f"Loading the cards in '{self.folder}' failed")
+            self.error = str(e)
+        finally:
+            db.close()
+            self.generation += 1
+            self.finished.set()
+        if self.on_done is not None:
+            self.on_done(rejected)
+
+
+class CardWatcher(threading.Thread):
+    """
+    Keeps the database in step with the cards folder while the program runs.
+    inotify reports which files changed, so each batch reparses only those cards.
+    Uses its own connection, since sqlite3 connections cannot be shared between threads.
+    A sync that fails (e.g. the folder was moved away) is logged and kept in error,
+    and the whole folder is rescanned after a back-off until a sync succeeds.  If the
+    folder itself is deleted or moved for good, the watcher is restarted the same way.
+    """
+
+    def __init__(self, db_file, folder, on_change=None):
+        super().__init__(daemon=True)
+        self.db_file = db_file
+        self.folder = folder
+        self.on_change = on_change
+        self._stop_event = threading.Event()
+        # Why the folder is no longer being kept in step, or None while it is.
+        self.error = None
+
+    def stop(self):
+        self._stop_event.set()
+
+    def run(self):
+        watcher = libvc.createCardWatcher(self.folder.encode("utf-8"), WATCH_DEBOUNCE_MS)
+        if not watcher:
+            self.error = f"Cannot watch '{self.folder}' for changes"
+            logging.error(self.error)
+            return
+        db = open_worker_db(self.db_file)
+        events = (WatchEvent * 256)()
+        retry = False
+        backoff = WATCH_RETRY_SECONDS
+        try:
+            # A short timeout so stop() is noticed promptly.
+            while not self._stop_event.is_set():
+                n = libvc.pollCardWatcher(watcher, 500, events, len(events))
+                if n < 0:
+                    watcher = self._restart(watcher, backoff)
+                    if not watcher:
+                        break
+                    # Changes made while the folder was not watched are only found by a rescan.
+                    retry = True
+                    backoff = WATCH_RETRY_SECONDS
+                    continue
+                if n == 0 and not retry:
+                    continue
+                if retry or any(events[i].kind == WATCH_RESCAN for i in range(n)):
+                    names = None
+                else:
+                    names = [events[i].name.decode("utf-8", "replace") for i in range(n)]
+                try:
+                    rejected = sync_cards(db, self.folder, names)
+                except (OSError, sqlite3.Error) as e:
+                    logging.exception(f"Syncing the cards in '{self.folder}' failed")
+                    self.error = f"Sync failed, retrying in {backoff}s: {e}"
+                    retry = True
+                    self._stop_event.wait(backoff)
+                    backoff = min(backoff * 2, WATCH_MAX_BACKOFF)
+                    continue
+                retry = False
+                backoff = WATCH_RETRY_SECONDS
+                self.error = None
+                if self.on_change is not None:
+                    self.on_change(names, rejected)
+        finally:
+            db.close()
+            if watcher:
+                libvc.deleteCardWatcher(watcher)
+
+    def _restart(self, watcher, backoff):
+        """Replaces a watcher that lost the folder, retrying with back-off until the folder
+        can be watched again.  Returns None if stop() was called first."""
+        libvc.deleteCardWatcher(watcher)
+        while True:
+            self.error = f"Lost the watch on '{self.folder}', retrying in {backoff}s"
+            logging.error(self.error)
+            if self._stop_event.wait(backoff):
+                return None
+            backoff = min(backoff * 2, WATCH_MAX_BACKOFF)
+            watcher = libvc.createCardWatcher(self.folder.encode("utf-8"), WATCH_DEBOUNCE_MS)
+            if watcher:
+                return watcher
+
+
+# Parsed cards shared by the views, so opening a card and then saving it parses it once.
+card_cache = libvc.createCardCache(CARD_CACHE_BUDGET)
+
+
+def cache_stats():
+    stats = CacheStats()
+    libvc.getCacheStats(card_cache, byref(stats))
+    return stats
+
+
 # Global variable for passing the selected file.
 SELECTED_FILE = ""
 
 class ContactModel:
-    def __init__(self):
-        # Create a database in RAM.
-        self._db = sqlite3.connect(':memory:')
+    def __init__(self, db_file=DB_FILE):
+        # Open (or create) the database on disk, so unchanged cards are not reparsed next time.
+        self._db = sqlite3.connect(db_file)
         self._db.row_factory = sqlite3.Row
+        self._db.execute("PRAGMA foreign_keys = ON")
+        # WAL lets the loader and watcher threads write while the UI reads.
+        self._db.execute("PRAGMA journal_mode = WAL")
         self.cursor = self._db.cursor()
+        self._create_tables()
+
+        # Files that failed to parse or validate, as (file name, error code).
+        self.rejected = []
+
+        # The CardWatcher keeping the database in step once the UI is up, if any.
+        self.watcher = None
+
+        # Bring the database up to date with the "cards" folder in the background;
+        # whatever is already in the database can be shown straight away.
+        self.loader = None
+        folder = "cards"
+        if not os.path.exists(folder):
+           # logging.info(f"No '{folder}' directory found.")
+           self.scene.add_effect(PopUpDialog(self.screen, f"No '{folder}' directory found.", ["OK"]))
 
-        # Create FILE table (SQLite syntax)
+        else:
+            self.loader = CardLoader(db_file, folder, self._loaded)
+            self.loader.start()
+
+    def _loaded(self, rejected):
+        self.rejected = rejected
+
+    def _create_tables(self):
+        version = self.cursor.execute("PRAGMA user_version").fetchone()[0]
+        if version != SCHEMA_VERSION:
+            # The database only caches what is in the cards folder, so an old
+            # layout is simply dropped and rebuilt by the next sync.
+            self.cursor.execute("DROP TABLE IF EXISTS CONTACT")
+            self.cursor.execute("DROP TABLE IF EXISTS FILE")
+
+        # Create FILE table (SQLite syntax).  mtime_ns, file_size and content_hash
+        # identify the version of the file that was parsed.
         self.cursor.execute("""
             CREATE TABLE IF NOT EXISTS FILE (
                 file_id INTEGER PRIMARY KEY AUTOINCREMENT,
-                file_name VARCHAR(60) NOT NULL,
+                file_name VARCHAR(60) NOT NULL UNIQUE,
                 last_modified DATETIME,
-                creation_time DATETIME NOT NULL
+                creation_time DATETIME NOT NULL,
+                mtime_ns INTEGER,
+                file_size INTEGER,
+                content_hash TEXT,
+                parse_error INTEGER NOT NULL DEFAULT 0
             )
         """)
-        # Create CONTACT table (SQLite syntax)
+        # Create CONTACT table (SQLite syntax).  birthday and anniversary hold the ISO
+        # text for display; the *_year and *_md (month * 100 + day) columns are what
+        # date queries filter on, so they can use the indexes below.
         self.cursor.execute("""
             CREATE TABLE IF NOT EXISTS CONTACT (
                 contact_id INTEGER PRIMARY KEY AUTOINCREMENT,
                 name VARCHAR(256) NOT NULL,
                 birthday DATETIME,
                 anniversary DATETIME,
+                bday_year INTEGER,
+                bday_md INTEGER,
+                ann_year INTEGER,
+                ann_md INTEGER,
                 file_id INTEGER NOT NULL,
                 FOREIGN KEY (file_id) REFERENCES FILE(file_id) ON DELETE CASCADE
             )
         """)
+        self.cursor.execute("CREATE INDEX IF NOT EXISTS CONTACT_FILE ON CONTACT(file_id)")
+        self.cursor.execute("CREATE INDEX IF NOT EXISTS CONTACT_BDAY ON CONTACT(bday_md)")
+        self.cursor.execute("CREATE INDEX IF NOT EXISTS CONTACT_ANN ON CONTACT(ann_md)")
+        self.cursor.execute(f"PRAGMA user_version = {SCHEMA_VERSION}")
         self._db.commit()
 
-        # Populate from files in the "cards" folder.
-        folder = "cards"
-        if not os.path.exists(folder):
-           # logging.info(f"No '{folder}' directory found.")
-           self.scene.add_effect(PopUpDialog(self.screen, f"No '{folder}' directory found.", ["OK"]))
+    def sync_folder(self, folder):
+        """Brings the database up to date with every card in folder."""
+        self.rejected = sync_cards(self._db, folder)
 
+    def files_after(self, key, limit, inclusive=False):
+        """Up to limit file names following key (or from the start if key is None), in name order."""
+        if key is None:
+            rows = self.cursor.execute(
+                "SELECT file_name FROM FILE ORDER BY file_name LIMIT ?", (limit,))
         else:
-            for f in os.listdir(folder):
-                if not f.endswith(".vcf"):
-                    continue
-                full_path = os.path.join(folder, f)
-                
-
-                # Create a card from the file using createCard.
-                card_ptr = c_void_p()
-                ret = libvc.createCard(full_path.encode("utf-8"), byref(card_ptr))
-                if ret != 0:
-                    
-                    continue
-
-                # Validate the card.
-                ret_val = libvc.validateCard(card_ptr)
-                if ret_val != 0:
-                    
-                    libvc.deleteCard(card_ptr)
-                    continue
-
-                # Extract details using shared library functions.
-                fn_bytes = libvc.fnToString(card_ptr)
-                contact_name = fn_bytes.decode("utf-8") if fn_bytes else ""
-                bday_bytes = libvc.bdayToString(card_ptr)
-                birthday = bday_bytes.decode("utf-8") if bday_bytes else None
-                ann_bytes = libvc.annToString(card_ptr)
-                anniversary = ann_bytes.decode("utf-8") if ann_bytes else None
-
-                # Get file modification time.
-                mod_time = datetime.fromtimestamp(os.path.getmtime(full_path)).strftime("%Y-%m-%d %H:%M:%S")
-                creation_time = datetime.now().strftime("%Y-%m-%d %H:%M:%S")
-
-                try:
-                    self.cursor.execute(
-                        "INSERT INTO FILE (file_name, last_modified, creation_time) VALUES (?, ?, ?)",
-                        (f, mod_time, creation_time)
-                    )
-                    file_id = self.cursor.lastrowid
-                    self.cursor.execute(
-                        "INSERT INTO CONTACT (name, birthday, anniversary, file_id) VALUES (?, ?, ?, ?)",
-                        (contact_name, birthday, anniversary, file_id)
-                    )
-                    self._db.commit()
-                 
-                except Exception as e:
-                    self._db.rollback()
-                  
-
-                # Delete the card pointer after use.
-                libvc.deleteCard(card_ptr)
+            op = ">=" if inclusive else ">"
+            rows = self.cursor.execute(
+                f"SELECT file_name FROM FILE WHERE file_name {op} ? ORDER BY file_name LIMIT ?",
+                (key, limit))
+        return [row[0] for row in rows]
+
+    def files_before(self, key, limit):
+        """Up to limit file names preceding key, in name order."""
+        rows = self.cursor.execute(
+            "SELECT file_name FROM FILE WHERE file_name < ? ORDER BY file_name DESC LIMIT ?",
+            (key, limit)).fetchall()
+        return [row[0] for row in reversed(rows)]
+
+    def birthdays_in_month(self, month):
+        """Contacts whose birthday falls in the given month, youngest first."""
+        return self.cursor.execute("""
+            SELECT name, birthday FROM CONTACT
+            WHERE bday_md BETWEEN ? AND ?
+            ORDER BY bday_year DESC, bday_md DESC
+        """, (month * 100 + 1, month * 100 + 31)).fetchall()
 
+    def upcoming(self, column, days, today=None):
+        """
+        Contacts whose birthday ("bday") or anniversary ("ann") falls within the next
+        days days, soonest first.  Wraps around the end of the year.
+        """
+        if column not in ("bday", "ann"):
+            raise ValueError(column)
+        today = today or datetime.now().date()
+        start = today.month * 100 + today.day
+        end_date = today + timedelta(days=days)
+        end = end_date.month * 100 + end_date.day
+        if days >= 365:
+            start, end = 101, 1231
+        date_col = "birthday" if column == "bday" else "anniversary"
+        if start <= end:
+            where = f"{column}_md BETWEEN ? AND ?"
+            order = f"{column}_md"
+        else:
+            where = f"({column}_md >= ? OR {column}_md <= ?)"
+            order = f"{column}_md < {start}, {column}_md"
+        return self.cursor.execute(f"""
+            SELECT name, {date_col} FROM CONTACT
+            WHERE {where}
+            ORDER BY {order}
+        """, (start, end)).fetchall()
 
     def add(self, contact):
         full_file = contact.get("file", "").strip()
@@ -215,6 +720,7 @@ class VCardListView(Frame):
         super(VCardListView, self).__init__(screen, screen.height, screen.width,
                                             has_shadow=True, title="vCard List", name="CardList")
         self.card_files = card_files
+        self._generation = -1
         self.list_box = ListBox(
             Widget.FILL_FRAME,
             [(f, f) for f in card_files],
@@ -240,7 +746,75 @@ class VCardListView(Frame):
         
         self.fix()
     
+    def _show_window(self, files, selected):
+        self.card_files = files
+        self.list_box.options = [(f, f) for f in files]
+        if selected in files:
+            self.list_box.value = selected
+        elif files:
+            self.list_box.value = files[0]
+        self.selected_file = self.list_box.value
+
+    def _refresh_files(self):
+        """Reloads the current window, keeping the current selection."""
+        first = self.card_files[0] if self.card_files else None
+        self._show_window(contacts.files_after(first, LIST_WINDOW, inclusive=True), self.list_box.value)
+
+    def _slide_window(self):
+        """
+        Fetches the next (or previous) page once the selection gets within a screen
+        of the end (or start) of the window, and drops a page from the other end.
+        """
+        selected = self.list_box.value
+        if selected is None or not self.card_files:
+            return
+        try:
+            index = self.card_files.index(selected)
+        except ValueError:
+            return
+        margin = self.screen.height
+        files = self.card_files
+        if index >= len(files) - margin:
+            more = contacts.files_after(files[-1], LIST_PAGE)
+            if not more:
+                return
+            files = files + more
+            files = files[max(0, len(files) - LIST_WINDOW):]
+        elif index < margin:
+            more = contacts.files_before(files[0], LIST_PAGE)
+            if not more:
+                return
+            files = (more + files)[:LIST_WINDOW]
+        else:
+            return
+        self._show_window(files, selected)
+
+    def _update(self, frame_no):
+        # Pick up whatever the background loader has committed since the last frame.
+        loader = contacts.loader
+        status = ""
+        if loader is not None:
+            if loader.generation != self._generation:
+                self._generation = loader.generation
+                self._refresh_files()
+            status = loader.status()
+        # A watcher that cannot keep up with the folder says so until it recovers.
+        watcher = contacts.watcher
+        if watcher is not None and watcher.error is not None:
+            status = watcher.error
+        self.title = f"vCard List - {status}" if status else "vCard List"
+        super(VCardListView, self)._update(frame_no)
+
+    @property
+    def frame_update_count(self):
+        # Redraw a few times a second while cards are still loading.
+        loader = contacts.loader
+        if loader is not None and not loader.finished.is_set():
+            return 5
+        return super(VCardListView, self).frame_update_count
+
     def _update_selected_file(self):
+        self._slide_window()
         self.selected_file = self.list_box.value
         # Write debug info to a file:
         
@@ -269,7 +843,9 @@ class VCardListView(Frame):
     def reset(self):
         global SELECTED_FILE
         super(VCardListView, self).reset()
-        new_options = [(f, f) for f in os.listdir("cards") if f.endswith(".vcf")]
+        # Start again from the top, loading only the first window.
+        new_options = [(f, f) for f in contacts.files_after(None, LIST_WINDOW)]
+        self.card_files = [f for f, _ in new_options]
         self.list_box.options = new_options
         if new_options:
             self.list_box.value = new_options[0][1]
@@ -450,8 +1026,12 @@ class VCardDetailsViewEdit(Frame):
         self.data = {"file": file_name, "contact": "", "bday": "", "anniv": "", "other": ""}
         
         full_path = os.path.join("cards", file_name)
-        card_ptr = c_void_p()
-        ret = libvc.createCard(full_path.encode("utf-8"), byref(card_ptr))
+        summary = CardSummary()
+        handle = c_void_p()
+        ret = libvc.acquireCard(card_cache, full_path.encode("utf-8"), byref(handle))
+        if ret == 0:
+            ret = libvc.summarizeCard(libvc.handleCard(handle), byref(summary))
+            libvc.releaseCardHandle(card_cache, handle)
         
         if ret != 0:
             self.card_summary = f"Error creating card: {ret}"
@@ -462,15 +1042,10 @@ class VCardDetailsViewEdit(Frame):
             return
         
         # Decode and assign property values.
-        fn_ptr = libvc.fnToString(card_ptr)
-        bday_ptr = libvc.bdayToString(card_ptr)
-        ann_ptr = libvc.annToString(card_ptr)
-        numProps_ptr = libvc.numPropsToString(card_ptr)
-        
-        fnStr = fn_ptr.decode("utf-8") if fn_ptr and fn_ptr != b'' else "No contact"
-        bdayStr = bday_ptr.decode("utf-8") if bday_ptr and bday_ptr != b'' else "No birthday"
-        annStr = ann_ptr.decode("utf-8") if ann_ptr and ann_ptr != b'' else "No anniversary"
-        numPropsStr = numProps_ptr.decode("utf-8") if numProps_ptr and numProps_ptr != b'' else "No other properties"
+        fnStr = summary.fn.decode("utf-8", "replace") or "No contact"
+        bdayStr = summary.birthday.decode("utf-8", "replace") or "No birthday"
+        annStr = summary.anniversary.decode("utf-8", "replace") or "No anniversary"
+        numPropsStr = str(summary.numProps)
         
         # Update the data.
         self.data["file"] = file_name
@@ -487,8 +1062,6 @@ class VCardDetailsViewEdit(Frame):
             print(f"Debugging: {self.data['bday']}", file=f)
             print(f"Debugging: {self.data['anniv']}", file=f)
             print(f"Debugging: {self.data['other']}", file=f)
-
-        libvc.deleteCard(card_ptr)
     
     def _ok(self):
         self.save()  # Update self.data with the latest widget values.
@@ -501,45 +1074,44 @@ class VCardDetailsViewEdit(Frame):
             return
 
         full_path = os.path.join("cards", file_name)
-        card_ptr = c_void_p()  # Use a single pointer for card operations
+        path_bytes = full_path.encode("utf-8")
 
-        # Create a new card
-        ret = libvc.createCard(full_path.encode("utf-8"), byref(card_ptr))
-        if ret != 0 or not card_ptr:
+        # Get the card parsed by load_details from the cache
+        handle = c_void_p()
+        ret = libvc.acquireCard(card_cache, path_bytes, byref(handle))
+        if ret != 0 or not handle:
             self.scene.add_effect(PopUpDialog(self.screen, f"Error creating card: {ret}", ["OK"]))
-            # Cleanup
-            libvc.deleteCard(card_ptr)
             raise NextScene("CardList")
             return
+        card_ptr = c_void_p(libvc.handleCard(handle))
 
-        # Set more card properties (such as Name) before editing if there's another valid function
-        ret2 = libvc.editMinimalCard(card_ptr, contact.encode("utf-8"))
-        if ret2 != 0:
-            self.scene.add_effect(PopUpDialog(self.screen, "Card editing failed", ["OK"]))
-            libvc.deleteCard(card_ptr)
-            return
+        try:
+            # Set more card properties (such as Name) before editing if there's another valid function
+            ret2 = libvc.editMinimalCard(byref(card_ptr), contact.encode("utf-8"))
+            if ret2 != 0:
+                self.scene.add_effect(PopUpDialog(self.screen, "Card editing failed", ["OK"]))
+                return
 
-        # Validate the card to ensure correctness
-        ret3 = libvc.validateCard(card_ptr)
-        if ret3 != 0:
-            # Adding more detailed debug info for validation failure
-            self.scene.add_effect(PopUpDialog(self.screen, f"Card validation failed. Error code: {ret3}", ["OK"]))
-            libvc.deleteCard(card_ptr)
-            return
+            # Validate the card to ensure correctness
+            ret3 = libvc.validateCard(card_ptr)
+            if ret3 != 0:
+                # Adding more detailed debug info for validation failure
+                self.scene.add_effect(PopUpDialog(self.screen, f"Card validation failed. Error code: {ret3}", ["OK"]))
+                return
 
-        # Write the card to the file
-        ret4 = libvc.writeCard(full_path.encode("utf-8"), card_ptr)
-        if ret4 != 0:
-            self.scene.add_effect(PopUpDialog(self.screen, "Writing to file failed", ["OK"]))
-            libvc.deleteCard(card_ptr)
-            return
+            # Write the card to the file
+            ret4 = libvc.writeCard(path_bytes, card_ptr)
+            if ret4 != 0:
+                self.scene.add_effect(PopUpDialog(self.screen, "Writing to file failed", ["OK"]))
+                return
+        finally:
+            # The cached card was edited in place, so it no longer matches any file version.
+            libvc.releaseCardHandle(card_cache, handle)
+            libvc.invalidateCachedCard(card_cache, path_bytes)
 
         # Successfully saved the card
         contacts.update_current_contact({"name": contact, "file_name": file_name})
         self.scene.add_effect(PopUpDialog(self.screen, "Card saved successfully", ["OK"]))
-        
-        # Cleanup
-        libvc.deleteCard(card_ptr)
 
         # Transition to the "CardList" scene after successful save
         raise NextScene("CardList")
@@ -605,13 +1177,7 @@ class DBQueryView(Frame):
         self.fix()
 
     def _find_june(self):
-        q = """
-            SELECT name, birthday FROM CONTACT
-            WHERE strftime('%m', birthday) = '06'
-            ORDER BY julianday('now') - julianday(birthday)
-        """
-        self.db_model.cursor.execute(q)
-        rows = self.db_model.cursor.fetchall()
+        rows = self.db_model.birthdays_in_month(6)
         result = "\n".join([", ".join(map(str, row)) for row in rows])
         self.data["results"] = result
         if self.data["results"]:
@@ -629,7 +1195,7 @@ class DBQueryView(Frame):
 
 def get_scenes(screen):
     return [
-        Scene([VCardListView(screen, os.listdir("cards"))], -1, name="CardList"),
+        Scene([VCardListView(screen, contacts.files_after(None, LIST_WINDOW))], -1, name="CardList"),
         Scene([VCardDetailsViewCreate(screen)], -1, name="CardDetailsCreate"),
         Scene([VCardDetailsViewEdit(screen)], -1, name="CardDetailsEdit"),
         Scene([DBQueryView(screen, contacts)], -1, name="DBQueries")
@@ -644,6 +1210,9 @@ def demo_ui(screen):
             pass
 contacts = ContactModel()
 def main():
+    if os.path.isdir("cards"):
+        contacts.watcher = CardWatcher(DB_FILE, "cards")
+        contacts.watcher.start()
     while True:
         try:
             Screen.wrapper(demo_ui)
@@ -0,0 +1,132 @@
+/**
+ * @file VCBitmap.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Compressed sets of document ids in the style of Roaring bitmaps, with
+ *        intersection, union and difference.
+ */
+
+#ifndef _VCBITMAP_H
+#define _VCBITMAP_H
+
+#include "VCParser.h"
+#include <stdint.h>
+
+/*	Ids are split by their upper 16 bits into chunks of 65536.  A chunk holding up to
+	BITMAP_ARRAY_MAX ids stores them as a sorted array of their lower 16 bits; a fuller
+	chunk stores a bit for each of its 65536 ids.  Either way no chunk takes more than
+	8 KB, and sparse chunks take two bytes an id.  Zero-initialize before use.
+*/
+#define BITMAP_ARRAY_MAX 4096
+#define BITMAP_WORDS     1024
+
+typedef struct bitmapContainer {
+	//Upper 16 bits of the ids in the chunk
+	uint16_t  key;
+
+	//Number of ids, from 1 to 65536
+	int       count;
+
+	//Sorted lower 16 bits when count <= BITMAP_ARRAY_MAX (with room for cap), else NULL
+	uint16_t* array;
+	int       cap;
+
+	//BITMAP_WORDS words of bits when count > BITMAP_ARRAY_MAX, else NULL
+	uint64_t* bits;
+} BitmapContainer;
+
+typedef struct bitmap {
+	//Chunks in increasing key order; empty chunks are removed
+	BitmapContainer* containers;
+	int              numContainers;
+	int              cap;
+} Bitmap;
+
+/** Function to add an id.
+ *@return 1 if it was added, 0 if it was already there, -1 if malloc fails
+ *@param bitmap - the set
+		 id - the id (not negative)
+ **/
+int bitmapAdd(Bitmap* bitmap, int id);
+
+/** Function to remove an id.
+ *@return true if it was there
+ *@param bitmap - the set
+		 id - the id
+ **/
+bool bitmapRemove(Bitmap* bitmap, int id);
+
+/** Function to check for an id.
+ *@return true if the id is in the set
+ *@param bitmap - the set
+		 id - the id
+ **/
+bool bitmapContains(const Bitmap* bitmap, int id);
+
+/** Function to count the ids.
+ *@return the number of ids in the set
+ *@param bitmap - the set
+ **/
+int bitmapCardinality(const Bitmap* bitmap);
+
+/** Function to intersect two sets.
+ *@pre out is zero-initialized, and is neither a nor b
+ *@return OK, or OTHER_ERROR if malloc fails (out is then empty)
+ *@param a - a set
+		 b - another set
+		 out - receives the ids in both
+ **/
+VCardErrorCode bitmapAnd(const Bitmap* a, const Bitmap* b, Bitmap* out);
+
+/** Function to join two sets.
+ *@pre out is zero-initialized, and is neither a nor b
+ *@return OK, or OTHER_ERROR if malloc fails (out is then empty)
+ *@param a - a set
+		 b - another set
+		 out - receives the ids in either
+ **/
+VCardErrorCode bitmapOr(const Bitmap* a, const Bitmap* b, Bitmap* out);
+
+/** Function to subtract one set from another.
+ *@pre out is zero-initialized, and is neither a nor b
+ *@return OK, or OTHER_ERROR if malloc fails (out is then empty)
+ *@param a - a set
+		 b - the set to remove
+		 out - receives the ids in a but not in b
+ **/
+VCardErrorCode bitmapAndNot(const Bitmap* a, const Bitmap* b, Bitmap* out);
+
+/** Function to count the intersection of two sets without building it.
+ *@return the number of ids in both
+ *@param a - a set
+		 b - another set
+ **/
+int bitmapAndCount(const Bitmap* a, const Bitmap* b);
+
+/** Function to copy a set.
+ *@pre out is zero-initialized
+ *@return OK, or OTHER_ERROR if malloc fails (out is then empty)
+ *@param bitmap - the set
+		 out - receives the copy
+ **/
+VCardErrorCode bitmapCopy(const Bitmap* bitmap, Bitmap* out);
+
+/** Function to list the ids.
+ *@pre out has room for bitmapCardinality(bitmap) ids
+ *@return the number of ids written
+ *@param bitmap - the set
+		 out - receives the ids in increasing order
+ **/
+int bitmapToArray(const Bitmap* bitmap, int* out);
+
+/** Function to get the memory used by a set.
+ *@return the number of bytes allocated for the set
+ *@param bitmap - the set
+ **/
+size_t bitmapBytes(const Bitmap* bitmap);
+
+/** Function to release the memory held by a set, leaving it empty.
+ *@param bitmap - the set
+ **/
+void bitmapFree(Bitmap* bitmap);
+
+#endif
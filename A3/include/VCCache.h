@@ -0,0 +1,81 @@
+/**
+ * @file VCCache.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief LRU cache of parsed cards, so a file that is viewed or edited again is not reparsed.
+ *        An entry is reused only while the file's inode, size and modification time are unchanged.
+ */
+
+#ifndef _VCCACHE_H
+#define _VCCACHE_H
+
+#include "VCParser.h"
+
+//Opaque cache state
+typedef struct cardCache CardCache;
+
+//Opaque reference to a cached card.  Keeps the card alive until it is released.
+typedef struct cardHandle CardHandle;
+
+typedef struct cacheStats {
+	unsigned long long hits;
+	unsigned long long misses;
+	unsigned long long evictions;
+
+	//Number of cards held by the cache and their estimated size in bytes
+	int                entries;
+	size_t             bytes;
+	size_t             budget;
+} CacheStats;
+
+/** Function to create an empty cache.
+ *@return a new cache, or NULL if malloc fails.  Must be freed with deleteCardCache.
+ *@param budget - the most memory, in bytes, the cached cards may use.  The least recently
+                  used cards are evicted to stay under it.
+ **/
+CardCache* createCardCache(size_t budget);
+
+/** Function to get the parsed card for a file, parsing it with createCard only if it is not
+ *  cached or the file has changed since it was cached.
+ *  The card is shared: it stays valid until the handle is released, even if it is evicted in
+ *  the meantime.  A caller that modifies it must call invalidateCachedCard afterwards.
+ *@pre cache and fileName are not NULL
+ *@post on success, handle holds a new reference that must be released with releaseCardHandle
+ *@return OK, or the error from createCard.  Files that fail to parse are not cached.
+ *@param cache - the cache
+		 fileName - the path of the file
+		 handle - receives the handle
+ **/
+VCardErrorCode acquireCard(CardCache* cache, const char* fileName, CardHandle** handle);
+
+/** Function to get the card a handle refers to.
+ *@return the card
+ *@param handle - the handle
+ **/
+Card* handleCard(const CardHandle* handle);
+
+/** Function to drop a reference returned by acquireCard.
+ *@param cache - the cache the handle came from
+		 handle - the handle.  It must not be used afterwards.
+ **/
+void releaseCardHandle(CardCache* cache, CardHandle* handle);
+
+/** Function to remove a file's card from the cache, e.g. after it was modified or rewritten.
+ *  Outstanding handles stay valid.
+ *@param cache - the cache
+		 fileName - the path of the file
+ **/
+void invalidateCachedCard(CardCache* cache, const char* fileName);
+
+/** Function to read the cache counters.
+ *@param cache - the cache
+		 stats - receives the counters
+ **/
+void getCacheStats(CardCache* cache, CacheStats* stats);
+
+/** Function to free a cache.
+ *@pre no handle from the cache is still held
+ *@param cache - the cache
+ **/
+void deleteCardCache(CardCache* cache);
+
+#endif
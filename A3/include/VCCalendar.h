@@ -0,0 +1,128 @@
+/**
+ * @file VCCalendar.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief In-memory index of birthdays and anniversaries by day of the year, for
+ *        "who has a birthday between these dates" and "what is coming up next".
+ */
+
+#ifndef _VCCALENDAR_H
+#define _VCCALENDAR_H
+
+#include "VCCorpus.h"
+
+/*	Days are numbered through a leap year: January 1 is 0, February 29 is 59 and
+	December 31 is 365.  In other years, events on February 29 fall on February 28.
+*/
+#define CALENDAR_DAYS 366
+
+typedef enum ekind { EVENT_BIRTHDAY, EVENT_ANNIVERSARY } CalendarEventKind;
+
+typedef struct calendarEvent {
+	int               docId;
+	CalendarEventKind kind;
+
+	//The date in the card.  year is -1 for dates without one, such as --0203.
+	int               year;
+	int               month;
+	int               day;
+
+	//Days from the start date to this occurrence.  Only set by calendarIterNext; -1 otherwise.
+	int               daysAway;
+} CalendarEvent;
+
+//Opaque index state
+typedef struct calendarIndex CalendarIndex;
+
+//Walks the events in date order from a start date, repeating every year
+typedef struct calendarIter {
+	const CalendarIndex* index;
+
+	//Date being read, and position in that day's events
+	int                  year;
+	int                  dayOfYear;
+	int                  pos;
+	int                  daysAway;
+} CalendarIter;
+
+/** Function to get the day number of a month and day (see CALENDAR_DAYS).
+ *@return the day number, or -1 if the date does not exist in a leap year
+ *@param month - 1 to 12
+		 day - 1 to 31
+ **/
+int calendarDay(int month, int day);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteCalendarIndex.
+ **/
+CalendarIndex* createCalendarIndex(void);
+
+/** Function to index the birthdays and anniversaries of every card in a corpus, using the
+ *  corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteCalendarIndex.
+ *@param corpus - the cards to index
+ **/
+CalendarIndex* buildCalendarIndex(const CardCorpus* corpus);
+
+/** Function to add a card's birthday and anniversary.  Dates are read with dateToParts;
+ *  text values and dates without a month and day (e.g. 1954) are skipped.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode calendarAddCard(CalendarIndex* index, const Card* card, int docId);
+
+/** Function to remove a card's events, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void calendarRemoveCard(CalendarIndex* index, int docId);
+
+/** Function to find the events from one month and day to another, both included.
+ *  If the end is before the start the range wraps past December 31, so
+ *  12/20 to 01/10 covers the turn of the year.
+ *@return the number of events written to out, at most maxResults, ordered by date then document id
+ *@param index - the index
+		 fromMonth, fromDay - the first day
+		 toMonth, toDay - the last day
+		 out - receives the events
+		 maxResults - the size of out
+ **/
+int calendarRange(const CalendarIndex* index, int fromMonth, int fromDay, int toMonth, int toDay,
+                  CalendarEvent* out, int maxResults);
+
+/** Function to count the events from one month and day to another, as calendarRange
+ *  would return them, in O(log CALENDAR_DAYS).
+ *@return the number of events, or 0 if a date does not exist
+ *@param index - the index
+		 fromMonth, fromDay - the first day
+		 toMonth, toDay - the last day
+ **/
+int calendarCount(const CalendarIndex* index, int fromMonth, int fromDay, int toMonth, int toDay);
+
+/** Function to start reading events on a date with calendarIterNext.
+ *@pre the index is not changed while the iterator is in use, and month and day exist
+ *@param index - the index
+		 year, month, day - the start date
+		 iter - the iterator to set up
+ **/
+void calendarIterInit(const CalendarIndex* index, int year, int month, int day, CalendarIter* iter);
+
+/** Function to read the next event.  Events repeat each year, so the iterator never runs
+ *  out unless the index is empty; take as many as needed ("the next 10 birthdays").
+ *@return true if an event was read, false if the index is empty
+ *@param iter - the iterator
+		 event - receives the event, with daysAway set
+ **/
+bool calendarIterNext(CalendarIter* iter, CalendarEvent* event);
+
+/** Function to get the number of indexed events.
+ *@return the number of events
+ *@param index - the index
+ **/
+int calendarSize(const CalendarIndex* index);
+
+void deleteCalendarIndex(CalendarIndex* index);
+
+#endif
@@ -0,0 +1,82 @@
+/**
+ * @file VCCategories.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Dictionary of CATEGORIES values with a compressed bitmap of cards for each,
+ *        and AND/OR/NOT queries over them, e.g. "vip AND emea AND NOT churned".
+ */
+
+#ifndef _VCCATEGORIES_H
+#define _VCCATEGORIES_H
+
+#include "VCCorpus.h"
+
+//Opaque index state
+typedef struct categoryIndex CategoryIndex;
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteCategoryIndex.
+ **/
+CategoryIndex* createCategoryIndex(void);
+
+/** Function to index every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteCategoryIndex.
+ *@param corpus - the cards to index
+ **/
+CategoryIndex* buildCategoryIndex(const CardCorpus* corpus);
+
+/** Function to index the categories of a card.  Each CATEGORIES value is split at commas
+ *  (a comma escaped as \, is kept), and each category is case-folded with foldText.
+ *  Cards without categories are indexed too, so that NOT can match them.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode categoryIndexAddCard(CategoryIndex* index, const Card* card, int docId);
+
+/** Function to remove a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void categoryIndexRemoveCard(CategoryIndex* index, int docId);
+
+/** Function to find the cards matching a query.
+ *  A query combines categories with AND, OR and NOT (in capitals) and parentheses.  NOT
+ *  binds most tightly and OR most loosely; adjacent terms without an operator are AND-ed,
+ *  so "vip emea OR partner" means (vip AND emea) OR partner.  A category containing
+ *  spaces or parentheses can be written in double quotes.
+ *@pre index, query and docIds are not NULL
+ *@post *docIds is a newly allocated array of the matching document ids in increasing
+        order (NULL if there are none).  It must be freed by the caller.
+ *@return the number of matching documents, or -1 if the query is malformed or malloc fails
+ *@param index - the index
+		 query - the query
+		 docIds - receives the matches
+ **/
+int categoryQuery(const CategoryIndex* index, const char* query, int** docIds);
+
+/** Function to count the cards matching a query without listing them.
+ *@return the number of matching documents, or -1 if the query is malformed or malloc fails
+ *@param index - the index
+		 query - the query, see categoryQuery
+ **/
+int categoryQueryCount(const CategoryIndex* index, const char* query);
+
+/** Function to get the number of categories in the dictionary.
+ *@return the number of categories, including any no card has any more
+ *@param index - the index
+ **/
+int categoryCount(const CategoryIndex* index);
+
+/** Function to get a category from the dictionary.
+ *@return the folded name, or NULL if id is out of range.  It belongs to the index.
+ *@param index - the index
+		 id - from 0 to categoryCount - 1, in order of first appearance
+		 cards - receives the number of cards in the category, if not NULL
+ **/
+const char* categoryName(const CategoryIndex* index, int id, int* cards);
+
+void deleteCategoryIndex(CategoryIndex* index);
+
+#endif
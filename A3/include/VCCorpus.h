@@ -0,0 +1,92 @@
+/**
+ * @file VCCorpus.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Helpers for working on a directory of vCard files: listing the files,
+ *        spreading per-file work over a pool of threads, and loading every card
+ *        into memory for the in-memory indexes.
+ */
+
+#ifndef _VCCORPUS_H
+#define _VCCORPUS_H
+
+#include "VCParser.h"
+
+//Opaque UID index state (see VCUid.h)
+typedef struct uidIndex UidIndex;
+
+/*	Every card of a directory, parsed.  The position of a card in these arrays is its
+	document id, which the in-memory indexes use to refer to it.
+*/
+typedef struct cardCorpus {
+	int     count;
+
+	//File names (not paths), sorted
+	char**  names;
+
+	//Parsed cards.  NULL where the file failed to parse.
+	Card**  cards;
+
+	//Result of createCard for each file
+	int*    errors;
+
+	//The cards by UID.  Built by loadCardCorpus; NULL for a corpus assembled by hand.
+	UidIndex* uids;
+} CardCorpus;
+
+/** Function to list the vCard files (.vcf or .vcard) in a directory.
+ *@pre dirName is not NULL
+ *@post *names is a newly allocated array of *count newly allocated file names (not paths),
+        sorted by name.  It must be released with freeCardFileList.
+ *@return OK, INV_FILE if the directory cannot be opened, OTHER_ERROR if malloc fails
+ *@param dirName - the directory to scan
+		 names - receives the array of file names
+		 count - receives the number of file names
+ **/
+VCardErrorCode listCardFiles(const char* dirName, char*** names, int* count);
+
+/** Function to release an array returned by listCardFiles.
+ *@param names - the array of file names
+		 count - the number of file names
+ **/
+void freeCardFileList(char** names, int count);
+
+/** Function to join a directory name and a file name into a newly allocated path.
+ *@return the path, or NULL if malloc fails.  Must be freed by the caller.
+ *@param dirName - the directory
+		 fileName - the file name
+ **/
+char* joinPath(const char* dirName, const char* fileName);
+
+/** Function to get the number of worker threads to use.
+ *@return numThreads if it is positive, otherwise the number of online processors
+ *@param numThreads - the requested number of threads, or 0 for the default
+ **/
+int resolveThreadCount(int numThreads);
+
+/** Function to call work(index, thread, ctx) for every index in [0, numItems) on a pool of threads.
+ *  Indices are handed out in small chunks, so uneven work is balanced between the threads.
+ *  The thread argument is in [0, resolveThreadCount(numThreads)) and can be used to index
+ *  per-thread accumulators without locking.
+ *@pre work is not NULL, and is safe to call concurrently for different indices
+ *@post work has been called exactly once for every index, and all threads have been joined
+ *@return OK, or OTHER_ERROR if the threads could not be started
+ *@param numItems - the number of work items
+		 numThreads - the number of threads, or 0 for one per processor
+		 work - the function to run for each item
+		 ctx - passed through to work
+ **/
+VCardErrorCode runParallel(int numItems, int numThreads, void (*work)(int index, int thread, void* ctx), void* ctx);
+
+/** Function to parse every vCard file in a directory with createCard, in parallel,
+ *  and index the cards by UID.
+ *@pre dirName is not NULL
+ *@return a new corpus, or NULL if the directory cannot be read or malloc fails.
+          Must be freed with deleteCardCorpus.
+ *@param dirName - the directory to load
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+CardCorpus* loadCardCorpus(const char* dirName, int numThreads);
+
+void deleteCardCorpus(CardCorpus* corpus);
+
+#endif
@@ -0,0 +1,47 @@
+/**
+ * @file VCDates.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Normalization of vCard date-and-or-time values (RFC 6350, Section 4.3).
+ */
+
+#ifndef _VCDATES_H
+#define _VCDATES_H
+
+#include "VCParser.h"
+
+/*	Numeric parts of a date.  vCard dates may be truncated (RFC 6350, Section 4.3.1),
+	e.g. --0203 has no year and 1954 has no month or day.  Missing parts are -1.
+*/
+typedef struct dateParts {
+	int  year;
+	int  month;   //1 - 12
+	int  day;     //1 - 31
+
+	bool hasYear;
+	bool hasMonth;
+	bool hasDay;
+} DateParts;
+
+/** Function to split the date portion of a DateTime into numbers.
+ *@pre parts is not NULL
+ *@post parts holds the year, month and day, with -1 for missing parts.
+        All parts are missing if the function does not return OK.
+ *@return OK, or INV_DT if dt is NULL, is a text value, has no date or the date is not recognized
+ *@param dt - a pointer to a DateTime struct, or NULL
+		 parts - receives the result
+ **/
+VCardErrorCode dateToParts(const DateTime* dt, DateParts* parts);
+
+/** Function to write a DateTime in ISO 8601 extended format, e.g. "1954-02-03", "--02-03"
+ *  or "2009-08-08T14:30:00Z".  Text values are copied unchanged.
+ *  Parts that are not recognized are copied as they appear in the card.
+ *@pre buffer is not NULL and size > 0
+ *@post buffer holds the NUL-terminated result, truncated to fit.  It is empty if dt is NULL.
+ *@return the length of the result
+ *@param dt - a pointer to a DateTime struct, or NULL
+		 buffer - receives the result
+		 size - the size of buffer
+ **/
+int dateToISO(const DateTime* dt, char* buffer, size_t size);
+
+#endif
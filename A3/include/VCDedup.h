@@ -0,0 +1,88 @@
+/**
+ * @file VCDedup.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Detection of cards that describe the same contact, across a whole corpus:
+ *        blocking on normalized names, numbers and addresses plus MinHash/LSH over the
+ *        card's words, parallel scoring of the candidate pairs, and clustering.
+ */
+
+#ifndef _VCDEDUP_H
+#define _VCDEDUP_H
+
+#include "VCCorpus.h"
+
+typedef struct dedupOptions {
+	//Pairs scoring at least this (0 to 1) are put in the same cluster
+	double      threshold;
+
+	//Blocks shared by more cards than this are too common to compare (e.g. a company
+	//switchboard number) and are skipped
+	int         maxBlock;
+
+	//Country calling code for TEL values without one, see normalizePhone.  May be NULL.
+	const char* defaultCountry;
+
+	//Number of threads, or 0 for one per processor
+	int         numThreads;
+} DedupOptions;
+
+//Two cards whose score reached the threshold
+typedef struct dedupPair {
+	int    first;
+	int    second;
+	double score;
+} DedupPair;
+
+typedef struct dedupCluster {
+	//Document ids of the cards, in increasing order
+	int*   docIds;
+	int    count;
+
+	//Lowest score among the pairs that formed the cluster
+	double score;
+} DedupCluster;
+
+typedef struct dedupResult {
+	//Clusters of two or more cards, ordered by their first document id
+	DedupCluster* clusters;
+	int           numClusters;
+
+	//Every pair that reached the threshold, ordered by first and then second document id
+	DedupPair*    pairs;
+	int           numPairs;
+
+	//Number of candidate pairs that were scored
+	long          numCandidates;
+} DedupResult;
+
+/** Function to fill in the default options: threshold 0.7, maxBlock 64, defaultCountry "1"
+ *  and one thread per processor.
+ *@pre options is not NULL
+ *@param options - the options to set
+ **/
+void defaultDedupOptions(DedupOptions* options);
+
+/** Function to score how likely two cards are to describe the same contact.
+ *  0.4 of the score is the overlap of the name words (FN, and the family, given and
+ *  additional names of N, in any order), 0.3 the estimated overlap of all the words in the
+ *  cards, and 0.3 for sharing a normalized TEL or EMAIL (0.15 if either card has none).
+ *@return the score, from 0 to 1
+ *@param first - a card
+		 second - another card
+		 defaultCountry - see DedupOptions
+ **/
+double cardSimilarity(const Card* first, const Card* second, const char* defaultCountry);
+
+/** Function to find the groups of duplicate cards in a corpus.
+ *  Only cards that share a block are compared: the same set of name words, the same
+ *  normalized TEL or EMAIL, or the same band of their MinHash signature.
+ *@pre corpus is not NULL
+ *@return the result, or NULL if malloc fails.  Must be freed with deleteDedupResult.
+ *@param corpus - the cards; NULL cards are ignored
+		 options - the options, or NULL for the defaults
+ **/
+DedupResult* findDuplicates(const CardCorpus* corpus, const DedupOptions* options);
+
+void deleteDedupResult(DedupResult* result);
+
+#endif
@@ -0,0 +1,129 @@
+/**
+ * @file VCDocTable.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief The chained hash table the telephone, e-mail and sync key indexes keep their
+ *        entries in, and the FNV-1a string hash the in-memory indexes share.
+ */
+
+#ifndef _VCDOCTABLE_H
+#define _VCDOCTABLE_H
+
+#include <stdint.h>
+#include "VCParser.h"
+
+/*	Each entry holds a fixed-size item (the key and what it maps to), laid out by the
+	caller.  An entry is on the chain of its hash bucket, for lookups, and on the chain
+	of its document, so removing a changed card walks only that card's entries.  Removed
+	entries go on a free list and are reused.  Entry positions stay the same until the
+	entry is removed, so other structures may refer to them.
+*/
+typedef struct docEntry {
+	//Hash of the item's key, compared before the key itself
+	uint32_t hash;
+	int      docId;
+
+	//Next entry in the same bucket (or in the free list once removed), and the next
+	//entry of the same document.  -1 ends a chain.
+	int      nextInBucket;
+	int      nextInDoc;
+} DocEntry;
+
+typedef struct docTable {
+	DocEntry* entries;
+	char*     items;
+	size_t    itemSize;
+	int       numEntries;
+	int       entryCap;
+	int       freeList;
+
+	//Number of entries in use
+	int       size;
+
+	int*      buckets;
+	int       numBuckets;
+
+	//First entry of each document, -1 if it has none
+	int*      docHeads;
+	int       docCap;
+} DocTable;
+
+/** Function to hash a string with FNV-1a.
+ *@return the hash
+ *@param s - the string
+ **/
+uint32_t fnvHash(const char* s);
+
+/** Function to hash a string with FNV-1a over its lower-cased bytes.
+ *@return the hash, the same for strings that differ only in ASCII case
+ *@param s - the string
+ **/
+uint32_t fnvHashFolded(const char* s);
+
+/** Function to get the size a per-document array must grow to so docId fits: at least
+ *  64, doubling from the current size.
+ *@return the new size, or docCap if docId already fits
+ *@param docCap - the current size
+		 docId - the document id
+ **/
+int docCapFor(int docCap, int docId);
+
+/** Function to set up an empty table.
+ *@return true, or false if malloc fails.  Either way the table must be freed with docTableFree.
+ *@param table - the table
+		 itemSize - the size of each entry's item
+ **/
+bool docTableInit(DocTable* table, size_t itemSize);
+
+/** Function to make room for the entries of a document.
+ *@return true, or false if malloc fails
+ *@param table - the table
+		 docId - the largest document id to make room for
+ **/
+bool docTableReserveDoc(DocTable* table, int docId);
+
+/** Function to add an entry.  The caller fills in its item with docTableItem.
+ *@return the entry position, or -1 if malloc fails
+ *@param table - the table
+		 hash - the hash of the item's key
+		 docId - the document the entry belongs to
+ **/
+int docTableAdd(DocTable* table, uint32_t hash, int docId);
+
+/** Function to remove one entry, e.g. when filling in its item failed.
+ *@param table - the table
+		 e - the entry position
+ **/
+void docTableRemove(DocTable* table, int e);
+
+/** Function to remove every entry of a document.  Anything the items own must be freed
+ *  first, walking the document's chain from docHeads[docId].
+ *@param table - the table
+		 docId - the document id
+ **/
+void docTableRemoveDoc(DocTable* table, int docId);
+
+/** Function to get the item of an entry.
+ *@return the item
+ *@param table - the table
+		 e - the entry position
+ **/
+void* docTableItem(const DocTable* table, int e);
+
+/** Function to find the first entry with a hash, to read with docTableNext.  Entries
+ *  with other keys may share the hash, so the caller still compares the keys.
+ *@return the entry position, or -1 if there is none
+ *@param table - the table
+		 hash - the hash
+ **/
+int docTableFind(const DocTable* table, uint32_t hash);
+
+/** Function to find the next entry with the same hash as e.
+ *@return the entry position, or -1 if there is none
+ *@param table - the table
+		 e - an entry returned by docTableFind or docTableNext
+ **/
+int docTableNext(const DocTable* table, int e);
+
+void docTableFree(DocTable* table);
+
+#endif
@@ -0,0 +1,95 @@
+/**
+ * @file VCEmailIndex.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Lookup from e-mail addresses to the cards and EMAIL properties that hold them,
+ *        by whole address or by domain (optionally with its subdomains).
+ */
+
+#ifndef _VCEMAILINDEX_H
+#define _VCEMAILINDEX_H
+
+#include "VCCorpus.h"
+
+//Longest normalized address, including the terminating NUL
+#define EMAIL_MAX_LEN 256
+
+//Where an address was found
+typedef struct emailMatch {
+	int docId;
+
+	//Position of the EMAIL property in the card's optionalProperties
+	int propIndex;
+} EmailMatch;
+
+//Opaque index state
+typedef struct emailIndex EmailIndex;
+
+/** Function to reduce an EMAIL value to a lower-case local@domain address.
+ *  Surrounding spaces, a mailto: prefix, angle brackets and a trailing dot on the
+ *  domain are dropped.
+ *@return the length of out, or 0 if the value is not a single local@domain address or does not fit
+ *@param value - the EMAIL value, e.g. "mailto:Jane.Doe@Example.COM"
+		 out - receives the normalized address
+		 size - the size of out
+ **/
+int normalizeEmail(const char* value, char* out, size_t size);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteEmailIndex.
+ **/
+EmailIndex* createEmailIndex(void);
+
+/** Function to index the EMAIL properties of every card in a corpus, using the corpus
+ *  positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteEmailIndex.
+ *@param corpus - the cards to index
+ **/
+EmailIndex* buildEmailIndex(const CardCorpus* corpus);
+
+/** Function to add the EMAIL properties of a card.  Values that do not normalize are skipped.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode emailIndexAddCard(EmailIndex* index, const Card* card, int docId);
+
+/** Function to remove every address of a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void emailIndexRemoveCard(EmailIndex* index, int docId);
+
+/** Function to find the properties holding an address.  The address is normalized
+ *  first, so the comparison ignores case.
+ *@return the number of matches written to out, at most maxResults
+ *@param index - the index
+		 address - the address
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int emailIndexLookup(const EmailIndex* index, const char* address, EmailMatch* out, int maxResults);
+
+/** Function to find the addresses at a domain, e.g. everyone @example.com.
+ *  Addresses at the domain itself come first, ordered by local part, then those at its
+ *  subdomains, ordered by reversed subdomain (so a.example.com before b.example.com).
+ *@return the number of matches written to out, at most maxResults
+ *@param index - the index
+		 domain - the domain, with or without a leading @
+		 subdomains - true to also return addresses at subdomains such as mail.example.com
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int emailIndexDomain(const EmailIndex* index, const char* domain, bool subdomains,
+                     EmailMatch* out, int maxResults);
+
+/** Function to get the number of indexed EMAIL values.
+ *@return the number of values
+ *@param index - the index
+ **/
+int emailIndexSize(const EmailIndex* index);
+
+void deleteEmailIndex(EmailIndex* index);
+
+#endif
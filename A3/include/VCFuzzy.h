@@ -0,0 +1,81 @@
+/**
+ * @file VCFuzzy.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Typo-tolerant name search: edit distance (Myers' bit-parallel algorithm)
+ *        over candidates chosen by a trigram index of FN values and N components.
+ */
+
+#ifndef _VCFUZZY_H
+#define _VCFUZZY_H
+
+#include "VCCorpus.h"
+
+//A card whose name is close to the query
+typedef struct fuzzyMatch {
+	int docId;
+
+	//Smallest edit distance between the query and one of the card's names
+	int distance;
+} FuzzyMatch;
+
+//Opaque index state
+typedef struct fuzzyIndex FuzzyIndex;
+
+/** Function to compute the Levenshtein distance between two strings, counting bytes.
+ *@return the number of single-byte insertions, deletions and substitutions needed to
+          turn a into b
+ *@param a - a string
+		 b - another string
+ **/
+int editDistance(const char* a, const char* b);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteFuzzyIndex.
+ **/
+FuzzyIndex* createFuzzyIndex(void);
+
+/** Function to index the names of every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteFuzzyIndex.
+ *@param corpus - the cards to index
+ **/
+FuzzyIndex* buildFuzzyIndex(const CardCorpus* corpus);
+
+/** Function to index the names of a card: every FN, and the family and given names of
+ *  each N, all case-folded with foldText.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode fuzzyIndexAddCard(FuzzyIndex* index, const Card* card, int docId);
+
+/** Function to remove the names of a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void fuzzyIndexRemoveCard(FuzzyIndex* index, int docId);
+
+/** Function to find the cards with a name within an edit distance of the query, e.g.
+ *  "Jon Smyth" finds "John Smith" at distance 2.  The query is case-folded first.
+ *@return the number of matches written to out, at most maxResults, ordered by distance
+          and then document id (so out holds the best maxResults matches)
+ *@param index - the index
+		 query - the name to look for
+		 maxDistance - the largest distance to accept, or -1 to allow 1 edit for up to
+					   4 bytes, 2 for up to 8 and 3 beyond that
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int fuzzyNameSearch(const FuzzyIndex* index, const char* query, int maxDistance,
+                    FuzzyMatch* out, int maxResults);
+
+/** Function to get the number of indexed names.
+ *@return the number of names
+ *@param index - the index
+ **/
+int fuzzyIndexSize(const FuzzyIndex* index);
+
+void deleteFuzzyIndex(FuzzyIndex* index);
+
+#endif
@@ -0,0 +1,124 @@
+/**
+ * @file VCGeo.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief "Contacts near a point": GEO values parsed into coordinates and kept in a k-d
+ *        tree, with radius, bounding-box and nearest-neighbour queries.
+ */
+
+#ifndef _VCGEO_H
+#define _VCGEO_H
+
+#include "VCCorpus.h"
+
+//Mean radius of the Earth used for distances
+#define GEO_EARTH_RADIUS_KM 6371.0088
+
+//A card found near a point
+typedef struct geoMatch {
+	int    docId;
+	double lat;
+	double lon;
+
+	//Great-circle distance from the query point
+	double distanceKm;
+} GeoMatch;
+
+//Opaque index state
+typedef struct geoIndex GeoIndex;
+
+/** Function to read the coordinates of a GEO property: a geo: URI as in vCard 4.0
+ *  (geo:37.386013,-122.082932, optionally with an altitude or parameters after it), or
+ *  the latitude and longitude as two values as in vCard 3.0 (37.386013;-122.082932).
+ *@return true if the property holds a latitude from -90 to 90 and a longitude from
+          -180 to 180
+ *@param prop - the GEO property
+		 lat - receives the latitude in degrees
+		 lon - receives the longitude in degrees
+ **/
+bool parseGeo(const Property* prop, double* lat, double* lon);
+
+/** Function to compute the great-circle distance between two points (haversine formula).
+ *@return the distance in kilometres
+ *@param lat1 - latitude of the first point, in degrees
+		 lon1 - longitude of the first point
+		 lat2 - latitude of the second point
+		 lon2 - longitude of the second point
+ **/
+double geoDistance(double lat1, double lon1, double lat2, double lon2);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteGeoIndex.
+ **/
+GeoIndex* createGeoIndex(void);
+
+/** Function to index every card in a corpus, using the corpus positions as document ids.
+ *  GEO values are parsed on several threads and the tree is built in one pass.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteGeoIndex.
+ *@param corpus - the cards to index
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+GeoIndex* buildGeoIndex(const CardCorpus* corpus, int numThreads);
+
+/** Function to index the location of a card: its first GEO property that parseGeo accepts.
+ *  A card already in the index is moved.  Cards without a location are ignored.
+ *  New locations are buffered and merged into trees of doubling size, so adding a card
+ *  costs O(log n) amortized and queries stay close to those on a freshly built index.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode geoIndexAddCard(GeoIndex* index, const Card* card, int docId);
+
+/** Function to remove a card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void geoIndexRemoveCard(GeoIndex* index, int docId);
+
+/** Function to find the cards within a distance of a point.
+ *@return the number of matches written to out, at most maxResults, nearest first (so
+          out holds the nearest maxResults of them), or -1 if malloc fails
+ *@param index - the index
+		 lat - latitude of the point, in degrees
+		 lon - longitude of the point
+		 radiusKm - the distance
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int geoRadius(const GeoIndex* index, double lat, double lon, double radiusKm, GeoMatch* out, int maxResults);
+
+/** Function to find the cards inside a latitude/longitude box.  A box with west greater
+ *  than east crosses the 180th meridian.
+ *@return the number of document ids written to out, at most maxResults, in increasing order,
+          or -1 if malloc fails
+ *@param index - the index
+		 south - the lowest latitude
+		 west - the western longitude
+		 north - the highest latitude
+		 east - the eastern longitude
+		 out - receives the document ids
+		 maxResults - the size of out
+ **/
+int geoBox(const GeoIndex* index, double south, double west, double north, double east, int* out, int maxResults);
+
+/** Function to find the cards nearest to a point.
+ *@return the number of matches written to out, at most k, nearest first
+ *@param index - the index
+		 lat - latitude of the point, in degrees
+		 lon - longitude of the point
+		 k - the number of cards wanted, and the size of out
+		 out - receives the matches
+ **/
+int geoNearest(const GeoIndex* index, double lat, double lon, int k, GeoMatch* out);
+
+/** Function to get the number of indexed cards.
+ *@return the number of cards with a location
+ *@param index - the index
+ **/
+int geoIndexSize(const GeoIndex* index);
+
+void deleteGeoIndex(GeoIndex* index);
+
+#endif
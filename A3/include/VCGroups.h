@@ -0,0 +1,141 @@
+/**
+ * @file VCGroups.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Lookup of grouped properties (RFC 6350, Section 3.3), e.g. item1.TEL and
+ *        item1.X-ABLabel, per card and by label across a corpus.
+ */
+
+#ifndef _VCGROUPS_H
+#define _VCGROUPS_H
+
+#include "VCCorpus.h"
+
+//The properties of one card that share a group name
+typedef struct propertyGroup {
+	//Group name as written in the card, e.g. "item1"
+	char*       name;
+
+	/*	Label of the group: the value of its X-ABLABEL property, with Apple's _$!<...>!$_
+		wrapper removed (so "_$!<Home>!$_" becomes "Home").  NULL if the group has none.
+	*/
+	char*       label;
+
+	//The properties, in card order.  They belong to the card, not to the group.
+	Property**  props;
+	int         count;
+	int         cap;
+} PropertyGroup;
+
+typedef struct cardGroups {
+	//Groups in order of first appearance in the card
+	PropertyGroup* groups;
+	int            count;
+	int            cap;
+
+	//Hash table of group positions by case-folded name, -1 for empty slots
+	int*           slots;
+	int            numSlots;
+} CardGroups;
+
+//A group found by label
+typedef struct groupMatch {
+	int                  docId;
+	const PropertyGroup* group;
+} GroupMatch;
+
+//Opaque corpus index state
+typedef struct groupIndex GroupIndex;
+
+/** Function to create an empty set of groups.
+ *@return a new set, or NULL if malloc fails.  Must be freed with deleteCardGroups.
+ **/
+CardGroups* createCardGroups(void);
+
+/** Function to add a property to the group named by its group field.  Properties
+ *  without a group are ignored.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param groups - the groups
+		 prop - the property; it must outlive the groups
+ **/
+VCardErrorCode cardGroupsAdd(CardGroups* groups, Property* prop);
+
+/** Function to group the properties of a parsed card (FN and optionalProperties).
+ *@return a new set, or NULL if malloc fails.  Must be freed with deleteCardGroups.
+ *@param card - the card; it must outlive the groups
+ **/
+CardGroups* indexCardGroups(const Card* card);
+
+/** Function to parse a vCard file like createCard, grouping the properties as they are read.
+ *@post on OK, *groups holds the groups of *obj (possibly none).  It must be freed with
+        deleteCardGroups before *obj is deleted.  Both are NULL on any other result.
+ *@return the same result as createCard, or OTHER_ERROR if malloc fails
+ *@param fileName - the file to parse
+		 obj - receives the card
+		 groups - receives the groups
+ **/
+VCardErrorCode createCardGrouped(char* fileName, Card** obj, CardGroups** groups);
+
+/** Function to find a group by name, ignoring case, in O(1).
+ *@return the group, or NULL if the card has no such group
+ *@param groups - the groups
+		 name - the group name, e.g. "item1"
+ **/
+const PropertyGroup* findGroup(const CardGroups* groups, const char* name);
+
+/** Function to find the first property of a group with the given name, ignoring case.
+ *@return the property, or NULL if the group has none
+ *@param group - the group
+		 propName - the property name, e.g. "TEL"
+ **/
+Property* groupProperty(const PropertyGroup* group, const char* propName);
+
+void deleteCardGroups(CardGroups* groups);
+
+/** Function to group the properties of every card in a corpus, on several threads,
+ *  and index the groups by label.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteGroupIndex.
+ *@param corpus - the cards; they must outlive the index
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+GroupIndex* buildGroupIndex(const CardCorpus* corpus, int numThreads);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteGroupIndex.
+ **/
+GroupIndex* createGroupIndex(void);
+
+/** Function to add the groups of a card.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card; it must outlive the index, or be removed first
+		 docId - the card's document id
+ **/
+VCardErrorCode groupIndexAddCard(GroupIndex* index, const Card* card, int docId);
+
+/** Function to remove the groups of a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void groupIndexRemoveCard(GroupIndex* index, int docId);
+
+/** Function to get the groups of a card.
+ *@return the groups, or NULL if the card has not been added
+ *@param index - the index
+		 docId - the card's document id
+ **/
+const CardGroups* groupIndexCard(const GroupIndex* index, int docId);
+
+/** Function to find the groups with a label, e.g. every "Home" number or address,
+ *  ignoring case and the _$!<...>!$_ wrapper.
+ *@return the number of matches written to out, at most maxResults, ordered by document id
+ *@param index - the index
+		 label - the label
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int groupIndexLabel(const GroupIndex* index, const char* label, GroupMatch* out, int maxResults);
+
+void deleteGroupIndex(GroupIndex* index);
+
+#endif
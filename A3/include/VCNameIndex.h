@@ -0,0 +1,79 @@
+/**
+ * @file VCNameIndex.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief In-memory compressed trie over case-folded FN values, for type-ahead
+ *        search by name prefix.
+ */
+
+#ifndef _VCNAMEINDEX_H
+#define _VCNAMEINDEX_H
+
+#include "VCCorpus.h"
+
+//Opaque index state
+typedef struct nameIndex NameIndex;
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteNameIndex.
+ **/
+NameIndex* createNameIndex(void);
+
+/** Function to index every FN of every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteNameIndex.
+ *@param corpus - the cards to index
+ **/
+NameIndex* buildNameIndex(const CardCorpus* corpus);
+
+/** Function to add a name.  The name is case-folded with foldText.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 name - the name
+		 docId - the document id to return for it
+ **/
+VCardErrorCode nameIndexInsert(NameIndex* index, const char* name, int docId);
+
+/** Function to remove a name added with nameIndexInsert.
+ *@return true if the pair was in the index
+ *@param index - the index
+		 name - the name
+		 docId - the document id it was added with
+ **/
+bool nameIndexRemove(NameIndex* index, const char* name, int docId);
+
+/** Function to add every FN of a card (the first one and any in optionalProperties).
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode nameIndexAddCard(NameIndex* index, const Card* card, int docId);
+
+/** Function to remove every FN of a card, e.g. before re-adding the changed card.
+ *@pre card holds the same FN values it was added with
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+void nameIndexRemoveCard(NameIndex* index, const Card* card, int docId);
+
+/** Function to find the names that start with a prefix (compared case-folded).
+ *  Results are ordered by folded name, then by document id.  A card with several
+ *  matching FN values is returned once per name.
+ *@return the number of document ids written to docIds, at most maxResults
+ *@param index - the index
+		 prefix - the prefix.  An empty prefix matches every name.
+		 docIds - receives the document ids
+		 maxResults - the size of docIds
+ **/
+int nameIndexPrefix(const NameIndex* index, const char* prefix, int* docIds, int maxResults);
+
+/** Function to get the number of (name, document id) pairs in the index.
+ *@return the number of pairs
+ *@param index - the index
+ **/
+int nameIndexSize(const NameIndex* index);
+
+void deleteNameIndex(NameIndex* index);
+
+#endif
@@ -147,4 +147,34 @@ char* dateToString(void* date);
   **/
  VCardErrorCode validateCard(const Card* obj);
 
+// ************* Validation helpers *****************************************
+
+/** Function to check a single property against the rules applied by validateCard.
+ *@pre prop is not NULL
+ *@post prop has not been modified in any way
+ *@return OK, INV_PROP if the property is malformed or its name is not allowed,
+          INV_DT if a BDAY or ANNIVERSARY property is found in the optional property list
+ *@param prop - a pointer to a Property struct
+		 optional - true if the property is an element of Card->optionalProperties
+		 propId - if not NULL, receives the id of the property name (see VCProperties.h)
+ **/
+VCardErrorCode validateProperty(const Property* prop, bool optional, int* propId);
+
+/** Function to check a birthday or anniversary DateTime against the rules applied by validateCard.
+ *@pre dt is not NULL
+ *@return OK or INV_DT
+ *@param dt - a pointer to a DateTime struct
+ **/
+VCardErrorCode validateDateTime(const DateTime* dt);
+
+/** Function to parse and validate a vCard file in a single pass.
+ *  Each property is checked as soon as it is parsed, so the Card is never traversed a second time.
+ *@pre fileName is not NULL
+ *@post On success *obj points to a new, valid Card.  On failure *obj is NULL.
+ *@return the same error code that createCard followed by validateCard would produce
+ *@param fileName - the name of the vCard file
+		 obj - receives the new Card
+ **/
+VCardErrorCode createCardValidated(char* fileName, Card** obj);
+
 #endif	
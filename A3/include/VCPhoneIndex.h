@@ -0,0 +1,98 @@
+/**
+ * @file VCPhoneIndex.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Reverse lookup from telephone numbers to the cards and TEL properties
+ *        that hold them, by whole number or by its last digits.
+ */
+
+#ifndef _VCPHONEINDEX_H
+#define _VCPHONEINDEX_H
+
+#include "VCCorpus.h"
+
+//Longest normalized number, including the leading + and the terminating NUL
+#define PHONE_MAX_LEN 24
+
+//Where a number was found
+typedef struct phoneMatch {
+	int docId;
+
+	//Position of the TEL property in the card's optionalProperties
+	int propIndex;
+} PhoneMatch;
+
+//Opaque index state
+typedef struct phoneIndex PhoneIndex;
+
+/** Function to reduce a telephone number to "+" followed by its digits (E.164 style).
+ *  A tel: prefix, punctuation, spaces and any extension (;ext=, x, ext, #) are dropped.
+ *  A number given with + or the 00 international prefix keeps its country code.  Any other
+ *  number that starts with a trunk 0 or has at most 10 digits is treated as national: the
+ *  trunk 0 is removed and defaultCountry is put in front.
+ *@return the length of out, or 0 if the value has fewer than 3 digits or does not fit
+ *@param value - the TEL value, e.g. "tel:+1-519-555-0100;ext=12" or "(519) 555 0100"
+		 defaultCountry - country calling code for national numbers, e.g. "1", or NULL for none
+		 out - receives the normalized number
+		 size - the size of out
+ **/
+int normalizePhone(const char* value, const char* defaultCountry, char* out, size_t size);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deletePhoneIndex.
+ *@param defaultCountry - passed to normalizePhone for every number added or looked up
+ **/
+PhoneIndex* createPhoneIndex(const char* defaultCountry);
+
+/** Function to index the TEL properties of every card in a corpus.  Numbers are
+ *  normalized on several threads, then added in document order.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deletePhoneIndex.
+ *@param corpus - the cards to index
+		 defaultCountry - see createPhoneIndex
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+PhoneIndex* buildPhoneIndex(const CardCorpus* corpus, const char* defaultCountry, int numThreads);
+
+/** Function to add the TEL properties of a card.  Values that do not normalize are skipped.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode phoneIndexAddCard(PhoneIndex* index, const Card* card, int docId);
+
+/** Function to remove every number of a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void phoneIndexRemoveCard(PhoneIndex* index, int docId);
+
+/** Function to find the properties holding a number.  The number is normalized first,
+ *  so any of the forms normalizePhone accepts can be used.
+ *@return the number of matches written to out, at most maxResults
+ *@param index - the index
+		 number - the number
+		 out - receives the matches
+		 maxResults - the size of out
+ **/
+int phoneIndexLookup(const PhoneIndex* index, const char* number, PhoneMatch* out, int maxResults);
+
+/** Function to find the numbers that end in the given digits, e.g. the last 7 digits of
+ *  a number whose area code is unknown.  Characters other than digits are ignored.
+ *@return the number of matches written to out, at most maxResults
+ *@param index - the index
+		 digits - the last digits of the number
+		 out - receives the matches, ordered by the reversed number
+		 maxResults - the size of out
+ **/
+int phoneIndexSuffix(const PhoneIndex* index, const char* digits, PhoneMatch* out, int maxResults);
+
+/** Function to get the number of indexed TEL values.
+ *@return the number of values
+ *@param index - the index
+ **/
+int phoneIndexSize(const PhoneIndex* index);
+
+void deletePhoneIndex(PhoneIndex* index);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file VCPhonetic.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Sound-alike name lookup: Double Metaphone keys of the words of FN and of the
+ *        family and given names of N, in a multi-map from key to cards.
+ */
+
+#ifndef _VCPHONETIC_H
+#define _VCPHONETIC_H
+
+#include "VCCorpus.h"
+
+//Maximum length of a Double Metaphone key; key buffers need one more byte
+#define METAPHONE_LEN 4
+
+//Opaque index state
+typedef struct phoneticIndex PhoneticIndex;
+
+/** Function to compute the Double Metaphone keys of a word, e.g. "Smith" gives "SM0" and
+ *  "XMT", and "Schmidt" gives "XMT" and "SMT".  Case is ignored, and accented Latin-1
+ *  letters count as their plain form.
+ *@post primary and secondary hold keys of at most METAPHONE_LEN characters.  They are
+        equal when the word has one likely pronunciation, and empty if it has no letters.
+ *@param word - the word
+		 primary - receives the most likely key
+		 secondary - receives the alternative key
+ **/
+void doubleMetaphone(const char* word, char* primary, char* secondary);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deletePhoneticIndex.
+ **/
+PhoneticIndex* createPhoneticIndex(void);
+
+/** Function to index the names of every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deletePhoneticIndex.
+ *@param corpus - the cards to index
+ **/
+PhoneticIndex* buildPhoneticIndex(const CardCorpus* corpus);
+
+/** Function to index both keys of every word of a card's FN values and of the family
+ *  and given names of its N properties.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+VCardErrorCode phoneticIndexAddCard(PhoneticIndex* index, const Card* card, int docId);
+
+/** Function to remove the names of a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void phoneticIndexRemoveCard(PhoneticIndex* index, int docId);
+
+/** Function to find the cards whose names sound like every word of a name, e.g. "Jon
+ *  Smyth" finds "John Smith" and "Jon Schmidt".  Two words sound alike when either
+ *  key of one equals either key of the other.
+ *@return the number of document ids written to out, at most maxResults, in increasing order
+ *@param index - the index
+		 name - one or more words
+		 out - receives the document ids
+		 maxResults - the size of out
+ **/
+int phoneticLookup(const PhoneticIndex* index, const char* name, int* out, int maxResults);
+
+/** Function to get the number of distinct keys in the index.
+ *@return the number of keys
+ *@param index - the index
+ **/
+int phoneticIndexSize(const PhoneticIndex* index);
+
+void deletePhoneticIndex(PhoneticIndex* index);
+
+#endif
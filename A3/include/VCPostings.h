@@ -0,0 +1,125 @@
+/**
+ * @file VCPostings.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Compressed lists of sorted document ids (blocks of delta-encoded varints), and the
+ *        sorted-array set operations the in-memory indexes evaluate queries with.
+ */
+
+#ifndef _VCPOSTINGS_H
+#define _VCPOSTINGS_H
+
+#include "VCParser.h"
+
+/*	A set of document ids, kept in increasing order in blocks.  Appending starts a new
+	block every POSTING_BLOCK ids; an id inserted into the middle goes into the block it
+	falls in, which may grow to 2 * POSTING_BLOCK ids before it is split in two halves.
+	Each block stores its first id and then the differences between neighbours, 7 bits
+	per byte.  Appending a larger id is O(1), and any other change rewrites only the
+	block it falls in.  Zero-initialize before use.
+*/
+#define POSTING_BLOCK 128
+
+typedef struct postingBlock {
+	int            first;
+	int            last;
+	int            count;
+	unsigned char* data;
+	size_t         size;
+	size_t         cap;
+} PostingBlock;
+
+typedef struct postingList {
+	PostingBlock*  blocks;
+	int            numBlocks;
+	int            blockCap;
+
+	//Number of ids
+	int            count;
+} PostingList;
+
+//Reads a posting list one id at a time without decoding all of it
+typedef struct postingIter {
+	const PostingList*   list;
+	int                  block;
+	const unsigned char* pos;
+	const unsigned char* end;
+	int                  current;
+} PostingIter;
+
+/** Function to add a document id.
+ *@return 1 if it was added, 0 if it was already there, -1 if malloc fails
+ *@param list - the list
+		 docId - the id (not negative)
+ **/
+int postingAdd(PostingList* list, int docId);
+
+/** Function to remove a document id.
+ *@return true if it was there
+ *@param list - the list
+		 docId - the id
+ **/
+bool postingRemove(PostingList* list, int docId);
+
+/** Function to decode a whole list.
+ *@pre out has room for list->count ids
+ *@return the number of ids written
+ *@param list - the list
+		 out - receives the ids in increasing order
+ **/
+int postingDecode(const PostingList* list, int* out);
+
+/** Function to start reading a list with postingNext.
+ *@param list - the list
+		 iter - the iterator to set up
+ **/
+void postingIterInit(const PostingList* list, PostingIter* iter);
+
+/** Function to read the next id.
+ *@return the id, or -1 at the end of the list
+ *@param iter - the iterator
+ **/
+int postingNext(PostingIter* iter);
+
+/** Function to get the memory used by a list's blocks.
+ *@return the number of bytes
+ *@param list - the list
+ **/
+size_t postingBytes(const PostingList* list);
+
+/** Function to free the storage of a list and empty it.
+ *@param list - the list
+ **/
+void postingFree(PostingList* list);
+
+/** Function to keep only the ids of a sorted array that are also in a list.
+ *@return the new length of ids
+ *@param ids - sorted ids, overwritten with the intersection
+		 count - the length of ids
+		 list - the list to intersect with
+ **/
+int intersectPosting(int* ids, int count, const PostingList* list);
+
+/** Function to merge two sorted arrays without duplicates.
+ *@pre out has room for aCount + bCount ids
+ *@return the length of out
+ *@param a, aCount - the first array
+		 b, bCount - the second array
+		 out - receives the union
+ **/
+int unionSorted(const int* a, int aCount, const int* b, int bCount, int* out);
+
+/** Function to keep only the ids of one sorted array that are also in another.
+ *@return the new length of a
+ *@param a, aCount - the first array, overwritten with the intersection
+		 b, bCount - the second array
+ **/
+int intersectSorted(int* a, int aCount, const int* b, int bCount);
+
+/** Function to remove from one sorted array the ids that are in another.
+ *@return the new length of a
+ *@param a, aCount - the first array, overwritten with the difference
+		 b, bCount - the ids to remove
+ **/
+int subtractSorted(int* a, int aCount, const int* b, int bCount);
+
+#endif
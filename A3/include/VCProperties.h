@@ -0,0 +1,53 @@
+/**
+ * @file VCProperties.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Table of the vCard 4.0 property names (RFC 6350, Sections 6.1 - 6.9.3)
+ *        with their cardinalities, used to map a property name to a small integer id.
+ */
+
+#ifndef _VCPROPERTIES_H
+#define _VCPROPERTIES_H
+
+#include <stdbool.h>
+
+//Number of entries in the property table.  Always fits in a 64-bit mask.
+#define NUM_KNOWN_PROPS 38
+
+//Returned by propertyId for names that are not in the table
+#define PROP_UNKNOWN  -1
+
+//Returned by propertyId for extended (X-) property names
+#define PROP_EXTENDED -2
+
+/*	Cardinality of a property, as listed in RFC 6350, Section 3.3:
+	exactly one (1), at most one (*1), one or more (1*) and any number (*)
+*/
+typedef enum card { CARD_ONE, CARD_ZERO_OR_ONE, CARD_ONE_OR_MORE, CARD_ANY } PropCardinality;
+
+/** Function to look up the id of a property name.
+ *@pre name is not NULL
+ *@return an id in the range [0, NUM_KNOWN_PROPS) for a known name (case-insensitive),
+          PROP_EXTENDED for an X- name, PROP_UNKNOWN otherwise
+ *@param name - the property name
+ **/
+int propertyId(const char* name);
+
+/** Function to get the cardinality of a property id.
+ *@return the cardinality of the property.  Extended properties may occur any number of times.
+ *@param id - a value returned by propertyId
+ **/
+PropCardinality propertyCardinality(int id);
+
+/** Function to get the canonical (upper case) name of a known property id.
+ *@return the property name, or NULL if id is not a known property id
+ *@param id - a value returned by propertyId
+ **/
+const char* propertyName(int id);
+
+/** Function to check whether a property may occur more than once in a card.
+ *@return true if the cardinality of the property is 1* or *
+ *@param id - a value returned by propertyId
+ **/
+bool propertyIsRepeatable(int id);
+
+#endif
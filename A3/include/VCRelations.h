@@ -0,0 +1,155 @@
+/**
+ * @file VCRelations.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Graph of the links between cards: UID values resolved to cards, MEMBER lists of
+ *        KIND=group cards and RELATED links, with group expansion and breadth-first search.
+ */
+
+#ifndef _VCRELATIONS_H
+#define _VCRELATIONS_H
+
+#include "VCCorpus.h"
+
+//Kinds of link, combined with | where a set of kinds is asked for
+#define RELATION_MEMBER  1
+#define RELATION_RELATED 2
+#define RELATION_ANY     (RELATION_MEMBER | RELATION_RELATED)
+
+//A link from a card, as written in it
+typedef struct relationLink {
+	//RELATION_MEMBER or RELATION_RELATED
+	int         kind;
+
+	//The UID the link names (a urn:uuid: prefix is dropped and UUIDs are lower-cased).
+	//It belongs to the graph.
+	const char* uid;
+
+	//The card whose UID it is, or -1 if no indexed card has that UID
+	int         docId;
+} RelationLink;
+
+//A card reached by relationTraverse
+typedef struct relationHit {
+	int docId;
+
+	//Number of links from the start
+	int depth;
+
+	//The card it was reached from (the start card for depth 1)
+	int parent;
+} RelationHit;
+
+//Opaque graph state
+typedef struct relationGraph RelationGraph;
+
+/** Function to create an empty graph.
+ *@return a new graph, or NULL if malloc fails.  Must be freed with deleteRelationGraph.
+ **/
+RelationGraph* createRelationGraph(void);
+
+/** Function to build the graph of every card in a corpus, using the corpus positions as
+ *  document ids.  The links are laid out in compressed arrays in one pass.
+ *@pre corpus is not NULL
+ *@return a new graph, or NULL if malloc fails.  Must be freed with deleteRelationGraph.
+ *@param corpus - the cards to index
+ **/
+RelationGraph* buildRelationGraph(const CardCorpus* corpus);
+
+/** Function to add a card: its UID, whether it is a group (KIND:group), and its MEMBER
+ *  and RELATED links (the X-ADDRESSBOOKSERVER- forms of KIND and MEMBER are read too).
+ *  RELATED values marked VALUE=text are not links and are skipped.  A card already in the
+ *  graph is replaced.  Links may name UIDs that no card has yet; they resolve once such a
+ *  card is added.  Changed cards are kept beside the compressed arrays until enough of
+ *  them build up to rebuild the arrays.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param graph - the graph
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode relationGraphAddCard(RelationGraph* graph, const Card* card, int docId);
+
+/** Function to remove a card.  Links to its UID stay, and no longer resolve unless
+ *  another card has the same UID.
+ *@param graph - the graph
+		 docId - the card's document id
+ **/
+void relationGraphRemoveCard(RelationGraph* graph, int docId);
+
+/** Function to find the card with a UID.  When several cards share a UID, the first added
+ *  is returned.
+ *@return the document id, or -1 if no card has the UID
+ *@param graph - the graph
+		 uid - the UID, e.g. "urn:uuid:f81d4fae-7dec-11d0-a765-00a0c91e6bf6"
+ **/
+int relationGraphFind(const RelationGraph* graph, const char* uid);
+
+/** Function to tell whether a card is a group.
+ *@return true if the card was added with KIND:group
+ *@param graph - the graph
+		 docId - the card's document id
+ **/
+bool relationGraphIsGroup(const RelationGraph* graph, int docId);
+
+/** Function to get the links written in a card.
+ *@return the number of links written to out, at most maxResults, in card order
+ *@param graph - the graph
+		 docId - the card's document id
+		 kinds - the kinds of link wanted, e.g. RELATION_ANY
+		 out - receives the links
+		 maxResults - the size of out
+ **/
+int relationGraphLinks(const RelationGraph* graph, int docId, int kinds, RelationLink* out, int maxResults);
+
+/** Function to list the members of a group.  With transitive set, members that are groups
+ *  themselves are replaced by their own members, however deeply nested (cycles are
+ *  followed once).  MEMBER values that no card has as its UID are left out.
+ *@pre graph and docIds are not NULL
+ *@post *docIds is a newly allocated array of the members in increasing order (NULL if
+        there are none).  It must be freed by the caller.
+ *@return the number of members, or -1 if malloc fails
+ *@param graph - the graph
+		 groupId - the document id of the group
+		 transitive - true to expand nested groups
+		 docIds - receives the members
+ **/
+int relationGraphMembers(const RelationGraph* graph, int groupId, bool transitive, int** docIds);
+
+/** Function to list the groups that have a card as a MEMBER.  With transitive set, the
+ *  groups that contain those groups are included too, however deeply nested.
+ *@pre graph and docIds are not NULL
+ *@post *docIds is a newly allocated array of the groups in increasing order (NULL if
+        there are none).  It must be freed by the caller.
+ *@return the number of groups, or -1 if malloc fails
+ *@param graph - the graph
+		 docId - the card's document id
+		 transitive - true to include the groups of groups
+		 docIds - receives the groups
+ **/
+int relationGraphGroupsOf(const RelationGraph* graph, int docId, bool transitive, int** docIds);
+
+/** Function to search the graph breadth-first from a card, up to a number of links away.
+ *  Links are followed from the card that holds them to the card they name and, with
+ *  bothWays set, also back (so from an employee's RELATED;TYPE=x-manager link, both the
+ *  manager and the manager's reports are found).
+ *@return the number of cards written to out, at most maxResults, nearest first; the start
+          card is not included
+ *@param graph - the graph
+		 startId - the document id to start from
+		 maxDepth - the largest number of links to follow
+		 kinds - the kinds of link to follow, e.g. RELATION_RELATED
+		 bothWays - true to follow links backwards as well
+		 out - receives the cards reached
+		 maxResults - the size of out
+ **/
+int relationTraverse(const RelationGraph* graph, int startId, int maxDepth, int kinds, bool bothWays,
+                     RelationHit* out, int maxResults);
+
+/** Function to get the number of links in the graph.
+ *@return the number of MEMBER and RELATED links of the cards in the graph
+ *@param graph - the graph
+ **/
+int relationGraphSize(const RelationGraph* graph);
+
+void deleteRelationGraph(RelationGraph* graph);
+
+#endif
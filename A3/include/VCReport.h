@@ -0,0 +1,111 @@
+/**
+ * @file VCReport.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Validation reports that list every problem in a Card instead of only the first,
+ *        and a multi-threaded validator that summarizes a whole directory of cards.
+ */
+
+#ifndef _VCREPORT_H
+#define _VCREPORT_H
+
+#include "VCParser.h"
+
+//Kinds of problems found by validateCardReport
+typedef enum vkind {
+	VIOL_PARSE,          //createCard failed, see the error code
+	VIOL_MISSING_FN,     //the card has no FN property
+	VIOL_BAD_NAME,       //property name is empty, NULL or not allowed
+	VIOL_NO_VALUE,       //property has no values
+	VIOL_BAD_PARAM,      //parameter with an empty name or value
+	VIOL_N_VALUES,       //N property does not have exactly 5 values
+	VIOL_DATE_PROP,      //BDAY or ANNIVERSARY found in optionalProperties
+	VIOL_VERSION_PROP,   //VERSION found in optionalProperties
+	VIOL_CARDINALITY,    //a 1 or *1 property occurs more than once
+	VIOL_BAD_DATE,       //birthday or anniversary DateTime is inconsistent
+	NUM_VIOLATION_KINDS
+} ViolationKind;
+
+//Index used for problems that do not belong to an element of optionalProperties
+#define VIOL_INDEX_FN          -1
+#define VIOL_INDEX_BIRTHDAY    -2
+#define VIOL_INDEX_ANNIVERSARY -3
+#define VIOL_INDEX_CARD        -4
+
+//A single problem found in a Card
+typedef struct violation {
+	ViolationKind  kind;
+
+	//The error code validateCard would return if this were the first problem
+	VCardErrorCode code;
+
+	//Name of the offending property.  Empty string for card-level problems.  Must not be NULL.
+	char*          propName;
+
+	//Position in optionalProperties, or one of the VIOL_INDEX_ values
+	int            index;
+
+	//Human-readable description.  Must not be NULL.
+	char*          reason;
+} Violation;
+
+//All problems found in a Card
+typedef struct report {
+	//Error code validateCard returns for the same Card (the code of the first violation), or OK
+	VCardErrorCode result;
+
+	//List of Violation structs, in the order validateCard checks them.  Must never be NULL.
+	List*          violations;
+} ValidationReport;
+
+//Aggregate results of validating a directory of cards
+typedef struct corpusStats {
+	int numFiles;
+	int numValid;
+
+	//Number of files per error code returned by createCard + validateCard
+	int errorCounts[OTHER_ERROR + 1];
+
+	//Number of violations of each kind, over all files
+	int kindCounts[NUM_VIOLATION_KINDS];
+} CorpusStats;
+
+/** Function to collect every validation problem in a Card.
+ *@pre obj may be NULL, in which case the report contains a single card-level violation
+ *@post obj has not been modified in any way
+ *@return a newly allocated report, or NULL if malloc fails.  Must be freed with deleteValidationReport.
+ *@param obj - a pointer to a Card struct
+ **/
+ValidationReport* validateCardReport(const Card* obj);
+
+/** Function to parse a file and collect every validation problem in it.
+ *  If the file cannot be parsed, the report holds a single VIOL_PARSE violation.
+ *@return a newly allocated report, or NULL if malloc fails.  Must be freed with deleteValidationReport.
+ *@param fileName - the name of the vCard file
+ **/
+ValidationReport* validateFileReport(char* fileName);
+
+void deleteValidationReport(ValidationReport* report);
+char* reportToString(const ValidationReport* report);
+
+// List helper functions for Violation
+void deleteViolation(void* toBeDeleted);
+int compareViolations(const void* first, const void* second);
+char* violationToString(void* violation);
+
+/** Function to get a short name for a violation kind, e.g. "cardinality".
+ *@return a static string.  Must not be freed.
+ *@param kind - the violation kind
+ **/
+const char* violationKindName(ViolationKind kind);
+
+/** Function to validate every vCard file in a directory on a pool of threads.
+ *@pre dirName and stats are not NULL
+ *@post stats holds the histogram of error codes and violation kinds
+ *@return OK, or the error from listCardFiles / runParallel
+ *@param dirName - the directory of vCard files
+		 numThreads - the number of threads, or 0 for one per processor
+		 stats - receives the results
+ **/
+VCardErrorCode validateCorpus(const char* dirName, int numThreads, CorpusStats* stats);
+
+#endif
@@ -0,0 +1,67 @@
+/**
+ * @file VCScan.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Parses a whole directory of vCard files in parallel and returns the results
+ *        as one packed, column-oriented table, so a caller needs a single call per load.
+ */
+
+#ifndef _VCSCAN_H
+#define _VCSCAN_H
+
+#include "VCParser.h"
+
+/*	Result of scanning a set of vCard files.  Row i describes one file.
+	Every string column is stored in the shared strings buffer and addressed by an offset.
+	The strings of a row are stored back to back in the order
+	name, fn, birthday, anniversary, so the buffer can also be split on NUL characters
+	into 4 * count fields.
+*/
+typedef struct scanTable {
+	int        count;
+
+	//All strings, each NUL-terminated.  stringsSize is the total size in bytes.
+	char*      strings;
+	size_t     stringsSize;
+
+	//Offsets into strings.  FN, birthday and anniversary are empty if error is not OK.
+	size_t*    nameOff;
+	size_t*    fnOff;
+	size_t*    bdayOff;     //birthday, see dateToISO.  Empty if absent.
+	size_t*    annOff;      //anniversary, see dateToISO.  Empty if absent.
+
+	//Numeric date parts, see dateToParts.  -1 where a part (or the whole date) is missing.
+	int*       bdayYear;
+	int*       bdayMonth;
+	int*       bdayDay;
+	int*       annYear;
+	int*       annMonth;
+	int*       annDay;
+
+	long long* mtime;       //seconds since the epoch, or 0 if the file could not be read
+	long long* size;        //file size in bytes
+	int*       error;       //result of createCardValidated
+} ScanTable;
+
+/** Function to parse and validate every vCard file in a directory.
+ *@pre dirName is not NULL
+ *@return a newly allocated table sorted by file name, or NULL if the directory cannot be read
+          or malloc fails.  Must be freed with freeScanTable.
+ *@param dirName - the directory to scan
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+ScanTable* scanCardDirectory(const char* dirName, int numThreads);
+
+/** Function to parse and validate the given files of a directory.
+ *@pre dirName is not NULL, names holds count file names (not paths)
+ *@return a newly allocated table with one row per name, in the same order, or NULL if malloc fails.
+          Must be freed with freeScanTable.
+ *@param dirName - the directory holding the files
+		 names - the file names
+		 count - the number of file names
+		 numThreads - the number of threads, or 0 for one per processor
+ **/
+ScanTable* scanCardFiles(const char* dirName, char** names, int count, int numThreads);
+
+void freeScanTable(ScanTable* table);
+
+#endif
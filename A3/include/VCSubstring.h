@@ -0,0 +1,76 @@
+/**
+ * @file VCSubstring.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Infix search ("mith" finds "Smith") over the values of selected properties: a
+ *        trigram index with compressed posting lists narrows the cards, and the stored
+ *        values confirm each match.
+ */
+
+#ifndef _VCSUBSTRING_H
+#define _VCSUBSTRING_H
+
+#include "VCCorpus.h"
+
+//Opaque index state
+typedef struct substringIndex SubstringIndex;
+
+/** Function to create an empty index over the values of some properties.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteSubstringIndex.
+ *@param propNames - the property names, ignoring case, or NULL for FN, ORG, NOTE and EMAIL
+		 numProps - the number of names
+ **/
+SubstringIndex* createSubstringIndex(const char* const* propNames, int numProps);
+
+/** Function to index every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteSubstringIndex.
+ *@param corpus - the cards to index
+		 propNames - see createSubstringIndex
+		 numProps - the number of names
+ **/
+SubstringIndex* buildSubstringIndex(const CardCorpus* corpus, const char* const* propNames, int numProps);
+
+/** Function to index the values of a card's selected properties, case-folded with
+ *  foldText.  The index keeps its own copy of the folded values.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode substringIndexAddCard(SubstringIndex* index, const Card* card, int docId);
+
+/** Function to remove a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void substringIndexRemoveCard(SubstringIndex* index, int docId);
+
+/** Function to find the cards with a value containing a string, ignoring case.
+ *  Patterns of three bytes or more are looked up by their trigrams; shorter ones check
+ *  every stored value.
+ *@pre index, pattern and docIds are not NULL
+ *@post *docIds is a newly allocated array of the matching document ids in increasing
+        order (NULL if there are none).  It must be freed by the caller.
+ *@return the number of matching documents, or -1 if malloc fails
+ *@param index - the index
+		 pattern - the string to look for
+		 propName - only search values of this property, or NULL for all indexed properties
+		 docIds - receives the matches
+ **/
+int substringSearch(const SubstringIndex* index, const char* pattern, const char* propName, int** docIds);
+
+/** Function to get the number of distinct trigrams.
+ *@return the number of trigrams
+ *@param index - the index
+ **/
+int substringIndexSize(const SubstringIndex* index);
+
+/** Function to get the size of the postings, including block overhead.
+ *@return the number of bytes used by postings
+ *@param index - the index
+ **/
+size_t substringIndexPostingBytes(const SubstringIndex* index);
+
+void deleteSubstringIndex(SubstringIndex* index);
+
+#endif
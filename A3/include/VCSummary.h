@@ -0,0 +1,75 @@
+/**
+ * @file VCSummary.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Fixed-size card summaries (FN, birthday, anniversary, property count) filled in a
+ *        single call, so callers such as the Python UI do not need one call and one
+ *        allocated string per field.
+ */
+
+#ifndef _VCSUMMARY_H
+#define _VCSUMMARY_H
+
+#include "VCParser.h"
+
+#define SUMMARY_FN_LEN   256
+#define SUMMARY_DATE_LEN 64
+
+/*	Summary of a single card.  All strings are NUL-terminated and truncated to fit.
+	Birthday and anniversary use the dateToString format, or "None" if absent.
+*/
+typedef struct cardSummary {
+	char fn[SUMMARY_FN_LEN];
+	char birthday[SUMMARY_DATE_LEN];
+	char anniversary[SUMMARY_DATE_LEN];
+
+	//Number of optional properties
+	int  numProps;
+
+	//Result of parsing (and validating) the card.  The other fields are empty unless this is OK.
+	int  error;
+} CardSummary;
+
+/** Function to fill a summary from a Card.
+ *@pre out is not NULL
+ *@post obj has not been modified in any way
+ *@return OK, or INV_CARD if obj is NULL
+ *@param obj - a pointer to a Card struct
+		 out - the summary to fill
+ **/
+VCardErrorCode summarizeCard(const Card* obj, CardSummary* out);
+
+/** Function to parse a file and fill its summary, without keeping the Card.
+ *@pre fileName and out are not NULL
+ *@return the error code from createCard, or createCardValidated if validate is true.  Also stored in out->error.
+ *@param fileName - the name of the vCard file
+		 validate - true to apply the validateCard rules while parsing
+		 out - the summary to fill
+ **/
+VCardErrorCode summarizeFile(char* fileName, bool validate, CardSummary* out);
+
+/** Function to summarize a batch of files on a pool of threads.
+ *@pre fileNames holds count file names, and out has room for count summaries
+ *@post out[i] holds the summary of fileNames[i]
+ *@return the number of files that were summarized without error
+ *@param fileNames - the file names
+		 count - the number of files
+		 validate - true to apply the validateCard rules while parsing
+		 numThreads - the number of threads, or 0 for one per processor
+		 out - the summaries to fill
+ **/
+int summarizeFiles(char** fileNames, int count, bool validate, int numThreads, CardSummary* out);
+
+/** Function to allocate an array of summaries, for callers that cannot allocate it themselves.
+ *@return a zeroed array of count summaries, or NULL.  Must be freed with freeSummaries.
+ *@param count - the number of summaries
+ **/
+CardSummary* allocSummaries(int count);
+void freeSummaries(CardSummary* summaries);
+
+/** Function to free a string returned by the library, e.g. by fnToString or errorToString.
+ *  Callers using a different allocator (for example through ctypes) must use this instead of free.
+ *@param str - the string to free.  May be NULL.
+ **/
+void freeString(char* str);
+
+#endif
@@ -0,0 +1,29 @@
+/**
+ * @file VCText.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Text normalization shared by the in-memory indexes, so every index
+ *        compares property values the same way.
+ */
+
+#ifndef _VCTEXT_H
+#define _VCTEXT_H
+
+#include "VCParser.h"
+
+/** Function to case-fold a value for searching.
+ *  ASCII and Latin-1 letters are lowercased (other UTF-8 text is kept as is), leading and
+ *  trailing white space is removed, and runs of white space become a single space.
+ *@return a newly allocated string, or NULL if s is NULL or malloc fails.  Must be freed by the caller.
+ *@param s - the text to fold
+ **/
+char* foldText(const char* s);
+
+/** Function to find the next word in a string: a run of ASCII letters and digits or
+ *  non-ASCII (UTF-8) bytes.  Everything else separates words.
+ *@return a pointer to the start of the word, or NULL if there are no more words
+ *@param s - where to start looking
+		 len - receives the length of the word in bytes
+ **/
+const char* nextToken(const char* s, int* len);
+
+#endif
@@ -0,0 +1,76 @@
+/**
+ * @file VCTextIndex.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief In-memory inverted index over the words of every property value, with
+ *        AND/OR queries and optional property-name scoping (e.g. ORG:acme).
+ */
+
+#ifndef _VCTEXTINDEX_H
+#define _VCTEXTINDEX_H
+
+#include "VCCorpus.h"
+
+//Opaque index state
+typedef struct textIndex TextIndex;
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteTextIndex.
+ **/
+TextIndex* createTextIndex(void);
+
+/** Function to index every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteTextIndex.
+ *@param corpus - the cards to index
+ **/
+TextIndex* buildTextIndex(const CardCorpus* corpus);
+
+/** Function to index the words of every value of every property of a card (BDAY and
+ *  ANNIVERSARY are not indexed).  Words are case-folded with foldText and split with nextToken.
+ *  Adding documents in increasing id order is cheapest.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode textIndexAddCard(TextIndex* index, const Card* card, int docId);
+
+/** Function to remove a card, e.g. before re-adding the changed card.
+ *@pre card holds the same values it was added with
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id
+ **/
+void textIndexRemoveCard(TextIndex* index, const Card* card, int docId);
+
+/** Function to find the documents matching a query.
+ *  A query is a list of terms separated by spaces.  Adjacent terms must all match (AND);
+ *  the word OR (in capitals) separates alternatives, and binds more loosely than AND,
+ *  so "a b OR c" means (a AND b) OR c.  A term NAME:word matches word only in values of
+ *  the property NAME, e.g. ORG:acme; a plain term matches any property.  A term that
+ *  contains several words, such as ORG:acme-corp, needs all of them.
+ *@pre index, query and docIds are not NULL
+ *@post *docIds is a newly allocated array of the matching document ids in increasing
+        order (NULL if there are none).  It must be freed by the caller.
+ *@return the number of matching documents, or -1 if malloc fails
+ *@param index - the index
+		 query - the query
+		 docIds - receives the matches
+ **/
+int textIndexQuery(const TextIndex* index, const char* query, int** docIds);
+
+/** Function to get the number of distinct terms, counting each scoped NAME:word separately.
+ *@return the number of terms
+ *@param index - the index
+ **/
+int textIndexTermCount(const TextIndex* index);
+
+/** Function to get the size of the postings, including block overhead.
+ *@return the number of bytes used by postings
+ *@param index - the index
+ **/
+size_t textIndexPostingBytes(const TextIndex* index);
+
+void deleteTextIndex(TextIndex* index);
+
+#endif
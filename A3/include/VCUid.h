@@ -0,0 +1,157 @@
+/**
+ * @file VCUid.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief UID as the identity of a card: a primary-key index from UID to cards with
+ *        duplicate detection, and sync keys for single properties built from their PID
+ *        parameters and the card's CLIENTPIDMAP (RFC 6350, Sections 5.5 and 6.7.7).
+ */
+
+#ifndef _VCUID_H
+#define _VCUID_H
+
+#include "VCCorpus.h"
+
+//Most PID values read from one parameter
+#define PID_MAX_VALUES 16
+
+//One value of a PID parameter, e.g. 2.1
+typedef struct pidValue {
+	//Local id of the property within the card (the 2)
+	int local;
+
+	//CLIENTPIDMAP id of the client that assigned it (the 1), or 0 if there is none
+	int source;
+} PidValue;
+
+//A property found by its sync key
+typedef struct syncMatch {
+	int docId;
+
+	//Position of the property in the card's optionalProperties, or -1 for FN
+	int propIndex;
+} SyncMatch;
+
+//Counts over an index, for spotting cards that break the one-card-per-UID rule
+typedef struct uidIndexStats {
+	int cards;
+	int cardsWithoutUid;
+
+	//UIDs held by more than one card
+	int duplicateUids;
+
+	//Sync keys, and those held by more than one property
+	int syncKeys;
+	int syncKeyCollisions;
+
+	//PID values naming a source the card has no CLIENTPIDMAP for (not indexed)
+	int unmappedPids;
+} UidIndexStats;
+
+/*	UidIndex is declared in VCCorpus.h, since loadCardCorpus builds one for the cards
+	it loads.
+*/
+
+/** Function to reduce a UID, or a URI naming one, to the form UIDs are compared in.
+ *  Surrounding spaces and a urn:uuid: prefix are dropped, and a UUID is lower-cased
+ *  (RFC 4122 compares them without regard to case), so urn:uuid:F81D4FAE-... and
+ *  f81d4fae-... are the same UID.
+ *@return the UID, or NULL if malloc fails.  Must be freed by the caller.
+ *@param value - the UID value or URI
+ **/
+char* normalizeUid(const char* value);
+
+/** Function to read the value of a PID parameter: a comma-separated list of local ids,
+ *  each optionally followed by a dot and a CLIENTPIDMAP id, e.g. "1.1,2.3" or "4".
+ *@return the number of values written to out, or -1 if the value is malformed or there
+          are more than maxValues of them
+ *@param value - the parameter value
+		 out - receives the values
+		 maxValues - the size of out
+ **/
+int parsePid(const char* value, PidValue* out, int maxValues);
+
+/** Function to read a CLIENTPIDMAP property, e.g. 1;urn:uuid:3df403f4-5924-4bb7-b077-3c711d9eb34b.
+ *@return true if the property holds a positive id and a URI
+ *@param prop - the CLIENTPIDMAP property
+		 sourceId - receives the id
+		 uri - receives the URI.  It belongs to the property.
+ **/
+bool parseClientPidMap(const Property* prop, int* sourceId, const char** uri);
+
+/** Function to create an empty index.
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteUidIndex.
+ **/
+UidIndex* createUidIndex(void);
+
+/** Function to index every card in a corpus, using the corpus positions as document ids.
+ *@pre corpus is not NULL
+ *@return a new index, or NULL if malloc fails.  Must be freed with deleteUidIndex.
+ *@param corpus - the cards to index
+ **/
+UidIndex* buildUidIndex(const CardCorpus* corpus);
+
+/** Function to index a card by its UID, and each of its properties with a PID parameter
+ *  by sync key: the card's UID, the property name, the local id and the URI its source
+ *  id maps to in the card's CLIENTPIDMAP.  Cards without a UID are counted but have no
+ *  sync keys.  A card already in the index is replaced.
+ *@return OK, or OTHER_ERROR if malloc fails
+ *@param index - the index
+		 card - the card
+		 docId - the card's document id (not negative)
+ **/
+VCardErrorCode uidIndexAddCard(UidIndex* index, const Card* card, int docId);
+
+/** Function to remove a card, e.g. before re-adding the changed card.
+ *@param index - the index
+		 docId - the card's document id
+ **/
+void uidIndexRemoveCard(UidIndex* index, int docId);
+
+/** Function to find the card with a UID in O(1).
+ *@return the document id of the first card added with the UID, or -1 if there is none
+ *@param index - the index
+		 uid - the UID, normalized as by normalizeUid before comparing
+ **/
+int uidIndexFind(const UidIndex* index, const char* uid);
+
+/** Function to list every card with a UID, to resolve duplicates.
+ *@return the number of cards with the UID (which may be more than maxResults); the first
+          maxResults of their document ids are written to out in the order they were added
+ *@param index - the index
+		 uid - the UID
+		 out - receives the document ids
+		 maxResults - the size of out
+ **/
+int uidIndexCards(const UidIndex* index, const char* uid, int* out, int maxResults);
+
+/** Function to list the UIDs held by more than one card.
+ *@return the number of UIDs written to out, at most maxResults.  They belong to the index.
+ *@param index - the index
+		 out - receives the UIDs, normalized
+		 maxResults - the size of out
+ **/
+int uidIndexDuplicates(const UidIndex* index, const char** out, int maxResults);
+
+/** Function to find the properties with a sync key in O(1).
+ *@return the number of properties with the key (more than one is a collision); the first
+          maxResults of them are written to out
+ *@param index - the index
+		 uid - the UID of the card
+		 propName - the property name, e.g. "TEL" (compared without regard to case)
+		 localPid - the local id of the PID value
+		 clientUri - the URI the PID value's source maps to, or NULL for a PID without a source
+		 out - receives the properties
+		 maxResults - the size of out
+ **/
+int syncKeyLookup(const UidIndex* index, const char* uid, const char* propName, int localPid,
+                  const char* clientUri, SyncMatch* out, int maxResults);
+
+/** Function to count the cards, duplicates and sync keys of an index, in one pass over it.
+ *@param index - the index
+		 stats - receives the counts
+ **/
+void uidIndexStats(const UidIndex* index, UidIndexStats* stats);
+
+void deleteUidIndex(UidIndex* index);
+
+#endif
@@ -0,0 +1,65 @@
+/**
+ * @file VCWatcher.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Watches a directory of vCard files with inotify and reports debounced,
+ *        coalesced batches of changes, so only the affected cards need to be reparsed.
+ */
+
+#ifndef _VCWATCHER_H
+#define _VCWATCHER_H
+
+#include "VCParser.h"
+
+#define WATCH_NAME_LEN 256
+
+/*	Kinds of change.  A rename is reported as WATCH_DELETED for the old name and
+	WATCH_CREATED for the new one.  WATCH_RESCAN means events were lost (the kernel
+	queue overflowed, or the directory was deleted or moved and is now watched again)
+	and the caller should compare the whole directory again.
+*/
+typedef enum wkind { WATCH_CREATED, WATCH_MODIFIED, WATCH_DELETED, WATCH_RESCAN } WatchEventKind;
+
+typedef struct watchEvent {
+	WatchEventKind kind;
+
+	//File name (not path) of the card.  Empty for WATCH_RESCAN.
+	char           name[WATCH_NAME_LEN];
+} WatchEvent;
+
+//Opaque watcher state
+typedef struct cardWatcher CardWatcher;
+
+/** Function to start watching a directory for changes to .vcf and .vcard files.
+ *@pre dirName is not NULL
+ *@return a new watcher, or NULL if inotify is not available or the directory cannot be watched.
+          Must be freed with deleteCardWatcher.
+ *@param dirName - the directory to watch
+		 debounceMs - a batch is released only after no event has arrived for this many milliseconds
+ **/
+CardWatcher* createCardWatcher(const char* dirName, int debounceMs);
+
+/** Function to wait for the next batch of changes.
+ *  Several events for the same file are merged into one: for example a file that is
+ *  created and then written is reported once as WATCH_CREATED, and a file that is
+ *  created and deleted again within the batch is not reported at all.
+ *@pre watcher is not NULL, events has room for maxEvents
+ *@post events holds the returned batch.  Changes that did not fit stay queued for the next call.
+ *@return the number of events written, 0 if the timeout expired first, -1 on error.  It is
+ *        also -1 if the directory was deleted or moved away and nothing is at its path to
+ *        watch again; the watcher must then be deleted and a new one created.
+ *@param watcher - the watcher
+		 timeoutMs - the longest time to wait, or -1 to wait until a batch is ready
+		 events - receives the batch
+		 maxEvents - the size of events
+ **/
+int pollCardWatcher(CardWatcher* watcher, int timeoutMs, WatchEvent* events, int maxEvents);
+
+/** Function to get the inotify file descriptor, e.g. to add it to an event loop.
+ *@return the file descriptor
+ *@param watcher - the watcher
+ **/
+int cardWatcherFd(const CardWatcher* watcher);
+
+void deleteCardWatcher(CardWatcher* watcher);
+
+#endif
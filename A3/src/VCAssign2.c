@@ -3,6 +3,8 @@
 #include <string.h>
 #include "VCParser.h"      
 #include "LinkedListAPI.h" 
+#include "VCProperties.h"
+#include <stdint.h>
 
 VCardErrorCode writeCard(const char *fileName, const Card *obj) {
     if (fileName == NULL || obj == NULL){
@@ -280,46 +282,34 @@ VCardErrorCode writeCard(const char *fileName, const Card *obj) {
 
 
 
-VCardErrorCode validateCard(const Card *obj) {
-    // Allowed property names (Sections 6.1–6.9.3)
-    const char *allowedProps[] = {
-        "BEGIN", "END", "SOURCE", "KIND", "XML", "FN", "ORG", "N", "NICKNAME",
-        "PHOTO", "BDAY", "ANNIVERSARY", "GENDER", "ADR", "TEL", "EMAIL", "IMPP",
-        "LANG", "TZ", "GEO", "TITLE", "ROLE", "LOGO", "MEMBER", "RELATED",
-        "CATEGORIES", "NOTE", "PRODID", "REV", "SOUND", "UID", "CLIENTPIDMAP",
-        "URL", "VERSION", "KEY", "FBURL", "CALURI", "CALADRURI"
-    };
-    int numAllowed = sizeof(allowedProps) / sizeof(allowedProps[0]);
-    
-    int i, isAllowed;
+VCardErrorCode validateProperty(const Property *prop, bool optional, int *propId) {
     char *val;
     Parameter *param;
 
-    if (obj == NULL || obj->fn == NULL){
-        return INV_CARD;}
-    
-    Property *fn = obj->fn;
-    if (fn->name == NULL || strlen(fn->name) == 0  || fn->group==NULL){
+    if (prop->name == NULL || strlen(prop->name) == 0 || prop->group==NULL){
         return INV_PROP;}
-    
-    isAllowed = 0;
-    for (i = 0; i < numAllowed; i++) {
-        if (strcasecmp(fn->name, allowedProps[i]) == 0) { isAllowed = 1; break; }
-    }
-    if (!isAllowed){
+
+    // Allowed property names (Sections 6.1–6.9.3) and their cardinalities
+    // live in the property table, see VCProperties.c.
+    int id = propertyId(prop->name);
+    if (propId != NULL){
+        *propId = id;}
+    // Extended (X-) names are not in the allowed list either.
+    if (id == PROP_UNKNOWN || id == PROP_EXTENDED){
         return INV_PROP;}
-    
-    if (fn->values == NULL || getLength(fn->values) == 0){
+
+    // Validate that the values list exists and has at least one value.
+    if (prop->values == NULL || getLength(prop->values) == 0){
         return INV_PROP;}
-    ListIterator iterVal = createIterator(fn->values);
+    ListIterator iterVal = createIterator(prop->values);
     while ((val = (char *) nextElement(&iterVal)) != NULL) {
         if (val == NULL){
             return INV_PROP;}
     }
-  
-    if (fn->parameters == NULL){
+
+    if (prop->parameters == NULL){
         return INV_PROP;}
-    ListIterator iterParam = createIterator(fn->parameters);
+    ListIterator iterParam = createIterator(prop->parameters);
     while ((param = (Parameter *) nextElement(&iterParam)) != NULL) {
         if (param == NULL){
             return INV_PROP;}
@@ -328,114 +318,91 @@ VCardErrorCode validateCard(const Card *obj) {
         if (param->value == NULL || strlen(param->value) == 0){
             return INV_PROP;}
     }
-    
+
+    if (!optional){
+        return OK;}
+
+    if (strcasecmp(prop->name, "N") == 0) {
+        // The N property must have exactly 5 values.
+        if (getLength(prop->values) != 5){
+            return INV_PROP;}
+    }
+
+    // BDAY and ANNIVERSARY belong in their own Card fields.
+    if (strcasecmp(prop->name, "BDAY") == 0 || strcasecmp(prop->name, "ANNIVERSARY") == 0){
+        return INV_DT;}
+
+    return OK;
+}
+
+VCardErrorCode validateDateTime(const DateTime *dt) {
+    if (dt->date == NULL || dt->time == NULL || dt->text == NULL){
+        return INV_DT;}
+    if (dt->isText) {
+        if (strlen(dt->date) != 0 || strlen(dt->time) != 0){
+            return INV_DT;}
+        if (dt->UTC != 0){
+            return INV_DT;}
+    } else {
+        if (strlen(dt->date) == 0){
+            return INV_DT;}
+        if (strlen(dt->text) != 0){
+            return INV_DT;}
+    }
+    return OK;
+}
+
+VCardErrorCode validateCard(const Card *obj) {
+    VCardErrorCode err;
+
+    if (obj == NULL || obj->fn == NULL){
+        return INV_CARD;}
+
+    err = validateProperty(obj->fn, false, NULL);
+    if (err != OK){
+        return err;}
+
     if (obj->optionalProperties == NULL){
         return INV_CARD;}
     
-    // Counters for properties that must be unique.
-    int countN = 0;
+    // Properties seen so far, one bit per property id.  A second occurrence of a
+    // property with cardinality 1 or *1 is a duplicate.
+    uint64_t seen = 0;
+    bool duplicate = false;
     int countVersion = 0;
   
     ListIterator iterProp = createIterator(obj->optionalProperties);
     Property *prop;
     while ((prop = (Property *) nextElement(&iterProp)) != NULL) {
-       
-        if (prop->name == NULL || strlen(prop->name) == 0 || prop->group==NULL){
-            return INV_PROP;}
-  
-        
-        isAllowed = 0;
-        for (i = 0; i < numAllowed; i++) {
-            if (strcasecmp(prop->name, allowedProps[i]) == 0) { isAllowed = 1; break; }
-        }
-        if (!isAllowed){
-            return INV_PROP;}
-        // Validate that the values list exists and has at least one value.
-        if (prop->values == NULL || getLength(prop->values) == 0){
-            return INV_PROP;}
-        ListIterator iterVal2 = createIterator(prop->values);
-        while ((val = (char *) nextElement(&iterVal2)) != NULL) {
-            if (val == NULL){
-                return INV_PROP;}
-        }
-      
-        if (prop->parameters == NULL){
-            return INV_PROP;}
-        ListIterator iterParam2 = createIterator(prop->parameters);
-        while ((param = (Parameter *) nextElement(&iterParam2)) != NULL) {
-            if (param == NULL){
-                return INV_PROP;}
-            if (param->name == NULL || strlen(param->name) == 0){
-                return INV_PROP;}
-            if (param->value == NULL || strlen(param->value) == 0){
-                return INV_PROP;}
+        int id;
+        err = validateProperty(prop, true, &id);
+        if (err != OK){
+            return err;}
+
+        if (id >= 0 && !propertyIsRepeatable(id)) {
+            uint64_t bit = (uint64_t)1 << id;
+            if (seen & bit){
+                duplicate = true;}
+            seen |= bit;
         }
-      
+
         if (strcasecmp(prop->name, "VERSION") == 0){
             countVersion++;}
-        if (strcasecmp(prop->name, "N") == 0) {
-            countN++;
-            // The N property must have exactly 5 values.
-            if (getLength(prop->values) != 5){
-                return INV_PROP;}
-        }
-     
-        
-        if (strcasecmp(prop->name, "BDAY") == 0 || strcasecmp(prop->name, "ANNIVERSARY") == 0){
-            return INV_DT;}
     }
     if (countVersion > 0){
         return INV_CARD;} 
-    if (countN > 1){
-        return INV_PROP;} 
+    if (duplicate){
+        return INV_PROP;}
 
-    
-   
-        ListIterator outer = createIterator(obj->optionalProperties);
-        Property *outerProp;
-        while ((outerProp = (Property *) nextElement(&outer)) != NULL) {
-            ListIterator inner = createIterator(obj->optionalProperties);
-            Property *innerProp;
-            while ((innerProp = (Property *) nextElement(&inner)) != NULL) {
-                if (outerProp == innerProp){
-                    continue;}
-                if (strcasecmp(outerProp->name, innerProp->name) == 0){
-                    return INV_PROP;}
-            }
-        }
-    
-    
     if (obj->birthday != NULL) {
-        DateTime *dt = obj->birthday;
-        if (dt->date == NULL || dt->time == NULL || dt->text == NULL){
-            return INV_DT;}
-        if (dt->isText) {
-            if (strlen(dt->date) != 0 || strlen(dt->time) != 0){
-                return INV_DT;}
-            if (dt->UTC != 0){
-                return INV_DT;}
-        } else {
-            if (strlen(dt->date) == 0){
-                return INV_DT;}
-            if (strlen(dt->text) != 0){
-                return INV_DT;}
-        }
+        err = validateDateTime(obj->birthday);
+        if (err != OK){
+            return err;}
     }
     if (obj->anniversary != NULL) {
-        DateTime *dt = obj->anniversary;
-        if (dt->date == NULL || dt->time == NULL || dt->text == NULL){
-            return INV_DT;}
-        if (dt->isText) {
-            if (strlen(dt->date) != 0 || strlen(dt->time) != 0){
-                return INV_DT;}
-            if (dt->UTC != 0){
-                return INV_DT;}
-        } else {
-            if (strlen(dt->date) == 0){
-                return INV_DT;}
-            if (strlen(dt->text) != 0){
-                return INV_DT;}
-        }
+        err = validateDateTime(obj->anniversary);
+        if (err != OK){
+            return err;}
     }
     
     return OK;
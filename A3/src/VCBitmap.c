@@ -0,0 +1,475 @@
+// VCBitmap.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Roaring-style bitmaps: chunks of 65536 ids stored as sorted arrays or
+//              as plain bits, whichever is smaller, and set operations chunk by chunk.
+
+#include "VCBitmap.h"
+
+typedef enum { OP_AND, OP_OR, OP_ANDNOT } BitmapOp;
+
+// ---------- Helper function: findContainer ----------
+// Returns the position of the chunk with the key, or -(position to insert it) - 1.
+static int findContainer(const Bitmap* bitmap, uint16_t key) {
+    int lo = 0, hi = bitmap->numContainers - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        uint16_t k = bitmap->containers[mid].key;
+        if (k == key) return mid;
+        if (k < key) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -lo - 1;
+}
+
+// ---------- Helper function: findLow ----------
+// The same as findContainer, for the lower bits in an array chunk.
+static int findLow(const BitmapContainer* c, uint16_t low) {
+    int lo = 0, hi = c->count - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        if (c->array[mid] == low) return mid;
+        if (c->array[mid] < low) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -lo - 1;
+}
+
+// ---------- Helper function: testBit ----------
+static bool testBit(const uint64_t* bits, uint16_t low) {
+    return (bits[low >> 6] >> (low & 63)) & 1;
+}
+
+// ---------- Helper function: freeContainer ----------
+static void freeContainer(BitmapContainer* c) {
+    free(c->array);
+    free(c->bits);
+    c->array = NULL;
+    c->bits = NULL;
+    c->count = 0;
+    c->cap = 0;
+}
+
+// ---------- Helper function: toBits ----------
+static bool toBits(BitmapContainer* c) {
+    uint64_t* bits = calloc(BITMAP_WORDS, sizeof(uint64_t));
+    if (bits == NULL) return false;
+    for (int i = 0; i < c->count; i++) bits[c->array[i] >> 6] |= (uint64_t)1 << (c->array[i] & 63);
+    free(c->array);
+    c->array = NULL;
+    c->cap = 0;
+    c->bits = bits;
+    return true;
+}
+
+// ---------- Helper function: toArray ----------
+static bool toArray(BitmapContainer* c) {
+    uint16_t* array = malloc((c->count > 0 ? c->count : 1) * sizeof(uint16_t));
+    if (array == NULL) return false;
+    int n = 0;
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+        for (uint64_t word = c->bits[w]; word != 0; word &= word - 1) {
+            array[n++] = (uint16_t)(w * 64 + __builtin_ctzll(word));
+        }
+    }
+    free(c->bits);
+    c->bits = NULL;
+    c->array = array;
+    c->cap = c->count > 0 ? c->count : 1;
+    return true;
+}
+
+// ---------- Helper function: copyContainer ----------
+static bool copyContainer(const BitmapContainer* src, BitmapContainer* dst) {
+    *dst = *src;
+    dst->array = NULL;
+    dst->bits = NULL;
+    if (src->bits != NULL) {
+        dst->bits = malloc(BITMAP_WORDS * sizeof(uint64_t));
+        if (dst->bits == NULL) return false;
+        memcpy(dst->bits, src->bits, BITMAP_WORDS * sizeof(uint64_t));
+    } else {
+        dst->array = malloc(src->count * sizeof(uint16_t));
+        if (dst->array == NULL) return false;
+        memcpy(dst->array, src->array, src->count * sizeof(uint16_t));
+        dst->cap = src->count;
+    }
+    return true;
+}
+
+// ---------- Helper function: pushContainer ----------
+// Appends a chunk to a bitmap being built in key order.  Takes ownership of c.
+static bool pushContainer(Bitmap* bitmap, BitmapContainer* c) {
+    if (bitmap->numContainers == bitmap->cap) {
+        int cap = bitmap->cap > 0 ? bitmap->cap * 2 : 4;
+        BitmapContainer* bigger = realloc(bitmap->containers, cap * sizeof(BitmapContainer));
+        if (bigger == NULL) {
+            freeContainer(c);
+            return false;
+        }
+        bitmap->containers = bigger;
+        bitmap->cap = cap;
+    }
+    bitmap->containers[bitmap->numContainers++] = *c;
+    return true;
+}
+
+// ---------- Helper function: combine ----------
+// Computes one chunk of a AND, OR or ANDNOT b.  r->count is 0 if the result is empty.
+static bool combine(const BitmapContainer* a, const BitmapContainer* b, BitmapOp op, BitmapContainer* r) {
+    memset(r, 0, sizeof(BitmapContainer));
+    r->key = a->key;
+
+    if (op == OP_AND && (a->array != NULL || b->array != NULL)) {
+        // The result is no larger than the array side, so it is an array too.
+        const BitmapContainer* small = a->array != NULL ? a : b;
+        const BitmapContainer* other = small == a ? b : a;
+        r->array = malloc(small->count * sizeof(uint16_t));
+        if (r->array == NULL) return false;
+        r->cap = small->count;
+        if (other->bits != NULL) {
+            for (int i = 0; i < small->count; i++) {
+                if (testBit(other->bits, small->array[i])) r->array[r->count++] = small->array[i];
+            }
+        } else {
+            int i = 0, j = 0;
+            while (i < small->count && j < other->count) {
+                if (small->array[i] < other->array[j]) i++;
+                else if (small->array[i] > other->array[j]) j++;
+                else {
+                    r->array[r->count++] = small->array[i];
+                    i++;
+                    j++;
+                }
+            }
+        }
+        return true;
+    }
+
+    if (op == OP_ANDNOT && a->array != NULL) {
+        r->array = malloc(a->count * sizeof(uint16_t));
+        if (r->array == NULL) return false;
+        r->cap = a->count;
+        int j = 0;
+        for (int i = 0; i < a->count; i++) {
+            uint16_t low = a->array[i];
+            bool inB;
+            if (b->bits != NULL) {
+                inB = testBit(b->bits, low);
+            } else {
+                while (j < b->count && b->array[j] < low) j++;
+                inB = j < b->count && b->array[j] == low;
+            }
+            if (!inB) r->array[r->count++] = low;
+        }
+        return true;
+    }
+
+    if (op == OP_OR && a->array != NULL && b->array != NULL && a->count + b->count <= BITMAP_ARRAY_MAX) {
+        r->array = malloc((a->count + b->count) * sizeof(uint16_t));
+        if (r->array == NULL) return false;
+        r->cap = a->count + b->count;
+        int i = 0, j = 0;
+        while (i < a->count || j < b->count) {
+            if (j == b->count || (i < a->count && a->array[i] < b->array[j])) r->array[r->count++] = a->array[i++];
+            else if (i == a->count || b->array[j] < a->array[i]) r->array[r->count++] = b->array[j++];
+            else {
+                r->array[r->count++] = a->array[i++];
+                j++;
+            }
+        }
+        return true;
+    }
+
+    // Everything else works on bits.  Two bit chunks are combined and counted in one pass.
+    r->bits = malloc(BITMAP_WORDS * sizeof(uint64_t));
+    if (r->bits == NULL) return false;
+    if (a->bits != NULL && b->bits != NULL) {
+        for (int w = 0; w < BITMAP_WORDS; w++) {
+            uint64_t word = op == OP_AND ? a->bits[w] & b->bits[w]
+                          : op == OP_OR ? a->bits[w] | b->bits[w] : a->bits[w] & ~b->bits[w];
+            r->bits[w] = word;
+            r->count += __builtin_popcountll(word);
+        }
+        if (r->count <= BITMAP_ARRAY_MAX) return toArray(r);
+        return true;
+    }
+
+    // Otherwise one side is an array (OR with an array a, or a bit chunk less an array):
+    // start from a's bits, then apply b.
+    if (a->bits != NULL) memcpy(r->bits, a->bits, BITMAP_WORDS * sizeof(uint64_t));
+    else {
+        memset(r->bits, 0, BITMAP_WORDS * sizeof(uint64_t));
+        for (int i = 0; i < a->count; i++) r->bits[a->array[i] >> 6] |= (uint64_t)1 << (a->array[i] & 63);
+    }
+    if (b->bits != NULL) {
+        for (int w = 0; w < BITMAP_WORDS; w++) r->bits[w] |= b->bits[w];
+    } else {
+        for (int i = 0; i < b->count; i++) {
+            uint64_t bit = (uint64_t)1 << (b->array[i] & 63);
+            if (op == OP_OR) r->bits[b->array[i] >> 6] |= bit;
+            else r->bits[b->array[i] >> 6] &= ~bit;
+        }
+    }
+    for (int w = 0; w < BITMAP_WORDS; w++) r->count += __builtin_popcountll(r->bits[w]);
+    if (r->count <= BITMAP_ARRAY_MAX) return toArray(r);
+    return true;
+}
+
+// ---------- Helper function: apply ----------
+static VCardErrorCode apply(const Bitmap* a, const Bitmap* b, BitmapOp op, Bitmap* out) {
+    if (a == NULL || b == NULL || out == NULL) return OTHER_ERROR;
+    int i = 0, j = 0;
+    bool ok = true;
+    while (ok && (i < a->numContainers || (op == OP_OR && j < b->numContainers))) {
+        const BitmapContainer* ca = i < a->numContainers ? &a->containers[i] : NULL;
+        const BitmapContainer* cb = j < b->numContainers ? &b->containers[j] : NULL;
+        BitmapContainer r;
+        if (ca != NULL && cb != NULL && ca->key == cb->key) {
+            ok = combine(ca, cb, op, &r);
+            i++;
+            j++;
+            if (ok && r.count == 0) {
+                freeContainer(&r);
+                continue;
+            }
+        } else if (cb == NULL || (ca != NULL && ca->key < cb->key)) {
+            // Only in a: kept by OR and ANDNOT
+            i++;
+            if (op == OP_AND) continue;
+            ok = copyContainer(ca, &r);
+        } else {
+            // Only in b: kept by OR
+            j++;
+            if (op != OP_OR) continue;
+            ok = copyContainer(cb, &r);
+        }
+        if (!ok) {
+            freeContainer(&r);
+            break;
+        }
+        ok = pushContainer(out, &r);
+    }
+    if (!ok) {
+        bitmapFree(out);
+        return OTHER_ERROR;
+    }
+    return OK;
+}
+
+// ---------- bitmapAdd ----------
+int bitmapAdd(Bitmap* bitmap, int id) {
+    if (bitmap == NULL || id < 0) return -1;
+    uint16_t key = (uint16_t)((unsigned)id >> 16), low = (uint16_t)(id & 0xFFFF);
+    int pos = findContainer(bitmap, key);
+    if (pos < 0) {
+        // New chunk, inserted in key order
+        pos = -pos - 1;
+        if (bitmap->numContainers == bitmap->cap) {
+            int cap = bitmap->cap > 0 ? bitmap->cap * 2 : 4;
+            BitmapContainer* bigger = realloc(bitmap->containers, cap * sizeof(BitmapContainer));
+            if (bigger == NULL) return -1;
+            bitmap->containers = bigger;
+            bitmap->cap = cap;
+        }
+        uint16_t* array = malloc(4 * sizeof(uint16_t));
+        if (array == NULL) return -1;
+        memmove(&bitmap->containers[pos + 1], &bitmap->containers[pos],
+                (bitmap->numContainers - pos) * sizeof(BitmapContainer));
+        bitmap->numContainers++;
+        BitmapContainer* c = &bitmap->containers[pos];
+        memset(c, 0, sizeof(BitmapContainer));
+        c->key = key;
+        c->array = array;
+        c->cap = 4;
+        c->array[c->count++] = low;
+        return 1;
+    }
+
+    BitmapContainer* c = &bitmap->containers[pos];
+    if (c->bits != NULL) {
+        if (testBit(c->bits, low)) return 0;
+        c->bits[low >> 6] |= (uint64_t)1 << (low & 63);
+        c->count++;
+        return 1;
+    }
+    int at = findLow(c, low);
+    if (at >= 0) return 0;
+    at = -at - 1;
+    if (c->count == BITMAP_ARRAY_MAX) {
+        if (!toBits(c)) return -1;
+        c->bits[low >> 6] |= (uint64_t)1 << (low & 63);
+        c->count++;
+        return 1;
+    }
+    if (c->count == c->cap) {
+        int cap = c->cap * 2 < BITMAP_ARRAY_MAX ? c->cap * 2 : BITMAP_ARRAY_MAX;
+        uint16_t* bigger = realloc(c->array, cap * sizeof(uint16_t));
+        if (bigger == NULL) return -1;
+        c->array = bigger;
+        c->cap = cap;
+    }
+    memmove(&c->array[at + 1], &c->array[at], (c->count - at) * sizeof(uint16_t));
+    c->array[at] = low;
+    c->count++;
+    return 1;
+}
+
+// ---------- bitmapRemove ----------
+bool bitmapRemove(Bitmap* bitmap, int id) {
+    if (bitmap == NULL || id < 0) return false;
+    uint16_t key = (uint16_t)((unsigned)id >> 16), low = (uint16_t)(id & 0xFFFF);
+    int pos = findContainer(bitmap, key);
+    if (pos < 0) return false;
+
+    BitmapContainer* c = &bitmap->containers[pos];
+    if (c->bits != NULL) {
+        if (!testBit(c->bits, low)) return false;
+        c->bits[low >> 6] &= ~((uint64_t)1 << (low & 63));
+        c->count--;
+        // Switch back to an array once that is smaller; if malloc fails the bits still work.
+        if (c->count <= BITMAP_ARRAY_MAX) toArray(c);
+    } else {
+        int at = findLow(c, low);
+        if (at < 0) return false;
+        memmove(&c->array[at], &c->array[at + 1], (c->count - at - 1) * sizeof(uint16_t));
+        c->count--;
+    }
+    if (c->count == 0) {
+        freeContainer(c);
+        memmove(&bitmap->containers[pos], &bitmap->containers[pos + 1],
+                (bitmap->numContainers - pos - 1) * sizeof(BitmapContainer));
+        bitmap->numContainers--;
+    }
+    return true;
+}
+
+// ---------- bitmapContains ----------
+bool bitmapContains(const Bitmap* bitmap, int id) {
+    if (bitmap == NULL || id < 0) return false;
+    int pos = findContainer(bitmap, (uint16_t)((unsigned)id >> 16));
+    if (pos < 0) return false;
+    const BitmapContainer* c = &bitmap->containers[pos];
+    uint16_t low = (uint16_t)(id & 0xFFFF);
+    return c->bits != NULL ? testBit(c->bits, low) : findLow(c, low) >= 0;
+}
+
+// ---------- bitmapCardinality ----------
+int bitmapCardinality(const Bitmap* bitmap) {
+    if (bitmap == NULL) return 0;
+    int count = 0;
+    for (int i = 0; i < bitmap->numContainers; i++) count += bitmap->containers[i].count;
+    return count;
+}
+
+// ---------- bitmapAnd ----------
+VCardErrorCode bitmapAnd(const Bitmap* a, const Bitmap* b, Bitmap* out) {
+    return apply(a, b, OP_AND, out);
+}
+
+// ---------- bitmapOr ----------
+VCardErrorCode bitmapOr(const Bitmap* a, const Bitmap* b, Bitmap* out) {
+    return apply(a, b, OP_OR, out);
+}
+
+// ---------- bitmapAndNot ----------
+VCardErrorCode bitmapAndNot(const Bitmap* a, const Bitmap* b, Bitmap* out) {
+    return apply(a, b, OP_ANDNOT, out);
+}
+
+// ---------- bitmapAndCount ----------
+int bitmapAndCount(const Bitmap* a, const Bitmap* b) {
+    if (a == NULL || b == NULL) return 0;
+    int count = 0, i = 0, j = 0;
+    while (i < a->numContainers && j < b->numContainers) {
+        const BitmapContainer* ca = &a->containers[i];
+        const BitmapContainer* cb = &b->containers[j];
+        if (ca->key < cb->key) {
+            i++;
+            continue;
+        }
+        if (cb->key < ca->key) {
+            j++;
+            continue;
+        }
+        if (ca->bits != NULL && cb->bits != NULL) {
+            for (int w = 0; w < BITMAP_WORDS; w++) count += __builtin_popcountll(ca->bits[w] & cb->bits[w]);
+        } else if (ca->bits != NULL || cb->bits != NULL) {
+            const BitmapContainer* arr = ca->array != NULL ? ca : cb;
+            const uint64_t* bits = ca->bits != NULL ? ca->bits : cb->bits;
+            for (int k = 0; k < arr->count; k++) count += testBit(bits, arr->array[k]);
+        } else {
+            int x = 0, y = 0;
+            while (x < ca->count && y < cb->count) {
+                if (ca->array[x] < cb->array[y]) x++;
+                else if (ca->array[x] > cb->array[y]) y++;
+                else {
+                    count++;
+                    x++;
+                    y++;
+                }
+            }
+        }
+        i++;
+        j++;
+    }
+    return count;
+}
+
+// ---------- bitmapCopy ----------
+VCardErrorCode bitmapCopy(const Bitmap* bitmap, Bitmap* out) {
+    if (bitmap == NULL || out == NULL) return OTHER_ERROR;
+    for (int i = 0; i < bitmap->numContainers; i++) {
+        BitmapContainer c;
+        if (!copyContainer(&bitmap->containers[i], &c)) {
+            freeContainer(&c);
+            bitmapFree(out);
+            return OTHER_ERROR;
+        }
+        if (!pushContainer(out, &c)) {
+            bitmapFree(out);
+            return OTHER_ERROR;
+        }
+    }
+    return OK;
+}
+
+// ---------- bitmapToArray ----------
+int bitmapToArray(const Bitmap* bitmap, int* out) {
+    if (bitmap == NULL || out == NULL) return 0;
+    int n = 0;
+    for (int i = 0; i < bitmap->numContainers; i++) {
+        const BitmapContainer* c = &bitmap->containers[i];
+        int base = (int)c->key << 16;
+        if (c->bits != NULL) {
+            for (int w = 0; w < BITMAP_WORDS; w++) {
+                for (uint64_t word = c->bits[w]; word != 0; word &= word - 1) {
+                    out[n++] = base + w * 64 + __builtin_ctzll(word);
+                }
+            }
+        } else {
+            for (int k = 0; k < c->count; k++) out[n++] = base + c->array[k];
+        }
+    }
+    return n;
+}
+
+// ---------- bitmapBytes ----------
+size_t bitmapBytes(const Bitmap* bitmap) {
+    if (bitmap == NULL) return 0;
+    size_t bytes = bitmap->cap * sizeof(BitmapContainer);
+    for (int i = 0; i < bitmap->numContainers; i++) {
+        const BitmapContainer* c = &bitmap->containers[i];
+        bytes += c->bits != NULL ? BITMAP_WORDS * sizeof(uint64_t) : c->cap * sizeof(uint16_t);
+    }
+    return bytes;
+}
+
+// ---------- bitmapFree ----------
+void bitmapFree(Bitmap* bitmap) {
+    if (bitmap == NULL) return;
+    for (int i = 0; i < bitmap->numContainers; i++) freeContainer(&bitmap->containers[i]);
+    free(bitmap->containers);
+    bitmap->containers = NULL;
+    bitmap->numContainers = 0;
+    bitmap->cap = 0;
+}
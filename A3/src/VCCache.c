@@ -0,0 +1,315 @@
+// VCCache.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Memory-bounded LRU cache of parsed cards with reference-counted handles.
+
+#include "VCCache.h"
+#include "VCDocTable.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <sys/stat.h>
+
+// Identity of the file a card was parsed from.
+typedef struct fileIdentity {
+    dev_t     dev;
+    ino_t     ino;
+    off_t     size;
+    long long mtimeNs;
+} FileIdentity;
+
+struct cardHandle {
+    char*        fileName;
+    FileIdentity id;
+    Card*        card;
+    size_t       bytes;
+    int          refs;
+
+    // False once the entry has been evicted or invalidated; it is then freed on the last release.
+    bool         cached;
+
+    // Hash chain and LRU list (most recently used at the head).
+    CardHandle*  chain;
+    CardHandle*  newer;
+    CardHandle*  older;
+};
+
+struct cardCache {
+    pthread_mutex_t    lock;
+    size_t             budget;
+    size_t             bytes;
+    int                entries;
+    CardHandle**       buckets;
+    int                numBuckets;
+    CardHandle*        newest;
+    CardHandle*        oldest;
+    unsigned long long hits;
+    unsigned long long misses;
+    unsigned long long evictions;
+};
+
+// ---------- Helper function: statIdentity ----------
+static bool statIdentity(const char* fileName, FileIdentity* id) {
+    struct stat st;
+    if (stat(fileName, &st) != 0) return false;
+    id->dev = st.st_dev;
+    id->ino = st.st_ino;
+    id->size = st.st_size;
+    id->mtimeNs = (long long)st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+    return true;
+}
+
+// ---------- Helper function: sameIdentity ----------
+static bool sameIdentity(const FileIdentity* a, const FileIdentity* b) {
+    return a->dev == b->dev && a->ino == b->ino && a->size == b->size && a->mtimeNs == b->mtimeNs;
+}
+
+// ---------- Helper function: listFootprint ----------
+static size_t listFootprint(List* list, bool params) {
+    size_t bytes = sizeof(List);
+    ListIterator iter = createIterator(list);
+    void* data;
+    while ((data = nextElement(&iter)) != NULL) {
+        bytes += sizeof(Node);
+        if (params) {
+            Parameter* param = (Parameter*)data;
+            bytes += sizeof(Parameter) + strlen(param->name) + strlen(param->value) + 2;
+        } else {
+            bytes += strlen((char*)data) + 1;
+        }
+    }
+    return bytes;
+}
+
+// ---------- Helper function: propertyFootprint ----------
+static size_t propertyFootprint(Property* prop) {
+    return sizeof(Property) + strlen(prop->name) + strlen(prop->group) + 2 +
+           listFootprint(prop->parameters, true) + listFootprint(prop->values, false);
+}
+
+// ---------- Helper function: dateFootprint ----------
+static size_t dateFootprint(const DateTime* dt) {
+    if (dt == NULL) return 0;
+    return sizeof(DateTime) + strlen(dt->date) + strlen(dt->time) + strlen(dt->text) + 3;
+}
+
+// ---------- Helper function: cardFootprint ----------
+// Estimated heap size of a card, used to charge it against the budget.
+static size_t cardFootprint(Card* card) {
+    size_t bytes = sizeof(Card) + propertyFootprint(card->fn) + sizeof(List);
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        bytes += sizeof(Node) + propertyFootprint(prop);
+    }
+    return bytes + dateFootprint(card->birthday) + dateFootprint(card->anniversary);
+}
+
+// ---------- Helper function: freeEntry ----------
+static void freeEntry(CardHandle* entry) {
+    deleteCard(entry->card);
+    free(entry->fileName);
+    free(entry);
+}
+
+// ---------- Helper function: findEntry ----------
+static CardHandle** findEntry(CardCache* cache, const char* fileName) {
+    CardHandle** link = &cache->buckets[fnvHash(fileName) & (cache->numBuckets - 1)];
+    while (*link != NULL && strcmp((*link)->fileName, fileName) != 0) link = &(*link)->chain;
+    return link;
+}
+
+// ---------- Helper function: unlinkLRU ----------
+static void unlinkLRU(CardCache* cache, CardHandle* entry) {
+    if (entry->newer != NULL) entry->newer->older = entry->older;
+    else cache->newest = entry->older;
+    if (entry->older != NULL) entry->older->newer = entry->newer;
+    else cache->oldest = entry->newer;
+    entry->newer = entry->older = NULL;
+}
+
+// ---------- Helper function: pushNewest ----------
+static void pushNewest(CardCache* cache, CardHandle* entry) {
+    entry->older = cache->newest;
+    entry->newer = NULL;
+    if (cache->newest != NULL) cache->newest->newer = entry;
+    cache->newest = entry;
+    if (cache->oldest == NULL) cache->oldest = entry;
+}
+
+// ---------- Helper function: dropEntry ----------
+// Takes an entry out of the cache.  It is freed now if no handle refers to it.
+static void dropEntry(CardCache* cache, CardHandle* entry) {
+    CardHandle** link = findEntry(cache, entry->fileName);
+    if (*link == entry) *link = entry->chain;
+    unlinkLRU(cache, entry);
+    entry->chain = NULL;
+    entry->cached = false;
+    cache->bytes -= entry->bytes;
+    cache->entries--;
+    if (entry->refs == 0) freeEntry(entry);
+}
+
+// ---------- Helper function: growBuckets ----------
+static void growBuckets(CardCache* cache) {
+    int numBuckets = cache->numBuckets * 2;
+    CardHandle** buckets = calloc(numBuckets, sizeof(CardHandle*));
+    if (buckets == NULL) return;    // Longer chains, but still correct.
+
+    for (int i = 0; i < cache->numBuckets; i++) {
+        CardHandle* entry = cache->buckets[i];
+        while (entry != NULL) {
+            CardHandle* next = entry->chain;
+            uint32_t b = fnvHash(entry->fileName) & (numBuckets - 1);
+            entry->chain = buckets[b];
+            buckets[b] = entry;
+            entry = next;
+        }
+    }
+    free(cache->buckets);
+    cache->buckets = buckets;
+    cache->numBuckets = numBuckets;
+}
+
+// ---------- Helper function: evict ----------
+// Drops least recently used cards until the cache fits its budget, never dropping keep.
+static void evict(CardCache* cache, CardHandle* keep) {
+    while (cache->bytes > cache->budget && cache->oldest != NULL && cache->oldest != keep) {
+        dropEntry(cache, cache->oldest);
+        cache->evictions++;
+    }
+}
+
+// ---------- createCardCache ----------
+CardCache* createCardCache(size_t budget) {
+    CardCache* cache = calloc(1, sizeof(CardCache));
+    if (cache == NULL) return NULL;
+    cache->budget = budget;
+    cache->numBuckets = 64;
+    cache->buckets = calloc(cache->numBuckets, sizeof(CardHandle*));
+    if (cache->buckets == NULL || pthread_mutex_init(&cache->lock, NULL) != 0) {
+        free(cache->buckets);
+        free(cache);
+        return NULL;
+    }
+    return cache;
+}
+
+// ---------- acquireCard ----------
+VCardErrorCode acquireCard(CardCache* cache, const char* fileName, CardHandle** handle) {
+    if (cache == NULL || fileName == NULL || handle == NULL) return OTHER_ERROR;
+    *handle = NULL;
+
+    FileIdentity id;
+    if (!statIdentity(fileName, &id)) return INV_FILE;
+
+    pthread_mutex_lock(&cache->lock);
+    CardHandle* entry = *findEntry(cache, fileName);
+    if (entry != NULL && sameIdentity(&entry->id, &id)) {
+        entry->refs++;
+        unlinkLRU(cache, entry);
+        pushNewest(cache, entry);
+        cache->hits++;
+        pthread_mutex_unlock(&cache->lock);
+        *handle = entry;
+        return OK;
+    }
+    if (entry != NULL) dropEntry(cache, entry);   // The file changed.
+    cache->misses++;
+    pthread_mutex_unlock(&cache->lock);
+
+    // Parse without holding the lock, so other files can be served meanwhile.
+    Card* card = NULL;
+    VCardErrorCode err = createCard((char*)fileName, &card);
+    if (err != OK) return err;
+
+    CardHandle* fresh = calloc(1, sizeof(CardHandle));
+    char* name = strdup(fileName);
+    if (fresh == NULL || name == NULL) {
+        free(fresh);
+        free(name);
+        deleteCard(card);
+        return OTHER_ERROR;
+    }
+    fresh->fileName = name;
+    fresh->id = id;
+    fresh->card = card;
+    fresh->bytes = cardFootprint(card);
+    fresh->refs = 1;
+    fresh->cached = true;
+
+    pthread_mutex_lock(&cache->lock);
+    CardHandle** link = findEntry(cache, fileName);
+    if (*link != NULL) {
+        if (sameIdentity(&(*link)->id, &id)) {
+            // Another thread parsed the same version first; share its card.
+            CardHandle* other = *link;
+            other->refs++;
+            pthread_mutex_unlock(&cache->lock);
+            freeEntry(fresh);
+            *handle = other;
+            return OK;
+        }
+        dropEntry(cache, *link);
+        link = findEntry(cache, fileName);
+    }
+    fresh->chain = *link;
+    *link = fresh;
+    pushNewest(cache, fresh);
+    cache->bytes += fresh->bytes;
+    cache->entries++;
+    evict(cache, fresh);
+    if (cache->entries > cache->numBuckets) growBuckets(cache);
+    pthread_mutex_unlock(&cache->lock);
+
+    *handle = fresh;
+    return OK;
+}
+
+// ---------- handleCard ----------
+Card* handleCard(const CardHandle* handle) {
+    return handle != NULL ? handle->card : NULL;
+}
+
+// ---------- releaseCardHandle ----------
+void releaseCardHandle(CardCache* cache, CardHandle* handle) {
+    if (cache == NULL || handle == NULL) return;
+    pthread_mutex_lock(&cache->lock);
+    handle->refs--;
+    bool orphan = !handle->cached && handle->refs == 0;
+    pthread_mutex_unlock(&cache->lock);
+    if (orphan) freeEntry(handle);
+}
+
+// ---------- invalidateCachedCard ----------
+void invalidateCachedCard(CardCache* cache, const char* fileName) {
+    if (cache == NULL || fileName == NULL) return;
+    pthread_mutex_lock(&cache->lock);
+    CardHandle* entry = *findEntry(cache, fileName);
+    if (entry != NULL) dropEntry(cache, entry);
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// ---------- getCacheStats ----------
+void getCacheStats(CardCache* cache, CacheStats* stats) {
+    if (cache == NULL || stats == NULL) return;
+    pthread_mutex_lock(&cache->lock);
+    stats->hits = cache->hits;
+    stats->misses = cache->misses;
+    stats->evictions = cache->evictions;
+    stats->entries = cache->entries;
+    stats->bytes = cache->bytes;
+    stats->budget = cache->budget;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+// ---------- deleteCardCache ----------
+void deleteCardCache(CardCache* cache) {
+    if (cache == NULL) return;
+    while (cache->oldest != NULL) {
+        CardHandle* entry = cache->oldest;
+        unlinkLRU(cache, entry);
+        freeEntry(entry);
+    }
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->buckets);
+    free(cache);
+}
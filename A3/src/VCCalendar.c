@@ -0,0 +1,257 @@
+// VCCalendar.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Birthdays and anniversaries bucketed by day of the year, with a Fenwick
+//              tree over the bucket sizes for counting and a cursor for upcoming events.
+
+#include "VCCalendar.h"
+#include "VCDocTable.h"
+#include "VCDates.h"
+
+typedef struct dayEntry {
+    int docId;
+    int kind;
+    int year;
+} DayEntry;
+
+typedef struct dayBucket {
+    DayEntry* entries;
+    int       count;
+    int       cap;
+} DayBucket;
+
+struct calendarIndex {
+    DayBucket days[CALENDAR_DAYS];
+
+    // Fenwick tree over days[].count, 1-based.
+    int       tree[CALENDAR_DAYS + 1];
+    int       size;
+
+    // Day number of each document's birthday and anniversary, -1 if it has none.
+    int     (*docDays)[2];
+    int       docCap;
+};
+
+static const int monthStart[12] = { 0, 31, 60, 91, 121, 152, 182, 213, 244, 274, 305, 335 };
+static const int monthLength[12] = { 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+
+#define FEB_29 59
+
+// ---------- Helper function: isLeapYear ----------
+static bool isLeapYear(int year) {
+    return (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+}
+
+// ---------- Helper function: treeAdd ----------
+static void treeAdd(CalendarIndex* index, int day, int delta) {
+    for (int i = day + 1; i <= CALENDAR_DAYS; i += i & -i) index->tree[i] += delta;
+}
+
+// ---------- Helper function: treeSum ----------
+// Number of events on days 0 to day.
+static int treeSum(const CalendarIndex* index, int day) {
+    int sum = 0;
+    for (int i = day + 1; i > 0; i -= i & -i) sum += index->tree[i];
+    return sum;
+}
+
+// ---------- Helper function: findEntry ----------
+// Returns the position of the first entry not ordered before (docId, kind).
+static int findEntry(const DayBucket* bucket, int docId, int kind) {
+    int lo = 0, hi = bucket->count;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        const DayEntry* e = &bucket->entries[mid];
+        if (e->docId < docId || (e->docId == docId && e->kind < kind)) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(CalendarIndex* index, int docId) {
+    if (docId < index->docCap) return true;
+    int cap = docCapFor(index->docCap, docId);
+    int (*bigger)[2] = realloc(index->docDays, cap * sizeof(*bigger));
+    if (bigger == NULL) return false;
+    for (int i = index->docCap; i < cap; i++) bigger[i][0] = bigger[i][1] = -1;
+    index->docDays = bigger;
+    index->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: addEvent ----------
+static bool addEvent(CalendarIndex* index, const DateTime* dt, CalendarEventKind kind, int docId) {
+    DateParts parts;
+    if (dateToParts(dt, &parts) != OK || !parts.hasMonth || !parts.hasDay) return true;
+    int day = calendarDay(parts.month, parts.day);
+    if (day < 0) return true;
+
+    DayBucket* bucket = &index->days[day];
+    if (bucket->count == bucket->cap) {
+        int cap = bucket->cap > 0 ? bucket->cap * 2 : 4;
+        DayEntry* bigger = realloc(bucket->entries, cap * sizeof(DayEntry));
+        if (bigger == NULL) return false;
+        bucket->entries = bigger;
+        bucket->cap = cap;
+    }
+
+    // Cards are usually added in document order, so this is normally an append.
+    int at = findEntry(bucket, docId, kind);
+    memmove(bucket->entries + at + 1, bucket->entries + at, (bucket->count - at) * sizeof(DayEntry));
+    bucket->entries[at].docId = docId;
+    bucket->entries[at].kind = kind;
+    bucket->entries[at].year = parts.year;
+    bucket->count++;
+
+    index->docDays[docId][kind] = day;
+    treeAdd(index, day, 1);
+    index->size++;
+    return true;
+}
+
+// ---------- Helper function: fillEvent ----------
+static void fillEvent(const DayEntry* entry, int day, int daysAway, CalendarEvent* event) {
+    int month = 11;
+    while (monthStart[month] > day) month--;
+    event->docId = entry->docId;
+    event->kind = (CalendarEventKind)entry->kind;
+    event->year = entry->year;
+    event->month = month + 1;
+    event->day = day - monthStart[month] + 1;
+    event->daysAway = daysAway;
+}
+
+// ---------- calendarDay ----------
+int calendarDay(int month, int day) {
+    if (month < 1 || month > 12 || day < 1 || day > monthLength[month - 1]) return -1;
+    return monthStart[month - 1] + day - 1;
+}
+
+// ---------- createCalendarIndex ----------
+CalendarIndex* createCalendarIndex(void) {
+    return calloc(1, sizeof(CalendarIndex));
+}
+
+// ---------- buildCalendarIndex ----------
+CalendarIndex* buildCalendarIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    CalendarIndex* index = createCalendarIndex();
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (calendarAddCard(index, corpus->cards[i], i) != OK) {
+            deleteCalendarIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- calendarAddCard ----------
+VCardErrorCode calendarAddCard(CalendarIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (!reserveDoc(index, docId)) return OTHER_ERROR;
+
+    if (!addEvent(index, card->birthday, EVENT_BIRTHDAY, docId) ||
+        !addEvent(index, card->anniversary, EVENT_ANNIVERSARY, docId)) {
+        return OTHER_ERROR;
+    }
+    return OK;
+}
+
+// ---------- calendarRemoveCard ----------
+void calendarRemoveCard(CalendarIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+
+    for (int kind = EVENT_BIRTHDAY; kind <= EVENT_ANNIVERSARY; kind++) {
+        int day = index->docDays[docId][kind];
+        if (day < 0) continue;
+
+        DayBucket* bucket = &index->days[day];
+        int at = findEntry(bucket, docId, kind);
+        if (at < bucket->count && bucket->entries[at].docId == docId && bucket->entries[at].kind == kind) {
+            memmove(bucket->entries + at, bucket->entries + at + 1, (bucket->count - at - 1) * sizeof(DayEntry));
+            bucket->count--;
+            treeAdd(index, day, -1);
+            index->size--;
+        }
+        index->docDays[docId][kind] = -1;
+    }
+}
+
+// ---------- calendarRange ----------
+int calendarRange(const CalendarIndex* index, int fromMonth, int fromDay, int toMonth, int toDay,
+                  CalendarEvent* out, int maxResults) {
+    if (index == NULL || out == NULL) return 0;
+    int from = calendarDay(fromMonth, fromDay);
+    int to = calendarDay(toMonth, toDay);
+    if (from < 0 || to < 0) return 0;
+
+    int n = 0;
+    int length = (to - from + CALENDAR_DAYS) % CALENDAR_DAYS + 1;
+    for (int i = 0; i < length && n < maxResults; i++) {
+        int day = (from + i) % CALENDAR_DAYS;
+        const DayBucket* bucket = &index->days[day];
+        for (int e = 0; e < bucket->count && n < maxResults; e++) {
+            fillEvent(&bucket->entries[e], day, -1, &out[n++]);
+        }
+    }
+    return n;
+}
+
+// ---------- calendarCount ----------
+int calendarCount(const CalendarIndex* index, int fromMonth, int fromDay, int toMonth, int toDay) {
+    if (index == NULL) return 0;
+    int from = calendarDay(fromMonth, fromDay);
+    int to = calendarDay(toMonth, toDay);
+    if (from < 0 || to < 0) return 0;
+
+    int before = from > 0 ? treeSum(index, from - 1) : 0;
+    if (from <= to) return treeSum(index, to) - before;
+    return index->size - (before - treeSum(index, to));
+}
+
+// ---------- calendarIterInit ----------
+void calendarIterInit(const CalendarIndex* index, int year, int month, int day, CalendarIter* iter) {
+    iter->index = index;
+    iter->year = year;
+    iter->dayOfYear = calendarDay(month, day);
+    if (iter->dayOfYear < 0) iter->dayOfYear = 0;
+    iter->pos = 0;
+    iter->daysAway = 0;
+}
+
+// ---------- calendarIterNext ----------
+bool calendarIterNext(CalendarIter* iter, CalendarEvent* event) {
+    const CalendarIndex* index = iter->index;
+    if (index == NULL || index->size == 0) return false;
+
+    while (iter->pos >= index->days[iter->dayOfYear].count) {
+        iter->dayOfYear++;
+        if (iter->dayOfYear == CALENDAR_DAYS) {
+            iter->dayOfYear = 0;
+            iter->year++;
+        }
+        iter->pos = 0;
+
+        // Outside leap years February 29 is read on the same day as February 28.
+        if (iter->dayOfYear != FEB_29 || isLeapYear(iter->year)) iter->daysAway++;
+    }
+
+    fillEvent(&index->days[iter->dayOfYear].entries[iter->pos++], iter->dayOfYear, iter->daysAway, event);
+    return true;
+}
+
+// ---------- calendarSize ----------
+int calendarSize(const CalendarIndex* index) {
+    return index != NULL ? index->size : 0;
+}
+
+// ---------- deleteCalendarIndex ----------
+void deleteCalendarIndex(CalendarIndex* index) {
+    if (index == NULL) return;
+    for (int day = 0; day < CALENDAR_DAYS; day++) free(index->days[day].entries);
+    free(index->docDays);
+    free(index);
+}
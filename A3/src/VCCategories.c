@@ -0,0 +1,460 @@
+// VCCategories.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: CATEGORIES dictionary, a bitmap of cards per category, and a recursive
+//              descent evaluator for AND/OR/NOT queries over the bitmaps.
+
+#include "VCCategories.h"
+#include "VCDocTable.h"
+#include "VCBitmap.h"
+#include "VCText.h"
+#include <stdint.h>
+#include <strings.h>
+
+typedef struct category {
+    // Folded name
+    char*  name;
+    Bitmap cards;
+} Category;
+
+typedef struct docCategories {
+    int* ids;
+    int  count;
+} DocCategories;
+
+struct categoryIndex {
+    Category*      categories;
+    int            count;
+    int            cap;
+
+    // Hash table of category ids by name, -1 for empty slots
+    int*           slots;
+    int            numSlots;
+
+    // Every indexed card, the universe that NOT is taken against
+    Bitmap         all;
+
+    DocCategories* docs;
+    int            docCap;
+};
+
+typedef enum { TOKEN_END, TOKEN_TERM, TOKEN_AND, TOKEN_OR, TOKEN_NOT, TOKEN_OPEN, TOKEN_CLOSE } TokenType;
+
+// A set in the middle of a query: either a bitmap of the index, or one the query built
+typedef struct operand {
+    const Bitmap* view;
+    Bitmap        owned;
+    bool          isOwned;
+    bool          negated;
+} Operand;
+
+typedef struct queryParser {
+    const CategoryIndex* index;
+    const char*          pos;
+
+    // Current token; text and len are set for TOKEN_TERM
+    TokenType            type;
+    const char*          text;
+    int                  len;
+
+    bool                 failed;
+} QueryParser;
+
+static const Bitmap emptyBitmap = { NULL, 0, 0 };
+
+// ---------- Helper function: findSlot ----------
+static int findSlot(const CategoryIndex* index, const char* name) {
+    uint32_t s = fnvHash(name) & (index->numSlots - 1);
+    while (index->slots[s] != -1 && strcmp(index->categories[index->slots[s]].name, name) != 0) {
+        s = (s + 1) & (index->numSlots - 1);
+    }
+    return (int)s;
+}
+
+// ---------- Helper function: growSlots ----------
+static bool growSlots(CategoryIndex* index) {
+    int numSlots = index->numSlots > 0 ? index->numSlots * 2 : 64;
+    int* slots = malloc(numSlots * sizeof(int));
+    if (slots == NULL) return false;
+    for (int i = 0; i < numSlots; i++) slots[i] = -1;
+    for (int c = 0; c < index->count; c++) {
+        uint32_t s = fnvHash(index->categories[c].name) & (numSlots - 1);
+        while (slots[s] != -1) s = (s + 1) & (numSlots - 1);
+        slots[s] = c;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->numSlots = numSlots;
+    return true;
+}
+
+// ---------- Helper function: getCategory ----------
+// Returns the id of a category, adding it to the dictionary if needed, or -1 if malloc fails.
+static int getCategory(CategoryIndex* index, const char* name) {
+    int s = findSlot(index, name);
+    if (index->slots[s] != -1) return index->slots[s];
+
+    if (index->count == index->cap) {
+        int cap = index->cap > 0 ? index->cap * 2 : 16;
+        Category* bigger = realloc(index->categories, cap * sizeof(Category));
+        if (bigger == NULL) return -1;
+        index->categories = bigger;
+        index->cap = cap;
+    }
+    if (2 * (index->count + 1) > index->numSlots) {
+        if (!growSlots(index)) return -1;
+        s = findSlot(index, name);
+    }
+    Category* category = &index->categories[index->count];
+    memset(category, 0, sizeof(Category));
+    category->name = malloc(strlen(name) + 1);
+    if (category->name == NULL) return -1;
+    strcpy(category->name, name);
+    index->slots[s] = index->count;
+    return index->count++;
+}
+
+// ---------- Helper function: addCategories ----------
+// Adds the comma-separated categories of one value to a card.
+static bool addCategories(CategoryIndex* index, DocCategories* doc, const char* value, int docId) {
+    char* part = malloc(strlen(value) + 1);
+    if (part == NULL) return false;
+
+    bool ok = true;
+    const char* p = value;
+    while (ok) {
+        // Copy up to the next unescaped comma, unescaping "\,"
+        int len = 0;
+        while (*p != '\0' && *p != ',') {
+            if (*p == '\\' && p[1] == ',') p++;
+            part[len++] = *p++;
+        }
+        part[len] = '\0';
+
+        char* name = foldText(part);
+        if (name == NULL) {
+            ok = false;
+        } else if (name[0] != '\0') {
+            int id = getCategory(index, name);
+            bool seen = false;
+            for (int i = 0; i < doc->count && !seen; i++) seen = doc->ids[i] == id;
+            if (id < 0) {
+                ok = false;
+            } else if (!seen) {
+                int* ids = realloc(doc->ids, (doc->count + 1) * sizeof(int));
+                ok = ids != NULL && bitmapAdd(&index->categories[id].cards, docId) >= 0;
+                if (ids != NULL) {
+                    doc->ids = ids;
+                    if (ok) doc->ids[doc->count++] = id;
+                }
+            }
+        }
+        free(name);
+        if (*p == '\0') break;
+        p++;
+    }
+    free(part);
+    return ok;
+}
+
+// ---------- Helper function: nextQueryToken ----------
+static void nextQueryToken(QueryParser* parser) {
+    const char* p = parser->pos;
+    while (*p == ' ' || *p == '\t') p++;
+    parser->text = p;
+    parser->len = 0;
+
+    if (*p == '\0') {
+        parser->type = TOKEN_END;
+    } else if (*p == '(' || *p == ')') {
+        parser->type = *p == '(' ? TOKEN_OPEN : TOKEN_CLOSE;
+        p++;
+    } else if (*p == '"') {
+        const char* end = strchr(p + 1, '"');
+        if (end == NULL) {
+            parser->failed = true;
+            parser->type = TOKEN_END;
+            end = p + strlen(p) - 1;
+        } else {
+            parser->type = TOKEN_TERM;
+            parser->text = p + 1;
+            parser->len = (int)(end - p - 1);
+        }
+        p = end + 1;
+    } else {
+        while (*p != '\0' && *p != ' ' && *p != '\t' && *p != '(' && *p != ')') p++;
+        parser->len = (int)(p - parser->text);
+        parser->type = TOKEN_TERM;
+        if (parser->len == 3 && strncmp(parser->text, "AND", 3) == 0) parser->type = TOKEN_AND;
+        else if (parser->len == 2 && strncmp(parser->text, "OR", 2) == 0) parser->type = TOKEN_OR;
+        else if (parser->len == 3 && strncmp(parser->text, "NOT", 3) == 0) parser->type = TOKEN_NOT;
+    }
+    parser->pos = p;
+}
+
+// ---------- Helper function: setOf ----------
+static const Bitmap* setOf(const Operand* operand) {
+    return operand->isOwned ? &operand->owned : operand->view;
+}
+
+// ---------- Helper function: releaseOperand ----------
+static void releaseOperand(Operand* operand) {
+    if (operand->isOwned) bitmapFree(&operand->owned);
+    operand->isOwned = false;
+}
+
+// ---------- Helper function: combineInto ----------
+// Replaces *acc with acc AND (or ANDNOT, or OR) other.  Returns false if malloc fails.
+static bool combineInto(Operand* acc, const Bitmap* other,
+                        VCardErrorCode (*op)(const Bitmap*, const Bitmap*, Bitmap*)) {
+    Bitmap result = { NULL, 0, 0 };
+    if (op(setOf(acc), other, &result) != OK) return false;
+    releaseOperand(acc);
+    acc->owned = result;
+    acc->isOwned = true;
+    return true;
+}
+
+// ---------- Helper function: compareOperands ----------
+static int compareOperands(const void* first, const void* second) {
+    int a = bitmapCardinality(setOf((const Operand*)first));
+    int b = bitmapCardinality(setOf((const Operand*)second));
+    return (a > b) - (a < b);
+}
+
+static Operand parseOr(QueryParser* parser);
+
+// ---------- Helper function: parseUnary ----------
+static Operand parseUnary(QueryParser* parser) {
+    Operand result = { &emptyBitmap, { NULL, 0, 0 }, false, false };
+    if (parser->type == TOKEN_NOT) {
+        nextQueryToken(parser);
+        result = parseUnary(parser);
+        result.negated = !result.negated;
+    } else if (parser->type == TOKEN_OPEN) {
+        nextQueryToken(parser);
+        result = parseOr(parser);
+        if (parser->type != TOKEN_CLOSE) parser->failed = true;
+        else nextQueryToken(parser);
+    } else if (parser->type == TOKEN_TERM) {
+        char* term = malloc(parser->len + 1);
+        char* name = NULL;
+        if (term != NULL) {
+            memcpy(term, parser->text, parser->len);
+            term[parser->len] = '\0';
+            name = foldText(term);
+        }
+        if (name == NULL) {
+            parser->failed = true;
+        } else {
+            // Unknown categories match nothing.
+            const CategoryIndex* index = parser->index;
+            int s = findSlot(index, name);
+            if (index->slots[s] != -1) result.view = &index->categories[index->slots[s]].cards;
+        }
+        free(term);
+        free(name);
+        nextQueryToken(parser);
+    } else {
+        parser->failed = true;
+    }
+    return result;
+}
+
+// ---------- Helper function: parseAnd ----------
+// Intersects the positive terms, smallest first, then subtracts the negated ones.
+static Operand parseAnd(QueryParser* parser) {
+    Operand* terms = NULL;
+    int count = 0, cap = 0;
+    while (!parser->failed) {
+        if (count > 0 && parser->type == TOKEN_AND) nextQueryToken(parser);
+        else if (count > 0 && (parser->type == TOKEN_OR || parser->type == TOKEN_CLOSE || parser->type == TOKEN_END)) break;
+
+        Operand term = parseUnary(parser);
+        if (count == cap) {
+            cap = cap > 0 ? cap * 2 : 4;
+            Operand* bigger = realloc(terms, cap * sizeof(Operand));
+            if (bigger == NULL) {
+                releaseOperand(&term);
+                parser->failed = true;
+                break;
+            }
+            terms = bigger;
+        }
+        terms[count++] = term;
+    }
+
+    // Positive terms first, in increasing size, so every step can only shrink the result.
+    int positives = 0;
+    for (int i = 0; i < count; i++) {
+        if (!terms[i].negated) {
+            Operand t = terms[positives];
+            terms[positives++] = terms[i];
+            terms[i] = t;
+        }
+    }
+    qsort(terms, positives, sizeof(Operand), compareOperands);
+
+    Operand acc = { &parser->index->all, { NULL, 0, 0 }, false, false };
+    int first = 0;
+    if (positives > 0 && !parser->failed) {
+        acc = terms[0];
+        terms[0].isOwned = false;
+        first = 1;
+    }
+    for (int i = first; i < count && !parser->failed; i++) {
+        bool ok = combineInto(&acc, setOf(&terms[i]), terms[i].negated ? bitmapAndNot : bitmapAnd);
+        if (!ok) parser->failed = true;
+    }
+    for (int i = 0; i < count; i++) releaseOperand(&terms[i]);
+    free(terms);
+    return acc;
+}
+
+// ---------- Helper function: parseOr ----------
+static Operand parseOr(QueryParser* parser) {
+    Operand acc = parseAnd(parser);
+    while (!parser->failed && parser->type == TOKEN_OR) {
+        nextQueryToken(parser);
+        Operand other = parseAnd(parser);
+        if (!parser->failed && !combineInto(&acc, setOf(&other), bitmapOr)) parser->failed = true;
+        releaseOperand(&other);
+    }
+    return acc;
+}
+
+// ---------- Helper function: evaluate ----------
+// Runs a query.  Returns false if it is malformed or malloc fails.
+static bool evaluate(const CategoryIndex* index, const char* query, Operand* result) {
+    QueryParser parser = { index, query, TOKEN_END, NULL, 0, false };
+    nextQueryToken(&parser);
+    if (parser.type == TOKEN_END) return false;
+    *result = parseOr(&parser);
+    if (!parser.failed && parser.type != TOKEN_END) parser.failed = true;
+    if (parser.failed) releaseOperand(result);
+    return !parser.failed;
+}
+
+// ---------- createCategoryIndex ----------
+CategoryIndex* createCategoryIndex(void) {
+    CategoryIndex* index = calloc(1, sizeof(CategoryIndex));
+    if (index == NULL) return NULL;
+    if (!growSlots(index)) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildCategoryIndex ----------
+CategoryIndex* buildCategoryIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    CategoryIndex* index = createCategoryIndex();
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (categoryIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteCategoryIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- categoryIndexAddCard ----------
+VCardErrorCode categoryIndexAddCard(CategoryIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (docId >= index->docCap) {
+        int cap = docCapFor(index->docCap, docId);
+        DocCategories* docs = realloc(index->docs, cap * sizeof(DocCategories));
+        if (docs == NULL) return OTHER_ERROR;
+        memset(docs + index->docCap, 0, (cap - index->docCap) * sizeof(DocCategories));
+        index->docs = docs;
+        index->docCap = cap;
+    }
+    categoryIndexRemoveCard(index, docId);
+    DocCategories* doc = &index->docs[docId];
+
+    bool ok = bitmapAdd(&index->all, docId) >= 0;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "CATEGORIES") != 0) continue;
+        ListIterator values = createIterator(prop->values);
+        char* value;
+        while (ok && (value = nextElement(&values)) != NULL) {
+            ok = addCategories(index, doc, value, docId);
+        }
+    }
+    if (!ok) {
+        categoryIndexRemoveCard(index, docId);
+        return OTHER_ERROR;
+    }
+    return OK;
+}
+
+// ---------- categoryIndexRemoveCard ----------
+void categoryIndexRemoveCard(CategoryIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    DocCategories* doc = &index->docs[docId];
+    for (int i = 0; i < doc->count; i++) bitmapRemove(&index->categories[doc->ids[i]].cards, docId);
+    bitmapRemove(&index->all, docId);
+    free(doc->ids);
+    doc->ids = NULL;
+    doc->count = 0;
+}
+
+// ---------- categoryQuery ----------
+int categoryQuery(const CategoryIndex* index, const char* query, int** docIds) {
+    if (index == NULL || query == NULL || docIds == NULL) return -1;
+    *docIds = NULL;
+    Operand result;
+    if (!evaluate(index, query, &result)) return -1;
+
+    const Bitmap* set = setOf(&result);
+    int n = bitmapCardinality(set);
+    if (n > 0) {
+        *docIds = malloc(n * sizeof(int));
+        if (*docIds == NULL) n = -1;
+        else bitmapToArray(set, *docIds);
+    }
+    releaseOperand(&result);
+    return n;
+}
+
+// ---------- categoryQueryCount ----------
+int categoryQueryCount(const CategoryIndex* index, const char* query) {
+    if (index == NULL || query == NULL) return -1;
+    Operand result;
+    if (!evaluate(index, query, &result)) return -1;
+    int n = bitmapCardinality(setOf(&result));
+    releaseOperand(&result);
+    return n;
+}
+
+// ---------- categoryCount ----------
+int categoryCount(const CategoryIndex* index) {
+    return index != NULL ? index->count : 0;
+}
+
+// ---------- categoryName ----------
+const char* categoryName(const CategoryIndex* index, int id, int* cards) {
+    if (index == NULL || id < 0 || id >= index->count) return NULL;
+    if (cards != NULL) *cards = bitmapCardinality(&index->categories[id].cards);
+    return index->categories[id].name;
+}
+
+// ---------- deleteCategoryIndex ----------
+void deleteCategoryIndex(CategoryIndex* index) {
+    if (index == NULL) return;
+    for (int c = 0; c < index->count; c++) {
+        free(index->categories[c].name);
+        bitmapFree(&index->categories[c].cards);
+    }
+    for (int d = 0; d < index->docCap; d++) free(index->docs[d].ids);
+    bitmapFree(&index->all);
+    free(index->categories);
+    free(index->slots);
+    free(index->docs);
+    free(index);
+}
@@ -0,0 +1,227 @@
+// VCCorpus.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Directory listing, a simple thread pool for running per-file work in parallel,
+//              and loading a whole directory of cards into memory.
+
+#include "VCCorpus.h"
+#include "VCUid.h"
+#include <dirent.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <strings.h>
+#include <unistd.h>
+
+// Number of indices a worker claims at a time.
+#define PARALLEL_CHUNK 16
+
+typedef struct workerArgs {
+    int          numItems;
+    int          thread;
+    atomic_int*  next;
+    void       (*work)(int index, int thread, void* ctx);
+    void*        ctx;
+} WorkerArgs;
+
+// ---------- Helper function: hasCardExtension ----------
+static bool hasCardExtension(const char* fileName) {
+    const char* ext = strrchr(fileName, '.');
+    return ext != NULL && (strcasecmp(ext, ".vcf") == 0 || strcasecmp(ext, ".vcard") == 0);
+}
+
+// ---------- Helper function: compareNames ----------
+static int compareNames(const void* first, const void* second) {
+    return strcmp(*(char* const*)first, *(char* const*)second);
+}
+
+// ---------- listCardFiles ----------
+VCardErrorCode listCardFiles(const char* dirName, char*** names, int* count) {
+    *names = NULL;
+    *count = 0;
+    if (dirName == NULL) return INV_FILE;
+
+    DIR* dir = opendir(dirName);
+    if (dir == NULL) return INV_FILE;
+
+    int capacity = 64;
+    int n = 0;
+    char** list = malloc(capacity * sizeof(char*));
+    if (list == NULL) {
+        closedir(dir);
+        return OTHER_ERROR;
+    }
+
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != NULL) {
+        if (!hasCardExtension(entry->d_name)) continue;
+        if (n == capacity) {
+            capacity *= 2;
+            char** bigger = realloc(list, capacity * sizeof(char*));
+            if (bigger == NULL) {
+                freeCardFileList(list, n);
+                closedir(dir);
+                return OTHER_ERROR;
+            }
+            list = bigger;
+        }
+        list[n] = strdup(entry->d_name);
+        if (list[n] == NULL) {
+            freeCardFileList(list, n);
+            closedir(dir);
+            return OTHER_ERROR;
+        }
+        n++;
+    }
+    closedir(dir);
+
+    qsort(list, n, sizeof(char*), compareNames);
+    *names = list;
+    *count = n;
+    return OK;
+}
+
+// ---------- freeCardFileList ----------
+void freeCardFileList(char** names, int count) {
+    if (names == NULL) return;
+    for (int i = 0; i < count; i++) {
+        free(names[i]);
+    }
+    free(names);
+}
+
+// ---------- joinPath ----------
+char* joinPath(const char* dirName, const char* fileName) {
+    size_t dirLen = strlen(dirName);
+    bool needSlash = dirLen > 0 && dirName[dirLen - 1] != '/';
+    size_t size = dirLen + needSlash + strlen(fileName) + 1;
+    char* path = malloc(size);
+    if (path != NULL) {
+        snprintf(path, size, "%s%s%s", dirName, needSlash ? "/" : "", fileName);
+    }
+    return path;
+}
+
+// ---------- resolveThreadCount ----------
+int resolveThreadCount(int numThreads) {
+    if (numThreads > 0) return numThreads;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    return cpus > 0 ? (int)cpus : 1;
+}
+
+// ---------- Helper function: workerMain ----------
+static void* workerMain(void* arg) {
+    WorkerArgs* args = (WorkerArgs*)arg;
+    while (true) {
+        int start = atomic_fetch_add(args->next, PARALLEL_CHUNK);
+        if (start >= args->numItems) break;
+        int end = start + PARALLEL_CHUNK;
+        if (end > args->numItems) end = args->numItems;
+        for (int i = start; i < end; i++) {
+            args->work(i, args->thread, args->ctx);
+        }
+    }
+    return NULL;
+}
+
+// ---------- runParallel ----------
+VCardErrorCode runParallel(int numItems, int numThreads, void (*work)(int index, int thread, void* ctx), void* ctx) {
+    if (work == NULL) return OTHER_ERROR;
+    if (numItems <= 0) return OK;
+
+    numThreads = resolveThreadCount(numThreads);
+    atomic_int next = 0;
+
+    pthread_t* threads = malloc(numThreads * sizeof(pthread_t));
+    WorkerArgs* args = malloc(numThreads * sizeof(WorkerArgs));
+    if (threads == NULL || args == NULL) {
+        free(threads);
+        free(args);
+        return OTHER_ERROR;
+    }
+
+    // Thread 0 is the calling thread; the others are started here.
+    int started = 1;
+    for (int t = 0; t < numThreads; t++) {
+        args[t].numItems = numItems;
+        args[t].thread = t;
+        args[t].next = &next;
+        args[t].work = work;
+        args[t].ctx = ctx;
+    }
+    for (int t = 1; t < numThreads; t++) {
+        if (pthread_create(&threads[t], NULL, workerMain, &args[t]) != 0) break;
+        started++;
+    }
+    workerMain(&args[0]);
+    for (int t = 1; t < started; t++) {
+        pthread_join(threads[t], NULL);
+    }
+
+    free(threads);
+    free(args);
+    return OK;
+}
+
+typedef struct loadJob {
+    const char* dirName;
+    CardCorpus* corpus;
+} LoadJob;
+
+// ---------- Helper function: loadOneCard ----------
+static void loadOneCard(int index, int thread, void* ctx) {
+    LoadJob* job = (LoadJob*)ctx;
+    char* path = joinPath(job->dirName, job->corpus->names[index]);
+    if (path == NULL) {
+        job->corpus->errors[index] = OTHER_ERROR;
+        return;
+    }
+    job->corpus->errors[index] = createCard(path, &job->corpus->cards[index]);
+    if (job->corpus->errors[index] != OK) job->corpus->cards[index] = NULL;
+    free(path);
+}
+
+// ---------- loadCardCorpus ----------
+CardCorpus* loadCardCorpus(const char* dirName, int numThreads) {
+    if (dirName == NULL) return NULL;
+
+    CardCorpus* corpus = calloc(1, sizeof(CardCorpus));
+    if (corpus == NULL) return NULL;
+    if (listCardFiles(dirName, &corpus->names, &corpus->count) != OK) {
+        free(corpus);
+        return NULL;
+    }
+
+    size_t n = corpus->count > 0 ? corpus->count : 1;
+    corpus->cards = calloc(n, sizeof(Card*));
+    corpus->errors = calloc(n, sizeof(int));
+    if (corpus->cards == NULL || corpus->errors == NULL) {
+        deleteCardCorpus(corpus);
+        return NULL;
+    }
+
+    LoadJob job = { dirName, corpus };
+    if (runParallel(corpus->count, numThreads, loadOneCard, &job) != OK) {
+        deleteCardCorpus(corpus);
+        return NULL;
+    }
+    corpus->uids = buildUidIndex(corpus);
+    if (corpus->uids == NULL) {
+        deleteCardCorpus(corpus);
+        return NULL;
+    }
+    return corpus;
+}
+
+// ---------- deleteCardCorpus ----------
+void deleteCardCorpus(CardCorpus* corpus) {
+    if (corpus == NULL) return;
+    if (corpus->cards != NULL) {
+        for (int i = 0; i < corpus->count; i++) {
+            if (corpus->cards[i] != NULL) deleteCard(corpus->cards[i]);
+        }
+    }
+    deleteUidIndex(corpus->uids);
+    freeCardFileList(corpus->names, corpus->count);
+    free(corpus->cards);
+    free(corpus->errors);
+    free(corpus);
+}
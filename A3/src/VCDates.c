@@ -0,0 +1,138 @@
+// VCDates.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Parsing and normalization of vCard date-and-or-time values.
+
+#include "VCDates.h"
+#include <ctype.h>
+
+// ---------- Helper function: digitsAt ----------
+// Reads n digits at s into *value.  Returns false if any of them is not a digit.
+static bool digitsAt(const char* s, int n, int* value) {
+    int v = 0;
+    for (int i = 0; i < n; i++) {
+        if (!isdigit((unsigned char)s[i])) return false;
+        v = v * 10 + (s[i] - '0');
+    }
+    *value = v;
+    return true;
+}
+
+// ---------- Helper function: parseDate ----------
+// Splits a date (basic or extended format, possibly truncated) into its parts.
+// Missing parts are set to -1.  Returns false if the date is not recognized.
+static bool parseDate(const char* s, int* year, int* month, int* day) {
+    size_t len = strlen(s);
+    *year = *month = *day = -1;
+
+    if (len == 8 && digitsAt(s, 4, year) && digitsAt(s + 4, 2, month) && digitsAt(s + 6, 2, day)) {
+        // YYYYMMDD
+    } else if (len == 10 && s[4] == '-' && s[7] == '-' &&
+               digitsAt(s, 4, year) && digitsAt(s + 5, 2, month) && digitsAt(s + 8, 2, day)) {
+        // YYYY-MM-DD
+    } else if (len == 7 && s[4] == '-' && digitsAt(s, 4, year) && digitsAt(s + 5, 2, month)) {
+        // YYYY-MM
+    } else if (len == 4 && digitsAt(s, 4, year)) {
+        // YYYY
+    } else if (len == 6 && s[0] == '-' && s[1] == '-' && digitsAt(s + 2, 2, month) && digitsAt(s + 4, 2, day)) {
+        // --MMDD
+    } else if (len == 7 && s[0] == '-' && s[1] == '-' && s[4] == '-' &&
+               digitsAt(s + 2, 2, month) && digitsAt(s + 5, 2, day)) {
+        // --MM-DD
+    } else if (len == 4 && s[0] == '-' && s[1] == '-' && digitsAt(s + 2, 2, month)) {
+        // --MM
+    } else if (len == 5 && strncmp(s, "---", 3) == 0 && digitsAt(s + 3, 2, day)) {
+        // ---DD
+    } else {
+        *year = *month = *day = -1;
+        return false;
+    }
+
+    if (*month != -1 && (*month < 1 || *month > 12)) return false;
+    if (*day != -1 && (*day < 1 || *day > 31)) return false;
+    return true;
+}
+
+// ---------- Helper function: formatDate ----------
+static int formatDate(int year, int month, int day, char* buffer, size_t size) {
+    if (year != -1 && month != -1 && day != -1) return snprintf(buffer, size, "%04d-%02d-%02d", year, month, day);
+    if (year != -1 && month != -1) return snprintf(buffer, size, "%04d-%02d", year, month);
+    if (year != -1) return snprintf(buffer, size, "%04d", year);
+    if (month != -1 && day != -1) return snprintf(buffer, size, "--%02d-%02d", month, day);
+    if (month != -1) return snprintf(buffer, size, "--%02d", month);
+    return snprintf(buffer, size, "---%02d", day);
+}
+
+// ---------- Helper function: formatTime ----------
+// HH[MM[SS]] followed by an optional Z or +/-hh[mm] zone, in basic or extended format.
+static int formatTime(const char* s, bool utc, char* buffer, size_t size) {
+    int h, m = -1, sec = -1;
+    const char* p = s;
+
+    if (!digitsAt(p, 2, &h)) return snprintf(buffer, size, "%s", s);
+    p += 2;
+    if (*p == ':') p++;
+    if (digitsAt(p, 2, &m)) {
+        p += 2;
+        if (*p == ':') p++;
+        if (digitsAt(p, 2, &sec)) p += 2;
+    }
+
+    int n;
+    if (sec != -1) n = snprintf(buffer, size, "%02d:%02d:%02d", h, m, sec);
+    else if (m != -1) n = snprintf(buffer, size, "%02d:%02d", h, m);
+    else n = snprintf(buffer, size, "%02d", h);
+    if (n < 0 || (size_t)n >= size) return n;
+
+    int zh, zm = 0;
+    if (*p == 'Z' || *p == 'z' || (*p == '\0' && utc)) {
+        n += snprintf(buffer + n, size - n, "Z");
+    } else if ((*p == '+' || *p == '-') && digitsAt(p + 1, 2, &zh)) {
+        const char* q = p + 3;
+        if (*q == ':') q++;
+        digitsAt(q, 2, &zm);
+        n += snprintf(buffer + n, size - n, "%c%02d:%02d", *p, zh, zm);
+    } else if (*p != '\0') {
+        n += snprintf(buffer + n, size - n, "%s", p);
+    }
+    return n;
+}
+
+// ---------- dateToParts ----------
+VCardErrorCode dateToParts(const DateTime* dt, DateParts* parts) {
+    parts->year = parts->month = parts->day = -1;
+    parts->hasYear = parts->hasMonth = parts->hasDay = false;
+    if (dt == NULL || dt->isText || dt->date == NULL || dt->date[0] == '\0') return INV_DT;
+
+    int year, month, day;
+    if (!parseDate(dt->date, &year, &month, &day)) return INV_DT;
+    parts->year = year;
+    parts->month = month;
+    parts->day = day;
+    parts->hasYear = (year != -1);
+    parts->hasMonth = (month != -1);
+    parts->hasDay = (day != -1);
+    return OK;
+}
+
+// ---------- dateToISO ----------
+int dateToISO(const DateTime* dt, char* buffer, size_t size) {
+    buffer[0] = '\0';
+    if (dt == NULL) return 0;
+    if (dt->isText) return snprintf(buffer, size, "%s", dt->text != NULL ? dt->text : "");
+
+    const char* date = dt->date != NULL ? dt->date : "";
+    const char* time = dt->time != NULL ? dt->time : "";
+    int n = 0;
+    int year, month, day;
+
+    if (date[0] != '\0') {
+        if (parseDate(date, &year, &month, &day)) n = formatDate(year, month, day, buffer, size);
+        else n = snprintf(buffer, size, "%s", date);
+    }
+    if (time[0] != '\0' && n >= 0 && (size_t)n + 1 < size) {
+        buffer[n++] = 'T';
+        buffer[n] = '\0';
+        n += formatTime(time, dt->UTC, buffer + n, size - n);
+    }
+    return n;
+}
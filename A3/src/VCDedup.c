@@ -0,0 +1,487 @@
+// VCDedup.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Duplicate card detection: per-card features and blocking keys, candidate
+//              pairs from shared keys, parallel scoring and union-find clustering.
+
+#include "VCDedup.h"
+#include "VCEmailIndex.h"
+#include "VCPhoneIndex.h"
+#include "VCText.h"
+#include <stdint.h>
+#include <strings.h>
+
+// MinHash signature length, and how it is cut into LSH bands.  With 6 bands of 4 rows,
+// cards whose words overlap by about 2/3 or more are likely to share a band.
+#define MINHASH_SIZE 24
+#define LSH_BANDS    6
+#define LSH_ROWS     (MINHASH_SIZE / LSH_BANDS)
+
+#define MAX_NAME_WORDS 8
+#define MAX_CONTACTS   6
+
+// Name keys (from FN and from N), one per contact, and one per band.
+#define MAX_KEYS (2 + MAX_CONTACTS + LSH_BANDS)
+
+// Candidate pairs are scored in chunks of this many.
+#define SCORE_CHUNK 4096
+
+typedef struct cardFeatures {
+    // Hashes of the folded name words, sorted and without repeats
+    uint32_t names[MAX_NAME_WORDS];
+    int      numNames;
+
+    // Hashes of the normalized TEL and EMAIL values, sorted and without repeats
+    uint64_t contacts[MAX_CONTACTS];
+    int      numContacts;
+
+    // Low 16 bits of each MinHash value, enough to estimate the overlap
+    uint16_t signature[MINHASH_SIZE];
+} CardFeatures;
+
+typedef struct blockKey {
+    uint64_t key;
+    int      docId;
+} BlockKey;
+
+// ---------- Helper function: hashBytes ----------
+// FNV-1a, 64 bit
+static uint64_t hashBytes(uint64_t h, const char* s, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        h ^= (unsigned char)s[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+// ---------- Helper function: mix ----------
+// splitmix64 finalizer
+static uint64_t mix(uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// ---------- Helper function: addSorted32 ----------
+static void addSorted32(uint32_t* set, int* count, int max, uint32_t value) {
+    int i = 0;
+    while (i < *count && set[i] < value) i++;
+    if ((i < *count && set[i] == value) || *count == max) return;
+    memmove(set + i + 1, set + i, (*count - i) * sizeof(uint32_t));
+    set[i] = value;
+    (*count)++;
+}
+
+// ---------- Helper function: addSorted64 ----------
+static void addSorted64(uint64_t* set, int* count, int max, uint64_t value) {
+    int i = 0;
+    while (i < *count && set[i] < value) i++;
+    if ((i < *count && set[i] == value) || *count == max) return;
+    memmove(set + i + 1, set + i, (*count - i) * sizeof(uint64_t));
+    set[i] = value;
+    (*count)++;
+}
+
+// ---------- Helper function: addShingle ----------
+static void addShingle(uint32_t* minHash, uint64_t shingle) {
+    for (int i = 0; i < MINHASH_SIZE; i++) {
+        uint32_t h = (uint32_t)(mix(shingle ^ (0x51ED27A3u * (uint64_t)(i + 1))) >> 32);
+        if (h < minHash[i]) minHash[i] = h;
+    }
+}
+
+// ---------- Helper function: addWords ----------
+// Adds the words of a value as shingles, and to a sorted set of name words if names is not NULL.
+static void addWords(const char* value, uint32_t* minHash, uint32_t* names, int* numNames) {
+    if (value == NULL || value[0] == '\0') return;
+    char* folded = foldText(value);
+    if (folded == NULL) return;
+
+    const char* word = folded;
+    int len;
+    while ((word = nextToken(word, &len)) != NULL) {
+        uint64_t h = hashBytes(14695981039346656037ull, word, len);
+        addShingle(minHash, h);
+        if (names != NULL) addSorted32(names, numNames, MAX_NAME_WORDS, (uint32_t)h);
+        word += len;
+    }
+    free(folded);
+}
+
+// ---------- Helper function: nameKey ----------
+// A key for a set of name words that does not depend on their order.  0 if there are none.
+static uint64_t nameKey(const uint32_t* names, int count) {
+    if (count == 0) return 0;
+    uint64_t h = 14695981039346656037ull;
+    for (int i = 0; i < count; i++) h = hashBytes(h, (const char*)&names[i], sizeof(uint32_t));
+    return mix(h ^ 1);
+}
+
+// ---------- Helper function: extractFeatures ----------
+// Fills in the features of a card and writes its blocking keys.  Returns the number of keys.
+static int extractFeatures(const Card* card, const char* defaultCountry, CardFeatures* f, uint64_t* keys) {
+    memset(f, 0, sizeof(CardFeatures));
+    uint32_t minHash[MINHASH_SIZE];
+    for (int i = 0; i < MINHASH_SIZE; i++) minHash[i] = UINT32_MAX;
+    int numKeys = 0;
+
+    // FN gives one name key, the family, given and additional names of N another; they
+    // agree when N only reorders the FN.
+    uint32_t fnNames[MAX_NAME_WORDS], nNames[MAX_NAME_WORDS];
+    int numFn = 0, numN = 0;
+    if (card->fn != NULL) addWords(getFromFront(card->fn->values), minHash, fnNames, &numFn);
+
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (prop->values == NULL) continue;
+        const char* value = getFromFront(prop->values);
+        char normalized[EMAIL_MAX_LEN];
+        uint64_t contact = 0;
+
+        if (strcasecmp(prop->name, "TEL") == 0) {
+            if (normalizePhone(value, defaultCountry, normalized, sizeof(normalized)) > 0) {
+                contact = hashBytes(14695981039346656037ull ^ 'T', normalized, strlen(normalized));
+            }
+        } else if (strcasecmp(prop->name, "EMAIL") == 0) {
+            if (normalizeEmail(value, normalized, sizeof(normalized)) > 0) {
+                contact = hashBytes(14695981039346656037ull ^ 'E', normalized, strlen(normalized));
+            }
+        } else if (strcasecmp(prop->name, "N") == 0) {
+            ListIterator parts = createIterator(prop->values);
+            char* part;
+            for (int i = 0; i < 3 && (part = nextElement(&parts)) != NULL; i++) {
+                addWords(part, minHash, nNames, &numN);
+            }
+        } else {
+            ListIterator values = createIterator(prop->values);
+            char* v;
+            while ((v = nextElement(&values)) != NULL) addWords(v, minHash, NULL, NULL);
+        }
+
+        // Numbers and addresses are compared normalized, not word by word, so that
+        // formatting differences do not count against a pair.
+        if (contact != 0) {
+            addShingle(minHash, contact);
+            addSorted64(f->contacts, &f->numContacts, MAX_CONTACTS, contact);
+        }
+    }
+
+    uint64_t fnKey = nameKey(fnNames, numFn);
+    uint64_t nKey = nameKey(nNames, numN);
+    if (fnKey != 0) keys[numKeys++] = fnKey;
+    if (nKey != 0 && nKey != fnKey) keys[numKeys++] = nKey;
+    for (int i = 0; i < numFn; i++) addSorted32(f->names, &f->numNames, MAX_NAME_WORDS, fnNames[i]);
+    for (int i = 0; i < numN; i++) addSorted32(f->names, &f->numNames, MAX_NAME_WORDS, nNames[i]);
+
+    for (int i = 0; i < f->numContacts; i++) keys[numKeys++] = f->contacts[i];
+
+    if (minHash[0] != UINT32_MAX) {
+        for (int b = 0; b < LSH_BANDS; b++) {
+            uint64_t h = mix(0xB4D5 + b);
+            h = hashBytes(h, (const char*)&minHash[b * LSH_ROWS], LSH_ROWS * sizeof(uint32_t));
+            keys[numKeys++] = h;
+        }
+    }
+    for (int i = 0; i < MINHASH_SIZE; i++) f->signature[i] = (uint16_t)minHash[i];
+    return numKeys;
+}
+
+// ---------- Helper function: scoreFeatures ----------
+static double scoreFeatures(const CardFeatures* a, const CardFeatures* b) {
+    int i = 0, j = 0, common = 0;
+    while (i < a->numNames && j < b->numNames) {
+        if (a->names[i] < b->names[j]) i++;
+        else if (b->names[j] < a->names[i]) j++;
+        else {
+            common++;
+            i++;
+            j++;
+        }
+    }
+    int total = a->numNames + b->numNames - common;
+    double nameScore = total > 0 ? (double)common / total : 0.0;
+
+    int same = 0;
+    for (int k = 0; k < MINHASH_SIZE; k++) same += (a->signature[k] == b->signature[k]);
+    double wordScore = (double)same / MINHASH_SIZE;
+
+    bool sharedContact = false;
+    i = j = 0;
+    while (i < a->numContacts && j < b->numContacts && !sharedContact) {
+        if (a->contacts[i] < b->contacts[j]) i++;
+        else if (b->contacts[j] < a->contacts[i]) j++;
+        else sharedContact = true;
+    }
+
+    // Different numbers and addresses on both cards count against a pair; a card
+    // without any says nothing either way.
+    double contactScore = sharedContact ? 1.0 : (a->numContacts == 0 || b->numContacts == 0) ? 0.5 : 0.0;
+
+    return 0.4 * nameScore + 0.3 * wordScore + 0.3 * contactScore;
+}
+
+// ---------- Helper function: compareKeys ----------
+static int compareKeys(const void* first, const void* second) {
+    const BlockKey* a = (const BlockKey*)first;
+    const BlockKey* b = (const BlockKey*)second;
+    if (a->key != b->key) return a->key < b->key ? -1 : 1;
+    return (a->docId > b->docId) - (a->docId < b->docId);
+}
+
+// ---------- Helper function: compareU64 ----------
+static int compareU64(const void* first, const void* second) {
+    uint64_t a = *(const uint64_t*)first;
+    uint64_t b = *(const uint64_t*)second;
+    return (a > b) - (a < b);
+}
+
+// ---------- Helper function: findRoot ----------
+static int findRoot(int* parent, int x) {
+    while (parent[x] != x) {
+        parent[x] = parent[parent[x]];
+        x = parent[x];
+    }
+    return x;
+}
+
+typedef struct dedupJob {
+    const CardCorpus* corpus;
+    const char*       defaultCountry;
+    CardFeatures*     features;
+    uint64_t*         keys;
+    int*              numKeys;
+
+    const uint64_t*   pairs;
+    long              numPairs;
+    double*           scores;
+} DedupJob;
+
+// ---------- Helper function: featureWork ----------
+static void featureWork(int docId, int thread, void* ctx) {
+    DedupJob* job = (DedupJob*)ctx;
+    const Card* card = job->corpus->cards[docId];
+    job->numKeys[docId] = 0;
+    if (card != NULL) {
+        job->numKeys[docId] = extractFeatures(card, job->defaultCountry, &job->features[docId],
+                                              job->keys + (size_t)docId * MAX_KEYS);
+    }
+}
+
+// ---------- Helper function: scoreWork ----------
+static void scoreWork(int chunk, int thread, void* ctx) {
+    DedupJob* job = (DedupJob*)ctx;
+    long end = (long)(chunk + 1) * SCORE_CHUNK;
+    if (end > job->numPairs) end = job->numPairs;
+    for (long p = (long)chunk * SCORE_CHUNK; p < end; p++) {
+        int a = (int)(job->pairs[p] >> 32);
+        int b = (int)(job->pairs[p] & 0xFFFFFFFFu);
+        job->scores[p] = scoreFeatures(&job->features[a], &job->features[b]);
+    }
+}
+
+// ---------- Helper function: candidatePairs ----------
+// Gathers the blocking keys, and pairs up the cards that share one.  Returns the number
+// of distinct pairs (first << 32 | second, first < second), or -1 if malloc fails.
+static long candidatePairs(const DedupJob* job, int count, int maxBlock, uint64_t** pairsOut) {
+    size_t numBlockKeys = 0;
+    for (int i = 0; i < count; i++) numBlockKeys += job->numKeys[i];
+    BlockKey* blockKeys = malloc((numBlockKeys > 0 ? numBlockKeys : 1) * sizeof(BlockKey));
+    if (blockKeys == NULL) return -1;
+
+    size_t n = 0;
+    for (int i = 0; i < count; i++) {
+        for (int k = 0; k < job->numKeys[i]; k++) {
+            blockKeys[n].key = job->keys[(size_t)i * MAX_KEYS + k];
+            blockKeys[n].docId = i;
+            n++;
+        }
+    }
+    qsort(blockKeys, n, sizeof(BlockKey), compareKeys);
+
+    size_t cap = 1024, numPairs = 0;
+    uint64_t* pairs = malloc(cap * sizeof(uint64_t));
+    for (size_t start = 0, end; pairs != NULL && start < n; start = end) {
+        end = start + 1;
+        while (end < n && blockKeys[end].key == blockKeys[start].key) end++;
+        size_t size = end - start;
+        if (size < 2 || size > (size_t)maxBlock) continue;
+
+        if (numPairs + size * (size - 1) / 2 > cap) {
+            while (numPairs + size * (size - 1) / 2 > cap) cap *= 2;
+            uint64_t* bigger = realloc(pairs, cap * sizeof(uint64_t));
+            if (bigger == NULL) {
+                free(pairs);
+                pairs = NULL;
+                break;
+            }
+            pairs = bigger;
+        }
+        for (size_t x = start; x < end; x++) {
+            for (size_t y = x + 1; y < end; y++) {
+                // A card can hold the same key twice (e.g. one TEL written two ways).
+                if (blockKeys[x].docId == blockKeys[y].docId) continue;
+                pairs[numPairs++] = (uint64_t)blockKeys[x].docId << 32 | (uint32_t)blockKeys[y].docId;
+            }
+        }
+    }
+    free(blockKeys);
+    if (pairs == NULL) return -1;
+
+    qsort(pairs, numPairs, sizeof(uint64_t), compareU64);
+    size_t unique = 0;
+    for (size_t i = 0; i < numPairs; i++) {
+        if (unique == 0 || pairs[i] != pairs[unique - 1]) pairs[unique++] = pairs[i];
+    }
+    *pairsOut = pairs;
+    return (long)unique;
+}
+
+// ---------- Helper function: buildClusters ----------
+static bool buildClusters(DedupResult* result, int count) {
+    int* parent = malloc((count > 0 ? count : 1) * sizeof(int));
+    double* lowest = malloc((count > 0 ? count : 1) * sizeof(double));
+    int* sizes = calloc(count > 0 ? count : 1, sizeof(int));
+    int* clusterOf = malloc((count > 0 ? count : 1) * sizeof(int));
+    bool ok = parent != NULL && lowest != NULL && sizes != NULL && clusterOf != NULL;
+
+    for (int i = 0; ok && i < count; i++) {
+        parent[i] = i;
+        lowest[i] = 1.0;
+    }
+    for (int p = 0; ok && p < result->numPairs; p++) {
+        int a = findRoot(parent, result->pairs[p].first);
+        int b = findRoot(parent, result->pairs[p].second);
+        double score = result->pairs[p].score;
+        if (a != b) {
+            if (b < a) {
+                int t = a;
+                a = b;
+                b = t;
+            }
+            parent[b] = a;
+            if (lowest[b] < lowest[a]) lowest[a] = lowest[b];
+        }
+        if (score < lowest[a]) lowest[a] = score;
+    }
+
+    // Roots are the smallest document id of their cluster, so numbering them in
+    // document order gives clusters ordered by first document id.
+    for (int i = 0; ok && i < count; i++) sizes[findRoot(parent, i)]++;
+    int numClusters = 0;
+    for (int i = 0; ok && i < count; i++) clusterOf[i] = sizes[i] >= 2 ? numClusters++ : -1;
+
+    if (ok && numClusters > 0) {
+        result->clusters = calloc(numClusters, sizeof(DedupCluster));
+        ok = result->clusters != NULL;
+        for (int i = 0; ok && i < count; i++) {
+            if (clusterOf[i] < 0) continue;
+            DedupCluster* cluster = &result->clusters[clusterOf[i]];
+            cluster->docIds = malloc(sizes[i] * sizeof(int));
+            cluster->score = lowest[i];
+            if (cluster->docIds == NULL) ok = false;
+            result->numClusters++;
+        }
+        for (int i = 0; ok && i < count; i++) {
+            int c = clusterOf[findRoot(parent, i)];
+            if (c >= 0) result->clusters[c].docIds[result->clusters[c].count++] = i;
+        }
+    }
+
+    free(parent);
+    free(lowest);
+    free(sizes);
+    free(clusterOf);
+    return ok;
+}
+
+// ---------- defaultDedupOptions ----------
+void defaultDedupOptions(DedupOptions* options) {
+    options->threshold = 0.7;
+    options->maxBlock = 64;
+    options->defaultCountry = "1";
+    options->numThreads = 0;
+}
+
+// ---------- cardSimilarity ----------
+double cardSimilarity(const Card* first, const Card* second, const char* defaultCountry) {
+    if (first == NULL || second == NULL) return 0.0;
+    CardFeatures a, b;
+    uint64_t keys[MAX_KEYS];
+    extractFeatures(first, defaultCountry, &a, keys);
+    extractFeatures(second, defaultCountry, &b, keys);
+    return scoreFeatures(&a, &b);
+}
+
+// ---------- findDuplicates ----------
+DedupResult* findDuplicates(const CardCorpus* corpus, const DedupOptions* options) {
+    if (corpus == NULL) return NULL;
+    DedupOptions defaults;
+    if (options == NULL) {
+        defaultDedupOptions(&defaults);
+        options = &defaults;
+    }
+
+    DedupResult* result = calloc(1, sizeof(DedupResult));
+    if (result == NULL) return NULL;
+    int count = corpus->count;
+    size_t n = count > 0 ? count : 1;
+
+    DedupJob job = { corpus, options->defaultCountry, malloc(n * sizeof(CardFeatures)),
+                     malloc(n * MAX_KEYS * sizeof(uint64_t)), malloc(n * sizeof(int)), NULL, 0, NULL };
+    bool ok = job.features != NULL && job.keys != NULL && job.numKeys != NULL &&
+              runParallel(count, options->numThreads, featureWork, &job) == OK;
+
+    uint64_t* pairs = NULL;
+    long numPairs = ok ? candidatePairs(&job, count, options->maxBlock, &pairs) : -1;
+    free(job.keys);
+    job.keys = NULL;
+    ok = numPairs >= 0;
+
+    if (ok) {
+        result->numCandidates = numPairs;
+        job.pairs = pairs;
+        job.numPairs = numPairs;
+        job.scores = malloc((numPairs > 0 ? numPairs : 1) * sizeof(double));
+        int numChunks = (int)((numPairs + SCORE_CHUNK - 1) / SCORE_CHUNK);
+        ok = job.scores != NULL && runParallel(numChunks, options->numThreads, scoreWork, &job) == OK;
+    }
+
+    for (long p = 0; ok && p < numPairs; p++) {
+        if (job.scores[p] >= options->threshold) result->numPairs++;
+    }
+    if (ok && result->numPairs > 0) {
+        result->pairs = malloc(result->numPairs * sizeof(DedupPair));
+        ok = result->pairs != NULL;
+        int k = 0;
+        for (long p = 0; ok && p < numPairs; p++) {
+            if (job.scores[p] < options->threshold) continue;
+            result->pairs[k].first = (int)(pairs[p] >> 32);
+            result->pairs[k].second = (int)(pairs[p] & 0xFFFFFFFFu);
+            result->pairs[k].score = job.scores[p];
+            k++;
+        }
+    }
+    if (ok) ok = buildClusters(result, count);
+
+    free(pairs);
+    free(job.features);
+    free(job.numKeys);
+    free(job.scores);
+    if (!ok) {
+        deleteDedupResult(result);
+        return NULL;
+    }
+    return result;
+}
+
+// ---------- deleteDedupResult ----------
+void deleteDedupResult(DedupResult* result) {
+    if (result == NULL) return;
+    if (result->clusters != NULL) {
+        for (int c = 0; c < result->numClusters; c++) free(result->clusters[c].docIds);
+    }
+    free(result->clusters);
+    free(result->pairs);
+    free(result);
+}
@@ -0,0 +1,180 @@
+// VCDocTable.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Chained hash table of entries grouped by document, shared by the
+//              telephone, e-mail and sync key indexes, and the FNV-1a string hash.
+
+#include "VCDocTable.h"
+#include <ctype.h>
+
+// ---------- fnvHash ----------
+uint32_t fnvHash(const char* s) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        h ^= *p;
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// ---------- fnvHashFolded ----------
+uint32_t fnvHashFolded(const char* s) {
+    uint32_t h = 2166136261u;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        h ^= (unsigned char)tolower(*p);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+// ---------- docCapFor ----------
+int docCapFor(int docCap, int docId) {
+    if (docId < docCap) return docCap;
+    int cap = docCap > 0 ? docCap : 64;
+    while (cap <= docId) cap *= 2;
+    return cap;
+}
+
+// ---------- Helper function: growBuckets ----------
+static bool growBuckets(DocTable* table) {
+    int numBuckets = table->numBuckets * 2;
+    int* buckets = malloc(numBuckets * sizeof(int));
+    if (buckets == NULL) return false;
+    for (int i = 0; i < numBuckets; i++) buckets[i] = -1;
+
+    for (int b = 0; b < table->numBuckets; b++) {
+        int e = table->buckets[b];
+        while (e != -1) {
+            int next = table->entries[e].nextInBucket;
+            uint32_t nb = table->entries[e].hash & (numBuckets - 1);
+            table->entries[e].nextInBucket = buckets[nb];
+            buckets[nb] = e;
+            e = next;
+        }
+    }
+    free(table->buckets);
+    table->buckets = buckets;
+    table->numBuckets = numBuckets;
+    return true;
+}
+
+// ---------- docTableInit ----------
+bool docTableInit(DocTable* table, size_t itemSize) {
+    memset(table, 0, sizeof(DocTable));
+    table->itemSize = itemSize;
+    table->freeList = -1;
+    table->entryCap = 64;
+    table->numBuckets = 64;
+    table->entries = malloc(table->entryCap * sizeof(DocEntry));
+    table->items = malloc(table->entryCap * itemSize);
+    table->buckets = malloc(table->numBuckets * sizeof(int));
+    if (table->entries == NULL || table->items == NULL || table->buckets == NULL) return false;
+    for (int i = 0; i < table->numBuckets; i++) table->buckets[i] = -1;
+    return true;
+}
+
+// ---------- docTableReserveDoc ----------
+bool docTableReserveDoc(DocTable* table, int docId) {
+    if (docId < table->docCap) return true;
+    int cap = docCapFor(table->docCap, docId);
+    int* bigger = realloc(table->docHeads, cap * sizeof(int));
+    if (bigger == NULL) return false;
+    for (int i = table->docCap; i < cap; i++) bigger[i] = -1;
+    table->docHeads = bigger;
+    table->docCap = cap;
+    return true;
+}
+
+// ---------- docTableAdd ----------
+int docTableAdd(DocTable* table, uint32_t hash, int docId) {
+    if (!docTableReserveDoc(table, docId)) return -1;
+    if (table->size + 1 > table->numBuckets && !growBuckets(table)) return -1;
+
+    int e = table->freeList;
+    if (e != -1) {
+        table->freeList = table->entries[e].nextInBucket;
+    } else {
+        if (table->numEntries == table->entryCap) {
+            int cap = table->entryCap * 2;
+            DocEntry* bigger = realloc(table->entries, cap * sizeof(DocEntry));
+            if (bigger == NULL) return -1;
+            table->entries = bigger;
+            char* items = realloc(table->items, cap * table->itemSize);
+            if (items == NULL) return -1;
+            table->items = items;
+            table->entryCap = cap;
+        }
+        e = table->numEntries++;
+    }
+
+    DocEntry* entry = &table->entries[e];
+    entry->hash = hash;
+    entry->docId = docId;
+    uint32_t b = hash & (table->numBuckets - 1);
+    entry->nextInBucket = table->buckets[b];
+    table->buckets[b] = e;
+    entry->nextInDoc = table->docHeads[docId];
+    table->docHeads[docId] = e;
+    table->size++;
+    return e;
+}
+
+// ---------- Helper function: unlinkBucket ----------
+// Takes an entry off its bucket chain and puts it on the free list.
+static void unlinkBucket(DocTable* table, int e) {
+    DocEntry* entry = &table->entries[e];
+    int* link = &table->buckets[entry->hash & (table->numBuckets - 1)];
+    while (*link != e) link = &table->entries[*link].nextInBucket;
+    *link = entry->nextInBucket;
+    entry->nextInBucket = table->freeList;
+    table->freeList = e;
+    table->size--;
+}
+
+// ---------- docTableRemove ----------
+void docTableRemove(DocTable* table, int e) {
+    int* link = &table->docHeads[table->entries[e].docId];
+    while (*link != e) link = &table->entries[*link].nextInDoc;
+    *link = table->entries[e].nextInDoc;
+    unlinkBucket(table, e);
+}
+
+// ---------- docTableRemoveDoc ----------
+void docTableRemoveDoc(DocTable* table, int docId) {
+    if (docId < 0 || docId >= table->docCap) return;
+    int e = table->docHeads[docId];
+    while (e != -1) {
+        int next = table->entries[e].nextInDoc;
+        unlinkBucket(table, e);
+        e = next;
+    }
+    table->docHeads[docId] = -1;
+}
+
+// ---------- docTableItem ----------
+void* docTableItem(const DocTable* table, int e) {
+    return table->items + (size_t)e * table->itemSize;
+}
+
+// ---------- docTableFind ----------
+int docTableFind(const DocTable* table, uint32_t hash) {
+    int e = table->buckets[hash & (table->numBuckets - 1)];
+    while (e != -1 && table->entries[e].hash != hash) e = table->entries[e].nextInBucket;
+    return e;
+}
+
+// ---------- docTableNext ----------
+int docTableNext(const DocTable* table, int e) {
+    uint32_t hash = table->entries[e].hash;
+    e = table->entries[e].nextInBucket;
+    while (e != -1 && table->entries[e].hash != hash) e = table->entries[e].nextInBucket;
+    return e;
+}
+
+// ---------- docTableFree ----------
+void docTableFree(DocTable* table) {
+    free(table->entries);
+    free(table->items);
+    free(table->buckets);
+    free(table->docHeads);
+    memset(table, 0, sizeof(DocTable));
+}
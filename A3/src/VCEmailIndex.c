@@ -0,0 +1,248 @@
+// VCEmailIndex.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: E-mail address normalization, with a hash index for whole addresses and a
+//              trie over reversed domains (com.example@jane) for domain queries.
+
+#include "VCEmailIndex.h"
+#include "VCNameIndex.h"
+#include "VCDocTable.h"
+#include <ctype.h>
+#include <strings.h>
+
+// Item of each entry in the table
+typedef struct emailEntry {
+    // NULL once the entry is removed
+    char* address;
+    int   propIndex;
+} EmailEntry;
+
+struct emailIndex {
+    // Entries keyed by normalized address
+    DocTable    addresses;
+
+    // Reversed domain, @, local part, mapped to entry positions.
+    NameIndex*  domains;
+};
+
+// ---------- Helper function: reverseDomain ----------
+// Writes the labels of a domain in reverse order ("mail.example.com" -> "com.example.mail").
+// Returns the length written.
+static int reverseDomain(const char* domain, int len, char* out) {
+    int n = 0;
+    int end = len;
+    while (end > 0) {
+        int start = end;
+        while (start > 0 && domain[start - 1] != '.') start--;
+        if (n > 0) out[n++] = '.';
+        memcpy(out + n, domain + start, end - start);
+        n += end - start;
+        end = start - 1;
+    }
+    out[n] = '\0';
+    return n;
+}
+
+// ---------- Helper function: domainKey ----------
+// Builds the trie key of a normalized address: "jane@mail.example.com" -> "com.example.mail@jane".
+static void domainKey(const char* address, char* key) {
+    const char* at = strchr(address, '@');
+    int n = reverseDomain(at + 1, (int)strlen(at + 1), key);
+    key[n++] = '@';
+    memcpy(key + n, address, at - address);
+    key[n + (at - address)] = '\0';
+}
+
+// ---------- Helper function: addAddress ----------
+static bool addAddress(EmailIndex* index, const char* address, int docId, int propIndex) {
+    int e = docTableAdd(&index->addresses, fnvHash(address), docId);
+    if (e == -1) return false;
+
+    EmailEntry* entry = docTableItem(&index->addresses, e);
+    entry->address = malloc(strlen(address) + 1);
+    entry->propIndex = propIndex;
+    char key[EMAIL_MAX_LEN];
+    if (entry->address != NULL) {
+        strcpy(entry->address, address);
+        domainKey(address, key);
+    }
+    if (entry->address == NULL || nameIndexInsert(index->domains, key, e) != OK) {
+        free(entry->address);
+        entry->address = NULL;
+        docTableRemove(&index->addresses, e);
+        return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: firstValue ----------
+static const char* firstValue(const Property* prop) {
+    return prop->values != NULL ? getFromFront(prop->values) : NULL;
+}
+
+// ---------- Helper function: copyMatches ----------
+static void copyMatches(const EmailIndex* index, const int* entries, int count, EmailMatch* out) {
+    for (int i = 0; i < count; i++) {
+        out[i].docId = index->addresses.entries[entries[i]].docId;
+        out[i].propIndex = ((const EmailEntry*)docTableItem(&index->addresses, entries[i]))->propIndex;
+    }
+}
+
+// ---------- normalizeEmail ----------
+int normalizeEmail(const char* value, char* out, size_t size) {
+    if (out != NULL && size > 0) out[0] = '\0';
+    if (value == NULL || out == NULL || size == 0) return 0;
+
+    while (isspace((unsigned char)*value)) value++;
+    if (strncasecmp(value, "mailto:", 7) == 0) value += 7;
+    if (*value == '<') value++;
+
+    // The address ends at the first space, closing bracket or mailto: header (?subject=).
+    size_t len = strcspn(value, " \t\r\n>?");
+    while (len > 0 && value[len - 1] == '.') len--;
+    if (len == 0 || len >= size || len >= EMAIL_MAX_LEN) return 0;
+
+    const char* at = memchr(value, '@', len);
+    if (at == NULL || at == value || at + 1 == value + len || at[1] == '.' ||
+        memchr(at + 1, '@', value + len - at - 1) != NULL) {
+        return 0;
+    }
+
+    for (size_t i = 0; i < len; i++) out[i] = (char)tolower((unsigned char)value[i]);
+    out[len] = '\0';
+    return (int)len;
+}
+
+// ---------- createEmailIndex ----------
+EmailIndex* createEmailIndex(void) {
+    EmailIndex* index = calloc(1, sizeof(EmailIndex));
+    if (index == NULL) return NULL;
+    bool ok = docTableInit(&index->addresses, sizeof(EmailEntry));
+    index->domains = createNameIndex();
+    if (!ok || index->domains == NULL) {
+        deleteEmailIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildEmailIndex ----------
+EmailIndex* buildEmailIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    EmailIndex* index = createEmailIndex();
+    if (index == NULL) return NULL;
+    if (!docTableReserveDoc(&index->addresses, corpus->count)) {
+        deleteEmailIndex(index);
+        return NULL;
+    }
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (emailIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteEmailIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- emailIndexAddCard ----------
+VCardErrorCode emailIndexAddCard(EmailIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+
+    int propIndex = 0;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        char address[EMAIL_MAX_LEN];
+        if (strcasecmp(prop->name, "EMAIL") == 0 &&
+            normalizeEmail(firstValue(prop), address, sizeof(address)) > 0 &&
+            !addAddress(index, address, docId, propIndex)) {
+            return OTHER_ERROR;
+        }
+        propIndex++;
+    }
+    return OK;
+}
+
+// ---------- emailIndexRemoveCard ----------
+void emailIndexRemoveCard(EmailIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->addresses.docCap) return;
+
+    for (int e = index->addresses.docHeads[docId]; e != -1; e = index->addresses.entries[e].nextInDoc) {
+        EmailEntry* entry = docTableItem(&index->addresses, e);
+        char key[EMAIL_MAX_LEN];
+        domainKey(entry->address, key);
+        nameIndexRemove(index->domains, key, e);
+        free(entry->address);
+        entry->address = NULL;
+    }
+    docTableRemoveDoc(&index->addresses, docId);
+}
+
+// ---------- emailIndexLookup ----------
+int emailIndexLookup(const EmailIndex* index, const char* address, EmailMatch* out, int maxResults) {
+    if (index == NULL || out == NULL || maxResults <= 0) return 0;
+    char key[EMAIL_MAX_LEN];
+    if (normalizeEmail(address, key, sizeof(key)) == 0) return 0;
+
+    int n = 0;
+    int e = docTableFind(&index->addresses, fnvHash(key));
+    for (; e != -1 && n < maxResults; e = docTableNext(&index->addresses, e)) {
+        const EmailEntry* entry = docTableItem(&index->addresses, e);
+        if (strcmp(entry->address, key) == 0) {
+            out[n].docId = index->addresses.entries[e].docId;
+            out[n].propIndex = entry->propIndex;
+            n++;
+        }
+    }
+    return n;
+}
+
+// ---------- emailIndexDomain ----------
+int emailIndexDomain(const EmailIndex* index, const char* domain, bool subdomains,
+                     EmailMatch* out, int maxResults) {
+    if (index == NULL || domain == NULL || out == NULL || maxResults <= 0) return 0;
+
+    while (isspace((unsigned char)*domain)) domain++;
+    if (*domain == '@') domain++;
+    int len = (int)strcspn(domain, " \t\r\n");
+    while (len > 0 && domain[len - 1] == '.') len--;
+    if (len == 0 || len >= EMAIL_MAX_LEN - 1) return 0;
+
+    // Every key at the domain starts with "com.example@", and every key at a
+    // subdomain with "com.example.".
+    char prefix[EMAIL_MAX_LEN];
+    int n = reverseDomain(domain, len, prefix);
+    prefix[n + 1] = '\0';
+
+    int* entries = malloc(maxResults * sizeof(int));
+    if (entries == NULL) return 0;
+    prefix[n] = '@';
+    int count = nameIndexPrefix(index->domains, prefix, entries, maxResults);
+    if (subdomains && count < maxResults) {
+        prefix[n] = '.';
+        count += nameIndexPrefix(index->domains, prefix, entries + count, maxResults - count);
+    }
+    copyMatches(index, entries, count, out);
+    free(entries);
+    return count;
+}
+
+// ---------- emailIndexSize ----------
+int emailIndexSize(const EmailIndex* index) {
+    return index != NULL ? index->addresses.size : 0;
+}
+
+// ---------- deleteEmailIndex ----------
+void deleteEmailIndex(EmailIndex* index) {
+    if (index == NULL) return;
+    if (index->addresses.items != NULL) {
+        // Removed entries have a NULL address, so every slot can be freed.
+        for (int e = 0; e < index->addresses.numEntries; e++) {
+            free(((EmailEntry*)docTableItem(&index->addresses, e))->address);
+        }
+    }
+    deleteNameIndex(index->domains);
+    docTableFree(&index->addresses);
+    free(index);
+}
@@ -0,0 +1,515 @@
+// VCFuzzy.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Trigram candidate filtering and Myers' bit-parallel edit distance
+//              (one text at a time, or several at once in vector lanes).
+
+#include "VCFuzzy.h"
+#include "VCDocTable.h"
+#include "VCPostings.h"
+#include "VCText.h"
+#include <stdint.h>
+#include <strings.h>
+
+// Names are indexed by their 3-byte substrings, padded with two bytes at each end so
+// that a name of length n has n + 2 of them.  One edit changes at most 3.
+#define GRAM     3
+#define GRAM_PAD 1
+
+// Patterns up to this long fit in one machine word; longer ones use the plain table.
+#define MYERS_WORD 64
+
+// Candidates scored together, one per vector lane.
+#define BATCH_LANES 4
+
+typedef uint64_t Lanes __attribute__((vector_size(BATCH_LANES * sizeof(uint64_t))));
+typedef int64_t LaneInts __attribute__((vector_size(BATCH_LANES * sizeof(int64_t))));
+
+typedef struct nameEntry {
+    // Folded name, NULL once the entry is free
+    char* name;
+    int   len;
+    int   docId;
+
+    // Next entry of the same document, or of the free list.  -1 ends a chain.
+    int   next;
+} NameEntry;
+
+typedef struct gram {
+    // 0 marks an empty slot; real grams always contain a non-zero byte.
+    uint32_t    key;
+    PostingList entries;
+} Gram;
+
+struct fuzzyIndex {
+    NameEntry* entries;
+    int        numEntries;
+    int        entryCap;
+    int        freeList;
+    int        size;
+
+    // First entry of each document, -1 if it has none.
+    int*       docHeads;
+    int        docCap;
+
+    // Open-addressing table of grams
+    Gram*      grams;
+    int        numGrams;
+    int        gramCap;
+};
+
+// ---------- Helper function: buildPeq ----------
+// For each byte value, the bit mask of the pattern positions holding it.
+static void buildPeq(const unsigned char* pattern, int m, uint64_t* peq) {
+    memset(peq, 0, 256 * sizeof(uint64_t));
+    for (int i = 0; i < m; i++) peq[pattern[i]] |= (uint64_t)1 << i;
+}
+
+// ---------- Helper function: myers ----------
+// Distance between a pattern (of length m <= 64, described by peq) and a text.
+// Stops early and returns limit + 1 once the distance must exceed limit.
+static int myers(const uint64_t* peq, int m, const unsigned char* text, int n, int limit) {
+    uint64_t pv = m == MYERS_WORD ? ~(uint64_t)0 : ((uint64_t)1 << m) - 1;
+    uint64_t mv = 0;
+    uint64_t high = (uint64_t)1 << (m - 1);
+    int score = m;
+
+    for (int j = 0; j < n; j++) {
+        uint64_t eq = peq[text[j]];
+        uint64_t xv = eq | mv;
+        uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+        uint64_t ph = mv | ~(xh | pv);
+        uint64_t mh = pv & xh;
+        if (ph & high) score++;
+        else if (mh & high) score--;
+        ph = (ph << 1) | 1;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        // Each remaining byte can lower the distance by at most one.
+        if (score - (n - j - 1) > limit) return limit + 1;
+    }
+    return score;
+}
+
+// ---------- Helper function: myersBatch ----------
+// The same as myers for BATCH_LANES texts at once, without stopping early.
+static void myersBatch(const uint64_t* peq, int m, const unsigned char* const* texts,
+                       const int* lens, int* out) {
+    uint64_t ones = m == MYERS_WORD ? ~(uint64_t)0 : ((uint64_t)1 << m) - 1;
+    Lanes pv, mv, high, one, zero;
+    LaneInts score;
+    int longest = 0;
+    for (int l = 0; l < BATCH_LANES; l++) {
+        pv[l] = ones;
+        mv[l] = 0;
+        high[l] = (uint64_t)1 << (m - 1);
+        one[l] = 1;
+        zero[l] = 0;
+        score[l] = m;
+        out[l] = m;
+        if (lens[l] > longest) longest = lens[l];
+    }
+
+    for (int j = 0; j < longest; j++) {
+        Lanes eq;
+        for (int l = 0; l < BATCH_LANES; l++) eq[l] = j < lens[l] ? peq[texts[l][j]] : 0;
+        Lanes xv = eq | mv;
+        Lanes xh = (((eq & pv) + pv) ^ pv) | eq;
+        Lanes ph = mv | ~(xh | pv);
+        Lanes mh = pv & xh;
+
+        // Comparisons give -1 in the lanes where they hold.
+        score -= (LaneInts)((ph & high) != zero);
+        score += (LaneInts)((mh & high) != zero);
+        ph = (ph << 1) | one;
+        mh <<= 1;
+        pv = mh | ~(xv | ph);
+        mv = ph & xv;
+
+        for (int l = 0; l < BATCH_LANES; l++) {
+            if (lens[l] == j + 1) out[l] = (int)score[l];
+        }
+    }
+}
+
+// ---------- Helper function: tableDistance ----------
+// Row-by-row dynamic programming, for patterns too long for myers.
+static int tableDistance(const unsigned char* a, int m, const unsigned char* b, int n) {
+    int* row = malloc((n + 1) * sizeof(int));
+    if (row == NULL) return m > n ? m : n;
+    for (int j = 0; j <= n; j++) row[j] = j;
+    for (int i = 1; i <= m; i++) {
+        int diag = row[0];
+        row[0] = i;
+        for (int j = 1; j <= n; j++) {
+            int up = row[j];
+            int best = diag + (a[i - 1] != b[j - 1]);
+            if (up + 1 < best) best = up + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            diag = up;
+        }
+    }
+    int result = row[n];
+    free(row);
+    return result;
+}
+
+// ---------- Helper function: collectGrams ----------
+// Writes the distinct grams of a name, sorted.  Returns how many there are.
+static int collectGrams(const char* name, int len, uint32_t* grams) {
+    int n = 0;
+    for (int i = -(GRAM - 1); i < len; i++) {
+        uint32_t key = 0;
+        for (int k = 0; k < GRAM; k++) {
+            int at = i + k;
+            unsigned char c = (at >= 0 && at < len) ? (unsigned char)name[at] : GRAM_PAD;
+            key = (key << 8) | c;
+        }
+        grams[n++] = key;
+    }
+
+    // Insertion sort: names are short.
+    for (int i = 1; i < n; i++) {
+        uint32_t key = grams[i];
+        int j = i;
+        while (j > 0 && grams[j - 1] > key) {
+            grams[j] = grams[j - 1];
+            j--;
+        }
+        grams[j] = key;
+    }
+    int unique = 0;
+    for (int i = 0; i < n; i++) {
+        if (unique == 0 || grams[i] != grams[unique - 1]) grams[unique++] = grams[i];
+    }
+    return unique;
+}
+
+// ---------- Helper function: hashGram ----------
+static uint32_t hashGram(uint32_t key) {
+    key *= 0x9E3779B1u;
+    return key ^ (key >> 15);
+}
+
+// ---------- Helper function: findGram ----------
+// Returns the slot holding key, or the empty slot where it would go.
+static int findGram(const FuzzyIndex* index, uint32_t key) {
+    uint32_t s = hashGram(key) & (index->gramCap - 1);
+    while (index->grams[s].key != 0 && index->grams[s].key != key) s = (s + 1) & (index->gramCap - 1);
+    return (int)s;
+}
+
+// ---------- Helper function: growGrams ----------
+static bool growGrams(FuzzyIndex* index) {
+    int cap = index->gramCap > 0 ? index->gramCap * 2 : 1024;
+    Gram* grams = calloc(cap, sizeof(Gram));
+    if (grams == NULL) return false;
+    for (int i = 0; i < index->gramCap; i++) {
+        if (index->grams[i].key == 0) continue;
+        uint32_t s = hashGram(index->grams[i].key) & (cap - 1);
+        while (grams[s].key != 0) s = (s + 1) & (cap - 1);
+        grams[s] = index->grams[i];
+    }
+    free(index->grams);
+    index->grams = grams;
+    index->gramCap = cap;
+    return true;
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(FuzzyIndex* index, int docId) {
+    if (docId < index->docCap) return true;
+    int cap = docCapFor(index->docCap, docId);
+    int* bigger = realloc(index->docHeads, cap * sizeof(int));
+    if (bigger == NULL) return false;
+    for (int i = index->docCap; i < cap; i++) bigger[i] = -1;
+    index->docHeads = bigger;
+    index->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: removeEntry ----------
+static void removeEntry(FuzzyIndex* index, int e) {
+    NameEntry* entry = &index->entries[e];
+    uint32_t grams[MYERS_WORD * 4];
+    int len = entry->len < MYERS_WORD * 4 - GRAM ? entry->len : MYERS_WORD * 4 - GRAM;
+    int numGrams = collectGrams(entry->name, len, grams);
+    for (int g = 0; g < numGrams; g++) {
+        int s = findGram(index, grams[g]);
+        if (index->grams[s].key != 0) postingRemove(&index->grams[s].entries, e);
+    }
+    free(entry->name);
+    entry->name = NULL;
+    entry->next = index->freeList;
+    index->freeList = e;
+    index->size--;
+}
+
+// ---------- Helper function: addName ----------
+static bool addName(FuzzyIndex* index, const char* value, int docId) {
+    if (value == NULL) return true;
+    char* name = foldText(value);
+    if (name == NULL) return false;
+    int len = (int)strlen(name);
+
+    // Skip empty names, and repeats of a name the card already has.
+    bool skip = (len == 0);
+    for (int e = index->docHeads[docId]; e != -1 && !skip; e = index->entries[e].next) {
+        skip = strcmp(index->entries[e].name, name) == 0;
+    }
+    if (skip) {
+        free(name);
+        return true;
+    }
+
+    int e = index->freeList;
+    if (e != -1) {
+        index->freeList = index->entries[e].next;
+    } else {
+        if (index->numEntries == index->entryCap) {
+            int cap = index->entryCap > 0 ? index->entryCap * 2 : 64;
+            NameEntry* bigger = realloc(index->entries, cap * sizeof(NameEntry));
+            if (bigger == NULL) {
+                free(name);
+                return false;
+            }
+            index->entries = bigger;
+            index->entryCap = cap;
+        }
+        e = index->numEntries++;
+    }
+    NameEntry* entry = &index->entries[e];
+    entry->name = name;
+    entry->len = len;
+    entry->docId = docId;
+    entry->next = index->docHeads[docId];
+    index->docHeads[docId] = e;
+    index->size++;
+
+    // Very long names are indexed by their start; they are still scored in full.
+    uint32_t grams[MYERS_WORD * 4];
+    int numGrams = collectGrams(name, len < MYERS_WORD * 4 - GRAM ? len : MYERS_WORD * 4 - GRAM, grams);
+    for (int g = 0; g < numGrams; g++) {
+        if (2 * (index->numGrams + 1) > index->gramCap && !growGrams(index)) return false;
+        int s = findGram(index, grams[g]);
+        if (index->grams[s].key == 0) {
+            index->grams[s].key = grams[g];
+            index->numGrams++;
+        }
+        if (postingAdd(&index->grams[s].entries, e) < 0) return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: compareMatches ----------
+static int compareMatches(const void* first, const void* second) {
+    const FuzzyMatch* a = (const FuzzyMatch*)first;
+    const FuzzyMatch* b = (const FuzzyMatch*)second;
+    if (a->distance != b->distance) return a->distance - b->distance;
+    return (a->docId > b->docId) - (a->docId < b->docId);
+}
+
+// ---------- editDistance ----------
+int editDistance(const char* a, const char* b) {
+    if (a == NULL) a = "";
+    if (b == NULL) b = "";
+    int m = (int)strlen(a), n = (int)strlen(b);
+    if (m > n) {
+        const char* t = a;
+        a = b;
+        b = t;
+        int tl = m;
+        m = n;
+        n = tl;
+    }
+    if (m == 0) return n;
+    if (m > MYERS_WORD) return tableDistance((const unsigned char*)a, m, (const unsigned char*)b, n);
+
+    uint64_t peq[256];
+    buildPeq((const unsigned char*)a, m, peq);
+    return myers(peq, m, (const unsigned char*)b, n, n);
+}
+
+// ---------- createFuzzyIndex ----------
+FuzzyIndex* createFuzzyIndex(void) {
+    FuzzyIndex* index = calloc(1, sizeof(FuzzyIndex));
+    if (index == NULL) return NULL;
+    index->freeList = -1;
+    if (!growGrams(index)) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildFuzzyIndex ----------
+FuzzyIndex* buildFuzzyIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    FuzzyIndex* index = createFuzzyIndex();
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (fuzzyIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteFuzzyIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- fuzzyIndexAddCard ----------
+VCardErrorCode fuzzyIndexAddCard(FuzzyIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (!reserveDoc(index, docId)) return OTHER_ERROR;
+
+    bool ok = card->fn == NULL || addName(index, getFromFront(card->fn->values), docId);
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "FN") == 0) {
+            ok = addName(index, getFromFront(prop->values), docId);
+        } else if (strcasecmp(prop->name, "N") == 0) {
+            // Family name, then given name
+            ListIterator parts = createIterator(prop->values);
+            char* part;
+            for (int i = 0; ok && i < 2 && (part = nextElement(&parts)) != NULL; i++) {
+                ok = addName(index, part, docId);
+            }
+        }
+    }
+    return ok ? OK : OTHER_ERROR;
+}
+
+// ---------- fuzzyIndexRemoveCard ----------
+void fuzzyIndexRemoveCard(FuzzyIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    int e = index->docHeads[docId];
+    while (e != -1) {
+        int next = index->entries[e].next;
+        removeEntry(index, e);
+        e = next;
+    }
+    index->docHeads[docId] = -1;
+}
+
+// ---------- fuzzyNameSearch ----------
+int fuzzyNameSearch(const FuzzyIndex* index, const char* query, int maxDistance,
+                    FuzzyMatch* out, int maxResults) {
+    if (index == NULL || query == NULL || out == NULL || maxResults <= 0 || index->size == 0) return 0;
+    char* folded = foldText(query);
+    if (folded == NULL) return 0;
+    int m = (int)strlen(folded);
+    if (m == 0) {
+        free(folded);
+        return 0;
+    }
+    const unsigned char* pattern = (const unsigned char*)folded;
+    int k = maxDistance >= 0 ? maxDistance : m <= 4 ? 1 : m <= 8 ? 2 : 3;
+
+    // A name within k edits shares at least this many of the query's distinct grams.
+    uint32_t grams[MYERS_WORD * 4];
+    int numGrams = collectGrams(folded, m < MYERS_WORD * 4 - GRAM ? m : MYERS_WORD * 4 - GRAM, grams);
+    int needed = numGrams - k * GRAM;
+
+    int* candidates = NULL;
+    int numCandidates = 0;
+    unsigned char* counts = NULL;
+    if (needed > 0) {
+        counts = calloc(index->numEntries > 0 ? index->numEntries : 1, 1);
+        candidates = malloc((index->numEntries > 0 ? index->numEntries : 1) * sizeof(int));
+        for (int g = 0; counts != NULL && candidates != NULL && g < numGrams; g++) {
+            int s = findGram(index, grams[g]);
+            if (index->grams[s].key == 0) continue;
+            PostingIter iter;
+            postingIterInit(&index->grams[s].entries, &iter);
+            int e;
+            while ((e = postingNext(&iter)) >= 0) {
+                if (++counts[e] == needed) candidates[numCandidates++] = e;
+            }
+        }
+    } else {
+        // The query is too short to filter on; every name is a candidate.
+        candidates = malloc((index->numEntries > 0 ? index->numEntries : 1) * sizeof(int));
+        for (int e = 0; candidates != NULL && e < index->numEntries; e++) {
+            if (index->entries[e].name != NULL) candidates[numCandidates++] = e;
+        }
+    }
+
+    FuzzyMatch* matches = malloc((numCandidates > 0 ? numCandidates : 1) * sizeof(FuzzyMatch));
+    int numMatches = 0;
+    if (candidates == NULL || matches == NULL || (needed > 0 && counts == NULL)) {
+        numCandidates = 0;
+    }
+
+    uint64_t peq[256];
+    if (m <= MYERS_WORD) buildPeq(pattern, m, peq);
+    const unsigned char* batch[BATCH_LANES];
+    int lens[BATCH_LANES], owners[BATCH_LANES], distances[BATCH_LANES];
+    int inBatch = 0;
+
+    for (int c = 0; c <= numCandidates; c++) {
+        // Names whose length differs from the query's by more than k cannot match.
+        if (c < numCandidates) {
+            const NameEntry* entry = &index->entries[candidates[c]];
+            if (entry->len - m > k || m - entry->len > k) continue;
+            if (m > MYERS_WORD) {
+                int d = tableDistance(pattern, m, (const unsigned char*)entry->name, entry->len);
+                if (d <= k) {
+                    matches[numMatches].docId = entry->docId;
+                    matches[numMatches++].distance = d;
+                }
+                continue;
+            }
+            batch[inBatch] = (const unsigned char*)entry->name;
+            lens[inBatch] = entry->len;
+            owners[inBatch] = entry->docId;
+            inBatch++;
+            if (inBatch < BATCH_LANES) continue;
+            myersBatch(peq, m, batch, lens, distances);
+        } else {
+            // Score what is left of the last batch one at a time.
+            for (int l = 0; l < inBatch; l++) distances[l] = myers(peq, m, batch[l], lens[l], k);
+        }
+        for (int l = 0; l < inBatch; l++) {
+            if (distances[l] <= k) {
+                matches[numMatches].docId = owners[l];
+                matches[numMatches++].distance = distances[l];
+            }
+        }
+        inBatch = 0;
+    }
+
+    // Keep the closest name of each card.
+    qsort(matches, numMatches, sizeof(FuzzyMatch), compareMatches);
+    int n = 0;
+    for (int i = 0; i < numMatches && n < maxResults; i++) {
+        bool seen = false;
+        for (int j = 0; j < n && !seen; j++) seen = out[j].docId == matches[i].docId;
+        if (!seen) out[n++] = matches[i];
+    }
+
+    free(matches);
+    free(candidates);
+    free(counts);
+    free(folded);
+    return n;
+}
+
+// ---------- fuzzyIndexSize ----------
+int fuzzyIndexSize(const FuzzyIndex* index) {
+    return index != NULL ? index->size : 0;
+}
+
+// ---------- deleteFuzzyIndex ----------
+void deleteFuzzyIndex(FuzzyIndex* index) {
+    if (index == NULL) return;
+    for (int e = 0; e < index->numEntries; e++) free(index->entries[e].name);
+    for (int g = 0; g < index->gramCap; g++) postingFree(&index->grams[g].entries);
+    free(index->entries);
+    free(index->docHeads);
+    free(index->grams);
+    free(index);
+}
@@ -0,0 +1,655 @@
+// VCGeo.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: GEO parsing, and k-d trees over latitude and longitude searched with
+//              haversine distances.  Additions go to a small buffer and then into a
+//              series of trees of doubling size, merged as in a binary counter.
+
+#include "VCGeo.h"
+#include "VCDocTable.h"
+#include <math.h>
+#include <strings.h>
+
+#define DEG_TO_RAD (M_PI / 180.0)
+
+// Size of the buffer of additions.  Level i holds at most GEO_BUFFER_MIN << i points.
+#define GEO_BUFFER_MIN 1024
+#define GEO_LEVELS 24
+
+// Where a document's point is, if not in a level
+#define SLOT_NONE -2
+#define SLOT_BUFFER -1
+
+typedef struct geoPoint {
+    double lat;
+    double lon;
+    int    docId;
+
+    // Removed from its tree but not yet merged away
+    bool   dead;
+} GeoPoint;
+
+// An implicit k-d tree: the median of each range splits it, by latitude at even depths
+// and by longitude at odd ones.
+typedef struct geoLevel {
+    GeoPoint* points;
+    int       size;
+} GeoLevel;
+
+struct geoIndex {
+    // Empty levels have no points
+    GeoLevel     levels[GEO_LEVELS];
+    int          numDead;
+
+    // Points added since the last merge, at most GEO_BUFFER_MIN
+    GeoPoint*    buffer;
+    int          bufferSize;
+
+    // The level (or SLOT_BUFFER or SLOT_NONE) and position of each document's point
+    signed char* slotLevel;
+    int*         slotPos;
+    int          docCap;
+    int          size;
+};
+
+// A range of the tree and the box its points lie in
+typedef struct geoCell {
+    int    lo;
+    int    hi;
+    int    depth;
+    double south;
+    double north;
+    double west;
+    double east;
+} GeoCell;
+
+// A query point with its trigonometry done once
+typedef struct geoQuery {
+    double lat;
+    double lon;
+    double cosLat;
+} GeoQuery;
+
+typedef struct geoJob {
+    const CardCorpus* corpus;
+    GeoPoint*         points;
+    bool*             found;
+} GeoJob;
+
+// ---------- Helper function: hav ----------
+static double hav(double radians) {
+    double s = sin(radians / 2);
+    return s * s;
+}
+
+// ---------- Helper function: pointHav ----------
+// Haversine of the central angle between the query and a point.  It grows with the
+// distance, so it is compared directly and only converted for the results.
+static double pointHav(const GeoQuery* q, double lat, double lon) {
+    return hav((lat - q->lat) * DEG_TO_RAD) + q->cosLat * cos(lat * DEG_TO_RAD) * hav((lon - q->lon) * DEG_TO_RAD);
+}
+
+// ---------- Helper function: havToKm ----------
+static double havToKm(double h) {
+    if (h > 1) h = 1;
+    return 2 * GEO_EARTH_RADIUS_KM * asin(sqrt(h));
+}
+
+// ---------- Helper function: lonGap ----------
+// Smallest difference in degrees between a longitude and a range of longitudes.
+static double lonGap(double lon, double west, double east) {
+    if (lon >= west && lon <= east) return 0;
+    double toWest = fabs(lon - west), toEast = fabs(lon - east);
+    if (toWest > 180) toWest = 360 - toWest;
+    if (toEast > 180) toEast = 360 - toEast;
+    return toWest < toEast ? toWest : toEast;
+}
+
+// ---------- Helper function: cellHav ----------
+// A lower bound on pointHav for any point in a cell.  The two terms of the haversine
+// are bounded separately: the latitude gap, and the longitude gap weighted by the
+// smallest cosine in the cell's latitudes (found at one of its edges).
+static double cellHav(const GeoQuery* q, const GeoCell* c) {
+    double latGap = q->lat < c->south ? c->south - q->lat : q->lat > c->north ? q->lat - c->north : 0;
+    double gap = lonGap(q->lon, c->west, c->east);
+    double h = hav(latGap * DEG_TO_RAD);
+    if (gap > 0) {
+        double cosSouth = cos(c->south * DEG_TO_RAD), cosNorth = cos(c->north * DEG_TO_RAD);
+        double minCos = cosSouth < cosNorth ? cosSouth : cosNorth;
+        if (minCos > 0) h += q->cosLat * minCos * hav(gap * DEG_TO_RAD);
+    }
+    return h;
+}
+
+// ---------- Helper function: splitCell ----------
+// The cells of the points before and after the median of c.
+static void splitCell(const GeoPoint* tree, const GeoCell* c, GeoCell* left, GeoCell* right) {
+    int mid = (c->lo + c->hi) / 2;
+    const GeoPoint* median = &tree[mid];
+    *left = *c;
+    *right = *c;
+    left->hi = mid;
+    right->lo = mid + 1;
+    left->depth = right->depth = c->depth + 1;
+    if (c->depth % 2 == 0) {
+        left->north = median->lat;
+        right->south = median->lat;
+    } else {
+        left->east = median->lon;
+        right->west = median->lon;
+    }
+}
+
+// ---------- Helper function: coord ----------
+static double coord(const GeoPoint* p, int depth) {
+    return depth % 2 == 0 ? p->lat : p->lon;
+}
+
+// ---------- Helper function: selectMedian ----------
+// Moves the median (by the depth's coordinate) of points[lo, hi) to the middle, with
+// smaller points before it and larger ones after (quickselect).
+static void selectMedian(GeoPoint* points, int lo, int hi, int depth) {
+    int k = (lo + hi) / 2;
+    hi--;
+    while (lo < hi) {
+        double pivot = coord(&points[(lo + hi) / 2], depth);
+        int i = lo, j = hi;
+        while (i <= j) {
+            while (coord(&points[i], depth) < pivot) i++;
+            while (coord(&points[j], depth) > pivot) j--;
+            if (i <= j) {
+                GeoPoint t = points[i];
+                points[i] = points[j];
+                points[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j) hi = j;
+        else if (k >= i) lo = i;
+        else break;
+    }
+}
+
+// ---------- Helper function: buildTree ----------
+static void buildTree(GeoPoint* points, int lo, int hi, int depth) {
+    while (hi - lo > 1) {
+        selectMedian(points, lo, hi, depth);
+        int mid = (lo + hi) / 2;
+        buildTree(points, lo, mid, depth + 1);
+        lo = mid + 1;
+        depth++;
+    }
+}
+
+// ---------- Helper function: setLevel ----------
+// Builds the tree of a level from points it takes over.
+static void setLevel(GeoIndex* index, int level, GeoPoint* points, int n) {
+    buildTree(points, 0, n, 0);
+    for (int i = 0; i < n; i++) {
+        index->slotLevel[points[i].docId] = level;
+        index->slotPos[points[i].docId] = i;
+    }
+    index->levels[level].points = points;
+    index->levels[level].size = n;
+}
+
+// ---------- Helper function: levelFor ----------
+// The smallest level that can hold n points.
+static int levelFor(int n) {
+    int level = 0;
+    while (level < GEO_LEVELS - 1 && (GEO_BUFFER_MIN << level) < n) level++;
+    return level;
+}
+
+// ---------- Helper function: mergeLevels ----------
+// Moves the buffer and the live points of levels [0, count) into a new tree at the given
+// level, which must be empty or among them.
+static bool mergeLevels(GeoIndex* index, int count, int level) {
+    int total = index->bufferSize;
+    for (int i = 0; i < count; i++) total += index->levels[i].size;
+    GeoPoint* points = malloc((total > 0 ? total : 1) * sizeof(GeoPoint));
+    if (points == NULL) return false;
+
+    int n = 0;
+    for (int i = 0; i < count; i++) {
+        GeoLevel* l = &index->levels[i];
+        for (int j = 0; j < l->size; j++) {
+            if (l->points[j].dead) index->numDead--;
+            else points[n++] = l->points[j];
+        }
+        free(l->points);
+        l->points = NULL;
+        l->size = 0;
+    }
+    memcpy(points + n, index->buffer, index->bufferSize * sizeof(GeoPoint));
+    n += index->bufferSize;
+    index->bufferSize = 0;
+    if (n > 0) setLevel(index, level, points, n);
+    else free(points);
+    return true;
+}
+
+// ---------- Helper function: flushBuffer ----------
+// Merges the full buffer with the run of non-empty levels from 0 into the first empty
+// one, like carrying in a binary counter, so each point is rebuilt O(log n) times.
+static bool flushBuffer(GeoIndex* index) {
+    int level = 0;
+    while (level < GEO_LEVELS - 1 && index->levels[level].size > 0) level++;
+    return mergeLevels(index, level + 1, level);
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(GeoIndex* index, int docId) {
+    if (docId < index->docCap) return true;
+    int cap = docCapFor(index->docCap, docId);
+    signed char* biggerLevels = realloc(index->slotLevel, cap * sizeof(signed char));
+    if (biggerLevels == NULL) return false;
+    index->slotLevel = biggerLevels;
+    int* biggerPos = realloc(index->slotPos, cap * sizeof(int));
+    if (biggerPos == NULL) return false;
+    index->slotPos = biggerPos;
+    for (int i = index->docCap; i < cap; i++) index->slotLevel[i] = SLOT_NONE;
+    index->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: cardLocation ----------
+static bool cardLocation(const Card* card, double* lat, double* lon) {
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "GEO") == 0 && parseGeo(prop, lat, lon)) return true;
+    }
+    return false;
+}
+
+// ---------- Helper function: geoWork ----------
+static void geoWork(int docId, int thread, void* ctx) {
+    GeoJob* job = (GeoJob*)ctx;
+    const Card* card = job->corpus->cards[docId];
+    GeoPoint* p = &job->points[docId];
+    job->found[docId] = card != NULL && cardLocation(card, &p->lat, &p->lon);
+    p->docId = docId;
+    p->dead = false;
+}
+
+// ---------- Helper function: rootCell ----------
+static GeoCell rootCell(const GeoLevel* level) {
+    GeoCell c = { 0, level->size, 0, -90, 90, -180, 180 };
+    return c;
+}
+
+// ---------- Helper function: compareMatches ----------
+static int compareMatches(const void* first, const void* second) {
+    const GeoMatch* a = (const GeoMatch*)first;
+    const GeoMatch* b = (const GeoMatch*)second;
+    if (a->distanceKm != b->distanceKm) return a->distanceKm < b->distanceKm ? -1 : 1;
+    return (a->docId > b->docId) - (a->docId < b->docId);
+}
+
+// ---------- Helper function: compareInts ----------
+static int compareInts(const void* first, const void* second) {
+    int a = *(const int*)first, b = *(const int*)second;
+    return (a > b) - (a < b);
+}
+
+typedef struct matchList {
+    GeoMatch* matches;
+    int       count;
+    int       cap;
+    bool      failed;
+} MatchList;
+
+// ---------- Helper function: pushMatch ----------
+static void pushMatch(MatchList* list, const GeoPoint* p, double h) {
+    if (list->count == list->cap) {
+        int cap = list->cap > 0 ? list->cap * 2 : 64;
+        GeoMatch* bigger = realloc(list->matches, cap * sizeof(GeoMatch));
+        if (bigger == NULL) {
+            list->failed = true;
+            return;
+        }
+        list->matches = bigger;
+        list->cap = cap;
+    }
+    GeoMatch* m = &list->matches[list->count++];
+    m->docId = p->docId;
+    m->lat = p->lat;
+    m->lon = p->lon;
+    m->distanceKm = h;
+}
+
+// ---------- Helper function: radiusSearch ----------
+static void radiusSearch(const GeoPoint* tree, const GeoQuery* q, double limit, const GeoCell* c, MatchList* list) {
+    if (c->lo >= c->hi || cellHav(q, c) > limit) return;
+    int mid = (c->lo + c->hi) / 2;
+    const GeoPoint* p = &tree[mid];
+    if (!p->dead) {
+        double h = pointHav(q, p->lat, p->lon);
+        if (h <= limit) pushMatch(list, p, h);
+    }
+    GeoCell left, right;
+    splitCell(tree, c, &left, &right);
+    radiusSearch(tree, q, limit, &left, list);
+    radiusSearch(tree, q, limit, &right, list);
+}
+
+// ---------- Helper function: inBox ----------
+static bool inBox(const GeoPoint* p, double south, double west, double north, double east) {
+    if (p->lat < south || p->lat > north) return false;
+    return west <= east ? (p->lon >= west && p->lon <= east) : (p->lon >= west || p->lon <= east);
+}
+
+// ---------- Helper function: boxSearch ----------
+// Appends the documents in a box that does not cross the 180th meridian.
+static void boxSearch(const GeoPoint* tree, double south, double west, double north, double east,
+                      const GeoCell* c, MatchList* list) {
+    if (c->lo >= c->hi || c->north < south || c->south > north || c->east < west || c->west > east) return;
+    int mid = (c->lo + c->hi) / 2;
+    const GeoPoint* p = &tree[mid];
+    if (!p->dead && inBox(p, south, west, north, east)) pushMatch(list, p, 0);
+    GeoCell left, right;
+    splitCell(tree, c, &left, &right);
+    boxSearch(tree, south, west, north, east, &left, list);
+    boxSearch(tree, south, west, north, east, &right, list);
+}
+
+// A bounded max-heap of the nearest points found so far, by haversine
+typedef struct nearHeap {
+    GeoMatch* items;
+    int       count;
+    int       k;
+} NearHeap;
+
+// ---------- Helper function: heapOffer ----------
+static void heapOffer(NearHeap* heap, const GeoPoint* p, double h) {
+    GeoMatch m = { p->docId, p->lat, p->lon, h };
+    int i;
+    if (heap->count < heap->k) {
+        // Sift up
+        i = heap->count++;
+        while (i > 0 && heap->items[(i - 1) / 2].distanceKm < h) {
+            heap->items[i] = heap->items[(i - 1) / 2];
+            i = (i - 1) / 2;
+        }
+        heap->items[i] = m;
+        return;
+    }
+    if (h >= heap->items[0].distanceKm) return;
+
+    // Replace the farthest, then sift down
+    i = 0;
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= heap->count) break;
+        if (child + 1 < heap->count && heap->items[child + 1].distanceKm > heap->items[child].distanceKm) child++;
+        if (heap->items[child].distanceKm <= h) break;
+        heap->items[i] = heap->items[child];
+        i = child;
+    }
+    heap->items[i] = m;
+}
+
+// ---------- Helper function: nearestSearch ----------
+static void nearestSearch(const GeoPoint* tree, const GeoQuery* q, const GeoCell* c, NearHeap* heap) {
+    if (c->lo >= c->hi) return;
+    if (heap->count == heap->k && cellHav(q, c) >= heap->items[0].distanceKm) return;
+    int mid = (c->lo + c->hi) / 2;
+    const GeoPoint* p = &tree[mid];
+    if (!p->dead) heapOffer(heap, p, pointHav(q, p->lat, p->lon));
+
+    // Visit the side of the split holding the query first, to tighten the bound sooner.
+    GeoCell left, right;
+    splitCell(tree, c, &left, &right);
+    bool leftFirst = (c->depth % 2 == 0 ? q->lat : q->lon) < coord(p, c->depth);
+    nearestSearch(tree, q, leftFirst ? &left : &right, heap);
+    nearestSearch(tree, q, leftFirst ? &right : &left, heap);
+}
+
+// ---------- Helper function: makeQuery ----------
+static GeoQuery makeQuery(double lat, double lon) {
+    GeoQuery q = { lat, lon, cos(lat * DEG_TO_RAD) };
+    return q;
+}
+
+// ---------- parseGeo ----------
+bool parseGeo(const Property* prop, double* lat, double* lon) {
+    if (prop == NULL || lat == NULL || lon == NULL) return false;
+    const char* first = getFromFront(prop->values);
+    if (first == NULL) return false;
+
+    char* end;
+    double la, lo;
+    while (*first == ' ') first++;
+    if (strncasecmp(first, "geo:", 4) == 0) {
+        // geo:lat,lon[,alt][;params]
+        la = strtod(first + 4, &end);
+        if (end == first + 4 || *end != ',') return false;
+        const char* start = end + 1;
+        lo = strtod(start, &end);
+        if (end == start || (*end != '\0' && *end != ',' && *end != ';' && *end != ' ')) return false;
+    } else {
+        // vCard 3.0: latitude and longitude as separate values
+        la = strtod(first, &end);
+        if (end == first || (*end != '\0' && *end != ' ')) return false;
+        const char* second = getLength(prop->values) > 1 ? getFromBack(prop->values) : NULL;
+        if (second == NULL) return false;
+        lo = strtod(second, &end);
+        if (end == second || (*end != '\0' && *end != ' ')) return false;
+    }
+    if (!(la >= -90 && la <= 90 && lo >= -180 && lo <= 180)) return false;
+    *lat = la;
+    *lon = lo;
+    return true;
+}
+
+// ---------- geoDistance ----------
+double geoDistance(double lat1, double lon1, double lat2, double lon2) {
+    GeoQuery q = makeQuery(lat1, lon1);
+    return havToKm(pointHav(&q, lat2, lon2));
+}
+
+// ---------- createGeoIndex ----------
+GeoIndex* createGeoIndex(void) {
+    return calloc(1, sizeof(GeoIndex));
+}
+
+// ---------- buildGeoIndex ----------
+GeoIndex* buildGeoIndex(const CardCorpus* corpus, int numThreads) {
+    if (corpus == NULL) return NULL;
+    GeoIndex* index = createGeoIndex();
+    if (index == NULL) return NULL;
+
+    int count = corpus->count;
+    GeoJob job = { corpus, malloc((count > 0 ? count : 1) * sizeof(GeoPoint)),
+                   calloc(count > 0 ? count : 1, sizeof(bool)) };
+    bool ok = job.points != NULL && job.found != NULL && reserveDoc(index, count) &&
+              runParallel(count, numThreads, geoWork, &job) == OK;
+    if (ok) {
+        // Compact the cards with a location in place, then build one tree over them.
+        int n = 0;
+        for (int i = 0; i < count; i++) {
+            if (job.found[i]) job.points[n++] = job.points[i];
+        }
+        if (n > 0) {
+            setLevel(index, levelFor(n), job.points, n);
+            job.points = NULL;
+        }
+        index->size = n;
+    }
+    free(job.points);
+    free(job.found);
+    if (!ok) {
+        deleteGeoIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- geoIndexAddCard ----------
+VCardErrorCode geoIndexAddCard(GeoIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    double lat, lon;
+    if (!cardLocation(card, &lat, &lon)) {
+        geoIndexRemoveCard(index, docId);
+        return OK;
+    }
+    if (!reserveDoc(index, docId)) return OTHER_ERROR;
+    if (index->buffer == NULL) {
+        index->buffer = malloc(GEO_BUFFER_MIN * sizeof(GeoPoint));
+        if (index->buffer == NULL) return OTHER_ERROR;
+    }
+    if (index->bufferSize == GEO_BUFFER_MIN && !flushBuffer(index)) return OTHER_ERROR;
+    geoIndexRemoveCard(index, docId);
+
+    GeoPoint* p = &index->buffer[index->bufferSize];
+    p->lat = lat;
+    p->lon = lon;
+    p->docId = docId;
+    p->dead = false;
+    index->slotLevel[docId] = SLOT_BUFFER;
+    index->slotPos[docId] = index->bufferSize;
+    index->bufferSize++;
+    index->size++;
+    return OK;
+}
+
+// ---------- geoIndexRemoveCard ----------
+void geoIndexRemoveCard(GeoIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    int level = index->slotLevel[docId];
+    int pos = index->slotPos[docId];
+    if (level == SLOT_NONE) return;
+
+    if (level >= 0) {
+        index->levels[level].points[pos].dead = true;
+        index->numDead++;
+    } else {
+        // Move the last buffered point into the gap
+        index->buffer[pos] = index->buffer[--index->bufferSize];
+        if (pos < index->bufferSize) index->slotPos[index->buffer[pos].docId] = pos;
+    }
+    index->slotLevel[docId] = SLOT_NONE;
+    index->size--;
+
+    // Once removed points outnumber half the live ones, merge everything into one tree.
+    // A failed merge leaves the levels as they were, where the points are still skipped.
+    if (index->numDead > GEO_BUFFER_MIN + index->size / 2) {
+        mergeLevels(index, GEO_LEVELS, levelFor(index->size));
+    }
+}
+
+// ---------- geoRadius ----------
+int geoRadius(const GeoIndex* index, double lat, double lon, double radiusKm, GeoMatch* out, int maxResults) {
+    if (index == NULL || out == NULL || maxResults <= 0 || radiusKm < 0) return 0;
+    GeoQuery q = makeQuery(lat, lon);
+    double angle = radiusKm / GEO_EARTH_RADIUS_KM;
+    double limit = angle >= M_PI ? 1 : hav(angle);
+
+    MatchList list = { NULL, 0, 0, false };
+    for (int i = 0; i < GEO_LEVELS; i++) {
+        const GeoLevel* level = &index->levels[i];
+        if (level->size == 0) continue;
+        GeoCell root = rootCell(level);
+        radiusSearch(level->points, &q, limit, &root, &list);
+    }
+    for (int i = 0; i < index->bufferSize; i++) {
+        double h = pointHav(&q, index->buffer[i].lat, index->buffer[i].lon);
+        if (h <= limit) pushMatch(&list, &index->buffer[i], h);
+    }
+
+    if (list.failed) {
+        free(list.matches);
+        return -1;
+    }
+
+    // Ordering by haversine is ordering by distance.
+    if (list.count > 0) qsort(list.matches, list.count, sizeof(GeoMatch), compareMatches);
+    int n = list.count < maxResults ? list.count : maxResults;
+    for (int i = 0; i < n; i++) {
+        out[i] = list.matches[i];
+        out[i].distanceKm = havToKm(out[i].distanceKm);
+    }
+    free(list.matches);
+    return n;
+}
+
+// ---------- geoBox ----------
+int geoBox(const GeoIndex* index, double south, double west, double north, double east, int* out, int maxResults) {
+    if (index == NULL || out == NULL || maxResults <= 0 || south > north) return 0;
+    MatchList list = { NULL, 0, 0, false };
+    for (int i = 0; i < GEO_LEVELS; i++) {
+        const GeoLevel* level = &index->levels[i];
+        if (level->size == 0) continue;
+        GeoCell root = rootCell(level);
+        if (west <= east) {
+            boxSearch(level->points, south, west, north, east, &root, &list);
+        } else {
+            boxSearch(level->points, south, west, north, 180, &root, &list);
+            boxSearch(level->points, south, -180, north, east, &root, &list);
+        }
+    }
+    for (int i = 0; i < index->bufferSize; i++) {
+        if (inBox(&index->buffer[i], south, west, north, east)) pushMatch(&list, &index->buffer[i], 0);
+    }
+
+    if (list.failed) {
+        free(list.matches);
+        return -1;
+    }
+    if (list.count == 0) return 0;
+
+    int* ids = malloc(list.count * sizeof(int));
+    if (ids == NULL) {
+        free(list.matches);
+        return -1;
+    }
+    for (int i = 0; i < list.count; i++) ids[i] = list.matches[i].docId;
+    qsort(ids, list.count, sizeof(int), compareInts);
+
+    // A point on the 180th meridian is in both halves of a crossing box.
+    int n = 0;
+    for (int i = 0; i < list.count && n < maxResults; i++) {
+        if (n == 0 || ids[i] != out[n - 1]) out[n++] = ids[i];
+    }
+    free(ids);
+    free(list.matches);
+    return n;
+}
+
+// ---------- geoNearest ----------
+int geoNearest(const GeoIndex* index, double lat, double lon, int k, GeoMatch* out) {
+    if (index == NULL || out == NULL || k <= 0) return 0;
+    GeoQuery q = makeQuery(lat, lon);
+    NearHeap heap = { out, 0, k };
+
+    // The largest tree first: its points bound the search of the smaller ones best.
+    for (int i = GEO_LEVELS - 1; i >= 0; i--) {
+        const GeoLevel* level = &index->levels[i];
+        if (level->size == 0) continue;
+        GeoCell root = rootCell(level);
+        nearestSearch(level->points, &q, &root, &heap);
+    }
+    for (int i = 0; i < index->bufferSize; i++) {
+        heapOffer(&heap, &index->buffer[i], pointHav(&q, index->buffer[i].lat, index->buffer[i].lon));
+    }
+
+    if (heap.count > 0) qsort(out, heap.count, sizeof(GeoMatch), compareMatches);
+    for (int i = 0; i < heap.count; i++) out[i].distanceKm = havToKm(out[i].distanceKm);
+    return heap.count;
+}
+
+// ---------- geoIndexSize ----------
+int geoIndexSize(const GeoIndex* index) {
+    return index != NULL ? index->size : 0;
+}
+
+// ---------- deleteGeoIndex ----------
+void deleteGeoIndex(GeoIndex* index) {
+    if (index == NULL) return;
+    for (int i = 0; i < GEO_LEVELS; i++) free(index->levels[i].points);
+    free(index->buffer);
+    free(index->slotLevel);
+    free(index->slotPos);
+    free(index);
+}
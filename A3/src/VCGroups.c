@@ -0,0 +1,380 @@
+// VCGroups.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Per-card hash of property groups, and a corpus index of groups by label.
+
+#include "VCGroups.h"
+#include "VCDocTable.h"
+#include <ctype.h>
+#include <stdint.h>
+#include <strings.h>
+
+typedef struct labelRef {
+    int docId;
+    int group;
+} LabelRef;
+
+typedef struct labelEntry {
+    // Label as first seen (compared ignoring case), NULL for an empty slot
+    char*     key;
+
+    // Groups with this label, ordered by document id
+    LabelRef* refs;
+    int       count;
+    int       cap;
+} LabelEntry;
+
+struct groupIndex {
+    // Groups of each document, NULL if it has not been added
+    CardGroups** docs;
+    int          docCap;
+
+    // Open-addressing hash table of labels
+    LabelEntry*  labels;
+    int          numLabels;
+    int          labelCap;
+};
+
+// ---------- Helper function: unwrapLabel ----------
+// Copies a label without Apple's _$!<...>!$_ wrapper.
+static char* unwrapLabel(const char* value) {
+    size_t len = strlen(value);
+    if (len >= 8 && strncmp(value, "_$!<", 4) == 0 && strcmp(value + len - 4, ">!$_") == 0) {
+        value += 4;
+        len -= 8;
+    }
+    char* label = malloc(len + 1);
+    if (label == NULL) return NULL;
+    memcpy(label, value, len);
+    label[len] = '\0';
+    return label;
+}
+
+// ---------- Helper function: growSlots ----------
+static bool growSlots(CardGroups* groups) {
+    int numSlots = groups->numSlots > 0 ? groups->numSlots * 2 : 8;
+    int* slots = malloc(numSlots * sizeof(int));
+    if (slots == NULL) return false;
+    for (int i = 0; i < numSlots; i++) slots[i] = -1;
+    for (int g = 0; g < groups->count; g++) {
+        uint32_t s = fnvHashFolded(groups->groups[g].name) & (numSlots - 1);
+        while (slots[s] != -1) s = (s + 1) & (numSlots - 1);
+        slots[s] = g;
+    }
+    free(groups->slots);
+    groups->slots = slots;
+    groups->numSlots = numSlots;
+    return true;
+}
+
+// ---------- Helper function: findSlot ----------
+// Returns the slot holding the group, or the empty slot where it would go.
+static uint32_t findSlot(const CardGroups* groups, const char* name) {
+    uint32_t s = fnvHashFolded(name) & (groups->numSlots - 1);
+    while (groups->slots[s] != -1 && strcasecmp(groups->groups[groups->slots[s]].name, name) != 0) {
+        s = (s + 1) & (groups->numSlots - 1);
+    }
+    return s;
+}
+
+// ---------- createCardGroups ----------
+CardGroups* createCardGroups(void) {
+    return calloc(1, sizeof(CardGroups));
+}
+
+// ---------- cardGroupsAdd ----------
+VCardErrorCode cardGroupsAdd(CardGroups* groups, Property* prop) {
+    if (groups == NULL || prop == NULL) return OTHER_ERROR;
+    if (prop->group == NULL || prop->group[0] == '\0') return OK;
+
+    // Keep the table at most half full.
+    if (2 * (groups->count + 1) > groups->numSlots && !growSlots(groups)) return OTHER_ERROR;
+    uint32_t s = findSlot(groups, prop->group);
+
+    if (groups->slots[s] == -1) {
+        if (groups->count == groups->cap) {
+            int cap = groups->cap > 0 ? groups->cap * 2 : 4;
+            PropertyGroup* bigger = realloc(groups->groups, cap * sizeof(PropertyGroup));
+            if (bigger == NULL) return OTHER_ERROR;
+            groups->groups = bigger;
+            groups->cap = cap;
+        }
+        PropertyGroup* group = &groups->groups[groups->count];
+        memset(group, 0, sizeof(PropertyGroup));
+        group->name = malloc(strlen(prop->group) + 1);
+        if (group->name == NULL) return OTHER_ERROR;
+        strcpy(group->name, prop->group);
+        groups->slots[s] = groups->count++;
+    }
+
+    PropertyGroup* group = &groups->groups[groups->slots[s]];
+    if (group->count == group->cap) {
+        int cap = group->cap > 0 ? group->cap * 2 : 2;
+        Property** bigger = realloc(group->props, cap * sizeof(Property*));
+        if (bigger == NULL) return OTHER_ERROR;
+        group->props = bigger;
+        group->cap = cap;
+    }
+    group->props[group->count++] = prop;
+
+    if (group->label == NULL && strcasecmp(prop->name, "X-ABLABEL") == 0) {
+        const char* value = prop->values != NULL ? getFromFront(prop->values) : NULL;
+        if (value != NULL) {
+            group->label = unwrapLabel(value);
+            if (group->label == NULL) return OTHER_ERROR;
+        }
+    }
+    return OK;
+}
+
+// ---------- indexCardGroups ----------
+CardGroups* indexCardGroups(const Card* card) {
+    if (card == NULL) return NULL;
+    CardGroups* groups = createCardGroups();
+    if (groups == NULL) return NULL;
+
+    bool ok = card->fn == NULL || cardGroupsAdd(groups, card->fn) == OK;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        ok = cardGroupsAdd(groups, prop) == OK;
+    }
+    if (!ok) {
+        deleteCardGroups(groups);
+        return NULL;
+    }
+    return groups;
+}
+
+// ---------- findGroup ----------
+const PropertyGroup* findGroup(const CardGroups* groups, const char* name) {
+    if (groups == NULL || name == NULL || groups->numSlots == 0) return NULL;
+    uint32_t s = findSlot(groups, name);
+    return groups->slots[s] != -1 ? &groups->groups[groups->slots[s]] : NULL;
+}
+
+// ---------- groupProperty ----------
+Property* groupProperty(const PropertyGroup* group, const char* propName) {
+    if (group == NULL || propName == NULL) return NULL;
+    for (int i = 0; i < group->count; i++) {
+        if (strcasecmp(group->props[i]->name, propName) == 0) return group->props[i];
+    }
+    return NULL;
+}
+
+// ---------- deleteCardGroups ----------
+void deleteCardGroups(CardGroups* groups) {
+    if (groups == NULL) return;
+    for (int g = 0; g < groups->count; g++) {
+        free(groups->groups[g].name);
+        free(groups->groups[g].label);
+        free(groups->groups[g].props);
+    }
+    free(groups->groups);
+    free(groups->slots);
+    free(groups);
+}
+
+// ---------- Helper function: findLabel ----------
+// Returns the slot holding the label, or the empty slot where it would go.
+static int findLabel(const GroupIndex* index, const char* label) {
+    int s = fnvHashFolded(label) & (index->labelCap - 1);
+    while (index->labels[s].key != NULL && strcasecmp(index->labels[s].key, label) != 0) {
+        s = (s + 1) & (index->labelCap - 1);
+    }
+    return s;
+}
+
+// ---------- Helper function: growLabels ----------
+static bool growLabels(GroupIndex* index) {
+    int cap = index->labelCap > 0 ? index->labelCap * 2 : 64;
+    LabelEntry* labels = calloc(cap, sizeof(LabelEntry));
+    if (labels == NULL) return false;
+    for (int i = 0; i < index->labelCap; i++) {
+        if (index->labels[i].key == NULL) continue;
+        int s = fnvHashFolded(index->labels[i].key) & (cap - 1);
+        while (labels[s].key != NULL) s = (s + 1) & (cap - 1);
+        labels[s] = index->labels[i];
+    }
+    free(index->labels);
+    index->labels = labels;
+    index->labelCap = cap;
+    return true;
+}
+
+// ---------- Helper function: addLabelRef ----------
+static bool addLabelRef(GroupIndex* index, const char* label, int docId, int group) {
+    if (2 * (index->numLabels + 1) > index->labelCap && !growLabels(index)) return false;
+    LabelEntry* entry = &index->labels[findLabel(index, label)];
+    if (entry->key == NULL) {
+        entry->key = malloc(strlen(label) + 1);
+        if (entry->key == NULL) return false;
+        strcpy(entry->key, label);
+        index->numLabels++;
+    }
+    if (entry->count == entry->cap) {
+        int cap = entry->cap > 0 ? entry->cap * 2 : 4;
+        LabelRef* bigger = realloc(entry->refs, cap * sizeof(LabelRef));
+        if (bigger == NULL) return false;
+        entry->refs = bigger;
+        entry->cap = cap;
+    }
+
+    // Cards are usually added in document order, so this is normally an append.
+    int at = entry->count;
+    while (at > 0 && entry->refs[at - 1].docId > docId) at--;
+    memmove(entry->refs + at + 1, entry->refs + at, (entry->count - at) * sizeof(LabelRef));
+    entry->refs[at].docId = docId;
+    entry->refs[at].group = group;
+    entry->count++;
+    return true;
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(GroupIndex* index, int docId) {
+    if (docId < index->docCap) return true;
+    int cap = docCapFor(index->docCap, docId);
+    CardGroups** bigger = realloc(index->docs, cap * sizeof(CardGroups*));
+    if (bigger == NULL) return false;
+    for (int i = index->docCap; i < cap; i++) bigger[i] = NULL;
+    index->docs = bigger;
+    index->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: attachGroups ----------
+// Takes ownership of the groups of a document and indexes their labels.
+static VCardErrorCode attachGroups(GroupIndex* index, CardGroups* groups, int docId) {
+    if (!reserveDoc(index, docId)) {
+        deleteCardGroups(groups);
+        return OTHER_ERROR;
+    }
+    groupIndexRemoveCard(index, docId);
+    index->docs[docId] = groups;
+    for (int g = 0; g < groups->count; g++) {
+        if (groups->groups[g].label != NULL && !addLabelRef(index, groups->groups[g].label, docId, g)) {
+            return OTHER_ERROR;
+        }
+    }
+    return OK;
+}
+
+// ---------- createGroupIndex ----------
+GroupIndex* createGroupIndex(void) {
+    GroupIndex* index = calloc(1, sizeof(GroupIndex));
+    if (index == NULL) return NULL;
+    if (!growLabels(index)) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+typedef struct groupJob {
+    const CardCorpus* corpus;
+    CardGroups**      groups;
+} GroupJob;
+
+// ---------- Helper function: groupWork ----------
+static void groupWork(int docId, int thread, void* ctx) {
+    GroupJob* job = (GroupJob*)ctx;
+    const Card* card = job->corpus->cards[docId];
+    if (card != NULL) job->groups[docId] = indexCardGroups(card);
+}
+
+// ---------- buildGroupIndex ----------
+GroupIndex* buildGroupIndex(const CardCorpus* corpus, int numThreads) {
+    if (corpus == NULL) return NULL;
+    GroupIndex* index = createGroupIndex();
+    if (index == NULL) return NULL;
+
+    GroupJob job = { corpus, calloc(corpus->count > 0 ? corpus->count : 1, sizeof(CardGroups*)) };
+    bool ok = job.groups != NULL && reserveDoc(index, corpus->count) &&
+              runParallel(corpus->count, numThreads, groupWork, &job) == OK;
+
+    // Labels are indexed on one thread, in document order.  A card without groups
+    // means indexCardGroups ran out of memory.
+    for (int i = 0; job.groups != NULL && i < corpus->count; i++) {
+        if (job.groups[i] == NULL) {
+            if (corpus->cards[i] != NULL) ok = false;
+            continue;
+        }
+        if (!ok) deleteCardGroups(job.groups[i]);
+        else ok = attachGroups(index, job.groups[i], i) == OK;
+    }
+    free(job.groups);
+    if (!ok) {
+        deleteGroupIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- groupIndexAddCard ----------
+VCardErrorCode groupIndexAddCard(GroupIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    CardGroups* groups = indexCardGroups(card);
+    if (groups == NULL) return OTHER_ERROR;
+    return attachGroups(index, groups, docId);
+}
+
+// ---------- groupIndexRemoveCard ----------
+void groupIndexRemoveCard(GroupIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap || index->docs[docId] == NULL) return;
+
+    CardGroups* groups = index->docs[docId];
+    for (int g = 0; g < groups->count; g++) {
+        if (groups->groups[g].label == NULL) continue;
+        LabelEntry* entry = &index->labels[findLabel(index, groups->groups[g].label)];
+        if (entry->key == NULL) continue;
+
+        int lo = 0, hi = entry->count;
+        while (lo < hi) {
+            int mid = (lo + hi) / 2;
+            if (entry->refs[mid].docId < docId) lo = mid + 1;
+            else hi = mid;
+        }
+        int end = lo;
+        while (end < entry->count && entry->refs[end].docId == docId) end++;
+        memmove(entry->refs + lo, entry->refs + end, (entry->count - end) * sizeof(LabelRef));
+        entry->count -= end - lo;
+    }
+    deleteCardGroups(groups);
+    index->docs[docId] = NULL;
+}
+
+// ---------- groupIndexCard ----------
+const CardGroups* groupIndexCard(const GroupIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return NULL;
+    return index->docs[docId];
+}
+
+// ---------- groupIndexLabel ----------
+int groupIndexLabel(const GroupIndex* index, const char* label, GroupMatch* out, int maxResults) {
+    if (index == NULL || label == NULL || out == NULL || maxResults <= 0) return 0;
+    char* key = unwrapLabel(label);
+    if (key == NULL) return 0;
+    const LabelEntry* entry = &index->labels[findLabel(index, key)];
+    free(key);
+
+    int n = 0;
+    for (int i = 0; i < entry->count && n < maxResults; i++) {
+        const LabelRef* ref = &entry->refs[i];
+        out[n].docId = ref->docId;
+        out[n].group = &index->docs[ref->docId]->groups[ref->group];
+        n++;
+    }
+    return n;
+}
+
+// ---------- deleteGroupIndex ----------
+void deleteGroupIndex(GroupIndex* index) {
+    if (index == NULL) return;
+    for (int i = 0; i < index->docCap; i++) deleteCardGroups(index->docs[i]);
+    for (int i = 0; i < index->labelCap; i++) {
+        free(index->labels[i].key);
+        free(index->labels[i].refs);
+    }
+    free(index->docs);
+    free(index->labels);
+    free(index);
+}
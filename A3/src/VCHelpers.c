@@ -3,6 +3,7 @@
 // Description: Implementation of helper functions for the vCard parser.
 
 #include "VCParser.h"
+#include "VCDates.h"
 #include "LinkedListAPI.h"
 #include <stdlib.h>
 #include <stdio.h>
@@ -107,9 +108,27 @@ void deleteDate(void* toBeDeleted) {
 }
 
 // ---------- compareDates ----------
-// For now, always return 0 (stub)
+// Orders dates chronologically by year, month, day and then time; a missing part sorts
+// first, so --0203 comes before 1954-02-03.  Text values sort after dates, by text.
 int compareDates(const void* first, const void* second) {
-    return 0;
+    const DateTime* a = (const DateTime*)first;
+    const DateTime* b = (const DateTime*)second;
+    if (a == NULL || b == NULL) return (a != NULL) - (b != NULL);
+    if (a->isText || b->isText) {
+        if (a->isText != b->isText) return a->isText ? 1 : -1;
+        return strcmp(a->text ? a->text : "", b->text ? b->text : "");
+    }
+
+    DateParts pa, pb;
+    if (dateToParts(a, &pa) == OK && dateToParts(b, &pb) == OK) {
+        if (pa.year != pb.year) return pa.year < pb.year ? -1 : 1;
+        if (pa.month != pb.month) return pa.month < pb.month ? -1 : 1;
+        if (pa.day != pb.day) return pa.day < pb.day ? -1 : 1;
+    } else {
+        int c = strcmp(a->date ? a->date : "", b->date ? b->date : "");
+        if (c != 0) return c;
+    }
+    return strcmp(a->time ? a->time : "", b->time ? b->time : "");
 }
 
 // ---------- dateToString ----------
@@ -0,0 +1,359 @@
+// VCNameIndex.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Compressed (radix) trie over case-folded FN values with prefix lookup.
+
+#include "VCNameIndex.h"
+#include "VCText.h"
+#include <strings.h>
+
+// A node owns the edge label leading to it from its parent.  Children are kept
+// sorted by the first byte of their label, so a depth-first walk visits names in order.
+typedef struct trieNode {
+    char*             label;
+    int               labelLen;
+    struct trieNode** children;
+    int               numChildren;
+    int               childCap;
+
+    // Ids of the documents whose name ends at this node, sorted ascending.
+    int*              docIds;
+    int               numDocs;
+    int               docCap;
+} TrieNode;
+
+struct nameIndex {
+    TrieNode* root;
+    int       size;
+};
+
+// ---------- Helper function: newNode ----------
+static TrieNode* newNode(const char* label, int labelLen) {
+    TrieNode* node = calloc(1, sizeof(TrieNode));
+    if (node == NULL) return NULL;
+    node->label = malloc(labelLen > 0 ? labelLen : 1);
+    if (node->label == NULL) {
+        free(node);
+        return NULL;
+    }
+    memcpy(node->label, label, labelLen);
+    node->labelLen = labelLen;
+    return node;
+}
+
+// ---------- Helper function: freeNode ----------
+static void freeNode(TrieNode* node) {
+    if (node == NULL) return;
+    for (int i = 0; i < node->numChildren; i++) freeNode(node->children[i]);
+    free(node->children);
+    free(node->docIds);
+    free(node->label);
+    free(node);
+}
+
+// ---------- Helper function: findChild ----------
+// Binary search on the first label byte.  Returns the position of the child, or
+// -(insertion point) - 1 if there is none.
+static int findChild(const TrieNode* node, unsigned char c) {
+    int lo = 0, hi = node->numChildren - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        unsigned char m = (unsigned char)node->children[mid]->label[0];
+        if (m == c) return mid;
+        if (m < c) lo = mid + 1;
+        else hi = mid - 1;
+    }
+    return -lo - 1;
+}
+
+// ---------- Helper function: insertChild ----------
+static bool insertChild(TrieNode* node, int at, TrieNode* child) {
+    if (node->numChildren == node->childCap) {
+        int cap = node->childCap > 0 ? node->childCap * 2 : 2;
+        TrieNode** bigger = realloc(node->children, cap * sizeof(TrieNode*));
+        if (bigger == NULL) return false;
+        node->children = bigger;
+        node->childCap = cap;
+    }
+    memmove(node->children + at + 1, node->children + at, (node->numChildren - at) * sizeof(TrieNode*));
+    node->children[at] = child;
+    node->numChildren++;
+    return true;
+}
+
+// ---------- Helper function: removeChild ----------
+static void removeChild(TrieNode* node, int at) {
+    memmove(node->children + at, node->children + at + 1, (node->numChildren - at - 1) * sizeof(TrieNode*));
+    node->numChildren--;
+}
+
+// ---------- Helper function: addDoc ----------
+// Returns 1 if added, 0 if it was already there, -1 if malloc fails.
+static int addDoc(TrieNode* node, int docId) {
+    int lo = 0, hi = node->numDocs;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (node->docIds[mid] < docId) lo = mid + 1;
+        else hi = mid;
+    }
+    if (lo < node->numDocs && node->docIds[lo] == docId) return 0;
+
+    if (node->numDocs == node->docCap) {
+        int cap = node->docCap > 0 ? node->docCap * 2 : 1;
+        int* bigger = realloc(node->docIds, cap * sizeof(int));
+        if (bigger == NULL) return -1;
+        node->docIds = bigger;
+        node->docCap = cap;
+    }
+    memmove(node->docIds + lo + 1, node->docIds + lo, (node->numDocs - lo) * sizeof(int));
+    node->docIds[lo] = docId;
+    node->numDocs++;
+    return 1;
+}
+
+// ---------- Helper function: removeDoc ----------
+static bool removeDoc(TrieNode* node, int docId) {
+    for (int i = 0; i < node->numDocs; i++) {
+        if (node->docIds[i] == docId) {
+            memmove(node->docIds + i, node->docIds + i + 1, (node->numDocs - i - 1) * sizeof(int));
+            node->numDocs--;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------- Helper function: commonPrefix ----------
+static int commonPrefix(const char* a, int aLen, const char* b, int bLen) {
+    int n = 0;
+    while (n < aLen && n < bLen && a[n] == b[n]) n++;
+    return n;
+}
+
+// ---------- Helper function: splitChild ----------
+// Splits the edge to node->children[at] after len bytes and returns the new middle node.
+static TrieNode* splitChild(TrieNode* node, int at, int len) {
+    TrieNode* child = node->children[at];
+    TrieNode* mid = newNode(child->label, len);
+    if (mid == NULL) return NULL;
+
+    char* rest = malloc(child->labelLen - len);
+    if (rest == NULL || !insertChild(mid, 0, child)) {
+        free(rest);
+        freeNode(mid);
+        return NULL;
+    }
+    memcpy(rest, child->label + len, child->labelLen - len);
+    free(child->label);
+    child->label = rest;
+    child->labelLen -= len;
+    node->children[at] = mid;
+    return mid;
+}
+
+// ---------- Helper function: mergeWithChild ----------
+// Folds the only child of a node that holds no documents into the node itself.
+static void mergeWithChild(TrieNode* node) {
+    TrieNode* child = node->children[0];
+    char* label = malloc(node->labelLen + child->labelLen);
+    if (label == NULL) return;      // Leave the extra node; lookups are still correct.
+    memcpy(label, node->label, node->labelLen);
+    memcpy(label + node->labelLen, child->label, child->labelLen);
+
+    free(node->label);
+    free(node->children);
+    free(node->docIds);
+    node->label = label;
+    node->labelLen += child->labelLen;
+    node->children = child->children;
+    node->numChildren = child->numChildren;
+    node->childCap = child->childCap;
+    node->docIds = child->docIds;
+    node->numDocs = child->numDocs;
+    node->docCap = child->docCap;
+
+    free(child->label);
+    free(child);
+}
+
+// ---------- Helper function: insertKey ----------
+static int insertKey(TrieNode* node, const char* key, int len, int docId) {
+    int pos = 0;
+    while (pos < len) {
+        int at = findChild(node, (unsigned char)key[pos]);
+        if (at < 0) {
+            TrieNode* leaf = newNode(key + pos, len - pos);
+            if (leaf == NULL) return -1;
+            if (!insertChild(node, -at - 1, leaf)) {
+                freeNode(leaf);
+                return -1;
+            }
+            return addDoc(leaf, docId);
+        }
+
+        TrieNode* child = node->children[at];
+        int common = commonPrefix(child->label, child->labelLen, key + pos, len - pos);
+        if (common < child->labelLen) {
+            child = splitChild(node, at, common);
+            if (child == NULL) return -1;
+        }
+        node = child;
+        pos += common;
+    }
+    return addDoc(node, docId);
+}
+
+// ---------- Helper function: removeKey ----------
+// Removes the pair below node and tidies the path on the way back up.
+static bool removeKey(TrieNode* node, const char* key, int len, int docId) {
+    if (len == 0) return removeDoc(node, docId);
+
+    int at = findChild(node, (unsigned char)key[0]);
+    if (at < 0) return false;
+    TrieNode* child = node->children[at];
+    if (child->labelLen > len || memcmp(child->label, key, child->labelLen) != 0) return false;
+    if (!removeKey(child, key + child->labelLen, len - child->labelLen, docId)) return false;
+
+    if (child->numDocs == 0 && child->numChildren == 0) {
+        removeChild(node, at);
+        freeNode(child);
+    } else if (child->numDocs == 0 && child->numChildren == 1) {
+        mergeWithChild(child);
+    }
+    return true;
+}
+
+// ---------- Helper function: collect ----------
+// Appends the documents of a subtree in name order.  Returns the new count.
+static int collect(const TrieNode* node, int* docIds, int count, int maxResults) {
+    for (int i = 0; i < node->numDocs && count < maxResults; i++) {
+        docIds[count++] = node->docIds[i];
+    }
+    for (int i = 0; i < node->numChildren && count < maxResults; i++) {
+        count = collect(node->children[i], docIds, count, maxResults);
+    }
+    return count;
+}
+
+// ---------- Helper function: forEachName ----------
+// Calls add (nameIndexInsert) or remove (nameIndexRemove) for every FN of a card.
+static VCardErrorCode forEachName(NameIndex* index, const Card* card, int docId, bool add) {
+    VCardErrorCode result = OK;
+    const char* fn = getFromFront(card->fn->values);
+    if (fn != NULL) {
+        if (add) result = nameIndexInsert(index, fn, docId);
+        else nameIndexRemove(index, fn, docId);
+    }
+
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL && result == OK) {
+        if (strcasecmp(prop->name, "FN") != 0) continue;
+        fn = getFromFront(prop->values);
+        if (fn == NULL) continue;
+        if (add) result = nameIndexInsert(index, fn, docId);
+        else nameIndexRemove(index, fn, docId);
+    }
+    return result;
+}
+
+// ---------- createNameIndex ----------
+NameIndex* createNameIndex(void) {
+    NameIndex* index = calloc(1, sizeof(NameIndex));
+    if (index == NULL) return NULL;
+    index->root = newNode("", 0);
+    if (index->root == NULL) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildNameIndex ----------
+NameIndex* buildNameIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    NameIndex* index = createNameIndex();
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (nameIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteNameIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- nameIndexInsert ----------
+VCardErrorCode nameIndexInsert(NameIndex* index, const char* name, int docId) {
+    if (index == NULL || name == NULL) return OTHER_ERROR;
+    char* key = foldText(name);
+    if (key == NULL) return OTHER_ERROR;
+
+    int added = insertKey(index->root, key, (int)strlen(key), docId);
+    free(key);
+    if (added < 0) return OTHER_ERROR;
+    index->size += added;
+    return OK;
+}
+
+// ---------- nameIndexRemove ----------
+bool nameIndexRemove(NameIndex* index, const char* name, int docId) {
+    if (index == NULL || name == NULL) return false;
+    char* key = foldText(name);
+    if (key == NULL) return false;
+
+    bool removed = removeKey(index->root, key, (int)strlen(key), docId);
+    free(key);
+    if (removed) index->size--;
+    return removed;
+}
+
+// ---------- nameIndexAddCard ----------
+VCardErrorCode nameIndexAddCard(NameIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || card->fn == NULL) return OTHER_ERROR;
+    return forEachName(index, card, docId, true);
+}
+
+// ---------- nameIndexRemoveCard ----------
+void nameIndexRemoveCard(NameIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || card->fn == NULL) return;
+    forEachName(index, card, docId, false);
+}
+
+// ---------- nameIndexPrefix ----------
+int nameIndexPrefix(const NameIndex* index, const char* prefix, int* docIds, int maxResults) {
+    if (index == NULL || prefix == NULL || docIds == NULL || maxResults <= 0) return 0;
+    char* key = foldText(prefix);
+    if (key == NULL) return 0;
+
+    const TrieNode* node = index->root;
+    int len = (int)strlen(key);
+    int pos = 0;
+    while (pos < len) {
+        int at = findChild(node, (unsigned char)key[pos]);
+        if (at < 0) break;
+        const TrieNode* child = node->children[at];
+        int common = commonPrefix(child->label, child->labelLen, key + pos, len - pos);
+        if (common < child->labelLen && pos + common < len) break;
+        node = child;
+        pos += common;
+    }
+    free(key);
+
+    // The prefix may end part way along the last edge; everything below it still matches.
+    if (pos < len) return 0;
+    return collect(node, docIds, 0, maxResults);
+}
+
+// ---------- nameIndexSize ----------
+int nameIndexSize(const NameIndex* index) {
+    return index != NULL ? index->size : 0;
+}
+
+// ---------- deleteNameIndex ----------
+void deleteNameIndex(NameIndex* index) {
+    if (index == NULL) return;
+    freeNode(index->root);
+    free(index);
+}
@@ -4,20 +4,63 @@
 
 #include "VCParser.h"
 #include "LinkedListAPI.h"
+#include "VCProperties.h"
+#include "VCGroups.h"
 #include <ctype.h>
+#include <stdint.h>
 
 // ---------- Internal Helper Function Prototypes ----------
 static char* readFileToString(const char* fileName);
 static char* unfoldLines(const char* fileContent);
 static char* trimWhitespace(char* str);
 static Property* parseProperty(char* line, int lineNum, VCardErrorCode* err);
+static VCardErrorCode parseCard(char* fileName, Card** obj, bool validate, CardGroups* groups);
 
 // ---------- Implementation of createCard ----------
 
 VCardErrorCode createCard(char* fileName, Card** obj) {
+    return parseCard(fileName, obj, false, NULL);
+}
+
+// ---------- Implementation of createCardValidated ----------
+
+VCardErrorCode createCardValidated(char* fileName, Card** obj) {
+    return parseCard(fileName, obj, true, NULL);
+}
+
+// ---------- Implementation of createCardGrouped ----------
+
+VCardErrorCode createCardGrouped(char* fileName, Card** obj, CardGroups** groups) {
+    *groups = createCardGroups();
+    if (*groups == NULL) {
+        *obj = NULL;
+        return OTHER_ERROR;
+    }
+    VCardErrorCode err = parseCard(fileName, obj, false, *groups);
+    if (err != OK) {
+        deleteCardGroups(*groups);
+        *groups = NULL;
+    }
+    return err;
+}
+
+// ---------- Helper function: parseCard ----------
+// Parses a vCard file.  If validate is true, the checks done by validateCard are
+// applied to each property as it is parsed.  The first failure of each kind is
+// remembered and reported once the file has been parsed, in the order validateCard
+// would report it, so that parse errors still take precedence.  If groups is not NULL,
+// every grouped property kept in the card is added to it as it is read.
+static VCardErrorCode parseCard(char* fileName, Card** obj, bool validate, CardGroups* groups) {
     int lineNum = 0;
     VCardErrorCode retCode = OK;
 
+    // State for fused validation.
+    VCardErrorCode fnErr = OK, propErr = OK, bdayErr = OK, annErr = OK;
+    uint64_t seen = 0;
+    bool duplicate = false;
+    bool versionProp = false;
+    bool groupFailed = false;
+
     // Validate fileName argument.
     if (fileName == NULL || strlen(fileName) == 0) {
         *obj = NULL;
@@ -148,6 +191,12 @@ VCardErrorCode createCard(char* fileName, Card** obj) {
         if (strcmp(prop->name, "FN") == 0) {
             if (card->fn == NULL) {
                 card->fn = prop;
+                if (groups != NULL && cardGroupsAdd(groups, prop) != OK) {
+                    groupFailed = true;
+                }
+                if (validate) {
+                    fnErr = validateProperty(prop, false, NULL);
+                }
             } else {
                 deleteProperty(prop);
                 free(unfolded);
@@ -220,6 +269,9 @@ VCardErrorCode createCard(char* fileName, Card** obj) {
     }
     dt->UTC = false;  // Set UTC appropriately if needed.
     card->anniversary = dt;
+    if (validate) {
+        annErr = validateDateTime(dt);
+    }
     // Once processed, free the property structure.
     deleteProperty(prop);
 }
@@ -288,13 +340,35 @@ VCardErrorCode createCard(char* fileName, Card** obj) {
     }
     dt->UTC = false;  // Set as appropriate (for now, false)
     card->birthday = dt;
+    if (validate) {
+        bdayErr = validateDateTime(dt);
+    }
     // Once the BDAY property is processed into a DateTime, free its property structure.
     deleteProperty(prop);
 }
 
         else {
             // Other properties are added to the optional properties list.
+            // validateCard stops at the first bad optional property, so there
+            // is nothing left to check once propErr is set.
+            if (validate && propErr == OK) {
+                int id;
+                propErr = validateProperty(prop, true, &id);
+                if (propErr == OK && id >= 0 && !propertyIsRepeatable(id)) {
+                    uint64_t bit = (uint64_t)1 << id;
+                    if (seen & bit) {
+                        duplicate = true;
+                    }
+                    seen |= bit;
+                }
+                if (strcasecmp(prop->name, "VERSION") == 0) {
+                    versionProp = true;
+                }
+            }
             insertBack(card->optionalProperties, prop);
+            if (groups != NULL && cardGroupsAdd(groups, prop) != OK) {
+                groupFailed = true;
+            }
         }
         
         line = strtok_r(NULL, "\n", &saveptr);
@@ -307,6 +381,26 @@ VCardErrorCode createCard(char* fileName, Card** obj) {
         *obj = NULL;
         return INV_CARD;
     }
+    if (groupFailed) {
+        deleteCard(card);
+        *obj = NULL;
+        return OTHER_ERROR;
+    }
+
+    if (validate) {
+        if (fnErr != OK) retCode = fnErr;
+        else if (propErr != OK) retCode = propErr;
+        else if (versionProp) retCode = INV_CARD;
+        else if (duplicate) retCode = INV_PROP;
+        else if (bdayErr != OK) retCode = bdayErr;
+        else if (annErr != OK) retCode = annErr;
+
+        if (retCode != OK) {
+            deleteCard(card);
+            *obj = NULL;
+            return retCode;
+        }
+    }
     
     *obj = card;
     return OK;
@@ -400,9 +494,10 @@ static Property* parseProperty(char* line, int lineNum, VCardErrorCode* err) {
     char* preamble = line;         // Contains property name and optional parameters.
     char* valuePart = colonPos + 1;  // Contains the property values.
 
-    // Check for group (indicated by a dot).
+    // Check for group (indicated by a dot before any parameters, so PID=1.1 is not one).
     char* dotPos = strchr(preamble, '.');
-    if (dotPos != NULL) {
+    char* semiPos = strchr(preamble, ';');
+    if (dotPos != NULL && (semiPos == NULL || dotPos < semiPos)) {
         *dotPos = '\0';
         free(prop->group);
         prop->group = strdup(preamble);
@@ -410,7 +505,9 @@ static Property* parseProperty(char* line, int lineNum, VCardErrorCode* err) {
     }
 
     // The property name is the first token in the preamble (delimited by ';').
-    char* token = strtok(preamble, ";");
+    // strtok_r keeps the parser reentrant, so cards can be parsed from several threads.
+    char* paramSave;
+    char* token = strtok_r(preamble, ";", &paramSave);
     if (token == NULL || strlen(token) == 0) {
         deleteProperty(prop);
         *err = INV_PROP;
@@ -419,7 +516,7 @@ static Property* parseProperty(char* line, int lineNum, VCardErrorCode* err) {
     prop->name = strdup(token);
 
     // Process parameters (if any). Each parameter must be in the form name=value.
-    token = strtok(NULL, ";");
+    token = strtok_r(NULL, ";", &paramSave);
     while (token != NULL) {
         char* equalPos = strchr(token, '=');
         if (equalPos == NULL || *(equalPos + 1) == '\0') {
@@ -437,7 +534,7 @@ static Property* parseProperty(char* line, int lineNum, VCardErrorCode* err) {
         param->name = strdup(token);
         param->value = strdup(equalPos + 1);
         insertBack(prop->parameters, param);
-        token = strtok(NULL, ";");
+        token = strtok_r(NULL, ";", &paramSave);
     }
 
     // --- NEW VALUE SPLITTING LOGIC ---
@@ -0,0 +1,274 @@
+// VCPhoneIndex.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Telephone number normalization, with a hash index for whole numbers and a
+//              trie over reversed digits for matching the last digits of a number.
+
+#include "VCPhoneIndex.h"
+#include "VCNameIndex.h"
+#include "VCDocTable.h"
+#include <ctype.h>
+#include <strings.h>
+
+// Item of each entry in the table
+typedef struct phoneEntry {
+    char number[PHONE_MAX_LEN];
+    int  propIndex;
+} PhoneEntry;
+
+struct phoneIndex {
+    char        defaultCountry[8];
+
+    // Entries keyed by normalized number
+    DocTable    numbers;
+
+    // Reversed digits (without the +), mapped to entry positions.
+    NameIndex*  suffixes;
+};
+
+// ---------- Helper function: reverseDigits ----------
+static void reverseDigits(const char* number, char* out) {
+    if (*number == '+') number++;
+    size_t len = strlen(number);
+    for (size_t i = 0; i < len; i++) out[i] = number[len - 1 - i];
+    out[len] = '\0';
+}
+
+// ---------- Helper function: addNumber ----------
+static bool addNumber(PhoneIndex* index, const char* number, int docId, int propIndex) {
+    int e = docTableAdd(&index->numbers, fnvHash(number), docId);
+    if (e == -1) return false;
+
+    char reversed[PHONE_MAX_LEN];
+    reverseDigits(number, reversed);
+    if (nameIndexInsert(index->suffixes, reversed, e) != OK) {
+        docTableRemove(&index->numbers, e);
+        return false;
+    }
+
+    PhoneEntry* entry = docTableItem(&index->numbers, e);
+    snprintf(entry->number, PHONE_MAX_LEN, "%s", number);
+    entry->propIndex = propIndex;
+    return true;
+}
+
+// ---------- Helper function: copyMatch ----------
+static void copyMatch(const PhoneIndex* index, int e, PhoneMatch* out) {
+    out->docId = index->numbers.entries[e].docId;
+    out->propIndex = ((const PhoneEntry*)docTableItem(&index->numbers, e))->propIndex;
+}
+
+// ---------- Helper function: firstValue ----------
+static const char* firstValue(const Property* prop) {
+    return prop->values != NULL ? getFromFront(prop->values) : NULL;
+}
+
+// ---------- normalizePhone ----------
+int normalizePhone(const char* value, const char* defaultCountry, char* out, size_t size) {
+    if (out != NULL && size > 0) out[0] = '\0';
+    if (value == NULL || out == NULL) return 0;
+
+    while (isspace((unsigned char)*value)) value++;
+    if (strncasecmp(value, "tel:", 4) == 0) value += 4;
+
+    char digits[PHONE_MAX_LEN];
+    int n = 0;
+    bool plus = false;
+    for (const char* p = value; *p; p++) {
+        unsigned char c = (unsigned char)*p;
+        if (isdigit(c)) {
+            if (n == PHONE_MAX_LEN - 2) return 0;
+            digits[n++] = (char)c;
+        } else if (c == '+' && n == 0) {
+            plus = true;
+        } else if (c == ';' || c == '#' || c == ',' || isalpha(c)) {
+            // URI parameters, extensions and pauses are not part of the number.
+            break;
+        }
+    }
+    digits[n] = '\0';
+    if (n < 3) return 0;
+
+    const char* national = digits;
+    const char* country = "";
+    if (!plus) {
+        if (strncmp(digits, "00", 2) == 0) {
+            national = digits + 2;
+        } else if (defaultCountry != NULL && (digits[0] == '0' || n <= 10)) {
+            if (digits[0] == '0') national = digits + 1;
+            country = defaultCountry;
+        }
+    }
+
+    int len = snprintf(out, size, "+%s%s", country, national);
+    if (len < 0 || (size_t)len >= size || len >= PHONE_MAX_LEN) {
+        if (size > 0) out[0] = '\0';
+        return 0;
+    }
+    return len;
+}
+
+// ---------- createPhoneIndex ----------
+PhoneIndex* createPhoneIndex(const char* defaultCountry) {
+    PhoneIndex* index = calloc(1, sizeof(PhoneIndex));
+    if (index == NULL) return NULL;
+    if (defaultCountry != NULL) snprintf(index->defaultCountry, sizeof(index->defaultCountry), "%s", defaultCountry);
+    bool ok = docTableInit(&index->numbers, sizeof(PhoneEntry));
+    index->suffixes = createNameIndex();
+    if (!ok || index->suffixes == NULL) {
+        deletePhoneIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+typedef struct normalizedTel {
+    char number[PHONE_MAX_LEN];
+    int  propIndex;
+} NormalizedTel;
+
+typedef struct phoneJob {
+    const CardCorpus* corpus;
+    const char*       defaultCountry;
+    NormalizedTel**   tels;
+    int*              counts;
+} PhoneJob;
+
+// ---------- Helper function: normalizeCard ----------
+static void normalizeCard(int docId, int thread, void* ctx) {
+    PhoneJob* job = (PhoneJob*)ctx;
+    const Card* card = job->corpus->cards[docId];
+    job->counts[docId] = 0;
+    job->tels[docId] = NULL;
+    if (card == NULL || getLength(card->optionalProperties) == 0) return;
+
+    NormalizedTel* tels = malloc(getLength(card->optionalProperties) * sizeof(NormalizedTel));
+    if (tels == NULL) {
+        job->counts[docId] = -1;
+        return;
+    }
+    int n = 0, propIndex = 0;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "TEL") == 0 &&
+            normalizePhone(firstValue(prop), job->defaultCountry, tels[n].number, PHONE_MAX_LEN) > 0) {
+            tels[n++].propIndex = propIndex;
+        }
+        propIndex++;
+    }
+    job->tels[docId] = tels;
+    job->counts[docId] = n;
+}
+
+// ---------- buildPhoneIndex ----------
+PhoneIndex* buildPhoneIndex(const CardCorpus* corpus, const char* defaultCountry, int numThreads) {
+    if (corpus == NULL) return NULL;
+    PhoneIndex* index = createPhoneIndex(defaultCountry);
+    if (index == NULL) return NULL;
+
+    size_t n = corpus->count > 0 ? corpus->count : 1;
+    PhoneJob job = { corpus, index->defaultCountry[0] ? index->defaultCountry : NULL,
+                     calloc(n, sizeof(NormalizedTel*)), calloc(n, sizeof(int)) };
+    bool ok = job.tels != NULL && job.counts != NULL && docTableReserveDoc(&index->numbers, corpus->count) &&
+              runParallel(corpus->count, numThreads, normalizeCard, &job) == OK;
+
+    for (int i = 0; ok && i < corpus->count; i++) {
+        if (job.counts[i] < 0) ok = false;
+        for (int t = 0; ok && t < job.counts[i]; t++) {
+            ok = addNumber(index, job.tels[i][t].number, i, job.tels[i][t].propIndex);
+        }
+    }
+
+    if (job.tels != NULL) {
+        for (int i = 0; i < corpus->count; i++) free(job.tels[i]);
+    }
+    free(job.tels);
+    free(job.counts);
+    if (!ok) {
+        deletePhoneIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- phoneIndexAddCard ----------
+VCardErrorCode phoneIndexAddCard(PhoneIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    const char* country = index->defaultCountry[0] ? index->defaultCountry : NULL;
+
+    int propIndex = 0;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        char number[PHONE_MAX_LEN];
+        if (strcasecmp(prop->name, "TEL") == 0 &&
+            normalizePhone(firstValue(prop), country, number, sizeof(number)) > 0 &&
+            !addNumber(index, number, docId, propIndex)) {
+            return OTHER_ERROR;
+        }
+        propIndex++;
+    }
+    return OK;
+}
+
+// ---------- phoneIndexRemoveCard ----------
+void phoneIndexRemoveCard(PhoneIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->numbers.docCap) return;
+
+    for (int e = index->numbers.docHeads[docId]; e != -1; e = index->numbers.entries[e].nextInDoc) {
+        const PhoneEntry* entry = docTableItem(&index->numbers, e);
+        char reversed[PHONE_MAX_LEN];
+        reverseDigits(entry->number, reversed);
+        nameIndexRemove(index->suffixes, reversed, e);
+    }
+    docTableRemoveDoc(&index->numbers, docId);
+}
+
+// ---------- phoneIndexLookup ----------
+int phoneIndexLookup(const PhoneIndex* index, const char* number, PhoneMatch* out, int maxResults) {
+    if (index == NULL || out == NULL || maxResults <= 0) return 0;
+    char key[PHONE_MAX_LEN];
+    if (normalizePhone(number, index->defaultCountry[0] ? index->defaultCountry : NULL, key, sizeof(key)) == 0) return 0;
+
+    int n = 0;
+    int e = docTableFind(&index->numbers, fnvHash(key));
+    for (; e != -1 && n < maxResults; e = docTableNext(&index->numbers, e)) {
+        const PhoneEntry* entry = docTableItem(&index->numbers, e);
+        if (strcmp(entry->number, key) == 0) copyMatch(index, e, &out[n++]);
+    }
+    return n;
+}
+
+// ---------- phoneIndexSuffix ----------
+int phoneIndexSuffix(const PhoneIndex* index, const char* digits, PhoneMatch* out, int maxResults) {
+    if (index == NULL || digits == NULL || out == NULL || maxResults <= 0) return 0;
+
+    char reversed[PHONE_MAX_LEN];
+    int n = 0;
+    for (const char* p = digits + strlen(digits); p > digits && n < PHONE_MAX_LEN - 1; ) {
+        p--;
+        if (isdigit((unsigned char)*p)) reversed[n++] = *p;
+    }
+    reversed[n] = '\0';
+    if (n == 0) return 0;
+
+    int* entries = malloc(maxResults * sizeof(int));
+    if (entries == NULL) return 0;
+    int count = nameIndexPrefix(index->suffixes, reversed, entries, maxResults);
+    for (int i = 0; i < count; i++) copyMatch(index, entries[i], &out[i]);
+    free(entries);
+    return count;
+}
+
+// ---------- phoneIndexSize ----------
+int phoneIndexSize(const PhoneIndex* index) {
+    return index != NULL ? index->numbers.size : 0;
+}
+
+// ---------- deletePhoneIndex ----------
+void deletePhoneIndex(PhoneIndex* index) {
+    if (index == NULL) return;
+    deleteNameIndex(index->suffixes);
+    docTableFree(&index->numbers);
+    free(index);
+}
@@ -0,0 +1,789 @@
+// VCPhonetic.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Double Metaphone (Lawrence Philips' rules) and a multi-map from the
+//              keys of the name words to posting lists of cards.
+
+#include "VCPhonetic.h"
+#include "VCDocTable.h"
+#include "VCPostings.h"
+#include "VCText.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <ctype.h>
+#include <strings.h>
+
+// Longest word encoded; the rules look a few letters ahead of the key's last sound.
+#define METAPHONE_WORD 64
+
+// Letters are appended in steps of up to two, so keys are built in a larger buffer.
+#define METAPHONE_WORK (METAPHONE_LEN + 4)
+
+typedef struct metaphone {
+    // Upper-case word followed by spaces, so the rules can look past its end
+    char word[METAPHONE_WORD + 8];
+    int  length;
+    int  last;
+    bool slavoGermanic;
+
+    char primary[METAPHONE_WORK];
+    int  primaryLen;
+    char secondary[METAPHONE_WORK];
+    int  secondaryLen;
+} Metaphone;
+
+typedef struct keySlot {
+    // Key packed into an integer, 0 for an empty slot
+    uint32_t    key;
+    PostingList docs;
+} KeySlot;
+
+typedef struct docKeys {
+    uint32_t* keys;
+    int       count;
+} DocKeys;
+
+struct phoneticIndex {
+    // Open-addressing table of keys
+    KeySlot* slots;
+    int      numKeys;
+    int      cap;
+
+    // Keys of each document, so that it can be removed
+    DocKeys* docs;
+    int      docCap;
+};
+
+// Plain upper-case letter for each Latin-1 letter from U+00C0 to U+00DF (and, 32 higher,
+// its lower-case form).  Ç is read as S, as the rules specify.  0 for the two symbols in
+// the range.
+static const char latinLetters[32] = "AAAAAAASEEEEIIIIDNOOOOO\0OUUUUYTS";
+
+// ---------- Helper function: getAt ----------
+static char getAt(const Metaphone* m, int pos) {
+    return (pos < 0 || pos >= m->length) ? '\0' : m->word[pos];
+}
+
+// ---------- Helper function: isVowel ----------
+static bool isVowel(const Metaphone* m, int pos) {
+    char c = getAt(m, pos);
+    return c != '\0' && strchr("AEIOUY", c) != NULL;
+}
+
+// ---------- Helper function: stringAt ----------
+// Whether one of the given strings (a NULL-terminated list, all of the given length)
+// starts at start.
+static bool stringAt(const Metaphone* m, int start, int length, ...) {
+    if (start < 0 || start >= m->length) return false;
+    va_list options;
+    va_start(options, length);
+    const char* option;
+    bool found = false;
+    while (!found && (option = va_arg(options, const char*)) != NULL) {
+        found = strncmp(m->word + start, option, length) == 0;
+    }
+    va_end(options);
+    return found;
+}
+
+// ---------- Helper function: add ----------
+// Appends to both keys, or to the secondary key alt if it is not NULL.
+static void add(Metaphone* m, const char* main, const char* alt) {
+    if (alt == NULL) alt = main;
+    for (; *main != '\0' && m->primaryLen < METAPHONE_WORK - 1; main++) m->primary[m->primaryLen++] = *main;
+    for (; *alt != '\0' && m->secondaryLen < METAPHONE_WORK - 1; alt++) m->secondary[m->secondaryLen++] = *alt;
+}
+
+// ---------- Helper function: prepare ----------
+static void prepare(Metaphone* m, const char* s) {
+    const unsigned char* p = (const unsigned char*)s;
+    m->length = 0;
+    while (*p != '\0' && m->length < METAPHONE_WORD) {
+        char c = 0;
+        if (*p < 0x80) {
+            c = (char)toupper(*p);
+            p++;
+        } else if (*p == 0xC3 && p[1] >= 0x80 && p[1] <= 0xBF) {
+            // Latin-1 letters written in UTF-8
+            c = p[1] == 0xBF ? 'Y' : latinLetters[(p[1] - 0x80) & 31];
+            p += 2;
+        } else {
+            p++;
+        }
+        if (c != 0) m->word[m->length++] = c;
+    }
+    m->last = m->length - 1;
+    memset(m->word + m->length, ' ', 8);
+    m->word[m->length + 7] = '\0';
+    m->slavoGermanic = strchr(m->word, 'W') != NULL || strchr(m->word, 'K') != NULL ||
+                       strstr(m->word, "CZ") != NULL || strstr(m->word, "WITZ") != NULL;
+    m->primaryLen = 0;
+    m->secondaryLen = 0;
+}
+
+// ---------- Helper function: encodeC ----------
+static int encodeC(Metaphone* m, int current) {
+    // Various Germanic
+    if (current > 1 && !isVowel(m, current - 2) && stringAt(m, current - 1, 3, "ACH", NULL) &&
+        getAt(m, current + 2) != 'I' &&
+        (getAt(m, current + 2) != 'E' || stringAt(m, current - 2, 6, "BACHER", "MACHER", NULL))) {
+        add(m, "K", NULL);
+        return current + 2;
+    }
+    if (current == 0 && stringAt(m, current, 6, "CAESAR", NULL)) {
+        add(m, "S", NULL);
+        return current + 2;
+    }
+    // Italian "chianti"
+    if (stringAt(m, current, 4, "CHIA", NULL)) {
+        add(m, "K", NULL);
+        return current + 2;
+    }
+    if (stringAt(m, current, 2, "CH", NULL)) {
+        // "Michael"
+        if (current > 0 && stringAt(m, current, 4, "CHAE", NULL)) {
+            add(m, "K", "X");
+            return current + 2;
+        }
+        // Greek roots, e.g. "chemistry", "chorus"
+        if (current == 0 && (stringAt(m, current + 1, 5, "HARAC", "HARIS", NULL) ||
+                             stringAt(m, current + 1, 3, "HOR", "HYM", "HIA", "HEM", NULL)) &&
+            !stringAt(m, 0, 5, "CHORE", NULL)) {
+            add(m, "K", NULL);
+            return current + 2;
+        }
+        // Germanic, Greek, or otherwise "ch" for the "kh" sound
+        if (stringAt(m, 0, 4, "VAN ", "VON ", NULL) || stringAt(m, 0, 3, "SCH", NULL) ||
+            stringAt(m, current - 2, 6, "ORCHES", "ARCHIT", "ORCHID", NULL) ||
+            stringAt(m, current + 2, 1, "T", "S", NULL) ||
+            ((stringAt(m, current - 1, 1, "A", "O", "U", "E", NULL) || current == 0) &&
+             stringAt(m, current + 2, 1, "L", "R", "N", "M", "B", "H", "F", "V", "W", " ", NULL))) {
+            add(m, "K", NULL);
+        } else if (current > 0) {
+            if (stringAt(m, 0, 2, "MC", NULL)) add(m, "K", NULL);
+            else add(m, "X", "K");
+        } else {
+            add(m, "X", NULL);
+        }
+        return current + 2;
+    }
+    // "Czerny"
+    if (stringAt(m, current, 2, "CZ", NULL) && !stringAt(m, current - 2, 4, "WICZ", NULL)) {
+        add(m, "S", "X");
+        return current + 2;
+    }
+    // "Focaccia"
+    if (stringAt(m, current + 1, 3, "CIA", NULL)) {
+        add(m, "X", NULL);
+        return current + 3;
+    }
+    // Double C, but not "McClellan"
+    if (stringAt(m, current, 2, "CC", NULL) && !(current == 1 && getAt(m, 0) == 'M')) {
+        // "Bellocchio" but not "Bacchus"
+        if (stringAt(m, current + 2, 1, "I", "E", "H", NULL) && !stringAt(m, current + 2, 2, "HU", NULL)) {
+            // "Accident", "accede", "succeed"
+            if ((current == 1 && getAt(m, current - 1) == 'A') ||
+                stringAt(m, current - 1, 5, "UCCEE", "UCCES", NULL)) {
+                add(m, "KS", NULL);
+            } else {
+                add(m, "X", NULL);
+            }
+            return current + 3;
+        }
+        add(m, "K", NULL);
+        return current + 2;
+    }
+    if (stringAt(m, current, 2, "CK", "CG", "CQ", NULL)) {
+        add(m, "K", NULL);
+        return current + 2;
+    }
+    if (stringAt(m, current, 2, "CI", "CE", "CY", NULL)) {
+        // Italian against English
+        if (stringAt(m, current, 3, "CIO", "CIE", "CIA", NULL)) add(m, "S", "X");
+        else add(m, "S", NULL);
+        return current + 2;
+    }
+    add(m, "K", NULL);
+    if (stringAt(m, current + 1, 1, "C", "K", "Q", NULL) && !stringAt(m, current + 1, 2, "CE", "CI", NULL)) {
+        return current + 2;
+    }
+    return current + 1;
+}
+
+// ---------- Helper function: encodeG ----------
+static int encodeG(Metaphone* m, int current) {
+    if (getAt(m, current + 1) == 'H') {
+        if (current > 0 && !isVowel(m, current - 1)) {
+            add(m, "K", NULL);
+            return current + 2;
+        }
+        // "Ghislane", "Ghiradelli"
+        if (current == 0) {
+            add(m, getAt(m, current + 2) == 'I' ? "J" : "K", NULL);
+            return current + 2;
+        }
+        // Parker's rule, e.g. "Hugh", "bough", "Broughton"
+        if ((current > 1 && stringAt(m, current - 2, 1, "B", "H", "D", NULL)) ||
+            (current > 2 && stringAt(m, current - 3, 1, "B", "H", "D", NULL)) ||
+            (current > 3 && stringAt(m, current - 4, 1, "B", "H", NULL))) {
+            return current + 2;
+        }
+        // "Laugh", "McLaughlin", "cough", "rough"
+        if (current > 2 && getAt(m, current - 1) == 'U' &&
+            stringAt(m, current - 3, 1, "C", "G", "L", "R", "T", NULL)) {
+            add(m, "F", NULL);
+        } else if (current > 0 && getAt(m, current - 1) != 'I') {
+            add(m, "K", NULL);
+        }
+        return current + 2;
+    }
+    if (getAt(m, current + 1) == 'N') {
+        if (current == 1 && isVowel(m, 0) && !m->slavoGermanic) {
+            add(m, "KN", "N");
+        } else if (!stringAt(m, current + 2, 2, "EY", NULL) && getAt(m, current + 1) != 'Y' && !m->slavoGermanic) {
+            // Not "Cagney"
+            add(m, "N", "KN");
+        } else {
+            add(m, "KN", NULL);
+        }
+        return current + 2;
+    }
+    // "Tagliaro"
+    if (stringAt(m, current + 1, 2, "LI", NULL) && !m->slavoGermanic) {
+        add(m, "KL", "L");
+        return current + 2;
+    }
+    // -ges-, -gep-, -gel-, -gie- at the start
+    if (current == 0 && (getAt(m, current + 1) == 'Y' ||
+                         stringAt(m, current + 1, 2, "ES", "EP", "EB", "EL", "EY", "IB", "IL", "IN", "IE",
+                                  "EI", "ER", NULL))) {
+        add(m, "K", "J");
+        return current + 2;
+    }
+    // -ger-, -gy-
+    if ((stringAt(m, current + 1, 2, "ER", NULL) || getAt(m, current + 1) == 'Y') &&
+        !stringAt(m, 0, 6, "DANGER", "RANGER", "MANGER", NULL) &&
+        !stringAt(m, current - 1, 1, "E", "I", NULL) &&
+        !stringAt(m, current - 1, 3, "RGY", "OGY", NULL)) {
+        add(m, "K", "J");
+        return current + 2;
+    }
+    // Italian, e.g. "Biaggi"
+    if (stringAt(m, current + 1, 1, "E", "I", "Y", NULL) || stringAt(m, current - 1, 4, "AGGI", "OGGI", NULL)) {
+        if (stringAt(m, 0, 4, "VAN ", "VON ", NULL) || stringAt(m, 0, 3, "SCH", NULL) ||
+            stringAt(m, current + 1, 2, "ET", NULL)) {
+            add(m, "K", NULL);
+        } else if (stringAt(m, current + 1, 4, "IER ", NULL)) {
+            add(m, "J", NULL);
+        } else {
+            add(m, "J", "K");
+        }
+        return current + 2;
+    }
+    add(m, "K", NULL);
+    return getAt(m, current + 1) == 'G' ? current + 2 : current + 1;
+}
+
+// ---------- Helper function: encodeJ ----------
+static int encodeJ(Metaphone* m, int current) {
+    // Spanish "Jose", "San Jacinto"
+    if (stringAt(m, current, 4, "JOSE", NULL) || stringAt(m, 0, 4, "SAN ", NULL)) {
+        if ((current == 0 && (m->length == 4 || getAt(m, current + 4) == ' ')) || stringAt(m, 0, 4, "SAN ", NULL)) {
+            add(m, "H", NULL);
+        } else {
+            add(m, "J", "H");
+        }
+        return current + 1;
+    }
+    if (current == 0) {
+        // "Yankelovich" and "Jankelowicz"
+        add(m, "J", "A");
+    } else if (isVowel(m, current - 1) && !m->slavoGermanic &&
+               (getAt(m, current + 1) == 'A' || getAt(m, current + 1) == 'O')) {
+        // Spanish "bajador"
+        add(m, "J", "H");
+    } else if (current == m->last) {
+        add(m, "J", "");
+    } else if (!stringAt(m, current + 1, 1, "L", "T", "K", "S", "N", "M", "B", "Z", NULL) &&
+               !stringAt(m, current - 1, 1, "S", "K", "L", NULL)) {
+        add(m, "J", NULL);
+    }
+    return getAt(m, current + 1) == 'J' ? current + 2 : current + 1;
+}
+
+// ---------- Helper function: encodeS ----------
+static int encodeS(Metaphone* m, int current) {
+    // "Island", "isle", "Carlisle", "Carlysle"
+    if (stringAt(m, current - 1, 3, "ISL", "YSL", NULL)) return current + 1;
+    if (current == 0 && stringAt(m, current, 5, "SUGAR", NULL)) {
+        add(m, "X", "S");
+        return current + 1;
+    }
+    if (stringAt(m, current, 2, "SH", NULL)) {
+        // Germanic
+        if (stringAt(m, current + 1, 4, "HEIM", "HOEK", "HOLM", "HOLZ", NULL)) add(m, "S", NULL);
+        else add(m, "X", NULL);
+        return current + 2;
+    }
+    // Italian and Armenian
+    if (stringAt(m, current, 3, "SIO", "SIA", NULL) || stringAt(m, current, 4, "SIAN", NULL)) {
+        if (!m->slavoGermanic) add(m, "S", "X");
+        else add(m, "S", NULL);
+        return current + 3;
+    }
+    // German and anglicised forms ("Smith" and "Schmidt", "Snider" and "Schneider"), and
+    // Slavic -sz-
+    if ((current == 0 && stringAt(m, current + 1, 1, "M", "N", "L", "W", NULL)) ||
+        stringAt(m, current + 1, 1, "Z", NULL)) {
+        add(m, "S", "X");
+        return stringAt(m, current + 1, 1, "Z", NULL) ? current + 2 : current + 1;
+    }
+    if (stringAt(m, current, 2, "SC", NULL)) {
+        // Schlesinger's rule
+        if (getAt(m, current + 2) == 'H') {
+            // Dutch, e.g. "school", "schooner", "Schermerhorn", "Schenker"
+            if (stringAt(m, current + 3, 2, "OO", "ER", "EN", "UY", "ED", "EM", NULL)) {
+                if (stringAt(m, current + 3, 2, "ER", "EN", NULL)) add(m, "X", "SK");
+                else add(m, "SK", NULL);
+            } else if (current == 0 && !isVowel(m, 3) && getAt(m, 3) != 'W') {
+                add(m, "X", "S");
+            } else {
+                add(m, "X", NULL);
+            }
+            return current + 3;
+        }
+        if (stringAt(m, current + 2, 1, "I", "E", "Y", NULL)) add(m, "S", NULL);
+        else add(m, "SK", NULL);
+        return current + 3;
+    }
+    // French "Resnais", "Artois"
+    if (current == m->last && stringAt(m, current - 2, 2, "AI", "OI", NULL)) add(m, "", "S");
+    else add(m, "S", NULL);
+    return stringAt(m, current + 1, 1, "S", "Z", NULL) ? current + 2 : current + 1;
+}
+
+// ---------- Helper function: encodeW ----------
+static int encodeW(Metaphone* m, int current) {
+    if (stringAt(m, current, 2, "WR", NULL)) {
+        add(m, "R", NULL);
+        return current + 2;
+    }
+    // "Wasserman" matches "Vasserman", and "Uomo" matches "Womo"
+    if (current == 0 && (isVowel(m, current + 1) || stringAt(m, current, 2, "WH", NULL))) {
+        if (isVowel(m, current + 1)) add(m, "A", "F");
+        else add(m, "A", NULL);
+    }
+    // "Arnow" matches "Arnoff"
+    if ((current == m->last && isVowel(m, current - 1)) ||
+        stringAt(m, current - 1, 5, "EWSKI", "EWSKY", "OWSKI", "OWSKY", NULL) ||
+        stringAt(m, 0, 3, "SCH", NULL)) {
+        add(m, "", "F");
+        return current + 1;
+    }
+    // Polish "Filipowicz"
+    if (stringAt(m, current, 4, "WICZ", "WITZ", NULL)) {
+        add(m, "TS", "FX");
+        return current + 4;
+    }
+    return current + 1;
+}
+
+// ---------- Helper function: encodeLetter ----------
+// Encodes the sound starting at current.  Returns where the next one starts.
+static int encodeLetter(Metaphone* m, int current) {
+    char c = m->word[current];
+    char next = getAt(m, current + 1);
+    switch (c) {
+        case 'A': case 'E': case 'I': case 'O': case 'U': case 'Y':
+            // Vowels only count at the start
+            if (current == 0) add(m, "A", NULL);
+            return current + 1;
+        case 'B':
+            add(m, "P", NULL);
+            return next == 'B' ? current + 2 : current + 1;
+        case 'C':
+            return encodeC(m, current);
+        case 'D':
+            if (stringAt(m, current, 2, "DG", NULL)) {
+                // "Edge" against "Edgar"
+                if (stringAt(m, current + 2, 1, "I", "E", "Y", NULL)) {
+                    add(m, "J", NULL);
+                    return current + 3;
+                }
+                add(m, "TK", NULL);
+                return current + 2;
+            }
+            add(m, "T", NULL);
+            return stringAt(m, current, 2, "DT", "DD", NULL) ? current + 2 : current + 1;
+        case 'F':
+            add(m, "F", NULL);
+            return next == 'F' ? current + 2 : current + 1;
+        case 'G':
+            return encodeG(m, current);
+        case 'H':
+            // Only kept at the start or between vowels, before a vowel
+            if ((current == 0 || isVowel(m, current - 1)) && isVowel(m, current + 1)) {
+                add(m, "H", NULL);
+                return current + 2;
+            }
+            return current + 1;
+        case 'J':
+            return encodeJ(m, current);
+        case 'K':
+            add(m, "K", NULL);
+            return next == 'K' ? current + 2 : current + 1;
+        case 'L':
+            if (next == 'L') {
+                // Spanish "Cabrillo", "Gallegos"
+                if ((current == m->length - 3 && stringAt(m, current - 1, 4, "ILLO", "ILLA", "ALLE", NULL)) ||
+                    ((stringAt(m, m->last - 1, 2, "AS", "OS", NULL) || stringAt(m, m->last, 1, "A", "O", NULL)) &&
+                     stringAt(m, current - 1, 4, "ALLE", NULL))) {
+                    add(m, "L", "");
+                    return current + 2;
+                }
+                add(m, "L", NULL);
+                return current + 2;
+            }
+            add(m, "L", NULL);
+            return current + 1;
+        case 'M':
+            add(m, "M", NULL);
+            // "Dumb", "thumb", "plumber"
+            if ((stringAt(m, current - 1, 3, "UMB", NULL) &&
+                 (current + 1 == m->last || stringAt(m, current + 2, 2, "ER", NULL))) || next == 'M') {
+                return current + 2;
+            }
+            return current + 1;
+        case 'N':
+            add(m, "N", NULL);
+            return next == 'N' ? current + 2 : current + 1;
+        case 'P':
+            if (next == 'H') {
+                add(m, "F", NULL);
+                return current + 2;
+            }
+            // "Campbell", "raspberry"
+            add(m, "P", NULL);
+            return (next == 'P' || next == 'B') ? current + 2 : current + 1;
+        case 'Q':
+            add(m, "K", NULL);
+            return next == 'Q' ? current + 2 : current + 1;
+        case 'R':
+            // French "Rogier", but not "Hochmeier"
+            if (current == m->last && !m->slavoGermanic && stringAt(m, current - 2, 2, "IE", NULL) &&
+                !stringAt(m, current - 4, 2, "ME", "MA", NULL)) {
+                add(m, "", "R");
+            } else {
+                add(m, "R", NULL);
+            }
+            return next == 'R' ? current + 2 : current + 1;
+        case 'S':
+            return encodeS(m, current);
+        case 'T':
+            if (stringAt(m, current, 4, "TION", NULL) || stringAt(m, current, 3, "TIA", "TCH", NULL)) {
+                add(m, "X", NULL);
+                return current + 3;
+            }
+            if (stringAt(m, current, 2, "TH", NULL) || stringAt(m, current, 3, "TTH", NULL)) {
+                // "Thomas", "Thames", or Germanic
+                if (stringAt(m, current + 2, 2, "OM", "AM", NULL) || stringAt(m, 0, 4, "VAN ", "VON ", NULL) ||
+                    stringAt(m, 0, 3, "SCH", NULL)) {
+                    add(m, "T", NULL);
+                } else {
+                    add(m, "0", "T");
+                }
+                return current + 2;
+            }
+            add(m, "T", NULL);
+            return (next == 'T' || next == 'D') ? current + 2 : current + 1;
+        case 'V':
+            add(m, "F", NULL);
+            return next == 'V' ? current + 2 : current + 1;
+        case 'W':
+            return encodeW(m, current);
+        case 'X':
+            // French "Breaux"
+            if (!(current == m->last && (stringAt(m, current - 3, 3, "IAU", "EAU", NULL) ||
+                                         stringAt(m, current - 2, 2, "AU", "OU", NULL)))) {
+                add(m, "KS", NULL);
+            }
+            return (next == 'C' || next == 'X') ? current + 2 : current + 1;
+        case 'Z':
+            // Chinese pinyin "Zhao"
+            if (next == 'H') {
+                add(m, "J", NULL);
+                return current + 2;
+            }
+            if (stringAt(m, current + 1, 2, "ZO", "ZI", "ZA", NULL) ||
+                (m->slavoGermanic && current > 0 && getAt(m, current - 1) != 'T')) {
+                add(m, "S", "TS");
+            } else {
+                add(m, "S", NULL);
+            }
+            return next == 'Z' ? current + 2 : current + 1;
+        default:
+            return current + 1;
+    }
+}
+
+// ---------- doubleMetaphone ----------
+void doubleMetaphone(const char* word, char* primary, char* secondary) {
+    Metaphone m;
+    prepare(&m, word != NULL ? word : "");
+
+    int current = 0;
+    // Silent first letters
+    if (stringAt(&m, 0, 2, "GN", "KN", "PN", "WR", "PS", NULL)) current = 1;
+    // "Xavier"
+    if (getAt(&m, 0) == 'X') {
+        add(&m, "S", NULL);
+        current = 1;
+    }
+    while ((m.primaryLen < METAPHONE_LEN || m.secondaryLen < METAPHONE_LEN) && current < m.length) {
+        current = encodeLetter(&m, current);
+    }
+
+    int n = m.primaryLen < METAPHONE_LEN ? m.primaryLen : METAPHONE_LEN;
+    memcpy(primary, m.primary, n);
+    primary[n] = '\0';
+    n = m.secondaryLen < METAPHONE_LEN ? m.secondaryLen : METAPHONE_LEN;
+    memcpy(secondary, m.secondary, n);
+    secondary[n] = '\0';
+}
+
+// ---------- Helper function: packKey ----------
+// Keys are at most four characters, none of them NUL, so they fit in 32 bits.
+static uint32_t packKey(const char* key) {
+    uint32_t packed = 0;
+    for (int i = 0; i < METAPHONE_LEN && key[i] != '\0'; i++) packed |= (uint32_t)(unsigned char)key[i] << (8 * i);
+    return packed;
+}
+
+// ---------- Helper function: hashKey ----------
+static uint32_t hashKey(uint32_t key) {
+    key *= 0x9E3779B1u;
+    return key ^ (key >> 16);
+}
+
+// ---------- Helper function: findKey ----------
+// Returns the slot holding key, or the empty slot where it would go.
+static int findKey(const PhoneticIndex* index, uint32_t key) {
+    uint32_t s = hashKey(key) & (index->cap - 1);
+    while (index->slots[s].key != 0 && index->slots[s].key != key) s = (s + 1) & (index->cap - 1);
+    return (int)s;
+}
+
+// ---------- Helper function: growSlots ----------
+static bool growSlots(PhoneticIndex* index) {
+    int cap = index->cap > 0 ? index->cap * 2 : 256;
+    KeySlot* slots = calloc(cap, sizeof(KeySlot));
+    if (slots == NULL) return false;
+    for (int i = 0; i < index->cap; i++) {
+        if (index->slots[i].key == 0) continue;
+        uint32_t s = hashKey(index->slots[i].key) & (cap - 1);
+        while (slots[s].key != 0) s = (s + 1) & (cap - 1);
+        slots[s] = index->slots[i];
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->cap = cap;
+    return true;
+}
+
+// ---------- Helper function: addKey ----------
+static bool addKey(PhoneticIndex* index, DocKeys* doc, uint32_t key, int docId) {
+    if (key == 0) return true;
+    for (int i = 0; i < doc->count; i++) {
+        if (doc->keys[i] == key) return true;
+    }
+    uint32_t* keys = realloc(doc->keys, (doc->count + 1) * sizeof(uint32_t));
+    if (keys == NULL) return false;
+    doc->keys = keys;
+
+    if (2 * (index->numKeys + 1) > index->cap && !growSlots(index)) return false;
+    int s = findKey(index, key);
+    if (index->slots[s].key == 0) {
+        index->slots[s].key = key;
+        index->numKeys++;
+    }
+    if (postingAdd(&index->slots[s].docs, docId) < 0) return false;
+    doc->keys[doc->count++] = key;
+    return true;
+}
+
+// ---------- Helper function: addWords ----------
+static bool addWords(PhoneticIndex* index, DocKeys* doc, const char* text, int docId) {
+    if (text == NULL) return true;
+    const char* word;
+    int len;
+    for (const char* s = text; (word = nextToken(s, &len)) != NULL; s = word + len) {
+        char buffer[METAPHONE_WORD + 1];
+        char primary[METAPHONE_LEN + 1], secondary[METAPHONE_LEN + 1];
+        int n = len < METAPHONE_WORD ? len : METAPHONE_WORD;
+        memcpy(buffer, word, n);
+        buffer[n] = '\0';
+        doubleMetaphone(buffer, primary, secondary);
+        if (!addKey(index, doc, packKey(primary), docId) || !addKey(index, doc, packKey(secondary), docId)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// ---------- Helper function: wordDocs ----------
+// Cards with a word sounding like the given one, as a newly allocated sorted array.
+static int* wordDocs(const PhoneticIndex* index, const char* word, int* count) {
+    char primary[METAPHONE_LEN + 1], secondary[METAPHONE_LEN + 1];
+    doubleMetaphone(word, primary, secondary);
+    const PostingList* lists[2] = { NULL, NULL };
+    uint32_t keys[2] = { packKey(primary), packKey(secondary) };
+    for (int i = 0; i < 2; i++) {
+        if (keys[i] == 0 || (i == 1 && keys[1] == keys[0])) continue;
+        int s = findKey(index, keys[i]);
+        if (index->slots[s].key != 0) lists[i] = &index->slots[s].docs;
+    }
+
+    int sizes[2] = { lists[0] ? lists[0]->count : 0, lists[1] ? lists[1]->count : 0 };
+    int* first = malloc((sizes[0] + 1) * sizeof(int));
+    int* second = malloc((sizes[1] + 1) * sizeof(int));
+    int* both = malloc((sizes[0] + sizes[1] + 1) * sizeof(int));
+    if (first == NULL || second == NULL || both == NULL) {
+        free(first);
+        free(second);
+        free(both);
+        return NULL;
+    }
+    if (lists[0] != NULL) postingDecode(lists[0], first);
+    if (lists[1] != NULL) postingDecode(lists[1], second);
+    *count = unionSorted(first, sizes[0], second, sizes[1], both);
+    free(first);
+    free(second);
+    return both;
+}
+
+// ---------- createPhoneticIndex ----------
+PhoneticIndex* createPhoneticIndex(void) {
+    PhoneticIndex* index = calloc(1, sizeof(PhoneticIndex));
+    if (index == NULL) return NULL;
+    if (!growSlots(index)) {
+        free(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildPhoneticIndex ----------
+PhoneticIndex* buildPhoneticIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    PhoneticIndex* index = createPhoneticIndex();
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (phoneticIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deletePhoneticIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- phoneticIndexAddCard ----------
+VCardErrorCode phoneticIndexAddCard(PhoneticIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (docId >= index->docCap) {
+        int cap = docCapFor(index->docCap, docId);
+        DocKeys* docs = realloc(index->docs, cap * sizeof(DocKeys));
+        if (docs == NULL) return OTHER_ERROR;
+        memset(docs + index->docCap, 0, (cap - index->docCap) * sizeof(DocKeys));
+        index->docs = docs;
+        index->docCap = cap;
+    }
+    DocKeys* doc = &index->docs[docId];
+
+    bool ok = card->fn == NULL || addWords(index, doc, getFromFront(card->fn->values), docId);
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "FN") == 0) {
+            ok = addWords(index, doc, getFromFront(prop->values), docId);
+        } else if (strcasecmp(prop->name, "N") == 0) {
+            // Family name, then given name
+            ListIterator parts = createIterator(prop->values);
+            char* part;
+            for (int i = 0; ok && i < 2 && (part = nextElement(&parts)) != NULL; i++) {
+                ok = addWords(index, doc, part, docId);
+            }
+        }
+    }
+    return ok ? OK : OTHER_ERROR;
+}
+
+// ---------- phoneticIndexRemoveCard ----------
+void phoneticIndexRemoveCard(PhoneticIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    DocKeys* doc = &index->docs[docId];
+    for (int i = 0; i < doc->count; i++) {
+        int s = findKey(index, doc->keys[i]);
+        if (index->slots[s].key != 0) postingRemove(&index->slots[s].docs, docId);
+    }
+    free(doc->keys);
+    doc->keys = NULL;
+    doc->count = 0;
+}
+
+// ---------- phoneticLookup ----------
+int phoneticLookup(const PhoneticIndex* index, const char* name, int* out, int maxResults) {
+    if (index == NULL || name == NULL || out == NULL || maxResults <= 0) return 0;
+
+    // Cards matching every word so far; NULL before the first word with a key
+    int* matches = NULL;
+    int count = 0;
+    const char* word;
+    int len;
+    for (const char* s = name; (word = nextToken(s, &len)) != NULL; s = word + len) {
+        char buffer[METAPHONE_WORD + 1];
+        char primary[METAPHONE_LEN + 1], secondary[METAPHONE_LEN + 1];
+        int n = len < METAPHONE_WORD ? len : METAPHONE_WORD;
+        memcpy(buffer, word, n);
+        buffer[n] = '\0';
+
+        // Words without letters, such as numbers, do not narrow the search.
+        doubleMetaphone(buffer, primary, secondary);
+        if (primary[0] == '\0' && secondary[0] == '\0') continue;
+
+        int wordCount = 0;
+        int* docs = wordDocs(index, buffer, &wordCount);
+        if (docs == NULL) {
+            free(matches);
+            return 0;
+        }
+        if (matches == NULL) {
+            matches = docs;
+            count = wordCount;
+        } else {
+            count = intersectSorted(matches, count, docs, wordCount);
+            free(docs);
+        }
+        if (count == 0) break;
+    }
+
+    int n = count < maxResults ? count : maxResults;
+    if (n > 0) memcpy(out, matches, n * sizeof(int));
+    free(matches);
+    return n;
+}
+
+// ---------- phoneticIndexSize ----------
+int phoneticIndexSize(const PhoneticIndex* index) {
+    return index != NULL ? index->numKeys : 0;
+}
+
+// ---------- deletePhoneticIndex ----------
+void deletePhoneticIndex(PhoneticIndex* index) {
+    if (index == NULL) return;
+    for (int i = 0; i < index->cap; i++) postingFree(&index->slots[i].docs);
+    for (int i = 0; i < index->docCap; i++) free(index->docs[i].keys);
+    free(index->slots);
+    free(index->docs);
+    free(index);
+}
@@ -0,0 +1,278 @@
+// VCPostings.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Block-compressed posting lists (delta varints) and sorted-array set operations.
+
+#include "VCPostings.h"
+
+// ---------- Helper function: putVarint ----------
+static bool putVarint(PostingBlock* block, unsigned int value) {
+    if (block->size + 5 > block->cap) {
+        size_t cap = block->cap > 0 ? block->cap * 2 : 8;
+        unsigned char* bigger = realloc(block->data, cap);
+        if (bigger == NULL) return false;
+        block->data = bigger;
+        block->cap = cap;
+    }
+    while (value >= 0x80) {
+        block->data[block->size++] = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+    block->data[block->size++] = (unsigned char)value;
+    return true;
+}
+
+// ---------- Helper function: getVarint ----------
+static unsigned int getVarint(const unsigned char** pos, const unsigned char* end) {
+    unsigned int value = 0;
+    int shift = 0;
+    unsigned char b;
+    do {
+        b = *(*pos)++;
+        value |= (unsigned int)(b & 0x7F) << shift;
+        shift += 7;
+    } while ((b & 0x80) && *pos < end);
+    return value;
+}
+
+// ---------- Helper function: appendToBlock ----------
+static bool appendToBlock(PostingBlock* block, int docId) {
+    if (block->count == 0) {
+        block->first = block->last = docId;
+    } else {
+        if (!putVarint(block, (unsigned int)(docId - block->last))) return false;
+        block->last = docId;
+    }
+    block->count++;
+    return true;
+}
+
+// ---------- Helper function: decodeBlock ----------
+static int decodeBlock(const PostingBlock* block, int* out) {
+    if (block->count == 0) return 0;
+    const unsigned char* pos = block->data;
+    const unsigned char* end = block->data + block->size;
+    int n = 0;
+    int id = block->first;
+    out[n++] = id;
+    while (pos < end) {
+        id += (int)getVarint(&pos, end);
+        out[n++] = id;
+    }
+    return n;
+}
+
+// ---------- Helper function: encodeBlock ----------
+// Replaces the contents of a block with the given sorted ids.
+static bool encodeBlock(PostingBlock* block, const int* ids, int count) {
+    PostingBlock fresh = { 0, 0, 0, NULL, 0, 0 };
+    for (int i = 0; i < count; i++) {
+        if (!appendToBlock(&fresh, ids[i])) {
+            free(fresh.data);
+            return false;
+        }
+    }
+    free(block->data);
+    *block = fresh;
+    return true;
+}
+
+// ---------- Helper function: insertBlock ----------
+// Makes room for an empty block at position at.
+static PostingBlock* insertBlock(PostingList* list, int at) {
+    if (list->numBlocks == list->blockCap) {
+        int cap = list->blockCap > 0 ? list->blockCap * 2 : 1;
+        PostingBlock* bigger = realloc(list->blocks, cap * sizeof(PostingBlock));
+        if (bigger == NULL) return NULL;
+        list->blocks = bigger;
+        list->blockCap = cap;
+    }
+    memmove(list->blocks + at + 1, list->blocks + at, (list->numBlocks - at) * sizeof(PostingBlock));
+    memset(&list->blocks[at], 0, sizeof(PostingBlock));
+    list->numBlocks++;
+    return &list->blocks[at];
+}
+
+// ---------- Helper function: findBlock ----------
+// Returns the first block whose last id is >= docId, or numBlocks if there is none.
+static int findBlock(const PostingList* list, int docId) {
+    int lo = 0, hi = list->numBlocks;
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+        if (list->blocks[mid].last < docId) lo = mid + 1;
+        else hi = mid;
+    }
+    return lo;
+}
+
+// ---------- postingIterInit ----------
+void postingIterInit(const PostingList* list, PostingIter* iter) {
+    iter->list = list;
+    iter->block = -1;
+    iter->pos = iter->end = NULL;
+    iter->current = -1;
+}
+
+// ---------- postingNext ----------
+int postingNext(PostingIter* iter) {
+    if (iter->pos != NULL && iter->pos < iter->end) {
+        iter->current += (int)getVarint(&iter->pos, iter->end);
+        return iter->current;
+    }
+    if (iter->block + 1 >= iter->list->numBlocks) return -1;
+
+    const PostingBlock* block = &iter->list->blocks[++iter->block];
+    iter->pos = block->data;
+    iter->end = block->data + block->size;
+    iter->current = block->first;
+    return iter->current;
+}
+
+// ---------- postingDecode ----------
+int postingDecode(const PostingList* list, int* out) {
+    int n = 0;
+    for (int b = 0; b < list->numBlocks; b++) n += decodeBlock(&list->blocks[b], out + n);
+    return n;
+}
+
+// ---------- postingAdd ----------
+int postingAdd(PostingList* list, int docId) {
+    if (docId < 0) return -1;
+
+    // Append: the common case when documents are added in id order.
+    PostingBlock* tail = list->numBlocks > 0 ? &list->blocks[list->numBlocks - 1] : NULL;
+    if (tail == NULL || docId > tail->last) {
+        if (tail == NULL || tail->count >= POSTING_BLOCK) {
+            tail = insertBlock(list, list->numBlocks);
+            if (tail == NULL) return -1;
+        }
+        if (!appendToBlock(tail, docId)) return -1;
+        list->count++;
+        return 1;
+    }
+
+    // Otherwise rewrite the block it belongs in, splitting it if it gets too big.
+    int at = findBlock(list, docId);
+    PostingBlock* block = &list->blocks[at];
+    int ids[2 * POSTING_BLOCK + 1];
+    int n = decodeBlock(block, ids);
+    int i = 0;
+    while (i < n && ids[i] < docId) i++;
+    if (i < n && ids[i] == docId) return 0;
+    memmove(ids + i + 1, ids + i, (n - i) * sizeof(int));
+    ids[i] = docId;
+    n++;
+
+    if (n <= 2 * POSTING_BLOCK) {
+        if (!encodeBlock(block, ids, n)) return -1;
+    } else {
+        PostingBlock* second = insertBlock(list, at + 1);
+        if (second == NULL) return -1;
+        block = &list->blocks[at];
+        if (!encodeBlock(second, ids + n / 2, n - n / 2) || !encodeBlock(block, ids, n / 2)) return -1;
+    }
+    list->count++;
+    return 1;
+}
+
+// ---------- postingRemove ----------
+bool postingRemove(PostingList* list, int docId) {
+    int at = findBlock(list, docId);
+    if (at == list->numBlocks || list->blocks[at].first > docId) return false;
+
+    PostingBlock* block = &list->blocks[at];
+    int ids[2 * POSTING_BLOCK];
+    int n = decodeBlock(block, ids);
+    int i = 0;
+    while (i < n && ids[i] < docId) i++;
+    if (i == n || ids[i] != docId) return false;
+    memmove(ids + i, ids + i + 1, (n - i - 1) * sizeof(int));
+    n--;
+
+    if (n == 0) {
+        free(block->data);
+        memmove(list->blocks + at, list->blocks + at + 1, (list->numBlocks - at - 1) * sizeof(PostingBlock));
+        list->numBlocks--;
+    } else if (!encodeBlock(block, ids, n)) {
+        return false;
+    }
+    list->count--;
+    return true;
+}
+
+// ---------- postingBytes ----------
+size_t postingBytes(const PostingList* list) {
+    size_t bytes = list->blockCap * sizeof(PostingBlock);
+    for (int b = 0; b < list->numBlocks; b++) bytes += list->blocks[b].cap;
+    return bytes;
+}
+
+// ---------- postingFree ----------
+void postingFree(PostingList* list) {
+    for (int b = 0; b < list->numBlocks; b++) free(list->blocks[b].data);
+    free(list->blocks);
+    memset(list, 0, sizeof(PostingList));
+}
+
+// ---------- intersectPosting ----------
+int intersectPosting(int* ids, int count, const PostingList* list) {
+    // Blocks that cannot hold the next id are skipped without being decoded.
+    int decoded[2 * POSTING_BLOCK];
+    int numDecoded = 0, pos = 0;
+    int current = -1;
+    int b = 0, n = 0;
+    for (int i = 0; i < count; i++) {
+        while (b < list->numBlocks && list->blocks[b].last < ids[i]) b++;
+        if (b == list->numBlocks) break;
+        if (list->blocks[b].first > ids[i]) continue;
+
+        if (current != b) {
+            numDecoded = decodeBlock(&list->blocks[b], decoded);
+            pos = 0;
+            current = b;
+        }
+        while (pos < numDecoded && decoded[pos] < ids[i]) pos++;
+        if (pos < numDecoded && decoded[pos] == ids[i]) ids[n++] = ids[i];
+    }
+    return n;
+}
+
+// ---------- unionSorted ----------
+int unionSorted(const int* a, int aCount, const int* b, int bCount, int* out) {
+    int i = 0, j = 0, n = 0;
+    while (i < aCount && j < bCount) {
+        if (a[i] < b[j]) out[n++] = a[i++];
+        else if (b[j] < a[i]) out[n++] = b[j++];
+        else {
+            out[n++] = a[i++];
+            j++;
+        }
+    }
+    while (i < aCount) out[n++] = a[i++];
+    while (j < bCount) out[n++] = b[j++];
+    return n;
+}
+
+// ---------- intersectSorted ----------
+int intersectSorted(int* a, int aCount, const int* b, int bCount) {
+    int i = 0, j = 0, n = 0;
+    while (i < aCount && j < bCount) {
+        if (a[i] < b[j]) i++;
+        else if (b[j] < a[i]) j++;
+        else {
+            a[n++] = a[i++];
+            j++;
+        }
+    }
+    return n;
+}
+
+// ---------- subtractSorted ----------
+int subtractSorted(int* a, int aCount, const int* b, int bCount) {
+    int i = 0, j = 0, n = 0;
+    while (i < aCount) {
+        while (j < bCount && b[j] < a[i]) j++;
+        if (j < bCount && b[j] == a[i]) i++;
+        else a[n++] = a[i++];
+    }
+    return n;
+}
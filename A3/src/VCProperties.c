@@ -0,0 +1,93 @@
+// VCProperties.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Property name table with RFC 6350 cardinalities and name -> id lookup.
+
+#include "VCProperties.h"
+#include <string.h>
+#include <strings.h>
+
+typedef struct propInfo {
+    const char*     name;
+    PropCardinality cardinality;
+} PropInfo;
+
+// Sorted by name so that propertyId can binary search it.
+// BEGIN, END and VERSION frame the card, so they may appear at most once.
+static const PropInfo propTable[NUM_KNOWN_PROPS] = {
+    { "ADR",          CARD_ANY },
+    { "ANNIVERSARY",  CARD_ZERO_OR_ONE },
+    { "BDAY",         CARD_ZERO_OR_ONE },
+    { "BEGIN",        CARD_ONE },
+    { "CALADRURI",    CARD_ANY },
+    { "CALURI",       CARD_ANY },
+    { "CATEGORIES",   CARD_ANY },
+    { "CLIENTPIDMAP", CARD_ANY },
+    { "EMAIL",        CARD_ANY },
+    { "END",          CARD_ONE },
+    { "FBURL",        CARD_ANY },
+    { "FN",           CARD_ONE_OR_MORE },
+    { "GENDER",       CARD_ZERO_OR_ONE },
+    { "GEO",          CARD_ANY },
+    { "IMPP",         CARD_ANY },
+    { "KEY",          CARD_ANY },
+    { "KIND",         CARD_ZERO_OR_ONE },
+    { "LANG",         CARD_ANY },
+    { "LOGO",         CARD_ANY },
+    { "MEMBER",       CARD_ANY },
+    { "N",            CARD_ZERO_OR_ONE },
+    { "NICKNAME",     CARD_ANY },
+    { "NOTE",         CARD_ANY },
+    { "ORG",          CARD_ANY },
+    { "PHOTO",        CARD_ANY },
+    { "PRODID",       CARD_ZERO_OR_ONE },
+    { "RELATED",      CARD_ANY },
+    { "REV",          CARD_ZERO_OR_ONE },
+    { "ROLE",         CARD_ANY },
+    { "SOUND",        CARD_ANY },
+    { "SOURCE",       CARD_ANY },
+    { "TEL",          CARD_ANY },
+    { "TITLE",        CARD_ANY },
+    { "TZ",           CARD_ANY },
+    { "UID",          CARD_ZERO_OR_ONE },
+    { "URL",          CARD_ANY },
+    { "VERSION",      CARD_ONE },
+    { "XML",          CARD_ANY }
+};
+
+// ---------- propertyId ----------
+int propertyId(const char* name) {
+    if (name == NULL) return PROP_UNKNOWN;
+
+    int lo = 0, hi = NUM_KNOWN_PROPS - 1;
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+        int cmp = strcasecmp(name, propTable[mid].name);
+        if (cmp == 0) return mid;
+        if (cmp < 0) hi = mid - 1;
+        else lo = mid + 1;
+    }
+
+    // Extended properties, RFC 6350 Section 6.10.
+    if ((name[0] == 'X' || name[0] == 'x') && name[1] == '-' && name[2] != '\0') {
+        return PROP_EXTENDED;
+    }
+    return PROP_UNKNOWN;
+}
+
+// ---------- propertyCardinality ----------
+PropCardinality propertyCardinality(int id) {
+    if (id < 0 || id >= NUM_KNOWN_PROPS) return CARD_ANY;
+    return propTable[id].cardinality;
+}
+
+// ---------- propertyName ----------
+const char* propertyName(int id) {
+    if (id < 0 || id >= NUM_KNOWN_PROPS) return NULL;
+    return propTable[id].name;
+}
+
+// ---------- propertyIsRepeatable ----------
+bool propertyIsRepeatable(int id) {
+    PropCardinality c = propertyCardinality(id);
+    return c == CARD_ONE_OR_MORE || c == CARD_ANY;
+}
@@ -0,0 +1,668 @@
+// VCRelations.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: UID dictionary and a graph of MEMBER and RELATED links over it, kept in
+//              compressed (CSR) arrays in both directions, with the cards changed since
+//              the arrays were built held in per-card lists beside them.
+
+#include "VCRelations.h"
+#include "VCDocTable.h"
+#include "VCUid.h"
+#include <stdint.h>
+#include <strings.h>
+
+// The compressed arrays are rebuilt once the changed cards hold more than this many
+// links plus a quarter of the graph.
+#define RELATION_CHANGES_MIN 1024
+
+#define DOC_PRESENT 1
+#define DOC_GROUP   2
+
+// The card's links are in changedOut, not in the compressed arrays
+#define DOC_CHANGED 4
+
+// A link: to a UID in the forward arrays, from a card in the backward ones
+typedef struct relationEdge {
+    int target;
+    int kind;
+} RelationEdge;
+
+typedef struct edgeList {
+    RelationEdge* edges;
+    int           count;
+    int           cap;
+} EdgeList;
+
+struct relationGraph {
+    // UID dictionary, with a hash table of ids by UID (-1 for empty slots)
+    char**         uids;
+    int            numUids;
+    int            uidCap;
+    int*           slots;
+    int            numSlots;
+
+    // Cards with each UID, chained through nextSameUid in the order they were added
+    int*           uidOwner;
+
+    // Per card: its UID id (-1 if none), the next card with the same UID, and DOC_ flags
+    int*           docUid;
+    int*           nextSameUid;
+    unsigned char* docFlags;
+    int            docCap;
+
+    // Links of each card (outStart has baseDocs + 1 entries), and the cards linking to
+    // each UID (inStart has baseUids + 1 entries), as of the last rebuild
+    int*           outStart;
+    RelationEdge*  outEdges;
+    int            baseDocs;
+    int*           inStart;
+    RelationEdge*  inEdges;
+    int            baseUids;
+
+    // Links of the cards changed since, by card and by UID
+    EdgeList*      changedOut;
+    EdgeList*      changedIn;
+    int            numChanged;
+
+    int            numEdges;
+};
+
+// Walks the cards linking to a UID: the compressed ones that have not changed since,
+// then the changed ones.
+typedef struct incomingIter {
+    const RelationGraph* graph;
+    const RelationEdge*  base;
+    int                  baseCount;
+    const EdgeList*      changed;
+    int                  pos;
+} IncomingIter;
+
+typedef struct intList {
+    int* items;
+    int  count;
+    int  cap;
+} IntList;
+
+// ---------- Helper function: findSlot ----------
+static int findSlot(const RelationGraph* graph, const char* uid) {
+    uint32_t s = fnvHash(uid) & (graph->numSlots - 1);
+    while (graph->slots[s] != -1 && strcmp(graph->uids[graph->slots[s]], uid) != 0) {
+        s = (s + 1) & (graph->numSlots - 1);
+    }
+    return (int)s;
+}
+
+// ---------- Helper function: growSlots ----------
+static bool growSlots(RelationGraph* graph) {
+    int numSlots = graph->numSlots > 0 ? graph->numSlots * 2 : 256;
+    int* slots = malloc(numSlots * sizeof(int));
+    if (slots == NULL) return false;
+    for (int i = 0; i < numSlots; i++) slots[i] = -1;
+    free(graph->slots);
+    graph->slots = slots;
+    graph->numSlots = numSlots;
+    for (int id = 0; id < graph->numUids; id++) graph->slots[findSlot(graph, graph->uids[id])] = id;
+    return true;
+}
+
+// ---------- Helper function: internUid ----------
+// Id of a UID, added to the dictionary if new.  Takes ownership of uid.  Returns -1 if
+// malloc fails.
+static int internUid(RelationGraph* graph, char* uid) {
+    if (graph->numUids * 2 >= graph->numSlots && !growSlots(graph)) {
+        free(uid);
+        return -1;
+    }
+    int s = findSlot(graph, uid);
+    if (graph->slots[s] != -1) {
+        free(uid);
+        return graph->slots[s];
+    }
+
+    if (graph->numUids == graph->uidCap) {
+        int cap = graph->uidCap > 0 ? graph->uidCap * 2 : 64;
+        char** uids = realloc(graph->uids, cap * sizeof(char*));
+        if (uids != NULL) graph->uids = uids;
+        int* owners = realloc(graph->uidOwner, cap * sizeof(int));
+        if (owners != NULL) graph->uidOwner = owners;
+        EdgeList* changed = realloc(graph->changedIn, cap * sizeof(EdgeList));
+        if (changed != NULL) {
+            memset(changed + graph->uidCap, 0, (cap - graph->uidCap) * sizeof(EdgeList));
+            graph->changedIn = changed;
+        }
+        if (uids == NULL || owners == NULL || changed == NULL) {
+            free(uid);
+            return -1;
+        }
+        graph->uidCap = cap;
+    }
+    int id = graph->numUids++;
+    graph->uids[id] = uid;
+    graph->uidOwner[id] = -1;
+    graph->slots[s] = id;
+    return id;
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(RelationGraph* graph, int docId) {
+    if (docId < graph->docCap) return true;
+    int cap = docCapFor(graph->docCap, docId);
+    int* uids = realloc(graph->docUid, cap * sizeof(int));
+    if (uids != NULL) graph->docUid = uids;
+    int* next = realloc(graph->nextSameUid, cap * sizeof(int));
+    if (next != NULL) graph->nextSameUid = next;
+    unsigned char* flags = realloc(graph->docFlags, cap);
+    if (flags != NULL) graph->docFlags = flags;
+    EdgeList* changed = realloc(graph->changedOut, cap * sizeof(EdgeList));
+    if (changed != NULL) graph->changedOut = changed;
+    if (uids == NULL || next == NULL || flags == NULL || changed == NULL) return false;
+
+    for (int i = graph->docCap; i < cap; i++) {
+        graph->docUid[i] = -1;
+        graph->nextSameUid[i] = -1;
+        graph->docFlags[i] = 0;
+    }
+    memset(graph->changedOut + graph->docCap, 0, (cap - graph->docCap) * sizeof(EdgeList));
+    graph->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: pushEdge ----------
+static bool pushEdge(EdgeList* list, int target, int kind) {
+    if (list->count == list->cap) {
+        int cap = list->cap > 0 ? list->cap * 2 : 4;
+        RelationEdge* bigger = realloc(list->edges, cap * sizeof(RelationEdge));
+        if (bigger == NULL) return false;
+        list->edges = bigger;
+        list->cap = cap;
+    }
+    list->edges[list->count].target = target;
+    list->edges[list->count].kind = kind;
+    list->count++;
+    return true;
+}
+
+// ---------- Helper function: pushInt ----------
+static bool pushInt(IntList* list, int value) {
+    if (list->count == list->cap) {
+        int cap = list->cap > 0 ? list->cap * 2 : 64;
+        int* bigger = realloc(list->items, cap * sizeof(int));
+        if (bigger == NULL) return false;
+        list->items = bigger;
+        list->cap = cap;
+    }
+    list->items[list->count++] = value;
+    return true;
+}
+
+// ---------- Helper function: isTextValue ----------
+static bool isTextValue(const Property* prop) {
+    ListIterator iter = createIterator(prop->parameters);
+    Parameter* param;
+    while ((param = nextElement(&iter)) != NULL) {
+        if (strcasecmp(param->name, "VALUE") == 0 && strcasecmp(param->value, "text") == 0) return true;
+    }
+    return false;
+}
+
+// ---------- Helper function: readCard ----------
+// Reads the UID, kind and links of a card, interning the UIDs and appending the links
+// to edges.  Returns the card's UID id (-1 if it has none) through uidId.
+static bool readCard(RelationGraph* graph, const Card* card, int docId, EdgeList* edges, int* uidId) {
+    *uidId = -1;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        const char* value = getFromFront(prop->values);
+        if (value == NULL) continue;
+
+        int kind = 0;
+        if (strcasecmp(prop->name, "UID") == 0) {
+            if (*uidId != -1) continue;
+        } else if (strcasecmp(prop->name, "KIND") == 0 || strcasecmp(prop->name, "X-ADDRESSBOOKSERVER-KIND") == 0) {
+            if (strcasecmp(value, "group") == 0) graph->docFlags[docId] |= DOC_GROUP;
+            continue;
+        } else if (strcasecmp(prop->name, "MEMBER") == 0 || strcasecmp(prop->name, "X-ADDRESSBOOKSERVER-MEMBER") == 0) {
+            kind = RELATION_MEMBER;
+        } else if (strcasecmp(prop->name, "RELATED") == 0 && !isTextValue(prop)) {
+            kind = RELATION_RELATED;
+        } else {
+            continue;
+        }
+
+        if (value[strspn(value, " \t")] == '\0') continue;
+        char* uid = normalizeUid(value);
+        int id = uid != NULL ? internUid(graph, uid) : -1;
+        if (id == -1) return false;
+        if (kind == 0) *uidId = id;
+        else if (!pushEdge(edges, id, kind)) return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: linkUid ----------
+// Appends a card to the chain of cards with its UID.
+static void linkUid(RelationGraph* graph, int docId, int uidId) {
+    graph->docUid[docId] = uidId;
+    graph->nextSameUid[docId] = -1;
+    if (uidId == -1) return;
+    int* link = &graph->uidOwner[uidId];
+    while (*link != -1) link = &graph->nextSameUid[*link];
+    *link = docId;
+}
+
+// ---------- Helper function: unlinkUid ----------
+static void unlinkUid(RelationGraph* graph, int docId) {
+    int uidId = graph->docUid[docId];
+    if (uidId == -1) return;
+    int* link = &graph->uidOwner[uidId];
+    while (*link != docId) link = &graph->nextSameUid[*link];
+    *link = graph->nextSameUid[docId];
+    graph->docUid[docId] = -1;
+    graph->nextSameUid[docId] = -1;
+}
+
+// ---------- Helper function: outgoing ----------
+// The links of a card.  Returns their number.
+static int outgoing(const RelationGraph* graph, int docId, const RelationEdge** edges) {
+    if (docId < 0 || docId >= graph->docCap || !(graph->docFlags[docId] & DOC_PRESENT)) return 0;
+    if (graph->docFlags[docId] & DOC_CHANGED) {
+        *edges = graph->changedOut[docId].edges;
+        return graph->changedOut[docId].count;
+    }
+    if (docId >= graph->baseDocs) return 0;
+    *edges = graph->outEdges + graph->outStart[docId];
+    return graph->outStart[docId + 1] - graph->outStart[docId];
+}
+
+// ---------- Helper function: incomingIter ----------
+static IncomingIter incomingIter(const RelationGraph* graph, int uidId) {
+    IncomingIter it = { graph, NULL, 0, NULL, 0 };
+    if (uidId < 0) return it;
+    if (uidId < graph->baseUids) {
+        it.base = graph->inEdges + graph->inStart[uidId];
+        it.baseCount = graph->inStart[uidId + 1] - graph->inStart[uidId];
+    }
+    it.changed = &graph->changedIn[uidId];
+    return it;
+}
+
+// ---------- Helper function: nextIncoming ----------
+static const RelationEdge* nextIncoming(IncomingIter* it) {
+    while (it->pos < it->baseCount) {
+        const RelationEdge* e = &it->base[it->pos++];
+        if (!(it->graph->docFlags[e->target] & DOC_CHANGED)) return e;
+    }
+    int i = it->pos++ - it->baseCount;
+    return it->changed != NULL && i < it->changed->count ? &it->changed->edges[i] : NULL;
+}
+
+// ---------- Helper function: buildIncoming ----------
+// Sorts the compressed links by UID (a counting sort) into the backward arrays.
+static bool buildIncoming(RelationGraph* graph) {
+    int numUids = graph->numUids;
+    int numEdges = graph->outStart[graph->baseDocs];
+    int* start = calloc(numUids + 1, sizeof(int));
+    RelationEdge* edges = malloc((numEdges > 0 ? numEdges : 1) * sizeof(RelationEdge));
+    if (start == NULL || edges == NULL) {
+        free(start);
+        free(edges);
+        return false;
+    }
+    for (int i = 0; i < numEdges; i++) start[graph->outEdges[i].target + 1]++;
+    for (int u = 0; u < numUids; u++) start[u + 1] += start[u];
+
+    // Walking the cards in order leaves each UID's list sorted by card.
+    for (int d = 0; d < graph->baseDocs; d++) {
+        for (int i = graph->outStart[d]; i < graph->outStart[d + 1]; i++) {
+            RelationEdge* e = &edges[start[graph->outEdges[i].target]++];
+            e->target = d;
+            e->kind = graph->outEdges[i].kind;
+        }
+    }
+    for (int u = numUids; u > 0; u--) start[u] = start[u - 1];
+    start[0] = 0;
+
+    free(graph->inStart);
+    free(graph->inEdges);
+    graph->inStart = start;
+    graph->inEdges = edges;
+    graph->baseUids = numUids;
+    return true;
+}
+
+// ---------- Helper function: rebuild ----------
+// Moves the links of the changed cards into new compressed arrays.
+static bool rebuild(RelationGraph* graph) {
+    int numDocs = graph->docCap;
+    int* start = malloc((numDocs + 1) * sizeof(int));
+    RelationEdge* edges = malloc((graph->numEdges > 0 ? graph->numEdges : 1) * sizeof(RelationEdge));
+    if (start == NULL || edges == NULL) {
+        free(start);
+        free(edges);
+        return false;
+    }
+    int n = 0;
+    for (int d = 0; d < numDocs; d++) {
+        const RelationEdge* links;
+        int count = outgoing(graph, d, &links);
+        start[d] = n;
+        if (count > 0) memcpy(edges + n, links, count * sizeof(RelationEdge));
+        n += count;
+    }
+    start[numDocs] = n;
+
+    int* oldStart = graph->outStart;
+    RelationEdge* oldEdges = graph->outEdges;
+    int oldDocs = graph->baseDocs;
+    graph->outStart = start;
+    graph->outEdges = edges;
+    graph->baseDocs = numDocs;
+    if (!buildIncoming(graph)) {
+        graph->outStart = oldStart;
+        graph->outEdges = oldEdges;
+        graph->baseDocs = oldDocs;
+        free(start);
+        free(edges);
+        return false;
+    }
+    free(oldStart);
+    free(oldEdges);
+
+    for (int d = 0; d < numDocs; d++) {
+        if (!(graph->docFlags[d] & DOC_CHANGED)) continue;
+        graph->docFlags[d] &= ~DOC_CHANGED;
+        free(graph->changedOut[d].edges);
+        memset(&graph->changedOut[d], 0, sizeof(EdgeList));
+    }
+    for (int u = 0; u < graph->numUids; u++) {
+        free(graph->changedIn[u].edges);
+        memset(&graph->changedIn[u], 0, sizeof(EdgeList));
+    }
+    graph->numChanged = 0;
+    return true;
+}
+
+// ---------- Helper function: dropChanged ----------
+// Removes the backward entries of a changed card's links.
+static void dropChanged(RelationGraph* graph, int docId) {
+    EdgeList* out = &graph->changedOut[docId];
+    for (int i = 0; i < out->count; i++) {
+        EdgeList* in = &graph->changedIn[out->edges[i].target];
+        for (int j = 0; j < in->count; j++) {
+            if (in->edges[j].target == docId) {
+                memmove(in->edges + j, in->edges + j + 1, (in->count - j - 1) * sizeof(RelationEdge));
+                in->count--;
+                break;
+            }
+        }
+    }
+    out->count = 0;
+}
+
+// ---------- Helper function: markVisited ----------
+// Sets a card's bit, and returns whether it was already set.
+static bool markVisited(unsigned char* visited, int docId) {
+    bool seen = visited[docId >> 3] & (1 << (docId & 7));
+    visited[docId >> 3] |= 1 << (docId & 7);
+    return seen;
+}
+
+// ---------- Helper function: compareInts ----------
+static int compareInts(const void* first, const void* second) {
+    int a = *(const int*)first, b = *(const int*)second;
+    return (a > b) - (a < b);
+}
+
+// ---------- Helper function: finishList ----------
+// Sorts the list into *docIds and returns its length, or -1 after a failed push.
+static int finishList(IntList* list, bool failed, int** docIds) {
+    if (failed) {
+        free(list->items);
+        *docIds = NULL;
+        return -1;
+    }
+    qsort(list->items, list->count, sizeof(int), compareInts);
+    if (list->count == 0) {
+        free(list->items);
+        list->items = NULL;
+    }
+    *docIds = list->items;
+    return list->count;
+}
+
+// ---------- createRelationGraph ----------
+RelationGraph* createRelationGraph(void) {
+    return calloc(1, sizeof(RelationGraph));
+}
+
+// ---------- buildRelationGraph ----------
+RelationGraph* buildRelationGraph(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    RelationGraph* graph = createRelationGraph();
+    if (graph == NULL) return NULL;
+
+    // Links go straight into the compressed arrays, card by card.
+    int count = corpus->count;
+    EdgeList edges = { NULL, 0, 0 };
+    bool ok = reserveDoc(graph, count) && (graph->outStart = malloc((graph->docCap + 1) * sizeof(int))) != NULL;
+    for (int d = 0; ok && d < count; d++) {
+        graph->outStart[d] = edges.count;
+        const Card* card = corpus->cards[d];
+        if (card == NULL) continue;
+        int uidId;
+        graph->docFlags[d] |= DOC_PRESENT;
+        ok = readCard(graph, card, d, &edges, &uidId);
+        if (ok) linkUid(graph, d, uidId);
+    }
+    if (ok) {
+        for (int d = count; d <= graph->docCap; d++) graph->outStart[d] = edges.count;
+        graph->outEdges = edges.edges;
+        graph->baseDocs = graph->docCap;
+        graph->numEdges = edges.count;
+        edges.edges = NULL;
+        ok = buildIncoming(graph);
+    }
+    free(edges.edges);
+    if (!ok) {
+        deleteRelationGraph(graph);
+        return NULL;
+    }
+    return graph;
+}
+
+// ---------- relationGraphAddCard ----------
+VCardErrorCode relationGraphAddCard(RelationGraph* graph, const Card* card, int docId) {
+    if (graph == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (!reserveDoc(graph, docId)) return OTHER_ERROR;
+    relationGraphRemoveCard(graph, docId);
+
+    EdgeList* out = &graph->changedOut[docId];
+    int uidId;
+    graph->docFlags[docId] = DOC_PRESENT | DOC_CHANGED;
+    bool ok = readCard(graph, card, docId, out, &uidId);
+    for (int i = 0; ok && i < out->count; i++) {
+        ok = pushEdge(&graph->changedIn[out->edges[i].target], docId, out->edges[i].kind);
+        if (!ok) out->count = i;
+    }
+    if (!ok) {
+        dropChanged(graph, docId);
+        graph->docFlags[docId] = DOC_CHANGED;
+        return OTHER_ERROR;
+    }
+    linkUid(graph, docId, uidId);
+    graph->numEdges += out->count;
+    graph->numChanged += out->count + 1;
+
+    // A failed rebuild leaves the links beside the arrays, where they are still found.
+    if (graph->numChanged > RELATION_CHANGES_MIN + graph->numEdges / 4) rebuild(graph);
+    return OK;
+}
+
+// ---------- relationGraphRemoveCard ----------
+void relationGraphRemoveCard(RelationGraph* graph, int docId) {
+    if (graph == NULL || docId < 0 || docId >= graph->docCap) return;
+    if (!(graph->docFlags[docId] & DOC_PRESENT)) return;
+
+    const RelationEdge* links;
+    graph->numEdges -= outgoing(graph, docId, &links);
+    unlinkUid(graph, docId);
+    if (graph->docFlags[docId] & DOC_CHANGED) dropChanged(graph, docId);
+
+    // The card's entries in the compressed arrays are skipped from now on.
+    graph->docFlags[docId] = DOC_CHANGED;
+    graph->numChanged++;
+    if (graph->numChanged > RELATION_CHANGES_MIN + graph->numEdges / 4) rebuild(graph);
+}
+
+// ---------- relationGraphFind ----------
+int relationGraphFind(const RelationGraph* graph, const char* uid) {
+    if (graph == NULL || uid == NULL || graph->numSlots == 0) return -1;
+    char* key = normalizeUid(uid);
+    if (key == NULL) return -1;
+    int id = graph->slots[findSlot(graph, key)];
+    free(key);
+    return id != -1 ? graph->uidOwner[id] : -1;
+}
+
+// ---------- relationGraphIsGroup ----------
+bool relationGraphIsGroup(const RelationGraph* graph, int docId) {
+    if (graph == NULL || docId < 0 || docId >= graph->docCap) return false;
+    return (graph->docFlags[docId] & DOC_GROUP) != 0;
+}
+
+// ---------- relationGraphLinks ----------
+int relationGraphLinks(const RelationGraph* graph, int docId, int kinds, RelationLink* out, int maxResults) {
+    if (graph == NULL || out == NULL) return 0;
+    const RelationEdge* links;
+    int count = outgoing(graph, docId, &links);
+    int n = 0;
+    for (int i = 0; i < count && n < maxResults; i++) {
+        if (!(links[i].kind & kinds)) continue;
+        out[n].kind = links[i].kind;
+        out[n].uid = graph->uids[links[i].target];
+        out[n].docId = graph->uidOwner[links[i].target];
+        n++;
+    }
+    return n;
+}
+
+// ---------- relationGraphMembers ----------
+int relationGraphMembers(const RelationGraph* graph, int groupId, bool transitive, int** docIds) {
+    if (graph == NULL || docIds == NULL) return -1;
+    *docIds = NULL;
+    if (groupId < 0 || groupId >= graph->docCap) return 0;
+
+    IntList members = { NULL, 0, 0 };
+    IntList stack = { NULL, 0, 0 };
+    unsigned char* visited = calloc(graph->docCap / 8 + 1, 1);
+    bool failed = visited == NULL || !pushInt(&stack, groupId);
+    if (!failed) markVisited(visited, groupId);
+
+    // Depth-first over the nested groups
+    while (!failed && stack.count > 0) {
+        const RelationEdge* links;
+        int count = outgoing(graph, stack.items[--stack.count], &links);
+        for (int i = 0; i < count && !failed; i++) {
+            int member = graph->uidOwner[links[i].target];
+            if (links[i].kind != RELATION_MEMBER || member == -1 || markVisited(visited, member)) continue;
+            if (transitive && (graph->docFlags[member] & DOC_GROUP)) failed = !pushInt(&stack, member);
+            else failed = !pushInt(&members, member);
+        }
+    }
+    free(stack.items);
+    free(visited);
+    return finishList(&members, failed, docIds);
+}
+
+// ---------- relationGraphGroupsOf ----------
+int relationGraphGroupsOf(const RelationGraph* graph, int docId, bool transitive, int** docIds) {
+    if (graph == NULL || docIds == NULL) return -1;
+    *docIds = NULL;
+    if (docId < 0 || docId >= graph->docCap) return 0;
+
+    IntList groups = { NULL, 0, 0 };
+    unsigned char* visited = calloc(graph->docCap / 8 + 1, 1);
+    bool failed = visited == NULL;
+    if (!failed) markVisited(visited, docId);
+
+    // The groups found so far double as the queue of cards whose groups are wanted.
+    int next = docId;
+    for (int done = 0; !failed && next != -1; ) {
+        IncomingIter it = incomingIter(graph, graph->docUid[next]);
+        const RelationEdge* e;
+        while ((e = nextIncoming(&it)) != NULL && !failed) {
+            if (e->kind == RELATION_MEMBER && !markVisited(visited, e->target)) failed = !pushInt(&groups, e->target);
+        }
+        next = transitive && done < groups.count ? groups.items[done++] : -1;
+    }
+    free(visited);
+    return finishList(&groups, failed, docIds);
+}
+
+// ---------- relationTraverse ----------
+int relationTraverse(const RelationGraph* graph, int startId, int maxDepth, int kinds, bool bothWays,
+                     RelationHit* out, int maxResults) {
+    if (graph == NULL || out == NULL || maxResults <= 0 || maxDepth <= 0) return 0;
+    if (startId < 0 || startId >= graph->docCap || !(graph->docFlags[startId] & DOC_PRESENT)) return 0;
+    unsigned char* visited = calloc(graph->docCap / 8 + 1, 1);
+    if (visited == NULL) return 0;
+    markVisited(visited, startId);
+
+    // out is the queue: cards are appended in order of depth, so the search can stop as
+    // soon as it is full.
+    int n = 0;
+    for (int head = -1; head < n && n < maxResults; head++) {
+        int from = head < 0 ? startId : out[head].docId;
+        int depth = head < 0 ? 0 : out[head].depth;
+        if (depth == maxDepth) break;
+
+        const RelationEdge* links;
+        int count = outgoing(graph, from, &links);
+        for (int i = 0; i < count && n < maxResults; i++) {
+            int to = graph->uidOwner[links[i].target];
+            if (!(links[i].kind & kinds) || to == -1 || markVisited(visited, to)) continue;
+            out[n].docId = to;
+            out[n].depth = depth + 1;
+            out[n].parent = from;
+            n++;
+        }
+        if (!bothWays) continue;
+        IncomingIter it = incomingIter(graph, graph->docUid[from]);
+        const RelationEdge* e;
+        while (n < maxResults && (e = nextIncoming(&it)) != NULL) {
+            if (!(e->kind & kinds) || markVisited(visited, e->target)) continue;
+            out[n].docId = e->target;
+            out[n].depth = depth + 1;
+            out[n].parent = from;
+            n++;
+        }
+    }
+    free(visited);
+    return n;
+}
+
+// ---------- relationGraphSize ----------
+int relationGraphSize(const RelationGraph* graph) {
+    return graph != NULL ? graph->numEdges : 0;
+}
+
+// ---------- deleteRelationGraph ----------
+void deleteRelationGraph(RelationGraph* graph) {
+    if (graph == NULL) return;
+    for (int i = 0; i < graph->numUids; i++) free(graph->uids[i]);
+    for (int i = 0; i < graph->uidCap; i++) free(graph->changedIn[i].edges);
+    for (int i = 0; i < graph->docCap; i++) free(graph->changedOut[i].edges);
+    free(graph->uids);
+    free(graph->slots);
+    free(graph->uidOwner);
+    free(graph->docUid);
+    free(graph->nextSameUid);
+    free(graph->docFlags);
+    free(graph->outStart);
+    free(graph->outEdges);
+    free(graph->inStart);
+    free(graph->inEdges);
+    free(graph->changedIn);
+    free(graph->changedOut);
+    free(graph);
+}
@@ -0,0 +1,341 @@
+// VCReport.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Collect-all-errors validation reports and a parallel corpus validator.
+
+#include "VCReport.h"
+#include "VCCorpus.h"
+#include "VCProperties.h"
+#include <stdarg.h>
+#include <stdint.h>
+#include <strings.h>
+
+static const char* kindNames[NUM_VIOLATION_KINDS] = {
+    "parse", "missing-fn", "bad-name", "no-value", "bad-param",
+    "n-values", "date-prop", "version-prop", "cardinality", "bad-date"
+};
+
+// ---------- Helper function: addViolation ----------
+static void addViolation(List* list, ViolationKind kind, VCardErrorCode code,
+                         const char* propName, int index, const char* fmt, ...) {
+    Violation* v = malloc(sizeof(Violation));
+    if (v == NULL) return;
+
+    char buffer[256];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(buffer, sizeof(buffer), fmt, args);
+    va_end(args);
+
+    v->kind = kind;
+    v->code = code;
+    v->propName = strdup(propName != NULL ? propName : "");
+    v->index = index;
+    v->reason = strdup(buffer);
+    insertBack(list, v);
+}
+
+// ---------- Helper function: checkProperty ----------
+// Records every problem with a single property, in the order validateProperty checks them.
+// Returns the property id.
+static int checkProperty(const Property* prop, bool optional, int index, List* out) {
+    const char* name = (prop->name != NULL) ? prop->name : "";
+    int id = PROP_UNKNOWN;
+
+    if (prop->name == NULL || strlen(prop->name) == 0) {
+        addViolation(out, VIOL_BAD_NAME, INV_PROP, name, index, "property name is empty");
+    } else {
+        id = propertyId(prop->name);
+        if (id == PROP_UNKNOWN) {
+            addViolation(out, VIOL_BAD_NAME, INV_PROP, name, index, "unknown property name");
+        } else if (id == PROP_EXTENDED) {
+            addViolation(out, VIOL_BAD_NAME, INV_PROP, name, index, "extended (X-) properties are not allowed");
+        }
+    }
+    if (prop->group == NULL) {
+        addViolation(out, VIOL_BAD_NAME, INV_PROP, name, index, "group is NULL");
+    }
+
+    if (prop->values == NULL || getLength(prop->values) == 0) {
+        addViolation(out, VIOL_NO_VALUE, INV_PROP, name, index, "property has no values");
+    }
+
+    if (prop->parameters == NULL) {
+        addViolation(out, VIOL_BAD_PARAM, INV_PROP, name, index, "parameter list is NULL");
+    } else {
+        ListIterator iter = createIterator(prop->parameters);
+        Parameter* param;
+        while ((param = nextElement(&iter)) != NULL) {
+            if (param->name == NULL || strlen(param->name) == 0) {
+                addViolation(out, VIOL_BAD_PARAM, INV_PROP, name, index, "parameter name is empty");
+            }
+            if (param->value == NULL || strlen(param->value) == 0) {
+                addViolation(out, VIOL_BAD_PARAM, INV_PROP, name, index, "parameter %s has no value",
+                             param->name != NULL ? param->name : "");
+            }
+        }
+    }
+
+    if (optional && prop->name != NULL) {
+        if (strcasecmp(prop->name, "N") == 0 && prop->values != NULL && getLength(prop->values) != 5) {
+            addViolation(out, VIOL_N_VALUES, INV_PROP, name, index,
+                         "N has %d values, expected 5", getLength(prop->values));
+        }
+        if (strcasecmp(prop->name, "BDAY") == 0 || strcasecmp(prop->name, "ANNIVERSARY") == 0) {
+            addViolation(out, VIOL_DATE_PROP, INV_DT, name, index, "%s must be stored as a DateTime", name);
+        }
+    }
+    return id;
+}
+
+// ---------- Helper function: checkDateTime ----------
+static void checkDateTime(const DateTime* dt, const char* name, int index, List* out) {
+    if (dt->date == NULL || dt->time == NULL || dt->text == NULL) {
+        addViolation(out, VIOL_BAD_DATE, INV_DT, name, index, "date, time or text is NULL");
+        return;
+    }
+    if (dt->isText) {
+        if (strlen(dt->date) != 0 || strlen(dt->time) != 0) {
+            addViolation(out, VIOL_BAD_DATE, INV_DT, name, index, "text value also has a date or time");
+        }
+        if (dt->UTC) {
+            addViolation(out, VIOL_BAD_DATE, INV_DT, name, index, "text value is marked UTC");
+        }
+    } else {
+        if (strlen(dt->date) == 0) {
+            addViolation(out, VIOL_BAD_DATE, INV_DT, name, index, "date is empty");
+        }
+        if (strlen(dt->text) != 0) {
+            addViolation(out, VIOL_BAD_DATE, INV_DT, name, index, "non-text value has text");
+        }
+    }
+}
+
+// ---------- Helper function: newReport ----------
+static ValidationReport* newReport(void) {
+    ValidationReport* report = malloc(sizeof(ValidationReport));
+    if (report == NULL) return NULL;
+    report->result = OK;
+    report->violations = initializeList(violationToString, deleteViolation, compareViolations);
+    return report;
+}
+
+// ---------- Helper function: appendAll ----------
+// Moves every element of src to the back of dst and frees src.
+static void appendAll(List* dst, List* src) {
+    void* data;
+    while ((data = getFromFront(src)) != NULL) {
+        deleteDataFromList(src, data);
+        insertBack(dst, data);
+    }
+    freeList(src);
+}
+
+// ---------- validateCardReport ----------
+ValidationReport* validateCardReport(const Card* obj) {
+    ValidationReport* report = newReport();
+    if (report == NULL) return NULL;
+    List* out = report->violations;
+
+    if (obj == NULL) {
+        addViolation(out, VIOL_MISSING_FN, INV_CARD, "", VIOL_INDEX_CARD, "card is NULL");
+        report->result = INV_CARD;
+        return report;
+    }
+
+    if (obj->fn == NULL) {
+        addViolation(out, VIOL_MISSING_FN, INV_CARD, "FN", VIOL_INDEX_FN, "card has no FN property");
+    } else {
+        checkProperty(obj->fn, false, VIOL_INDEX_FN, out);
+    }
+
+    if (obj->optionalProperties == NULL) {
+        addViolation(out, VIOL_BAD_NAME, INV_CARD, "", VIOL_INDEX_CARD, "optional property list is NULL");
+    } else {
+        // validateCard reports VERSION and cardinality problems only after every
+        // property has been checked, so collect them separately and append them.
+        List* late = initializeList(violationToString, deleteViolation, compareViolations);
+        List* dups = initializeList(violationToString, deleteViolation, compareViolations);
+        uint64_t seen = 0;
+        int index = 0;
+
+        ListIterator iter = createIterator(obj->optionalProperties);
+        Property* prop;
+        while ((prop = nextElement(&iter)) != NULL) {
+            int id = checkProperty(prop, true, index, out);
+            if (id >= 0 && !propertyIsRepeatable(id)) {
+                uint64_t bit = (uint64_t)1 << id;
+                if (seen & bit) {
+                    addViolation(dups, VIOL_CARDINALITY, INV_PROP, prop->name, index,
+                                 "%s may occur at most once", propertyName(id));
+                }
+                seen |= bit;
+            }
+            if (prop->name != NULL && strcasecmp(prop->name, "VERSION") == 0) {
+                addViolation(late, VIOL_VERSION_PROP, INV_CARD, prop->name, index,
+                             "VERSION must not be an optional property");
+            }
+            index++;
+        }
+        appendAll(late, dups);
+        appendAll(out, late);
+    }
+
+    if (obj->birthday != NULL) {
+        checkDateTime(obj->birthday, "BDAY", VIOL_INDEX_BIRTHDAY, out);
+    }
+    if (obj->anniversary != NULL) {
+        checkDateTime(obj->anniversary, "ANNIVERSARY", VIOL_INDEX_ANNIVERSARY, out);
+    }
+
+    Violation* first = getFromFront(out);
+    report->result = (first != NULL) ? first->code : OK;
+    return report;
+}
+
+// ---------- validateFileReport ----------
+ValidationReport* validateFileReport(char* fileName) {
+    Card* card = NULL;
+    VCardErrorCode err = createCard(fileName, &card);
+    if (err != OK) {
+        ValidationReport* report = newReport();
+        if (report == NULL) return NULL;
+        char* errStr = errorToString(err);
+        addViolation(report->violations, VIOL_PARSE, err, "", VIOL_INDEX_CARD, "%s", errStr);
+        free(errStr);
+        report->result = err;
+        return report;
+    }
+    ValidationReport* report = validateCardReport(card);
+    deleteCard(card);
+    return report;
+}
+
+// ---------- deleteValidationReport ----------
+void deleteValidationReport(ValidationReport* report) {
+    if (report == NULL) return;
+    if (report->violations) freeList(report->violations);
+    free(report);
+}
+
+// ---------- reportToString ----------
+char* reportToString(const ValidationReport* report) {
+    if (report == NULL) return strdup("null");
+    char* resultStr = errorToString(report->result);
+    char* listStr = toString(report->violations);
+    int size = snprintf(NULL, 0, "Result: %s, Violations: %d%s",
+                        resultStr, getLength(report->violations), listStr ? listStr : "") + 1;
+    char* result = malloc(size);
+    if (result != NULL) {
+        snprintf(result, size, "Result: %s, Violations: %d%s",
+                 resultStr, getLength(report->violations), listStr ? listStr : "");
+    }
+    free(resultStr);
+    free(listStr);
+    return result;
+}
+
+// ---------- deleteViolation ----------
+void deleteViolation(void* toBeDeleted) {
+    if (toBeDeleted == NULL) return;
+    Violation* v = (Violation*)toBeDeleted;
+    if (v->propName) free(v->propName);
+    if (v->reason) free(v->reason);
+    free(v);
+}
+
+// ---------- compareViolations ----------
+// Orders by kind, then by index.
+int compareViolations(const void* first, const void* second) {
+    const Violation* v1 = (const Violation*)first;
+    const Violation* v2 = (const Violation*)second;
+    if (v1->kind != v2->kind) return (int)v1->kind - (int)v2->kind;
+    return v1->index - v2->index;
+}
+
+// ---------- violationToString ----------
+char* violationToString(void* violation) {
+    if (violation == NULL) return strdup("");
+    Violation* v = (Violation*)violation;
+    int size = snprintf(NULL, 0, "\n Kind: %s, Property: %s, Index: %d, Reason: %s",
+                        violationKindName(v->kind), v->propName, v->index, v->reason) + 1;
+    char* result = malloc(size);
+    if (result != NULL) {
+        snprintf(result, size, "\n Kind: %s, Property: %s, Index: %d, Reason: %s",
+                 violationKindName(v->kind), v->propName, v->index, v->reason);
+    }
+    return result;
+}
+
+// ---------- violationKindName ----------
+const char* violationKindName(ViolationKind kind) {
+    if (kind < 0 || kind >= NUM_VIOLATION_KINDS) return "unknown";
+    return kindNames[kind];
+}
+
+// ---------- Corpus validation ----------
+
+typedef struct corpusJob {
+    const char*  dirName;
+    char**       names;
+    CorpusStats* perThread;
+} CorpusJob;
+
+// ---------- Helper function: validateCorpusFile ----------
+static void validateCorpusFile(int index, int thread, void* ctx) {
+    CorpusJob* job = (CorpusJob*)ctx;
+    CorpusStats* stats = &job->perThread[thread];
+
+    char* path = joinPath(job->dirName, job->names[index]);
+    if (path == NULL) return;
+    ValidationReport* report = validateFileReport(path);
+    free(path);
+    if (report == NULL) return;
+
+    stats->numFiles++;
+    if (report->result == OK) stats->numValid++;
+    if (report->result >= OK && report->result <= OTHER_ERROR) {
+        stats->errorCounts[report->result]++;
+    }
+    ListIterator iter = createIterator(report->violations);
+    Violation* v;
+    while ((v = nextElement(&iter)) != NULL) {
+        stats->kindCounts[v->kind]++;
+    }
+    deleteValidationReport(report);
+}
+
+// ---------- validateCorpus ----------
+VCardErrorCode validateCorpus(const char* dirName, int numThreads, CorpusStats* stats) {
+    if (dirName == NULL || stats == NULL) return OTHER_ERROR;
+    memset(stats, 0, sizeof(CorpusStats));
+
+    char** names;
+    int count;
+    VCardErrorCode err = listCardFiles(dirName, &names, &count);
+    if (err != OK) return err;
+
+    numThreads = resolveThreadCount(numThreads);
+    CorpusJob job;
+    job.dirName = dirName;
+    job.names = names;
+    job.perThread = calloc(numThreads, sizeof(CorpusStats));
+    if (job.perThread == NULL) {
+        freeCardFileList(names, count);
+        return OTHER_ERROR;
+    }
+
+    err = runParallel(count, numThreads, validateCorpusFile, &job);
+
+    // Merge the per-thread histograms.
+    for (int t = 0; t < numThreads; t++) {
+        CorpusStats* s = &job.perThread[t];
+        stats->numFiles += s->numFiles;
+        stats->numValid += s->numValid;
+        for (int i = 0; i <= OTHER_ERROR; i++) stats->errorCounts[i] += s->errorCounts[i];
+        for (int i = 0; i < NUM_VIOLATION_KINDS; i++) stats->kindCounts[i] += s->kindCounts[i];
+    }
+
+    free(job.perThread);
+    freeCardFileList(names, count);
+    return err;
+}
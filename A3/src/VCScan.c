@@ -0,0 +1,216 @@
+// VCScan.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Parallel directory scan that packs per-file results into a column-oriented table.
+
+#include "VCScan.h"
+#include "VCCorpus.h"
+#include "VCDates.h"
+#include <sys/stat.h>
+
+// Buffer size a date is first formatted into; longer (text) dates get a bigger one.
+#define SCAN_DATE_LEN 64
+
+// Result for one file, filled by a worker thread before packing.  Strings are NULL
+// where the card has no value (or could not be parsed).
+typedef struct scanRow {
+    char*     fn;
+    char*     birthday;
+    char*     anniversary;
+    DateParts bdayParts;
+    DateParts annParts;
+    long long mtime;
+    long long size;
+    int       error;
+} ScanRow;
+
+typedef struct scanJob {
+    const char* dirName;
+    char**      names;
+    ScanRow*    rows;
+} ScanJob;
+
+// ---------- Helper function: isoString ----------
+// dateToISO into a new string.  A text date may be any length, so the buffer is doubled
+// until the result fits with room to spare.  Returns NULL if malloc fails.
+static char* isoString(const DateTime* dt) {
+    size_t size = SCAN_DATE_LEN;
+    while (true) {
+        char* buffer = malloc(size);
+        if (buffer == NULL) return NULL;
+        int len = dateToISO(dt, buffer, size);
+        if (len < 0 || (size_t)len + 1 < size) return buffer;
+        free(buffer);
+        size *= 2;
+    }
+}
+
+// ---------- Helper function: scanOneFile ----------
+static void scanOneFile(int index, int thread, void* ctx) {
+    ScanJob* job = (ScanJob*)ctx;
+    ScanRow* row = &job->rows[index];
+    dateToParts(NULL, &row->bdayParts);
+    dateToParts(NULL, &row->annParts);
+
+    char* path = joinPath(job->dirName, job->names[index]);
+    if (path == NULL) {
+        row->error = OTHER_ERROR;
+        return;
+    }
+
+    struct stat st;
+    if (stat(path, &st) == 0) {
+        row->mtime = (long long)st.st_mtime;
+        row->size = (long long)st.st_size;
+    }
+
+    Card* card = NULL;
+    row->error = createCardValidated(path, &card);
+    free(path);
+    if (row->error != OK) return;
+
+    const char* fn = getFromFront(card->fn->values);
+    row->fn = strdup(fn != NULL ? fn : "");
+    row->birthday = isoString(card->birthday);
+    row->anniversary = isoString(card->anniversary);
+    dateToParts(card->birthday, &row->bdayParts);
+    dateToParts(card->anniversary, &row->annParts);
+    deleteCard(card);
+
+    if (row->fn == NULL || row->birthday == NULL || row->anniversary == NULL) {
+        free(row->fn);
+        free(row->birthday);
+        free(row->anniversary);
+        row->fn = row->birthday = row->anniversary = NULL;
+        dateToParts(NULL, &row->bdayParts);
+        dateToParts(NULL, &row->annParts);
+        row->error = OTHER_ERROR;
+    }
+}
+
+// ---------- Helper function: allocTable ----------
+static ScanTable* allocTable(int count) {
+    ScanTable* table = calloc(1, sizeof(ScanTable));
+    if (table == NULL) return NULL;
+    size_t n = count > 0 ? count : 1;
+    table->count = count;
+    table->nameOff = malloc(n * sizeof(size_t));
+    table->fnOff = malloc(n * sizeof(size_t));
+    table->bdayOff = malloc(n * sizeof(size_t));
+    table->annOff = malloc(n * sizeof(size_t));
+    table->bdayYear = malloc(n * sizeof(int));
+    table->bdayMonth = malloc(n * sizeof(int));
+    table->bdayDay = malloc(n * sizeof(int));
+    table->annYear = malloc(n * sizeof(int));
+    table->annMonth = malloc(n * sizeof(int));
+    table->annDay = malloc(n * sizeof(int));
+    table->mtime = malloc(n * sizeof(long long));
+    table->size = malloc(n * sizeof(long long));
+    table->error = malloc(n * sizeof(int));
+    if (!table->nameOff || !table->fnOff || !table->bdayOff || !table->annOff ||
+        !table->bdayYear || !table->bdayMonth || !table->bdayDay ||
+        !table->annYear || !table->annMonth || !table->annDay ||
+        !table->mtime || !table->size || !table->error) {
+        freeScanTable(table);
+        return NULL;
+    }
+    return table;
+}
+
+// ---------- Helper function: packString ----------
+static size_t packString(ScanTable* table, size_t* used, const char* str) {
+    size_t off = *used;
+    size_t len = strlen(str) + 1;
+    memcpy(table->strings + off, str, len);
+    *used += len;
+    return off;
+}
+
+// ---------- scanCardFiles ----------
+ScanTable* scanCardFiles(const char* dirName, char** names, int count, int numThreads) {
+    if (dirName == NULL || (count > 0 && names == NULL)) return NULL;
+    if (count < 0) count = 0;
+
+    ScanTable* table = allocTable(count);
+    if (table == NULL) return NULL;
+    ScanRow* rows = calloc(count > 0 ? count : 1, sizeof(ScanRow));
+    if (rows == NULL) {
+        freeScanTable(table);
+        return NULL;
+    }
+
+    ScanJob job = { dirName, names, rows };
+    runParallel(count, numThreads, scanOneFile, &job);
+
+    // Size the string buffer, then pack every row into it.
+    size_t total = 1;
+    for (int i = 0; i < count; i++) {
+        total += strlen(names[i]) + 1;
+        total += (rows[i].fn != NULL ? strlen(rows[i].fn) : 0) + 1;
+        total += (rows[i].birthday != NULL ? strlen(rows[i].birthday) : 0) + 1;
+        total += (rows[i].anniversary != NULL ? strlen(rows[i].anniversary) : 0) + 1;
+    }
+    table->strings = malloc(total);
+    if (table->strings == NULL) {
+        for (int i = 0; i < count; i++) {
+            free(rows[i].fn);
+            free(rows[i].birthday);
+            free(rows[i].anniversary);
+        }
+        free(rows);
+        freeScanTable(table);
+        return NULL;
+    }
+
+    size_t used = 0;
+    for (int i = 0; i < count; i++) {
+        table->nameOff[i] = packString(table, &used, names[i]);
+        table->fnOff[i] = packString(table, &used, rows[i].fn != NULL ? rows[i].fn : "");
+        table->bdayOff[i] = packString(table, &used, rows[i].birthday != NULL ? rows[i].birthday : "");
+        table->annOff[i] = packString(table, &used, rows[i].anniversary != NULL ? rows[i].anniversary : "");
+        table->bdayYear[i] = rows[i].bdayParts.year;
+        table->bdayMonth[i] = rows[i].bdayParts.month;
+        table->bdayDay[i] = rows[i].bdayParts.day;
+        table->annYear[i] = rows[i].annParts.year;
+        table->annMonth[i] = rows[i].annParts.month;
+        table->annDay[i] = rows[i].annParts.day;
+        table->mtime[i] = rows[i].mtime;
+        table->size[i] = rows[i].size;
+        table->error[i] = rows[i].error;
+        free(rows[i].fn);
+        free(rows[i].birthday);
+        free(rows[i].anniversary);
+    }
+    table->stringsSize = used;
+    free(rows);
+    return table;
+}
+
+// ---------- scanCardDirectory ----------
+ScanTable* scanCardDirectory(const char* dirName, int numThreads) {
+    char** names;
+    int count;
+    if (listCardFiles(dirName, &names, &count) != OK) return NULL;
+    ScanTable* table = scanCardFiles(dirName, names, count, numThreads);
+    freeCardFileList(names, count);
+    return table;
+}
+
+// ---------- freeScanTable ----------
+void freeScanTable(ScanTable* table) {
+    if (table == NULL) return;
+    free(table->strings);
+    free(table->nameOff);
+    free(table->fnOff);
+    free(table->bdayOff);
+    free(table->annOff);
+    free(table->bdayYear);
+    free(table->bdayMonth);
+    free(table->bdayDay);
+    free(table->annYear);
+    free(table->annMonth);
+    free(table->annDay);
+    free(table->mtime);
+    free(table->size);
+    free(table->error);
+    free(table);
+}
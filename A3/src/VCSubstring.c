@@ -0,0 +1,382 @@
+// VCSubstring.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Trigram index over the folded values of selected properties, with
+//              posting-list intersection and verification against the stored values.
+
+#include "VCSubstring.h"
+#include "VCDocTable.h"
+#include "VCPostings.h"
+#include "VCText.h"
+#include <stdint.h>
+#include <strings.h>
+
+#define GRAM 3
+
+typedef struct gram {
+    // 0 marks an empty slot; grams of strings never contain a NUL byte.
+    uint32_t    key;
+    PostingList docs;
+} Gram;
+
+typedef struct storedValue {
+    // Folded value
+    char* text;
+
+    // Position of the property in propNames
+    int   prop;
+} StoredValue;
+
+typedef struct docValues {
+    StoredValue* values;
+    int          count;
+} DocValues;
+
+struct substringIndex {
+    char**     propNames;
+    int        numProps;
+
+    // Open-addressing table of grams
+    Gram*      grams;
+    int        numGrams;
+    int        gramCap;
+
+    DocValues* docs;
+    int        docCap;
+};
+
+static const char* const defaultProps[] = { "FN", "ORG", "NOTE", "EMAIL" };
+
+// ---------- Helper function: gramAt ----------
+static uint32_t gramAt(const char* s) {
+    const unsigned char* u = (const unsigned char*)s;
+    return ((uint32_t)u[0] << 16) | ((uint32_t)u[1] << 8) | u[2];
+}
+
+// ---------- Helper function: hashGram ----------
+static uint32_t hashGram(uint32_t key) {
+    key *= 0x9E3779B1u;
+    return key ^ (key >> 15);
+}
+
+// ---------- Helper function: findGram ----------
+// Returns the slot holding key, or the empty slot where it would go.
+static int findGram(const SubstringIndex* index, uint32_t key) {
+    uint32_t s = hashGram(key) & (index->gramCap - 1);
+    while (index->grams[s].key != 0 && index->grams[s].key != key) s = (s + 1) & (index->gramCap - 1);
+    return (int)s;
+}
+
+// ---------- Helper function: growGrams ----------
+static bool growGrams(SubstringIndex* index) {
+    int cap = index->gramCap > 0 ? index->gramCap * 2 : 4096;
+    Gram* grams = calloc(cap, sizeof(Gram));
+    if (grams == NULL) return false;
+    for (int i = 0; i < index->gramCap; i++) {
+        if (index->grams[i].key == 0) continue;
+        uint32_t s = hashGram(index->grams[i].key) & (cap - 1);
+        while (grams[s].key != 0) s = (s + 1) & (cap - 1);
+        grams[s] = index->grams[i];
+    }
+    free(index->grams);
+    index->grams = grams;
+    index->gramCap = cap;
+    return true;
+}
+
+// ---------- Helper function: compareGrams ----------
+static int compareGrams(const void* first, const void* second) {
+    uint32_t a = *(const uint32_t*)first;
+    uint32_t b = *(const uint32_t*)second;
+    return (a > b) - (a < b);
+}
+
+// ---------- Helper function: docGrams ----------
+// The distinct grams of a document's values, as a newly allocated sorted array.
+// Returns the number of grams, or -1 if malloc fails.
+static int docGrams(const DocValues* doc, uint32_t** grams) {
+    size_t total = 0;
+    for (int v = 0; v < doc->count; v++) {
+        size_t len = strlen(doc->values[v].text);
+        if (len >= GRAM) total += len - GRAM + 1;
+    }
+    *grams = malloc((total + 1) * sizeof(uint32_t));
+    if (*grams == NULL) return -1;
+
+    int n = 0;
+    for (int v = 0; v < doc->count; v++) {
+        const char* text = doc->values[v].text;
+        for (int i = 0; text[i] != '\0' && text[i + 1] != '\0' && text[i + 2] != '\0'; i++) {
+            (*grams)[n++] = gramAt(text + i);
+        }
+    }
+    qsort(*grams, n, sizeof(uint32_t), compareGrams);
+    int unique = 0;
+    for (int i = 0; i < n; i++) {
+        if (unique == 0 || (*grams)[i] != (*grams)[unique - 1]) (*grams)[unique++] = (*grams)[i];
+    }
+    return unique;
+}
+
+// ---------- Helper function: propIndex ----------
+static int propIndex(const SubstringIndex* index, const char* name) {
+    for (int p = 0; p < index->numProps; p++) {
+        if (strcasecmp(index->propNames[p], name) == 0) return p;
+    }
+    return -1;
+}
+
+// ---------- Helper function: storeValue ----------
+static bool storeValue(DocValues* doc, const char* value, int prop) {
+    if (value == NULL || value[0] == '\0') return true;
+    char* text = foldText(value);
+    if (text == NULL) return false;
+    StoredValue* values = realloc(doc->values, (doc->count + 1) * sizeof(StoredValue));
+    if (values == NULL) {
+        free(text);
+        return false;
+    }
+    doc->values = values;
+    doc->values[doc->count].text = text;
+    doc->values[doc->count].prop = prop;
+    doc->count++;
+    return true;
+}
+
+// ---------- Helper function: storeProperty ----------
+static bool storeProperty(const SubstringIndex* index, DocValues* doc, const Property* prop) {
+    int p = propIndex(index, prop->name);
+    if (p < 0) return true;
+    ListIterator iter = createIterator(prop->values);
+    char* value;
+    while ((value = nextElement(&iter)) != NULL) {
+        if (!storeValue(doc, value, p)) return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: clearDoc ----------
+static void clearDoc(DocValues* doc) {
+    for (int v = 0; v < doc->count; v++) free(doc->values[v].text);
+    free(doc->values);
+    doc->values = NULL;
+    doc->count = 0;
+}
+
+// ---------- Helper function: verify ----------
+static bool verify(const DocValues* doc, const char* pattern, int prop) {
+    for (int v = 0; v < doc->count; v++) {
+        if ((prop < 0 || doc->values[v].prop == prop) && strstr(doc->values[v].text, pattern) != NULL) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// ---------- Helper function: compareCounts ----------
+static int compareCounts(const void* first, const void* second) {
+    const PostingList* a = *(const PostingList* const*)first;
+    const PostingList* b = *(const PostingList* const*)second;
+    return (a->count > b->count) - (a->count < b->count);
+}
+
+// ---------- Helper function: candidates ----------
+// Documents holding every gram of the pattern, in increasing order.
+// Returns the number of documents (in *out), or -1 if malloc fails.
+static int candidates(const SubstringIndex* index, const char* pattern, int** out) {
+    *out = NULL;
+    int len = (int)strlen(pattern);
+    const PostingList** lists = malloc((len - GRAM + 1) * sizeof(PostingList*));
+    if (lists == NULL) return -1;
+
+    int numLists = 0;
+    for (int i = 0; i + GRAM <= len; i++) {
+        int s = findGram(index, gramAt(pattern + i));
+        if (index->grams[s].key == 0 || index->grams[s].docs.count == 0) {
+            free(lists);
+            return 0;
+        }
+        bool repeat = false;
+        for (int l = 0; l < numLists && !repeat; l++) repeat = lists[l] == &index->grams[s].docs;
+        if (!repeat) lists[numLists++] = &index->grams[s].docs;
+    }
+
+    // Start from the shortest list, so every step can only shrink the result.
+    qsort(lists, numLists, sizeof(PostingList*), compareCounts);
+    int* ids = malloc(lists[0]->count * sizeof(int));
+    if (ids == NULL) {
+        free(lists);
+        return -1;
+    }
+    int n = postingDecode(lists[0], ids);
+    for (int i = 1; i < numLists && n > 0; i++) {
+        n = intersectPosting(ids, n, lists[i]);
+    }
+    free(lists);
+    *out = ids;
+    return n;
+}
+
+// ---------- createSubstringIndex ----------
+SubstringIndex* createSubstringIndex(const char* const* propNames, int numProps) {
+    if (propNames == NULL) {
+        propNames = defaultProps;
+        numProps = sizeof(defaultProps) / sizeof(defaultProps[0]);
+    }
+    SubstringIndex* index = calloc(1, sizeof(SubstringIndex));
+    if (index == NULL) return NULL;
+    index->propNames = calloc(numProps > 0 ? numProps : 1, sizeof(char*));
+    if (index->propNames == NULL || !growGrams(index)) {
+        deleteSubstringIndex(index);
+        return NULL;
+    }
+    for (int p = 0; p < numProps; p++) {
+        index->propNames[p] = malloc(strlen(propNames[p]) + 1);
+        if (index->propNames[p] == NULL) {
+            deleteSubstringIndex(index);
+            return NULL;
+        }
+        strcpy(index->propNames[p], propNames[p]);
+        index->numProps++;
+    }
+    return index;
+}
+
+// ---------- buildSubstringIndex ----------
+SubstringIndex* buildSubstringIndex(const CardCorpus* corpus, const char* const* propNames, int numProps) {
+    if (corpus == NULL) return NULL;
+    SubstringIndex* index = createSubstringIndex(propNames, numProps);
+    if (index == NULL) return NULL;
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (substringIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteSubstringIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- substringIndexAddCard ----------
+VCardErrorCode substringIndexAddCard(SubstringIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (docId >= index->docCap) {
+        int cap = docCapFor(index->docCap, docId);
+        DocValues* docs = realloc(index->docs, cap * sizeof(DocValues));
+        if (docs == NULL) return OTHER_ERROR;
+        memset(docs + index->docCap, 0, (cap - index->docCap) * sizeof(DocValues));
+        index->docs = docs;
+        index->docCap = cap;
+    }
+    substringIndexRemoveCard(index, docId);
+    DocValues* doc = &index->docs[docId];
+
+    bool ok = card->fn == NULL || storeProperty(index, doc, card->fn);
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        ok = storeProperty(index, doc, prop);
+    }
+
+    uint32_t* grams = NULL;
+    int numGrams = ok ? docGrams(doc, &grams) : -1;
+    for (int g = 0; g < numGrams && ok; g++) {
+        if (2 * (index->numGrams + 1) > index->gramCap && !growGrams(index)) {
+            ok = false;
+            break;
+        }
+        int s = findGram(index, grams[g]);
+        if (index->grams[s].key == 0) {
+            index->grams[s].key = grams[g];
+            index->numGrams++;
+        }
+        ok = postingAdd(&index->grams[s].docs, docId) >= 0;
+    }
+    free(grams);
+    if (!ok || numGrams < 0) {
+        substringIndexRemoveCard(index, docId);
+        return OTHER_ERROR;
+    }
+    return OK;
+}
+
+// ---------- substringIndexRemoveCard ----------
+void substringIndexRemoveCard(SubstringIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    DocValues* doc = &index->docs[docId];
+    if (doc->count == 0) return;
+
+    uint32_t* grams = NULL;
+    int numGrams = docGrams(doc, &grams);
+    for (int g = 0; g < numGrams; g++) {
+        int s = findGram(index, grams[g]);
+        if (index->grams[s].key != 0) postingRemove(&index->grams[s].docs, docId);
+    }
+    free(grams);
+    clearDoc(doc);
+}
+
+// ---------- substringSearch ----------
+int substringSearch(const SubstringIndex* index, const char* pattern, const char* propName, int** docIds) {
+    if (index == NULL || pattern == NULL || docIds == NULL) return -1;
+    *docIds = NULL;
+    int prop = -1;
+    if (propName != NULL && (prop = propIndex(index, propName)) < 0) return 0;
+
+    char* folded = foldText(pattern);
+    if (folded == NULL) return -1;
+
+    int* ids = NULL;
+    int n = 0;
+    if (strlen(folded) >= GRAM) {
+        n = candidates(index, folded, &ids);
+    } else {
+        // Too short for a trigram: every document with values is a candidate.
+        ids = malloc((index->docCap + 1) * sizeof(int));
+        for (int d = 0; ids != NULL && d < index->docCap; d++) {
+            if (index->docs[d].count > 0) ids[n++] = d;
+        }
+        if (ids == NULL) n = -1;
+    }
+
+    // Trigrams may come from different values, or from other properties.
+    int matches = 0;
+    for (int i = 0; i < n; i++) {
+        if (verify(&index->docs[ids[i]], folded, prop)) ids[matches++] = ids[i];
+    }
+    free(folded);
+    if (n < 0) return -1;
+    if (matches == 0) {
+        free(ids);
+        return 0;
+    }
+    *docIds = ids;
+    return matches;
+}
+
+// ---------- substringIndexSize ----------
+int substringIndexSize(const SubstringIndex* index) {
+    return index != NULL ? index->numGrams : 0;
+}
+
+// ---------- substringIndexPostingBytes ----------
+size_t substringIndexPostingBytes(const SubstringIndex* index) {
+    if (index == NULL) return 0;
+    size_t bytes = 0;
+    for (int g = 0; g < index->gramCap; g++) {
+        if (index->grams[g].key != 0) bytes += postingBytes(&index->grams[g].docs);
+    }
+    return bytes;
+}
+
+// ---------- deleteSubstringIndex ----------
+void deleteSubstringIndex(SubstringIndex* index) {
+    if (index == NULL) return;
+    for (int p = 0; p < index->numProps; p++) free(index->propNames[p]);
+    for (int g = 0; g < index->gramCap; g++) postingFree(&index->grams[g].docs);
+    for (int d = 0; d < index->docCap; d++) clearDoc(&index->docs[d]);
+    free(index->propNames);
+    free(index->grams);
+    free(index->docs);
+    free(index);
+}
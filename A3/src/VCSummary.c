@@ -0,0 +1,114 @@
+// VCSummary.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Fills fixed-size card summaries, one card or a batch at a time.
+
+#include "VCSummary.h"
+#include "VCCorpus.h"
+
+// ---------- Helper function: clearSummary ----------
+static void clearSummary(CardSummary* out) {
+    out->fn[0] = '\0';
+    out->birthday[0] = '\0';
+    out->anniversary[0] = '\0';
+    out->numProps = 0;
+    out->error = OK;
+}
+
+// ---------- Helper function: copyDate ----------
+// Same text as dateToString, written straight into the summary buffer.
+static void copyDate(const DateTime* dt, char* buffer, size_t size) {
+    if (dt == NULL) {
+        snprintf(buffer, size, "None");
+    } else if (dt->isText) {
+        snprintf(buffer, size, "Text: %s", dt->text);
+    } else {
+        snprintf(buffer, size, "Date: %s, Time: %s, UTC: %s",
+                 dt->date, dt->time, dt->UTC ? "Yes" : "No");
+    }
+}
+
+// ---------- summarizeCard ----------
+VCardErrorCode summarizeCard(const Card* obj, CardSummary* out) {
+    clearSummary(out);
+    if (obj == NULL) {
+        out->error = INV_CARD;
+        return INV_CARD;
+    }
+
+    const char* fn = NULL;
+    if (obj->fn != NULL && obj->fn->values != NULL) {
+        fn = getFromFront(obj->fn->values);
+    }
+    snprintf(out->fn, sizeof(out->fn), "%s", fn != NULL ? fn : "null");
+    copyDate(obj->birthday, out->birthday, sizeof(out->birthday));
+    copyDate(obj->anniversary, out->anniversary, sizeof(out->anniversary));
+    out->numProps = getLength(obj->optionalProperties);
+    return OK;
+}
+
+// ---------- summarizeFile ----------
+VCardErrorCode summarizeFile(char* fileName, bool validate, CardSummary* out) {
+    Card* card = NULL;
+    VCardErrorCode err = validate ? createCardValidated(fileName, &card) : createCard(fileName, &card);
+    if (err != OK) {
+        clearSummary(out);
+        out->error = err;
+        return err;
+    }
+    summarizeCard(card, out);
+    deleteCard(card);
+    return OK;
+}
+
+typedef struct summaryJob {
+    char**       fileNames;
+    bool         validate;
+    CardSummary* out;
+    int*         okPerThread;
+} SummaryJob;
+
+// ---------- Helper function: summarizeJobFile ----------
+static void summarizeJobFile(int index, int thread, void* ctx) {
+    SummaryJob* job = (SummaryJob*)ctx;
+    if (summarizeFile(job->fileNames[index], job->validate, &job->out[index]) == OK) {
+        job->okPerThread[thread]++;
+    }
+}
+
+// ---------- summarizeFiles ----------
+int summarizeFiles(char** fileNames, int count, bool validate, int numThreads, CardSummary* out) {
+    if (fileNames == NULL || out == NULL || count <= 0) return 0;
+
+    numThreads = resolveThreadCount(numThreads);
+    SummaryJob job;
+    job.fileNames = fileNames;
+    job.validate = validate;
+    job.out = out;
+    job.okPerThread = calloc(numThreads, sizeof(int));
+    if (job.okPerThread == NULL) return 0;
+
+    runParallel(count, numThreads, summarizeJobFile, &job);
+
+    int numOk = 0;
+    for (int t = 0; t < numThreads; t++) {
+        numOk += job.okPerThread[t];
+    }
+    free(job.okPerThread);
+    return numOk;
+}
+
+// ---------- allocSummaries ----------
+CardSummary* allocSummaries(int count) {
+    if (count <= 0) return NULL;
+    return calloc(count, sizeof(CardSummary));
+}
+
+// ---------- freeSummaries ----------
+void freeSummaries(CardSummary* summaries) {
+    free(summaries);
+}
+
+// ---------- freeString ----------
+void freeString(char* str) {
+    free(str);
+}
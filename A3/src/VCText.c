@@ -0,0 +1,55 @@
+// VCText.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Text normalization shared by the in-memory indexes.
+
+#include "VCText.h"
+#include <ctype.h>
+
+// ---------- foldText ----------
+char* foldText(const char* s) {
+    if (s == NULL) return NULL;
+
+    char* out = malloc(strlen(s) + 1);
+    if (out == NULL) return NULL;
+
+    size_t n = 0;
+    bool space = false;
+    for (const unsigned char* p = (const unsigned char*)s; *p; p++) {
+        if (isspace(*p)) {
+            space = (n > 0);
+            continue;
+        }
+        if (space) {
+            out[n++] = ' ';
+            space = false;
+        }
+        if (*p < 0x80) {
+            out[n++] = (char)tolower(*p);
+        } else if (*p == 0xC3 && p[1] >= 0x80 && p[1] <= 0x9E && p[1] != 0x97) {
+            // U+00C0..U+00DE (except U+00D7): the lowercase letter is 0x20 higher.
+            out[n++] = (char)*p;
+            out[n++] = (char)(*++p + 0x20);
+        } else {
+            out[n++] = (char)*p;
+        }
+    }
+    out[n] = '\0';
+    return out;
+}
+
+// ---------- Helper function: isWordByte ----------
+static bool isWordByte(unsigned char c) {
+    return c >= 0x80 || isalnum(c);
+}
+
+// ---------- nextToken ----------
+const char* nextToken(const char* s, int* len) {
+    const unsigned char* p = (const unsigned char*)s;
+    while (*p && !isWordByte(*p)) p++;
+    if (*p == '\0') return NULL;
+
+    const unsigned char* start = p;
+    while (*p && isWordByte(*p)) p++;
+    *len = (int)(p - start);
+    return (const char*)start;
+}
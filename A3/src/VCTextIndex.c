@@ -0,0 +1,371 @@
+// VCTextIndex.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Inverted index from property-value words to compressed posting lists.
+
+#include "VCTextIndex.h"
+#include "VCDocTable.h"
+#include "VCPostings.h"
+#include "VCText.h"
+#include <ctype.h>
+#include <stdint.h>
+
+// Longer words are indexed by their first TEXT_MAX_WORD bytes.
+#define TEXT_MAX_WORD 64
+
+// Room for "NAME:word".
+#define TEXT_MAX_KEY 192
+
+// Every word is indexed twice: as "word", matching any property, and as "NAME:word".
+typedef struct term {
+    char*       key;
+    PostingList postings;
+} Term;
+
+struct textIndex {
+    Term* terms;
+    int   numTerms;
+    int   termCap;
+
+    // Open-addressing table of indices into terms, -1 for an empty slot.
+    int*  slots;
+    int   numSlots;
+};
+
+// ---------- Helper function: findSlot ----------
+// Returns the slot holding key, or the empty slot where it would go.
+static int findSlot(const TextIndex* index, const char* key) {
+    uint32_t s = fnvHash(key) & (index->numSlots - 1);
+    while (index->slots[s] != -1 && strcmp(index->terms[index->slots[s]].key, key) != 0) {
+        s = (s + 1) & (index->numSlots - 1);
+    }
+    return (int)s;
+}
+
+// ---------- Helper function: findTerm ----------
+static const Term* findTerm(const TextIndex* index, const char* key) {
+    int s = findSlot(index, key);
+    return index->slots[s] != -1 ? &index->terms[index->slots[s]] : NULL;
+}
+
+// ---------- Helper function: growSlots ----------
+static bool growSlots(TextIndex* index) {
+    int numSlots = index->numSlots * 2;
+    int* slots = malloc(numSlots * sizeof(int));
+    if (slots == NULL) return false;
+    for (int i = 0; i < numSlots; i++) slots[i] = -1;
+    for (int i = 0; i < index->numTerms; i++) {
+        uint32_t s = fnvHash(index->terms[i].key) & (numSlots - 1);
+        while (slots[s] != -1) s = (s + 1) & (numSlots - 1);
+        slots[s] = i;
+    }
+    free(index->slots);
+    index->slots = slots;
+    index->numSlots = numSlots;
+    return true;
+}
+
+// ---------- Helper function: getTerm ----------
+// Finds or adds the term for key.
+static Term* getTerm(TextIndex* index, const char* key) {
+    int s = findSlot(index, key);
+    if (index->slots[s] != -1) return &index->terms[index->slots[s]];
+
+    if ((index->numTerms + 1) * 2 > index->numSlots) {
+        if (!growSlots(index)) return NULL;
+        s = findSlot(index, key);
+    }
+    if (index->numTerms == index->termCap) {
+        int cap = index->termCap * 2;
+        Term* bigger = realloc(index->terms, cap * sizeof(Term));
+        if (bigger == NULL) return NULL;
+        index->terms = bigger;
+        index->termCap = cap;
+    }
+
+    Term* term = &index->terms[index->numTerms];
+    term->key = strdup(key);
+    if (term->key == NULL) return NULL;
+    memset(&term->postings, 0, sizeof(PostingList));
+    index->slots[s] = index->numTerms++;
+    return term;
+}
+
+// ---------- Helper function: makeKey ----------
+// Writes "word" (scope NULL) or "SCOPE:word" to key, with the scope in capitals.
+static void makeKey(char* key, const char* scope, const char* word, int len) {
+    int n = 0;
+    if (scope != NULL) {
+        for (const char* p = scope; *p && n < TEXT_MAX_KEY - TEXT_MAX_WORD - 2; p++) {
+            key[n++] = (char)toupper((unsigned char)*p);
+        }
+        key[n++] = ':';
+    }
+    if (len > TEXT_MAX_WORD) len = TEXT_MAX_WORD;
+    memcpy(key + n, word, len);
+    key[n + len] = '\0';
+}
+
+// ---------- Helper function: updateProperty ----------
+static bool updateProperty(TextIndex* index, const Property* prop, int docId, bool add) {
+    char key[TEXT_MAX_KEY];
+    ListIterator iter = createIterator(prop->values);
+    char* value;
+    while ((value = nextElement(&iter)) != NULL) {
+        char* folded = foldText(value);
+        if (folded == NULL) return false;
+
+        const char* word = folded;
+        int len;
+        while ((word = nextToken(word, &len)) != NULL) {
+            for (int scoped = 0; scoped < 2; scoped++) {
+                makeKey(key, scoped ? prop->name : NULL, word, len);
+                if (add) {
+                    Term* term = getTerm(index, key);
+                    if (term == NULL || postingAdd(&term->postings, docId) < 0) {
+                        free(folded);
+                        return false;
+                    }
+                } else {
+                    int s = findSlot(index, key);
+                    if (index->slots[s] != -1) postingRemove(&index->terms[index->slots[s]].postings, docId);
+                }
+            }
+            word += len;
+        }
+        free(folded);
+    }
+    return true;
+}
+
+// ---------- Helper function: updateCard ----------
+static bool updateCard(TextIndex* index, const Card* card, int docId, bool add) {
+    if (!updateProperty(index, card->fn, docId, add)) return false;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (!updateProperty(index, prop, docId, add)) return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: compareCounts ----------
+static int compareCounts(const void* first, const void* second) {
+    const PostingList* a = *(const PostingList* const*)first;
+    const PostingList* b = *(const PostingList* const*)second;
+    return (a->count > b->count) - (a->count < b->count);
+}
+
+// ---------- Helper function: evalGroup ----------
+// Intersects the posting lists of every word of a group of AND-ed terms.
+// Returns the number of matches (in *out), or -1 if malloc fails.
+static int evalGroup(const TextIndex* index, char** terms, int numTerms, int** out) {
+    *out = NULL;
+    // One list per word; a term such as "a-b-c" holds several, so the array grows.
+    int listCap = numTerms + 8;
+    const PostingList** lists = malloc(listCap * sizeof(PostingList*));
+    if (lists == NULL) return -1;
+
+    int numLists = 0;
+    bool missing = false;
+    char key[TEXT_MAX_KEY];
+    for (int t = 0; t < numTerms && !missing; t++) {
+        // NAME:word scopes the words to one property.
+        char* scope = NULL;
+        char* text = terms[t];
+        char* colon = strchr(text, ':');
+        if (colon != NULL && colon != text && colon[1] != '\0') {
+            *colon = '\0';
+            scope = text;
+            text = colon + 1;
+        }
+
+        char* folded = foldText(text);
+        if (folded == NULL) {
+            free(lists);
+            return -1;
+        }
+        const char* word = folded;
+        int len;
+        while ((word = nextToken(word, &len)) != NULL) {
+            makeKey(key, scope, word, len);
+            const Term* term = findTerm(index, key);
+            if (term == NULL || term->postings.count == 0) {
+                missing = true;
+                break;
+            }
+            if (numLists == listCap) {
+                listCap *= 2;
+                const PostingList** bigger = realloc(lists, listCap * sizeof(PostingList*));
+                if (bigger == NULL) {
+                    free(folded);
+                    free(lists);
+                    return -1;
+                }
+                lists = bigger;
+            }
+            lists[numLists++] = &term->postings;
+            word += len;
+        }
+        free(folded);
+    }
+    if (missing || numLists == 0) {
+        free(lists);
+        return 0;
+    }
+
+    // Start from the shortest list, so every step can only shrink the result.
+    qsort(lists, numLists, sizeof(PostingList*), compareCounts);
+    int* ids = malloc(lists[0]->count * sizeof(int));
+    if (ids == NULL) {
+        free(lists);
+        return -1;
+    }
+    int n = postingDecode(lists[0], ids);
+    for (int i = 1; i < numLists && n > 0; i++) {
+        n = intersectPosting(ids, n, lists[i]);
+    }
+    free(lists);
+    *out = ids;
+    return n;
+}
+
+// ---------- createTextIndex ----------
+TextIndex* createTextIndex(void) {
+    TextIndex* index = calloc(1, sizeof(TextIndex));
+    if (index == NULL) return NULL;
+    index->termCap = 256;
+    index->numSlots = 512;
+    index->terms = malloc(index->termCap * sizeof(Term));
+    index->slots = malloc(index->numSlots * sizeof(int));
+    if (index->terms == NULL || index->slots == NULL) {
+        deleteTextIndex(index);
+        return NULL;
+    }
+    for (int i = 0; i < index->numSlots; i++) index->slots[i] = -1;
+    return index;
+}
+
+// ---------- buildTextIndex ----------
+TextIndex* buildTextIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    TextIndex* index = createTextIndex();
+    if (index == NULL) return NULL;
+
+    // Ids arrive in increasing order, so every posting is a plain append.
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (textIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteTextIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- textIndexAddCard ----------
+VCardErrorCode textIndexAddCard(TextIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || card->fn == NULL || docId < 0) return OTHER_ERROR;
+    return updateCard(index, card, docId, true) ? OK : OTHER_ERROR;
+}
+
+// ---------- textIndexRemoveCard ----------
+void textIndexRemoveCard(TextIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || card->fn == NULL) return;
+    updateCard(index, card, docId, false);
+}
+
+// ---------- textIndexQuery ----------
+int textIndexQuery(const TextIndex* index, const char* query, int** docIds) {
+    if (docIds != NULL) *docIds = NULL;
+    if (index == NULL || query == NULL || docIds == NULL) return -1;
+
+    char* copy = strdup(query);
+    char** terms = malloc((strlen(query) / 2 + 1) * sizeof(char*));
+    if (copy == NULL || terms == NULL) {
+        free(copy);
+        free(terms);
+        return -1;
+    }
+
+    int* result = NULL;
+    int count = 0;
+    int numTerms = 0;
+    char* save = NULL;
+    char* tok = strtok_r(copy, " \t", &save);
+    while (true) {
+        bool endOfGroup = (tok == NULL || strcmp(tok, "OR") == 0);
+        if (!endOfGroup) {
+            terms[numTerms++] = tok;
+            tok = strtok_r(NULL, " \t", &save);
+            continue;
+        }
+
+        if (numTerms > 0) {
+            int* ids;
+            int n = evalGroup(index, terms, numTerms, &ids);
+            if (n < 0) {
+                count = -1;
+                break;
+            }
+            if (result == NULL) {
+                result = ids;
+                count = n;
+            } else if (n > 0) {
+                int* merged = malloc((count + n) * sizeof(int));
+                if (merged == NULL) {
+                    free(ids);
+                    count = -1;
+                    break;
+                }
+                count = unionSorted(result, count, ids, n, merged);
+                free(result);
+                result = merged;
+            }
+            if (result != ids) free(ids);
+            numTerms = 0;
+        }
+        if (tok == NULL) break;
+        tok = strtok_r(NULL, " \t", &save);
+    }
+
+    free(terms);
+    free(copy);
+    if (count <= 0) {
+        free(result);
+        result = NULL;
+    }
+    *docIds = result;
+    return count;
+}
+
+// ---------- textIndexTermCount ----------
+int textIndexTermCount(const TextIndex* index) {
+    if (index == NULL) return 0;
+    int n = 0;
+    for (int i = 0; i < index->numTerms; i++) {
+        if (index->terms[i].postings.count > 0) n++;
+    }
+    return n;
+}
+
+// ---------- textIndexPostingBytes ----------
+size_t textIndexPostingBytes(const TextIndex* index) {
+    if (index == NULL) return 0;
+    size_t bytes = 0;
+    for (int i = 0; i < index->numTerms; i++) bytes += postingBytes(&index->terms[i].postings);
+    return bytes;
+}
+
+// ---------- deleteTextIndex ----------
+void deleteTextIndex(TextIndex* index) {
+    if (index == NULL) return;
+    if (index->terms != NULL) {
+        for (int i = 0; i < index->numTerms; i++) {
+            free(index->terms[i].key);
+            postingFree(&index->terms[i].postings);
+        }
+    }
+    free(index->terms);
+    free(index->slots);
+    free(index);
+}
@@ -0,0 +1,541 @@
+// VCUid.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: UID normalization, PID and CLIENTPIDMAP parsing, and a hash index of cards
+//              by UID and of properties by sync key.
+
+#include "VCUid.h"
+#include "VCDocTable.h"
+#include <ctype.h>
+#include <strings.h>
+
+// docUid values of a card that is not in the index, and of one without a UID
+#define DOC_ABSENT -2
+#define DOC_NO_UID -1
+
+// Interned strings, with a hash table of ids by string (-1 for empty slots)
+typedef struct stringTable {
+    char** strings;
+    int    count;
+    int    cap;
+    int*   slots;
+    int    numSlots;
+} StringTable;
+
+// Item of each sync key in the table
+typedef struct syncEntry {
+    // The key: ids of the UID, the property name and the client URI (-1 if the PID value
+    // has no source), and the local id
+    int uid;
+    int name;
+    int client;
+    int local;
+
+    int propIndex;
+} SyncEntry;
+
+struct uidIndex {
+    // Normalized UIDs, with the first card holding each (the others follow it through
+    // nextSameUid, in the order they were added) and the number of cards holding it
+    StringTable uids;
+    int*        uidOwner;
+    int*        uidHolders;
+    int         ownerCap;
+
+    // Upper-cased property names and normalized client URIs of the sync keys
+    StringTable names;
+
+    // Sync keys, chained by card
+    DocTable    keys;
+
+    // Per card: UID id (or DOC_ABSENT or DOC_NO_UID), the next card with the same UID,
+    // and its PID values without a CLIENTPIDMAP
+    int*        docUid;
+    int*        nextSameUid;
+    int*        docUnmapped;
+    int         docCap;
+
+    int         numCards;
+    int         numWithoutUid;
+    int         numUnmapped;
+};
+
+// ---------- Helper function: hashKey ----------
+static uint32_t hashKey(int uid, int name, int client, int local) {
+    uint32_t parts[4] = { (uint32_t)uid, (uint32_t)name, (uint32_t)client, (uint32_t)local };
+    uint32_t h = 2166136261u;
+    for (int i = 0; i < 4; i++) {
+        h ^= parts[i];
+        h *= 16777619u;
+        h ^= h >> 15;
+    }
+    return h;
+}
+
+// ---------- Helper function: findSlot ----------
+static int findSlot(const StringTable* table, const char* s) {
+    uint32_t slot = fnvHash(s) & (table->numSlots - 1);
+    while (table->slots[slot] != -1 && strcmp(table->strings[table->slots[slot]], s) != 0) {
+        slot = (slot + 1) & (table->numSlots - 1);
+    }
+    return (int)slot;
+}
+
+// ---------- Helper function: tableFind ----------
+static int tableFind(const StringTable* table, const char* s) {
+    return table->numSlots > 0 ? table->slots[findSlot(table, s)] : -1;
+}
+
+// ---------- Helper function: tableIntern ----------
+// Id of a string, added to the table if new.  Takes ownership of s.  Returns -1 if
+// malloc fails.
+static int tableIntern(StringTable* table, char* s) {
+    if (table->count * 2 >= table->numSlots) {
+        int numSlots = table->numSlots > 0 ? table->numSlots * 2 : 64;
+        int* slots = malloc(numSlots * sizeof(int));
+        if (slots == NULL) {
+            free(s);
+            return -1;
+        }
+        for (int i = 0; i < numSlots; i++) slots[i] = -1;
+        free(table->slots);
+        table->slots = slots;
+        table->numSlots = numSlots;
+        for (int id = 0; id < table->count; id++) table->slots[findSlot(table, table->strings[id])] = id;
+    }
+
+    int slot = findSlot(table, s);
+    if (table->slots[slot] != -1) {
+        free(s);
+        return table->slots[slot];
+    }
+    if (table->count == table->cap) {
+        int cap = table->cap > 0 ? table->cap * 2 : 64;
+        char** bigger = realloc(table->strings, cap * sizeof(char*));
+        if (bigger == NULL) {
+            free(s);
+            return -1;
+        }
+        table->strings = bigger;
+        table->cap = cap;
+    }
+    table->strings[table->count] = s;
+    table->slots[slot] = table->count;
+    return table->count++;
+}
+
+// ---------- Helper function: upperName ----------
+static char* upperName(const char* name) {
+    char* copy = malloc(strlen(name) + 1);
+    if (copy == NULL) return NULL;
+    int i = 0;
+    for (; name[i] != '\0'; i++) copy[i] = (char)toupper((unsigned char)name[i]);
+    copy[i] = '\0';
+    return copy;
+}
+
+// ---------- Helper function: isUuid ----------
+static bool isUuid(const char* s, size_t len) {
+    if (len != 36) return false;
+    for (size_t i = 0; i < len; i++) {
+        bool dash = i == 8 || i == 13 || i == 18 || i == 23;
+        if (dash ? s[i] != '-' : !isxdigit((unsigned char)s[i])) return false;
+    }
+    return true;
+}
+
+// ---------- Helper function: reserveOwners ----------
+// Makes room for one more UID.
+static bool reserveOwners(UidIndex* index) {
+    if (index->uids.count < index->ownerCap) return true;
+    int cap = index->ownerCap > 0 ? index->ownerCap * 2 : 64;
+    int* owners = realloc(index->uidOwner, cap * sizeof(int));
+    if (owners != NULL) index->uidOwner = owners;
+    int* holders = realloc(index->uidHolders, cap * sizeof(int));
+    if (holders != NULL) index->uidHolders = holders;
+    if (owners == NULL || holders == NULL) return false;
+    index->ownerCap = cap;
+    return true;
+}
+
+// ---------- Helper function: reserveDoc ----------
+static bool reserveDoc(UidIndex* index, int docId) {
+    if (docId < index->docCap) return true;
+    int cap = docCapFor(index->docCap, docId);
+    int* uids = realloc(index->docUid, cap * sizeof(int));
+    if (uids != NULL) index->docUid = uids;
+    int* next = realloc(index->nextSameUid, cap * sizeof(int));
+    if (next != NULL) index->nextSameUid = next;
+    int* unmapped = realloc(index->docUnmapped, cap * sizeof(int));
+    if (unmapped != NULL) index->docUnmapped = unmapped;
+    if (uids == NULL || next == NULL || unmapped == NULL || !docTableReserveDoc(&index->keys, docId)) return false;
+
+    for (int i = index->docCap; i < cap; i++) {
+        index->docUid[i] = DOC_ABSENT;
+        index->nextSameUid[i] = -1;
+        index->docUnmapped[i] = 0;
+    }
+    index->docCap = cap;
+    return true;
+}
+
+// ---------- Helper function: addKey ----------
+static bool addKey(UidIndex* index, int uid, int name, int client, int local, int docId, int propIndex) {
+    int e = docTableAdd(&index->keys, hashKey(uid, name, client, local), docId);
+    if (e == -1) return false;
+
+    SyncEntry* entry = docTableItem(&index->keys, e);
+    entry->uid = uid;
+    entry->name = name;
+    entry->client = client;
+    entry->local = local;
+    entry->propIndex = propIndex;
+    return true;
+}
+
+// ---------- Helper function: sameKey ----------
+static bool sameKey(const SyncEntry* a, const SyncEntry* b) {
+    return a->uid == b->uid && a->name == b->name && a->client == b->client && a->local == b->local;
+}
+
+// ---------- Helper function: clientUri ----------
+// The URI a card's CLIENTPIDMAP gives for a source id, or NULL if it has none.
+static const char* clientUri(const Card* card, int source) {
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        int id;
+        const char* uri;
+        if (strcasecmp(prop->name, "CLIENTPIDMAP") == 0 && parseClientPidMap(prop, &id, &uri) && id == source) {
+            return uri;
+        }
+    }
+    return NULL;
+}
+
+// ---------- Helper function: addProperty ----------
+// Adds the sync keys of one property's PID parameters.
+static bool addProperty(UidIndex* index, const Card* card, const Property* prop, int uid, int docId, int propIndex) {
+    int name = -1;
+    ListIterator iter = createIterator(prop->parameters);
+    Parameter* param;
+    while ((param = nextElement(&iter)) != NULL) {
+        PidValue pids[PID_MAX_VALUES];
+        int count = strcasecmp(param->name, "PID") == 0 ? parsePid(param->value, pids, PID_MAX_VALUES) : -1;
+        for (int i = 0; i < count; i++) {
+            int client = -1;
+            if (pids[i].source != 0) {
+                const char* uri = clientUri(card, pids[i].source);
+                if (uri == NULL) {
+                    index->docUnmapped[docId]++;
+                    index->numUnmapped++;
+                    continue;
+                }
+                char* key = normalizeUid(uri);
+                client = key != NULL ? tableIntern(&index->names, key) : -1;
+                if (client == -1) return false;
+            }
+            if (name == -1) {
+                char* key = upperName(prop->name);
+                name = key != NULL ? tableIntern(&index->names, key) : -1;
+                if (name == -1) return false;
+            }
+            if (!addKey(index, uid, name, client, pids[i].local, docId, propIndex)) return false;
+        }
+    }
+    return true;
+}
+
+// ---------- Helper function: keyOf ----------
+// Ids of a sync key's strings, or false if the index has none of them.
+static bool keyOf(const UidIndex* index, const char* uid, const char* propName, const char* uri,
+                  int* uidId, int* nameId, int* clientId) {
+    char* key = normalizeUid(uid);
+    *uidId = key != NULL ? tableFind(&index->uids, key) : -1;
+    free(key);
+    key = upperName(propName);
+    *nameId = key != NULL ? tableFind(&index->names, key) : -1;
+    free(key);
+    *clientId = -1;
+    if (uri != NULL) {
+        key = normalizeUid(uri);
+        *clientId = key != NULL ? tableFind(&index->names, key) : -1;
+        free(key);
+        if (*clientId == -1) return false;
+    }
+    return *uidId != -1 && *nameId != -1;
+}
+
+// ---------- Helper function: findUid ----------
+static int findUid(const UidIndex* index, const char* uid) {
+    if (index == NULL || uid == NULL) return -1;
+    char* key = normalizeUid(uid);
+    int id = key != NULL ? tableFind(&index->uids, key) : -1;
+    free(key);
+    return id;
+}
+
+// ---------- normalizeUid ----------
+char* normalizeUid(const char* value) {
+    if (value == NULL) return NULL;
+    while (*value == ' ' || *value == '\t') value++;
+    if (strncasecmp(value, "urn:uuid:", 9) == 0) value += 9;
+    size_t len = strlen(value);
+    while (len > 0 && (value[len - 1] == ' ' || value[len - 1] == '\t')) len--;
+
+    char* uid = malloc(len + 1);
+    if (uid == NULL) return NULL;
+    memcpy(uid, value, len);
+    uid[len] = '\0';
+    if (isUuid(uid, len)) {
+        for (size_t i = 0; i < len; i++) uid[i] = (char)tolower((unsigned char)uid[i]);
+    }
+    return uid;
+}
+
+// ---------- parsePid ----------
+int parsePid(const char* value, PidValue* out, int maxValues) {
+    if (value == NULL || out == NULL) return -1;
+    int n = 0;
+    const char* p = value;
+    while (true) {
+        while (*p == ' ') p++;
+        if (!isdigit((unsigned char)*p) || n == maxValues) return -1;
+        char* end;
+        long local = strtol(p, &end, 10);
+        long source = 0;
+        if (*end == '.') {
+            p = end + 1;
+            if (!isdigit((unsigned char)*p)) return -1;
+            source = strtol(p, &end, 10);
+        }
+        if (local > INT32_MAX || source > INT32_MAX) return -1;
+        out[n].local = (int)local;
+        out[n].source = (int)source;
+        n++;
+
+        p = end;
+        while (*p == ' ') p++;
+        if (*p == '\0') return n;
+        if (*p++ != ',') return -1;
+    }
+}
+
+// ---------- parseClientPidMap ----------
+bool parseClientPidMap(const Property* prop, int* sourceId, const char** uri) {
+    if (prop == NULL || sourceId == NULL || uri == NULL || getLength(prop->values) < 2) return false;
+    const char* id = getFromFront(prop->values);
+    const char* value = getFromBack(prop->values);
+    char* end;
+    long n = strtol(id, &end, 10);
+    if (end == id || *end != '\0' || n <= 0 || n > INT32_MAX || value[0] == '\0') return false;
+    *sourceId = (int)n;
+    *uri = value;
+    return true;
+}
+
+// ---------- createUidIndex ----------
+UidIndex* createUidIndex(void) {
+    UidIndex* index = calloc(1, sizeof(UidIndex));
+    if (index == NULL) return NULL;
+    if (!docTableInit(&index->keys, sizeof(SyncEntry))) {
+        deleteUidIndex(index);
+        return NULL;
+    }
+    return index;
+}
+
+// ---------- buildUidIndex ----------
+UidIndex* buildUidIndex(const CardCorpus* corpus) {
+    if (corpus == NULL) return NULL;
+    UidIndex* index = createUidIndex();
+    if (index == NULL) return NULL;
+    if (!reserveDoc(index, corpus->count)) {
+        deleteUidIndex(index);
+        return NULL;
+    }
+
+    for (int i = 0; i < corpus->count; i++) {
+        if (corpus->cards[i] == NULL) continue;
+        if (uidIndexAddCard(index, corpus->cards[i], i) != OK) {
+            deleteUidIndex(index);
+            return NULL;
+        }
+    }
+    return index;
+}
+
+// ---------- uidIndexAddCard ----------
+VCardErrorCode uidIndexAddCard(UidIndex* index, const Card* card, int docId) {
+    if (index == NULL || card == NULL || docId < 0) return OTHER_ERROR;
+    if (!reserveDoc(index, docId)) return OTHER_ERROR;
+    uidIndexRemoveCard(index, docId);
+
+    const Property* uidProp = NULL;
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while (uidProp == NULL && (prop = nextElement(&iter)) != NULL) {
+        if (strcasecmp(prop->name, "UID") == 0) uidProp = prop;
+    }
+    const char* value = uidProp != NULL ? getFromFront(uidProp->values) : NULL;
+    int uid = DOC_NO_UID;
+    if (value != NULL && value[strspn(value, " \t")] != '\0') {
+        if (!reserveOwners(index)) return OTHER_ERROR;
+        int before = index->uids.count;
+        char* key = normalizeUid(value);
+        uid = key != NULL ? tableIntern(&index->uids, key) : -1;
+        if (uid == -1) return OTHER_ERROR;
+        if (index->uids.count > before) {
+            index->uidOwner[uid] = -1;
+            index->uidHolders[uid] = 0;
+        }
+    }
+
+    index->docUid[docId] = uid;
+    index->numCards++;
+    if (uid == DOC_NO_UID) {
+        index->numWithoutUid++;
+        return OK;
+    }
+    int* link = &index->uidOwner[uid];
+    while (*link != -1) link = &index->nextSameUid[*link];
+    *link = docId;
+    index->nextSameUid[docId] = -1;
+    index->uidHolders[uid]++;
+
+    // Sync keys: FN, then the optional properties by position
+    bool ok = card->fn == NULL || addProperty(index, card, card->fn, uid, docId, -1);
+    int propIndex = 0;
+    iter = createIterator(card->optionalProperties);
+    while (ok && (prop = nextElement(&iter)) != NULL) {
+        ok = addProperty(index, card, prop, uid, docId, propIndex++);
+    }
+    if (!ok) {
+        uidIndexRemoveCard(index, docId);
+        return OTHER_ERROR;
+    }
+    return OK;
+}
+
+// ---------- uidIndexRemoveCard ----------
+void uidIndexRemoveCard(UidIndex* index, int docId) {
+    if (index == NULL || docId < 0 || docId >= index->docCap) return;
+    int uid = index->docUid[docId];
+    if (uid == DOC_ABSENT) return;
+
+    docTableRemoveDoc(&index->keys, docId);
+    index->numUnmapped -= index->docUnmapped[docId];
+    index->docUnmapped[docId] = 0;
+
+    if (uid == DOC_NO_UID) {
+        index->numWithoutUid--;
+    } else {
+        int* link = &index->uidOwner[uid];
+        while (*link != docId) link = &index->nextSameUid[*link];
+        *link = index->nextSameUid[docId];
+        index->nextSameUid[docId] = -1;
+        index->uidHolders[uid]--;
+    }
+    index->docUid[docId] = DOC_ABSENT;
+    index->numCards--;
+}
+
+// ---------- uidIndexFind ----------
+int uidIndexFind(const UidIndex* index, const char* uid) {
+    int id = findUid(index, uid);
+    return id != -1 ? index->uidOwner[id] : -1;
+}
+
+// ---------- uidIndexCards ----------
+int uidIndexCards(const UidIndex* index, const char* uid, int* out, int maxResults) {
+    int id = findUid(index, uid);
+    if (id == -1) return 0;
+    int n = 0;
+    for (int d = index->uidOwner[id]; d != -1; d = index->nextSameUid[d]) {
+        if (out != NULL && n < maxResults) out[n] = d;
+        n++;
+    }
+    return n;
+}
+
+// ---------- uidIndexDuplicates ----------
+int uidIndexDuplicates(const UidIndex* index, const char** out, int maxResults) {
+    if (index == NULL || out == NULL) return 0;
+    int n = 0;
+    for (int id = 0; id < index->uids.count && n < maxResults; id++) {
+        if (index->uidHolders[id] > 1) out[n++] = index->uids.strings[id];
+    }
+    return n;
+}
+
+// ---------- syncKeyLookup ----------
+int syncKeyLookup(const UidIndex* index, const char* uid, const char* propName, int localPid,
+                  const char* clientUri, SyncMatch* out, int maxResults) {
+    if (index == NULL || uid == NULL || propName == NULL) return 0;
+    int uidId, nameId, clientId;
+    if (!keyOf(index, uid, propName, clientUri, &uidId, &nameId, &clientId)) return 0;
+
+    SyncEntry key = { uidId, nameId, clientId, localPid, -1 };
+    int n = 0;
+    int e = docTableFind(&index->keys, hashKey(uidId, nameId, clientId, localPid));
+    for (; e != -1; e = docTableNext(&index->keys, e)) {
+        const SyncEntry* entry = docTableItem(&index->keys, e);
+        if (!sameKey(entry, &key)) continue;
+        if (out != NULL && n < maxResults) {
+            out[n].docId = index->keys.entries[e].docId;
+            out[n].propIndex = entry->propIndex;
+        }
+        n++;
+    }
+    return n;
+}
+
+// ---------- uidIndexStats ----------
+void uidIndexStats(const UidIndex* index, UidIndexStats* stats) {
+    if (stats == NULL) return;
+    memset(stats, 0, sizeof(UidIndexStats));
+    if (index == NULL) return;
+    stats->cards = index->numCards;
+    stats->cardsWithoutUid = index->numWithoutUid;
+    stats->syncKeys = index->keys.size;
+    stats->unmappedPids = index->numUnmapped;
+    for (int id = 0; id < index->uids.count; id++) {
+        if (index->uidHolders[id] > 1) stats->duplicateUids++;
+    }
+
+    // A key is a collision if it is held by more than one entry; count it at its first.
+    const DocTable* keys = &index->keys;
+    for (int b = 0; b < keys->numBuckets; b++) {
+        for (int e = keys->buckets[b]; e != -1; e = keys->entries[e].nextInBucket) {
+            const SyncEntry* entry = docTableItem(keys, e);
+            bool first = true;
+            for (int o = keys->buckets[b]; o != e && first; o = keys->entries[o].nextInBucket) {
+                first = !sameKey(docTableItem(keys, o), entry);
+            }
+            if (!first) continue;
+            for (int o = docTableNext(keys, e); o != -1; o = docTableNext(keys, o)) {
+                if (sameKey(docTableItem(keys, o), entry)) {
+                    stats->syncKeyCollisions++;
+                    break;
+                }
+            }
+        }
+    }
+}
+
+// ---------- deleteUidIndex ----------
+void deleteUidIndex(UidIndex* index) {
+    if (index == NULL) return;
+    for (int i = 0; i < index->uids.count; i++) free(index->uids.strings[i]);
+    for (int i = 0; i < index->names.count; i++) free(index->names.strings[i]);
+    free(index->uids.strings);
+    free(index->uids.slots);
+    free(index->names.strings);
+    free(index->names.slots);
+    free(index->uidOwner);
+    free(index->uidHolders);
+    docTableFree(&index->keys);
+    free(index->docUid);
+    free(index->nextSameUid);
+    free(index->docUnmapped);
+    free(index);
+}
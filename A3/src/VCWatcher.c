@@ -0,0 +1,316 @@
+// VCWatcher.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: inotify-based directory watcher with a debounced, coalescing event queue.
+
+#include "VCWatcher.h"
+#include "VCDocTable.h"
+#include <errno.h>
+#include <poll.h>
+#include <stdint.h>
+#include <strings.h>
+#include <sys/inotify.h>
+#include <time.h>
+#include <unistd.h>
+
+#define WATCH_MASK (IN_CREATE | IN_CLOSE_WRITE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF)
+
+// A batch is released after at most this many debounce periods, even if events keep arriving.
+#define WATCH_MAX_DELAY_FACTOR 10
+
+// Kind of a pending entry that cancelled itself out (created, then deleted).
+#define WATCH_NONE -1
+
+typedef struct pendingEvent {
+    char* name;
+    int   kind;
+} PendingEvent;
+
+struct cardWatcher {
+    int           fd;
+    int           wd;
+    char*         dirName;
+    int           debounceMs;
+    bool          rescan;
+
+    // The directory itself was deleted or moved, so wd no longer watches dirName.
+    bool          rewatch;
+    long long     firstEventMs;
+    long long     lastEventMs;
+
+    // Pending changes in arrival order, with an open-addressing hash table of
+    // indices into it (-1 for an empty slot) for finding a file's entry.
+    PendingEvent* pending;
+    int           numPending;
+    int           pendingCap;
+    int*          slots;
+    int           numSlots;
+};
+
+// ---------- Helper function: nowMs ----------
+static long long nowMs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (long long)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+// ---------- Helper function: isCardName ----------
+static bool isCardName(const char* name) {
+    const char* ext = strrchr(name, '.');
+    return ext != NULL && (strcasecmp(ext, ".vcf") == 0 || strcasecmp(ext, ".vcard") == 0);
+}
+
+// ---------- Helper function: rebuildSlots ----------
+// Resizes the hash table to fit the pending array and reinserts every entry.
+static bool rebuildSlots(CardWatcher* w) {
+    int numSlots = 64;
+    while (numSlots < w->pendingCap * 2) numSlots *= 2;
+
+    int* slots = malloc(numSlots * sizeof(int));
+    if (slots == NULL) return false;
+    for (int i = 0; i < numSlots; i++) slots[i] = -1;
+
+    for (int i = 0; i < w->numPending; i++) {
+        uint32_t s = fnvHash(w->pending[i].name) & (numSlots - 1);
+        while (slots[s] != -1) s = (s + 1) & (numSlots - 1);
+        slots[s] = i;
+    }
+    free(w->slots);
+    w->slots = slots;
+    w->numSlots = numSlots;
+    return true;
+}
+
+// ---------- Helper function: mergeKinds ----------
+// Combines the pending kind of a file with a newer event for the same file.
+static int mergeKinds(int older, int newer) {
+    if (older == WATCH_NONE) return newer;
+    if (older == WATCH_CREATED) {
+        if (newer == WATCH_DELETED) return WATCH_NONE;
+        return WATCH_CREATED;
+    }
+    if (older == WATCH_DELETED) {
+        if (newer == WATCH_DELETED) return WATCH_DELETED;
+        return WATCH_MODIFIED;
+    }
+    // older is WATCH_MODIFIED
+    if (newer == WATCH_DELETED) return WATCH_DELETED;
+    return WATCH_MODIFIED;
+}
+
+// ---------- Helper function: addPending ----------
+static void addPending(CardWatcher* w, const char* name, int kind) {
+    uint32_t s = fnvHash(name) & (w->numSlots - 1);
+    while (w->slots[s] != -1) {
+        PendingEvent* e = &w->pending[w->slots[s]];
+        if (strcmp(e->name, name) == 0) {
+            e->kind = mergeKinds(e->kind, kind);
+            return;
+        }
+        s = (s + 1) & (w->numSlots - 1);
+    }
+
+    if (w->numPending == w->pendingCap) {
+        int cap = w->pendingCap * 2;
+        PendingEvent* bigger = realloc(w->pending, cap * sizeof(PendingEvent));
+        if (bigger == NULL) {
+            // Out of memory: fall back to a full comparison of the directory.
+            w->rescan = true;
+            return;
+        }
+        w->pending = bigger;
+        w->pendingCap = cap;
+        if (!rebuildSlots(w)) {
+            w->rescan = true;
+            return;
+        }
+        s = fnvHash(name) & (w->numSlots - 1);
+        while (w->slots[s] != -1) s = (s + 1) & (w->numSlots - 1);
+    }
+
+    char* copy = strdup(name);
+    if (copy == NULL) {
+        w->rescan = true;
+        return;
+    }
+    w->pending[w->numPending].name = copy;
+    w->pending[w->numPending].kind = kind;
+    w->slots[s] = w->numPending;
+    w->numPending++;
+}
+
+// ---------- Helper function: clearPending ----------
+static void clearPending(CardWatcher* w) {
+    for (int i = 0; i < w->numPending; i++) free(w->pending[i].name);
+    w->numPending = 0;
+    for (int i = 0; i < w->numSlots; i++) w->slots[i] = -1;
+}
+
+// ---------- Helper function: readEvents ----------
+// Reads whatever the kernel has queued and merges it into the pending table.
+static int readEvents(CardWatcher* w) {
+    char buffer[8192] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+    while (true) {
+        ssize_t len = read(w->fd, buffer, sizeof(buffer));
+        if (len < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (len == 0) return 0;
+
+        long long now = nowMs();
+        for (char* p = buffer; p < buffer + len; ) {
+            struct inotify_event* ev = (struct inotify_event*)p;
+            p += sizeof(struct inotify_event) + ev->len;
+
+            if (ev->mask & IN_Q_OVERFLOW) {
+                w->rescan = true;
+            } else if (ev->mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)) {
+                // Events for a watch already replaced by rewatchDirectory are stale.
+                if (ev->wd != w->wd) continue;
+                w->rescan = true;
+                w->rewatch = true;
+            } else if (!(ev->mask & IN_ISDIR) && ev->len > 0 && isCardName(ev->name) &&
+                       strlen(ev->name) < WATCH_NAME_LEN) {
+                int kind;
+                if (ev->mask & (IN_CREATE | IN_MOVED_TO)) kind = WATCH_CREATED;
+                else if (ev->mask & (IN_DELETE | IN_MOVED_FROM)) kind = WATCH_DELETED;
+                else kind = WATCH_MODIFIED;
+                addPending(w, ev->name, kind);
+            } else {
+                continue;
+            }
+
+            if (w->numPending == 0 && !w->rescan) continue;
+            if (w->firstEventMs == 0) w->firstEventMs = now;
+            w->lastEventMs = now;
+        }
+    }
+}
+
+// ---------- Helper function: rewatchDirectory ----------
+// Watches dirName again after the directory was deleted and recreated, or moved back.
+static bool rewatchDirectory(CardWatcher* w) {
+    // After IN_MOVE_SELF the old watch is still alive, following the directory to its new name.
+    if (w->wd >= 0) inotify_rm_watch(w->fd, w->wd);
+    w->wd = inotify_add_watch(w->fd, w->dirName, WATCH_MASK | IN_ONLYDIR);
+    w->rewatch = false;
+    return w->wd >= 0;
+}
+
+// ---------- Helper function: takeBatch ----------
+static int takeBatch(CardWatcher* w, WatchEvent* events, int maxEvents) {
+    int n = 0;
+
+    if (w->rescan) {
+        // Watch again before the caller rescans, so changes made during the rescan are seen.
+        if (w->rewatch && !rewatchDirectory(w)) return -1;
+
+        // The caller compares the whole directory, which covers every pending change.
+        events[0].kind = WATCH_RESCAN;
+        events[0].name[0] = '\0';
+        clearPending(w);
+        w->rescan = false;
+        w->firstEventMs = w->lastEventMs = 0;
+        return 1;
+    }
+
+    int i = 0;
+    for (; i < w->numPending && n < maxEvents; i++) {
+        PendingEvent* e = &w->pending[i];
+        if (e->kind != WATCH_NONE) {
+            events[n].kind = (WatchEventKind)e->kind;
+            snprintf(events[n].name, WATCH_NAME_LEN, "%s", e->name);
+            n++;
+        }
+        free(e->name);
+    }
+
+    // Keep whatever did not fit for the next call.
+    int left = w->numPending - i;
+    memmove(w->pending, w->pending + i, left * sizeof(PendingEvent));
+    w->numPending = left;
+    if (!rebuildSlots(w)) w->rescan = true;
+    if (left == 0) w->firstEventMs = w->lastEventMs = 0;
+    return n;
+}
+
+// ---------- createCardWatcher ----------
+CardWatcher* createCardWatcher(const char* dirName, int debounceMs) {
+    if (dirName == NULL) return NULL;
+
+    CardWatcher* w = calloc(1, sizeof(CardWatcher));
+    if (w == NULL) return NULL;
+    w->fd = -1;
+    w->wd = -1;
+    w->dirName = strdup(dirName);
+    w->debounceMs = debounceMs > 0 ? debounceMs : 0;
+    w->pendingCap = 64;
+    w->pending = malloc(w->pendingCap * sizeof(PendingEvent));
+    w->fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (w->pending == NULL || w->dirName == NULL || w->fd < 0 || !rebuildSlots(w)) {
+        deleteCardWatcher(w);
+        return NULL;
+    }
+
+    w->wd = inotify_add_watch(w->fd, dirName, WATCH_MASK | IN_ONLYDIR);
+    if (w->wd < 0) {
+        deleteCardWatcher(w);
+        return NULL;
+    }
+    return w;
+}
+
+// ---------- pollCardWatcher ----------
+int pollCardWatcher(CardWatcher* watcher, int timeoutMs, WatchEvent* events, int maxEvents) {
+    if (watcher == NULL || events == NULL || maxEvents <= 0) return -1;
+
+    long long deadline = (timeoutMs < 0) ? -1 : nowMs() + timeoutMs;
+    long long maxDelay = (long long)watcher->debounceMs * WATCH_MAX_DELAY_FACTOR;
+
+    while (true) {
+        long long now = nowMs();
+        bool ready = watcher->rescan || watcher->numPending > 0;
+        long long wait = -1;
+
+        if (ready) {
+            long long quiet = now - watcher->lastEventMs;
+            long long age = now - watcher->firstEventMs;
+            if (quiet >= watcher->debounceMs || age >= maxDelay) {
+                int n = takeBatch(watcher, events, maxEvents);
+                if (n != 0) return n;
+                continue;
+            }
+            wait = watcher->debounceMs - quiet;
+        }
+        if (deadline >= 0) {
+            if (now >= deadline) return 0;
+            if (wait < 0 || deadline - now < wait) wait = deadline - now;
+        }
+
+        struct pollfd pfd = { watcher->fd, POLLIN, 0 };
+        int rc = poll(&pfd, 1, (int)wait);
+        if (rc < 0) {
+            if (errno == EINTR) continue;
+            return -1;
+        }
+        if (rc > 0 && readEvents(watcher) < 0) return -1;
+    }
+}
+
+// ---------- cardWatcherFd ----------
+int cardWatcherFd(const CardWatcher* watcher) {
+    return watcher != NULL ? watcher->fd : -1;
+}
+
+// ---------- deleteCardWatcher ----------
+void deleteCardWatcher(CardWatcher* watcher) {
+    if (watcher == NULL) return;
+    if (watcher->pending != NULL) clearPending(watcher);
+    if (watcher->fd >= 0) close(watcher->fd);
+    free(watcher->pending);
+    free(watcher->slots);
+    free(watcher->dirName);
+    free(watcher);
+}
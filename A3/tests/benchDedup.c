@@ -0,0 +1,175 @@
+// benchDedup.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Precision/recall harness and timing for findDuplicates.  A synthetic
+//              corpus is generated with duplicates planted at known places, and the
+//              clusters found are scored pair by pair against them.
+//              Usage: benchDedup [cards] [threshold]
+
+#include <ctype.h>
+#include "testCards.h"
+#include "VCDedup.h"
+
+//Pairwise precision and recall below this fail the run
+#define DEDUP_MIN_QUALITY 0.99
+
+//Clusters larger than this are counted but not checked pair by pair
+#define DEDUP_MAX_CHECKED 1000
+
+static const char* syllables[] = {"ka", "to", "ri", "mo", "ne", "sa", "lu", "vi", "de", "ga",
+                                  "po", "shi", "an", "er", "ol", "ur", "ba", "ze", "qui", "fen"};
+
+// ---------- Helper function: makeWord ----------
+// A capitalized made-up word of count syllables chosen by x.
+static void makeWord(char* buffer, unsigned x, int count) {
+    buffer[0] = '\0';
+    for (int i = 0; i < count; i++) {
+        strcat(buffer, syllables[x % 20]);
+        x /= 20;
+    }
+    buffer[0] = toupper((unsigned char)buffer[0]);
+}
+
+// ---------- Helper function: mixBits ----------
+static unsigned mixBits(unsigned x) {
+    x = (x + 0x9E3779B9u) * 0x85EBCA6Bu;
+    x ^= x >> 13;
+    x *= 0xC2B2AE35u;
+    x ^= x >> 16;
+    return x;
+}
+
+// ---------- Helper function: plantedCard ----------
+// Person p written as variant v.  Variant 0 is the original; 1 to 3 are duplicates of it
+// as another address book might hold them:
+//   1 - "Family, Given" name, TEL as 519.555.0142, no NOTE
+//   2 - TEL as a tel: URI, EMAIL in capitals and a second EMAIL
+//   3 - given and family names swapped in N, no work EMAIL, a second EMAIL
+// Only 200 given and 5000 family names are used, so many distinct people share a name.
+static Card* plantedCard(int p, int v, unsigned salt) {
+    unsigned r0 = (unsigned)p * 2654435761u;
+    unsigned r = mixBits((unsigned)p);
+    char first[32], last[32], fn[96], buf[256];
+    makeWord(first, r0 % 200 + 7, 2);
+    makeWord(last, (r0 >> 8) % 5000 + 11, 3);
+
+    if (v == 1) snprintf(fn, sizeof(fn), "%s, %s", last, first);
+    else snprintf(fn, sizeof(fn), "%s %s", first, last);
+    Card* card = NULL;
+    createMinimalCard(&card, fn);
+
+    snprintf(buf, sizeof(buf), "%s;%s;;;", v == 3 ? first : last, v == 3 ? last : first);
+    addPropertyValues(card, "N", buf);
+    addProperty(card, "ORG", synthOrgs[(r >> 10) % 8]);
+
+    unsigned exchange = (r >> 7) % 1000, line = (unsigned)(p * 7919u) % 10000, area = 200 + (r >> 17) % 700;
+    if (v == 1) snprintf(buf, sizeof(buf), "%u.%03u.%04u", area, exchange, line);
+    else if (v == 2) snprintf(buf, sizeof(buf), "tel:+1-%u-%03u-%04u", area, exchange, line);
+    else snprintf(buf, sizeof(buf), "+1 (%u) %03u-%04u", area, exchange, line);
+    addProperty(card, "TEL", buf);
+
+    snprintf(buf, sizeof(buf), "%s.%s%d@%s.example.com", first, last, p % 1000, (r >> 10) % 2 ? "mail" : "acme");
+    if (v == 2) {
+        for (char* c = buf; *c != '\0'; c++) *c = toupper((unsigned char)*c);
+    }
+    if (v != 3) addProperty(card, "EMAIL", buf);
+    if (v == 2 || v == 3) {
+        snprintf(buf, sizeof(buf), "%s%u@home.example.net", first, salt % 1000);
+        addProperty(card, "EMAIL", buf);
+    }
+
+    snprintf(buf, sizeof(buf), ";;%u King St;%s;ON;N1G 2W1;Canada", (r >> 3) % 900, synthCities[(r >> 13) % 8]);
+    addPropertyValues(card, "ADR", buf);
+    if (v != 1) {
+        snprintf(buf, sizeof(buf), "Met at %s conference in %u, likes %s", synthCities[(r >> 16) % 8],
+                 1990 + (r >> 19) % 30, synthOrgs[(r >> 22) % 8]);
+        addProperty(card, "NOTE", buf);
+    }
+    return card;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    double threshold = argc > 2 ? atof(argv[2]) : 0.7;
+    if (count < 2) count = 2;
+
+    // One person in ten gets 1 to 3 duplicates; then the cards are shuffled.
+    Card** cards = malloc(count * sizeof(Card*));
+    int* person = malloc(count * sizeof(int));
+    int n = 0, numPeople = 0;
+    unsigned seed = 12345;
+    while (n < count) {
+        cards[n] = plantedCard(numPeople, 0, 0);
+        person[n++] = numPeople;
+        seed = seed * 1103515245 + 12345;
+        if ((seed >> 16) % 10 == 0) {
+            int copies = 1 + (seed >> 8) % 3;
+            for (int v = 1; v <= copies && n < count; v++) {
+                cards[n] = plantedCard(numPeople, v, seed + v);
+                person[n++] = numPeople;
+            }
+        }
+        numPeople++;
+    }
+    for (int i = count - 1; i > 0; i--) {
+        seed = seed * 1103515245 + 12345;
+        int j = (seed >> 8) % (i + 1);
+        Card* card = cards[i];
+        cards[i] = cards[j];
+        cards[j] = card;
+        int who = person[i];
+        person[i] = person[j];
+        person[j] = who;
+    }
+
+    long truePairs = 0;
+    int* copies = calloc(numPeople, sizeof(int));
+    for (int i = 0; i < count; i++) copies[person[i]]++;
+    for (int i = 0; i < numPeople; i++) truePairs += (long)copies[i] * (copies[i] - 1) / 2;
+    free(copies);
+
+    CardCorpus* corpus = makeCorpus(cards, count);
+    DedupOptions options;
+    defaultDedupOptions(&options);
+    options.threshold = threshold;
+
+    double start = nowSeconds();
+    DedupResult* result = findDuplicates(corpus, &options);
+    double elapsed = nowSeconds() - start;
+    if (result == NULL) {
+        fprintf(stderr, "benchDedup: findDuplicates failed\n");
+        return 1;
+    }
+
+    // Every pair of cards in a cluster counts as found; it is correct if both are the same person.
+    long found = 0, correct = 0;
+    int largest = 0;
+    for (int c = 0; c < result->numClusters; c++) {
+        DedupCluster* cluster = &result->clusters[c];
+        if (cluster->count > largest) largest = cluster->count;
+        found += (long)cluster->count * (cluster->count - 1) / 2;
+        if (cluster->count > DEDUP_MAX_CHECKED) continue;
+        for (int i = 0; i < cluster->count; i++) {
+            for (int j = i + 1; j < cluster->count; j++) {
+                if (person[cluster->docIds[i]] == person[cluster->docIds[j]]) correct++;
+            }
+        }
+    }
+    double precision = found > 0 ? (double)correct / found : 1.0;
+    double recall = truePairs > 0 ? (double)correct / truePairs : 1.0;
+
+    printf("benchDedup: %d cards (%d people), threshold %.2f\n", count, numPeople, threshold);
+    printf("  findDuplicates %.2f s, %ld candidate pairs, %d pairs over threshold, %d clusters (largest %d)\n",
+           elapsed, result->numCandidates, result->numPairs, result->numClusters, largest);
+    printf("  planted pairs %ld, found %ld, correct %ld: precision %.4f, recall %.4f\n",
+           truePairs, found, correct, precision, recall);
+
+    deleteDedupResult(result);
+    deleteCardCorpus(corpus);
+    free(person);
+
+    if (precision < DEDUP_MIN_QUALITY || recall < DEDUP_MIN_QUALITY) {
+        printf("  FAILED: precision and recall must be at least %.2f\n", DEDUP_MIN_QUALITY);
+        return 1;
+    }
+    return 0;
+}
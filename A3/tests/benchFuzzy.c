@@ -0,0 +1,163 @@
+// benchFuzzy.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Benchmark for fuzzyNameSearch on synthetic cards.  Results are checked
+//              against a brute-force edit distance over every name, then top-k queries
+//              are timed; the run fails if they average 50 ms or more.
+//              Usage: benchFuzzy [cards]
+
+#include "testCards.h"
+#include "VCFuzzy.h"
+#include "VCText.h"
+
+//Average top-k query time the index must beat, in milliseconds
+#define FUZZY_MAX_MS 50.0
+
+#define FUZZY_TOP_K 20
+#define FUZZY_ROUNDS 200
+
+static const char* queries[] = {"alice smith4", "Jon Smyth", "bob", "grase hal12", "zoe",
+                                "trnt king9", "olivia", "vctor wrigt50", "xq", "Alice Smith42"};
+#define NUM_QUERIES (int)(sizeof(queries) / sizeof(queries[0]))
+
+// ---------- Helper function: levenshtein ----------
+// The textbook two-row table, to check the index against.
+static int levenshtein(const char* a, const char* b) {
+    int m = strlen(a), n = strlen(b);
+    int* row = malloc((n + 1) * sizeof(int));
+    for (int j = 0; j <= n; j++) row[j] = j;
+    for (int i = 1; i <= m; i++) {
+        int diagonal = row[0];
+        row[0] = i;
+        for (int j = 1; j <= n; j++) {
+            int above = row[j];
+            int best = diagonal + (a[i - 1] != b[j - 1]);
+            if (above + 1 < best) best = above + 1;
+            if (row[j - 1] + 1 < best) best = row[j - 1] + 1;
+            row[j] = best;
+            diagonal = above;
+        }
+    }
+    int distance = row[n];
+    free(row);
+    return distance;
+}
+
+// ---------- Helper function: nameDistance ----------
+// Smallest distance from the folded query to a folded name, or *best if that is smaller.
+static void nameDistance(const char* folded, const char* name, int* best) {
+    char* foldedName = foldText(name);
+    if (foldedName[0] != '\0') {
+        int distance = levenshtein(folded, foldedName);
+        if (distance < *best) *best = distance;
+    }
+    free(foldedName);
+}
+
+// ---------- Helper function: bruteForce ----------
+// Every card within maxDistance of the query, as fuzzyNameSearch defines it.  Returns the
+// number of matches and their total distance.
+static int bruteForce(const CardCorpus* corpus, const char* query, int maxDistance, long* totalDistance) {
+    char* folded = foldText(query);
+    int len = strlen(folded);
+    if (maxDistance < 0) maxDistance = len <= 4 ? 1 : len <= 8 ? 2 : 3;
+
+    int count = 0;
+    *totalDistance = 0;
+    for (int i = 0; i < corpus->count; i++) {
+        Card* card = corpus->cards[i];
+        int best = maxDistance + 1;
+        nameDistance(folded, getFromFront(card->fn->values), &best);
+        ListIterator iter = createIterator(card->optionalProperties);
+        Property* prop;
+        while ((prop = nextElement(&iter)) != NULL) {
+            if (strcmp(prop->name, "N") != 0) continue;
+            ListIterator values = createIterator(prop->values);
+            for (int part = 0; part < 2; part++) {
+                char* value = nextElement(&values);
+                if (value == NULL) break;
+                nameDistance(folded, value, &best);
+            }
+        }
+        if (best <= maxDistance) {
+            count++;
+            *totalDistance += best;
+        }
+    }
+    free(folded);
+    return count;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (count < 1) count = 1;
+
+    // A third of the cards have an N whose names differ from the FN.
+    Card** cards = malloc(count * sizeof(Card*));
+    for (int i = 0; i < count; i++) {
+        cards[i] = synthCard(i);
+        if (i % 3 == 0) {
+            char n[64];
+            snprintf(n, sizeof(n), "%s;%s;;;", synthLasts[(i * 7) % 20], synthFirsts[(i * 3) % 20]);
+            addPropertyValues(cards[i], "N", n);
+        }
+    }
+    CardCorpus* corpus = makeCorpus(cards, count);
+
+    double start = nowSeconds();
+    FuzzyIndex* index = buildFuzzyIndex(corpus);
+    double buildTime = nowSeconds() - start;
+    if (index == NULL) {
+        fprintf(stderr, "benchFuzzy: buildFuzzyIndex failed\n");
+        return 1;
+    }
+    printf("benchFuzzy: %d cards, %d names, built in %.2f s\n", count, fuzzyIndexSize(index), buildTime);
+
+    // Every match, in order, must agree with the brute force.
+    FuzzyMatch* matches = malloc(count * sizeof(FuzzyMatch));
+    int mismatches = 0;
+    for (int q = 0; q < NUM_QUERIES; q++) {
+        int found = fuzzyNameSearch(index, queries[q], -1, matches, count);
+        long total = 0, expectedTotal;
+        int expected = bruteForce(corpus, queries[q], -1, &expectedTotal);
+        bool ordered = true;
+        for (int i = 0; i < found; i++) {
+            total += matches[i].distance;
+            if (i > 0 && (matches[i - 1].distance > matches[i].distance ||
+                          (matches[i - 1].distance == matches[i].distance && matches[i - 1].docId >= matches[i].docId))) {
+                ordered = false;
+            }
+        }
+        if (found != expected || total != expectedTotal || !ordered) {
+            printf("  MISMATCH for '%s': %d matches, expected %d\n", queries[q], found, expected);
+            mismatches++;
+        }
+    }
+    free(matches);
+
+    FuzzyMatch top[FUZZY_TOP_K];
+    start = nowSeconds();
+    for (int r = 0; r < FUZZY_ROUNDS; r++) {
+        fuzzyNameSearch(index, queries[r % NUM_QUERIES], -1, top, FUZZY_TOP_K);
+    }
+    double average = (nowSeconds() - start) / FUZZY_ROUNDS * 1e3;
+
+    // A query too short to filter on checks every name.
+    start = nowSeconds();
+    for (int r = 0; r < FUZZY_ROUNDS / 10; r++) {
+        fuzzyNameSearch(index, "bob", 3, top, FUZZY_TOP_K);
+    }
+    double unfiltered = (nowSeconds() - start) / (FUZZY_ROUNDS / 10) * 1e3;
+
+    printf("  top-%d queries: %.2f ms on average; unfiltered ('bob' within 3): %.2f ms\n",
+           FUZZY_TOP_K, average, unfiltered);
+    printf("  results %s the brute force for %d queries\n", mismatches == 0 ? "match" : "DIFFER from", NUM_QUERIES);
+
+    deleteFuzzyIndex(index);
+    deleteCardCorpus(corpus);
+
+    if (mismatches > 0 || average >= FUZZY_MAX_MS) {
+        printf("  FAILED: results must match and top-%d queries average under %.0f ms\n", FUZZY_TOP_K, FUZZY_MAX_MS);
+        return 1;
+    }
+    return 0;
+}
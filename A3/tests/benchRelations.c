@@ -0,0 +1,237 @@
+// benchRelations.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Benchmark for the relationship graph on a synthetic org chart.  Every
+//              person has a RELATED;TYPE=x-manager link to their manager, 8 reports to a
+//              manager, and teams are KIND:group cards with 40 MEMBERs each and 4 nested
+//              subteams.  Queries are timed before and after a round of updates, and
+//              their results checked against the shape of the chart.
+//              Usage: benchRelations [cards]
+
+#include "testCards.h"
+#include "VCRelations.h"
+
+#define REPORTS_PER_MANAGER 8
+#define TEAM_SIZE 40
+#define SUBTEAMS 4
+#define RELATION_ROUNDS 1000
+
+//Layout of the chart: people are document ids [0, numPeople), teams follow them
+static int numPeople;
+static int numTeams;
+
+// ---------- Helper function: uidFor ----------
+// The UID of a card, written as a URN, an upper-case URN or a bare upper-case UUID.
+static void uidFor(int docId, int style, char* buffer, size_t size) {
+    const char* format = style == 0 ? "urn:uuid:%08x-0000-4000-8000-%012x"
+                       : style == 1 ? "URN:UUID:%08X-0000-4000-8000-%012X"
+                       : "%08X-0000-4000-8000-%012X";
+    snprintf(buffer, size, format, docId * 7919u, (unsigned)docId);
+}
+
+// ---------- Helper function: addLink ----------
+static void addLink(Card* card, const char* name, int target, int style) {
+    char uid[64];
+    uidFor(target, style, uid, sizeof(uid));
+    Property* prop = addProperty(card, name, uid);
+    if (strcmp(name, "RELATED") == 0) addParameter(prop, "TYPE", "x-manager");
+}
+
+// ---------- Helper function: personCard ----------
+static Card* personCard(int docId, int manager) {
+    char fn[32], uid[64];
+    snprintf(fn, sizeof(fn), "Person %d", docId);
+    Card* card = NULL;
+    createMinimalCard(&card, fn);
+    uidFor(docId, docId % 3, uid, sizeof(uid));
+    addProperty(card, "UID", uid);
+    if (manager >= 0) addLink(card, "RELATED", manager, (docId + 1) % 3);
+    return card;
+}
+
+// ---------- Helper function: teamCard ----------
+// Team t lists people t * TEAM_SIZE onwards, and teams SUBTEAMS * t + 1 to SUBTEAMS * t + SUBTEAMS.
+static Card* teamCard(int t) {
+    char fn[32], uid[64];
+    int docId = numPeople + t;
+    snprintf(fn, sizeof(fn), "Team %d", t);
+    Card* card = NULL;
+    createMinimalCard(&card, fn);
+    uidFor(docId, docId % 3, uid, sizeof(uid));
+    addProperty(card, "UID", uid);
+    addProperty(card, "KIND", "group");
+    for (int j = 0; j < TEAM_SIZE; j++) {
+        addLink(card, "MEMBER", ((long)t * TEAM_SIZE + j) % numPeople, j % 3);
+    }
+    for (int c = SUBTEAMS * t + 1; c <= SUBTEAMS * t + SUBTEAMS && c < numTeams; c++) {
+        addLink(card, "MEMBER", numPeople + c, c % 3);
+    }
+    return card;
+}
+
+// ---------- Helper function: checkChart ----------
+// Checks sampled cards against the chart; removed is every card taken out since the build.
+// Returns the number of failed checks.
+static int checkChart(const RelationGraph* graph, RelationHit* hits, int maxHits, bool (*removed)(int)) {
+    int failures = 0;
+    for (int s = 0; s < 200; s++) {
+        int person = (int)((s * 2654435761u) % numPeople);
+        char uid[64];
+        uidFor(person, (person + s) % 3, uid, sizeof(uid));
+        int found = relationGraphFind(graph, uid);
+        if (found != (removed(person) ? -1 : person)) failures++;
+        if (removed(person)) continue;
+
+        // One step either way: the manager (if still there) and every remaining report
+        int expected = person > 0 && !removed((person - 1) / REPORTS_PER_MANAGER) ? 1 : 0;
+        for (int i = REPORTS_PER_MANAGER * person + 1; i <= REPORTS_PER_MANAGER * person + REPORTS_PER_MANAGER; i++) {
+            if (i < numPeople && !removed(i)) expected++;
+        }
+        int n = relationTraverse(graph, person, 1, RELATION_RELATED, true, hits, maxHits);
+        if (n != expected) failures++;
+    }
+
+    for (int s = 0; s < 50 && s < numTeams; s++) {
+        int t = (int)((s * 40503u) % numTeams);
+        int* ids = NULL;
+        int n = relationGraphMembers(graph, numPeople + t, false, &ids);
+        int expected = 0;
+        for (int j = 0; j < TEAM_SIZE; j++) {
+            if (!removed(((long)t * TEAM_SIZE + j) % numPeople)) expected++;
+        }
+        for (int c = SUBTEAMS * t + 1; c <= SUBTEAMS * t + SUBTEAMS && c < numTeams; c++) expected++;
+        if (n != expected) failures++;
+        free(ids);
+    }
+    return failures;
+}
+
+// ---------- Helper function: noneRemoved ----------
+static bool noneRemoved(int docId) {
+    return false;
+}
+
+// ---------- Helper function: everySeventhRemoved ----------
+static bool everySeventhRemoved(int docId) {
+    return docId < numPeople && docId % 7 == 3;
+}
+
+// ---------- Helper function: hireManager ----------
+// The manager of the h-th new person: someone who is not removed.
+static int hireManager(int h) {
+    int manager = (int)(((long)h * 7) % numPeople);
+    return everySeventhRemoved(manager) ? manager - 1 : manager;
+}
+
+// ---------- Helper function: timeQueries ----------
+static void timeQueries(const RelationGraph* graph, RelationHit* hits, int maxHits) {
+    double start = nowSeconds();
+    for (int r = 0; r < RELATION_ROUNDS; r++) {
+        int* ids = NULL;
+        relationGraphMembers(graph, numPeople + (r * 7) % numTeams, false, &ids);
+        free(ids);
+    }
+    double members = (nowSeconds() - start) / RELATION_ROUNDS * 1e6;
+
+    start = nowSeconds();
+    for (int r = 0; r < RELATION_ROUNDS; r++) {
+        int* ids = NULL;
+        relationGraphGroupsOf(graph, (r * 7919) % numPeople, true, &ids);
+        free(ids);
+    }
+    double groupsOf = (nowSeconds() - start) / RELATION_ROUNDS * 1e6;
+
+    start = nowSeconds();
+    long reached = 0;
+    for (int r = 0; r < RELATION_ROUNDS; r++) {
+        reached += relationTraverse(graph, (r * 7919) % numPeople, 3, RELATION_RELATED, true, hits, maxHits);
+    }
+    double traverse = (nowSeconds() - start) / RELATION_ROUNDS * 1e6;
+
+    start = nowSeconds();
+    for (int r = 0; r < RELATION_ROUNDS; r++) {
+        char uid[64];
+        uidFor((r * 7919) % numPeople, r % 3, uid, sizeof(uid));
+        relationGraphFind(graph, uid);
+    }
+    double find = (nowSeconds() - start) / RELATION_ROUNDS * 1e6;
+
+    printf("  members %.2f us, transitive groups-of %.2f us, depth-3 BFS both ways %.2f us (%ld cards), UID lookup %.2f us\n",
+           members, groupsOf, traverse, reached / RELATION_ROUNDS, find);
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 1000000;
+    if (count < 128) count = 128;
+    numTeams = count / 64;
+    numPeople = count - numTeams;
+
+    Card** cards = malloc(count * sizeof(Card*));
+    for (int i = 0; i < numPeople; i++) {
+        cards[i] = personCard(i, i > 0 ? (i - 1) / REPORTS_PER_MANAGER : -1);
+    }
+    for (int t = 0; t < numTeams; t++) {
+        cards[numPeople + t] = teamCard(t);
+    }
+    CardCorpus* corpus = makeCorpus(cards, count);
+
+    double start = nowSeconds();
+    RelationGraph* graph = buildRelationGraph(corpus);
+    double buildTime = nowSeconds() - start;
+    if (graph == NULL) {
+        fprintf(stderr, "benchRelations: buildRelationGraph failed\n");
+        return 1;
+    }
+    printf("benchRelations: %d cards (%d people, %d teams), %d links, built in %.2f s\n", count, numPeople,
+           numTeams, relationGraphSize(graph), buildTime);
+
+    int maxHits = count;
+    RelationHit* hits = malloc(maxHits * sizeof(RelationHit));
+    int failures = checkChart(graph, hits, maxHits, noneRemoved);
+
+    // Every team is reached from the first, so expanding it finds everyone on a team.
+    int* ids = NULL;
+    start = nowSeconds();
+    int everyone = relationGraphMembers(graph, numPeople, true, &ids);
+    double expandTime = nowSeconds() - start;
+    free(ids);
+    long onTeams = (long)numTeams * TEAM_SIZE < numPeople ? (long)numTeams * TEAM_SIZE : numPeople;
+    if (everyone != onTeams) failures++;
+    printf("  expanding the top team: %d members in %.2f ms\n", everyone, expandTime * 1e3);
+    timeQueries(graph, hits, maxHits);
+
+    // Updates: every 7th person leaves, and a tenth as many new people join, each
+    // reporting to a manager who stays.
+    int numHires = count / 10;
+    Card** hires = malloc(numHires * sizeof(Card*));
+    start = nowSeconds();
+    for (int i = 3; i < numPeople; i += 7) {
+        relationGraphRemoveCard(graph, i);
+    }
+    double removeTime = nowSeconds() - start;
+    failures += checkChart(graph, hits, maxHits, everySeventhRemoved);
+
+    start = nowSeconds();
+    for (int h = 0; h < numHires; h++) {
+        hires[h] = personCard(count + h, hireManager(h));
+        if (relationGraphAddCard(graph, hires[h], count + h) != OK) failures++;
+    }
+    printf("  %d removals in %.2f s, %d additions in %.2f s\n", (numPeople + 3) / 7, removeTime, numHires,
+           nowSeconds() - start);
+    for (int h = 0; h < numHires; h += 997) {
+        int n = relationTraverse(graph, count + h, 1, RELATION_RELATED, false, hits, maxHits);
+        if (n != 1 || hits[0].docId != hireManager(h)) failures++;
+    }
+    timeQueries(graph, hits, maxHits);
+
+    free(hits);
+    deleteRelationGraph(graph);
+    deleteCardCorpus(corpus);
+    for (int h = 0; h < numHires; h++) deleteCard(hires[h]);
+    free(hires);
+
+    if (failures > 0) {
+        printf("  FAILED: %d checks against the chart\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,129 @@
+// benchSubstring.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Benchmark for substringSearch against a linear scan that folds and
+//              searches every value, on synthetic cards.  Some cards are removed and
+//              re-added first, and every result must match the scan.
+//              Usage: benchSubstring [cards]
+
+#include <strings.h>
+#include "testCards.h"
+#include "VCSubstring.h"
+#include "VCText.h"
+
+//The properties the index covers by default
+static const char* indexedProps[] = {"FN", "ORG", "NOTE", "EMAIL"};
+
+//Patterns, each with the property it is limited to (NULL for any)
+static const char* patterns[][2] = {
+    {"mith", NULL}, {"MITH42", NULL}, {"ith4", NULL}, {"acme", NULL}, {"acme", "ORG"},
+    {"acme", "EMAIL"}, {"conference in guelph", NULL}, {"ce", NULL}, {"k", NULL},
+    {"xyzzy", NULL}, {"son7@", NULL}, {"king st", NULL}, {"widg", "note"}, {"widg", "TEL"}
+};
+#define NUM_PATTERNS (int)(sizeof(patterns) / sizeof(patterns[0]))
+
+// ---------- Helper function: isRemoved ----------
+// Every 7th card is removed from the index, and every 14th added back.
+static bool isRemoved(int docId) {
+    return docId % 7 == 0 && docId % 14 != 0;
+}
+
+// ---------- Helper function: valueContains ----------
+static bool valueContains(const char* value, const char* folded) {
+    char* foldedValue = foldText(value);
+    bool found = strstr(foldedValue, folded) != NULL;
+    free(foldedValue);
+    return found;
+}
+
+// ---------- Helper function: linearScan ----------
+// The cards with an indexed value containing the pattern, found by looking at every value.
+static int linearScan(const CardCorpus* corpus, const char* pattern, const char* propName, bool skipRemoved,
+                      int* out) {
+    char* folded = foldText(pattern);
+    int count = 0;
+    for (int i = 0; i < corpus->count; i++) {
+        if (skipRemoved && isRemoved(i)) continue;
+        Card* card = corpus->cards[i];
+        bool hit = false;
+        if (propName == NULL || strcasecmp(propName, "FN") == 0) {
+            hit = valueContains(getFromFront(card->fn->values), folded);
+        }
+        ListIterator iter = createIterator(card->optionalProperties);
+        Property* prop;
+        while (!hit && (prop = nextElement(&iter)) != NULL) {
+            bool indexed = false;
+            for (int p = 0; p < 4; p++) {
+                if (strcasecmp(prop->name, indexedProps[p]) == 0) indexed = true;
+            }
+            if (!indexed || (propName != NULL && strcasecmp(propName, prop->name) != 0)) continue;
+            ListIterator values = createIterator(prop->values);
+            char* value;
+            while (!hit && (value = nextElement(&values)) != NULL) {
+                hit = valueContains(value, folded);
+            }
+        }
+        if (hit) out[count++] = i;
+    }
+    free(folded);
+    return count;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 200000;
+    if (count < 1) count = 1;
+    CardCorpus* corpus = synthCorpus(count);
+
+    double start = nowSeconds();
+    SubstringIndex* index = buildSubstringIndex(corpus, NULL, 0);
+    double buildTime = nowSeconds() - start;
+    if (index == NULL) {
+        fprintf(stderr, "benchSubstring: buildSubstringIndex failed\n");
+        return 1;
+    }
+    printf("benchSubstring: %d cards, built in %.2f s, %d trigrams, %zu KB of postings\n", count, buildTime,
+           substringIndexSize(index), substringIndexPostingBytes(index) / 1024);
+
+    for (int i = 0; i < count; i += 7) substringIndexRemoveCard(index, i);
+    for (int i = 0; i < count; i += 14) substringIndexAddCard(index, corpus->cards[i], i);
+
+    int* expected = malloc(count * sizeof(int));
+    int rounds = count > 100000 ? 3 : 20;
+    int mismatches = 0;
+    printf("  %-22s %-5s %8s  %10s  %10s\n", "pattern", "prop", "matches", "index ms", "scan ms");
+    for (int q = 0; q < NUM_PATTERNS; q++) {
+        const char* pattern = patterns[q][0];
+        const char* propName = patterns[q][1];
+        int* ids = NULL;
+        int found = substringSearch(index, pattern, propName, &ids);
+        int numExpected = linearScan(corpus, pattern, propName, true, expected);
+        bool same = found == numExpected;
+        for (int i = 0; same && i < found; i++) same = ids[i] == expected[i];
+        if (!same) mismatches++;
+        free(ids);
+
+        start = nowSeconds();
+        for (int r = 0; r < rounds; r++) {
+            substringSearch(index, pattern, propName, &ids);
+            free(ids);
+        }
+        double indexTime = (nowSeconds() - start) / rounds;
+
+        // The scan is timed over every card, as a LIKE query would be.
+        start = nowSeconds();
+        linearScan(corpus, pattern, propName, false, expected);
+        double scanTime = nowSeconds() - start;
+
+        printf("  %-22s %-5s %8d  %10.3f  %10.2f%s\n", pattern, propName != NULL ? propName : "*", found,
+               indexTime * 1e3, scanTime * 1e3, same ? "" : "  MISMATCH");
+    }
+    free(expected);
+
+    deleteSubstringIndex(index);
+    deleteCardCorpus(corpus);
+
+    if (mismatches > 0) {
+        printf("  FAILED: %d patterns differ from the linear scan\n", mismatches);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,125 @@
+// benchSummary.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Benchmark for summarizeFiles against the per-card calls it replaced in
+//              the UI: createCardValidated, then fnToString, bdayToString, annToString and
+//              numPropsToString, whose strings ctypes never frees.  Synthetic cards are
+//              written to a temporary directory and loaded both ways; time per card and
+//              resident memory growth are reported for each, and the summaries must
+//              agree with the strings.
+//              Usage: benchSummary [cards]
+
+#include <unistd.h>
+#include "testCards.h"
+#include "VCSummary.h"
+
+//The per-field calls, which have no header
+char* fnToString(const Card* obj);
+char* bdayToString(const Card* obj);
+char* annToString(const Card* obj);
+char* numPropsToString(const Card* obj);
+
+// ---------- Helper function: residentBytes ----------
+static long residentBytes(void) {
+    long size = 0, resident = 0;
+    FILE* fp = fopen("/proc/self/statm", "r");
+    if (fp == NULL) return 0;
+    if (fscanf(fp, "%ld %ld", &size, &resident) != 2) resident = 0;
+    fclose(fp);
+    return resident * sysconf(_SC_PAGESIZE);
+}
+
+// ---------- Helper function: makeDate ----------
+static DateTime* makeDate(const char* date) {
+    DateTime* dt = calloc(1, sizeof(DateTime));
+    dt->date = strdup(date);
+    dt->time = strdup("");
+    dt->text = strdup("");
+    return dt;
+}
+
+// ---------- Helper function: writeCards ----------
+// Writes count synthetic cards, most with a birthday and some with an anniversary, and
+// returns their paths.
+static char** writeCards(const char* dirName, int count) {
+    char** paths = malloc(count * sizeof(char*));
+    for (int i = 0; i < count; i++) {
+        char fileName[32], date[16];
+        snprintf(fileName, sizeof(fileName), "card%d.vcf", i);
+        paths[i] = joinPath(dirName, fileName);
+
+        Card* card = synthCard(i);
+        if (i % 4 != 0) {
+            snprintf(date, sizeof(date), "%04d%02d%02d", 1940 + i % 60, 1 + i % 12, 1 + i % 28);
+            card->birthday = makeDate(date);
+        }
+        if (i % 3 == 0) {
+            snprintf(date, sizeof(date), "--%02d%02d", 1 + i % 12, 1 + i % 28);
+            card->anniversary = makeDate(date);
+        }
+        writeCard(paths[i], card);
+        deleteCard(card);
+    }
+    return paths;
+}
+
+int main(int argc, char** argv) {
+    int count = argc > 1 ? atoi(argv[1]) : 100000;
+    if (count <= 0) return 1;
+    int failures = 0;
+
+    char dirName[] = "/tmp/benchSummaryXXXXXX";
+    if (mkdtemp(dirName) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char** paths = writeCards(dirName, count);
+
+    // One summary per card, as the UI allocates for summarizeFiles
+    long before = residentBytes();
+    double start = nowSeconds();
+    CardSummary* summaries = allocSummaries(count);
+    int ok = summarizeFiles(paths, count, true, 0, summaries);
+    double summaryTime = nowSeconds() - start;
+    long summaryGrowth = residentBytes() - before;
+    if (ok != count) failures++;
+
+    // A card and four strings per file; the card is deleted and the strings leak
+    before = residentBytes();
+    start = nowSeconds();
+    for (int i = 0; i < count; i++) {
+        Card* card = NULL;
+        if (createCardValidated(paths[i], &card) != OK) {
+            failures++;
+            continue;
+        }
+        char* fn = fnToString(card);
+        char* bday = bdayToString(card);
+        char* ann = annToString(card);
+        char* numProps = numPropsToString(card);
+        if (strcmp(fn, summaries[i].fn) != 0 || strcmp(bday, summaries[i].birthday) != 0 ||
+            strcmp(ann, summaries[i].anniversary) != 0 || atoi(numProps) != summaries[i].numProps) {
+            failures++;
+        }
+        deleteCard(card);
+    }
+    double stringTime = nowSeconds() - start;
+    long stringGrowth = residentBytes() - before;
+
+    printf("benchSummary: %d cards, microseconds per card and resident memory growth\n", count);
+    printf("  %-20s  %10.2f us  %8.1f MB\n", "summarizeFiles", summaryTime / count * 1e6, summaryGrowth / 1048576.0);
+    printf("  %-20s  %10.2f us  %8.1f MB\n", "four *ToString calls", stringTime / count * 1e6, stringGrowth / 1048576.0);
+
+    freeSummaries(summaries);
+    for (int i = 0; i < count; i++) {
+        unlink(paths[i]);
+        free(paths[i]);
+    }
+    free(paths);
+    rmdir(dirName);
+
+    if (failures > 0) {
+        printf("  FAILED: %d cards did not load or their summaries differ from the strings\n", failures);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,103 @@
+// benchValidate.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Benchmark for validateCard on cards of 10 to 10k properties.  Each size
+//              is timed valid and with a repeated UID at the end, beside the pairwise
+//              name comparison the duplicate check used to be, which must agree with it.
+//              Usage: benchValidate [largest]
+
+#include <strings.h>
+#include "testCards.h"
+#include "VCProperties.h"
+
+//Repeatable properties the cards are filled with
+static const char* repeatable[] = {"TEL", "EMAIL", "NOTE", "URL", "CATEGORIES", "IMPP"};
+
+//Numbers of optional properties swept
+static const int sizes[] = {10, 30, 100, 300, 1000, 3000, 10000};
+#define NUM_SIZES (int)(sizeof(sizes) / sizeof(sizes[0]))
+
+// ---------- Helper function: sweepCard ----------
+// A valid card of numProps optional properties: N, UID, GENDER and KIND once each, and
+// the rest repeatable.
+static Card* sweepCard(int numProps) {
+    Card* card = NULL;
+    createMinimalCard(&card, "Simon Perreault");
+    addPropertyValues(card, "N", "Perreault;Simon;;;");
+    addProperty(card, "UID", "urn:uuid:4fbe8971-0bc3-424c-9c26-36c3e1eff6b1");
+    addProperty(card, "GENDER", "M");
+    addProperty(card, "KIND", "individual");
+    for (int i = 4; i < numProps; i++) {
+        char value[32];
+        snprintf(value, sizeof(value), "value %d", i);
+        addProperty(card, repeatable[i % 6], value);
+    }
+    return card;
+}
+
+// ---------- Helper function: pairwiseDuplicate ----------
+// Compares every pair of property names, as validateCard did before the property table.
+static bool pairwiseDuplicate(const Card* card) {
+    bool duplicate = false;
+    ListIterator outer = createIterator(card->optionalProperties);
+    Property* first;
+    while ((first = nextElement(&outer)) != NULL) {
+        ListIterator inner = createIterator(card->optionalProperties);
+        Property* second;
+        while ((second = nextElement(&inner)) != NULL) {
+            if (first != second && strcasecmp(first->name, second->name) == 0 &&
+                !propertyIsRepeatable(propertyId(first->name))) {
+                duplicate = true;
+            }
+        }
+    }
+    return duplicate;
+}
+
+// ---------- Helper function: timeValidate ----------
+// Average time of validateCard in microseconds; *result receives what it returned.
+static double timeValidate(const Card* card, int rounds, VCardErrorCode* result) {
+    double start = nowSeconds();
+    for (int r = 0; r < rounds; r++) *result = validateCard(card);
+    return (nowSeconds() - start) / rounds * 1e6;
+}
+
+// ---------- Helper function: timePairwise ----------
+static double timePairwise(const Card* card, int rounds, bool* duplicate) {
+    double start = nowSeconds();
+    for (int r = 0; r < rounds; r++) *duplicate = pairwiseDuplicate(card);
+    return (nowSeconds() - start) / rounds * 1e6;
+}
+
+int main(int argc, char** argv) {
+    int largest = argc > 1 ? atoi(argv[1]) : 10000;
+    int failures = 0;
+
+    printf("benchValidate: validateCard against a pairwise name scan, microseconds per card\n");
+    printf("  %8s  %12s  %12s  %12s  %12s\n", "props", "valid", "pairwise", "repeated UID", "pairwise");
+    for (int s = 0; s < NUM_SIZES && sizes[s] <= largest; s++) {
+        int numProps = sizes[s];
+        Card* card = sweepCard(numProps);
+        int rounds = 2000000 / numProps;
+        int pairRounds = rounds / numProps + 1;
+
+        VCardErrorCode result = OK;
+        bool duplicate = false;
+        double valid = timeValidate(card, rounds, &result);
+        double validPairs = timePairwise(card, pairRounds, &duplicate);
+        if (result != OK || duplicate) failures++;
+
+        addProperty(card, "UID", "urn:uuid:0b3c2b4e-8e2e-4c6b-9a53-6a5b5a8c1e21");
+        double repeated = timeValidate(card, rounds, &result);
+        double repeatedPairs = timePairwise(card, pairRounds, &duplicate);
+        if (result != INV_PROP || !duplicate) failures++;
+
+        printf("  %8d  %12.2f  %12.2f  %12.2f  %12.2f\n", numProps, valid, validPairs, repeated, repeatedPairs);
+        deleteCard(card);
+    }
+
+    if (failures > 0) {
+        printf("  FAILED: %d results differ from the pairwise scan\n", failures);
+        return 1;
+    }
+    return 0;
+}
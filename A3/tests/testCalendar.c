@@ -0,0 +1,122 @@
+// testCalendar.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for the calendar index: ranges over the turn of the year, days away
+//              across December 31 and February 28/29, dates without a year, and removing
+//              and re-adding a card.
+
+#include "testCards.h"
+#include "VCCalendar.h"
+
+// ---------- Helper function: makeDate ----------
+// A DateTime holding a date in basic format, e.g. "19960229" or "--1231".
+static DateTime* makeDate(const char* date) {
+    DateTime* dt = malloc(sizeof(DateTime));
+    dt->UTC = false;
+    dt->isText = false;
+    dt->date = strdup(date);
+    dt->time = strdup("");
+    dt->text = strdup("");
+    return dt;
+}
+
+// ---------- Helper function: datedCard ----------
+// A card with a birthday and, if given, an anniversary.
+static Card* datedCard(const char* fn, const char* bday, const char* anniversary) {
+    Card* card = NULL;
+    if (createMinimalCard(&card, (char*)fn) != OK) return NULL;
+    card->birthday = makeDate(bday);
+    if (anniversary != NULL) card->anniversary = makeDate(anniversary);
+    return card;
+}
+
+// ---------- Helper function: nextEvents ----------
+// Reads the first count events from a start date.
+static void nextEvents(const CalendarIndex* index, int year, int month, int day, CalendarEvent* out, int count) {
+    CalendarIter iter;
+    calendarIterInit(index, year, month, day, &iter);
+    for (int i = 0; i < count; i++) {
+        if (!calendarIterNext(&iter, &out[i])) {
+            out[i].docId = -1;
+            out[i].daysAway = -1;
+        }
+    }
+}
+
+int main(void) {
+    Card** cards = malloc(6 * sizeof(Card*));
+    cards[0] = datedCard("Simon Perreault", "19701231", NULL);
+    cards[1] = datedCard("Ada Lovelace", "--0102", "--1220");
+    cards[2] = datedCard("Alan Turing", "19960229", NULL);
+    cards[3] = datedCard("Grace Hopper", "--0301", NULL);
+    cards[4] = datedCard("Edsger Dijkstra", "19540110", NULL);
+    cards[5] = datedCard("Barbara Liskov", "19390111", NULL);
+    CardCorpus* corpus = makeCorpus(cards, 6);
+
+    CalendarIndex* index = buildCalendarIndex(corpus);
+    CHECK(index != NULL && calendarSize(index) == 7);
+
+    // 12/20 to 01/10 wraps: the 12/20 anniversary, 12/31, 01/02 and 01/10, but not 01/11
+    CalendarEvent events[8];
+    int n = calendarRange(index, 12, 20, 1, 10, events, 8);
+    CHECK(n == 4 && calendarCount(index, 12, 20, 1, 10) == 4);
+    if (n == 4) {
+        CHECK(events[0].docId == 1 && events[0].kind == EVENT_ANNIVERSARY);
+        CHECK(events[1].docId == 0 && events[1].month == 12 && events[1].day == 31);
+        CHECK(events[2].docId == 1 && events[2].kind == EVENT_BIRTHDAY);
+        CHECK(events[3].docId == 4);
+    }
+    // The rest of the year is everything else
+    CHECK(calendarCount(index, 1, 11, 12, 19) == 3);
+
+    // Dates without a year keep their month and day
+    CHECK(events[2].year == -1 && events[2].month == 1 && events[2].day == 2);
+    CHECK(events[1].year == 1970);
+
+    // Across December 31: from 12/30, 12/31 is one day away and 01/02 is three
+    nextEvents(index, 2023, 12, 30, events, 3);
+    CHECK(events[0].docId == 0 && events[0].daysAway == 1);
+    CHECK(events[1].docId == 1 && events[1].kind == EVENT_BIRTHDAY && events[1].daysAway == 3);
+    CHECK(events[2].docId == 4 && events[2].daysAway == 11);
+
+    // In a common year February 29 falls on February 28, and March 1 is the next day
+    nextEvents(index, 2023, 2, 28, events, 2);
+    CHECK(events[0].docId == 2 && events[0].daysAway == 0);
+    CHECK(events[1].docId == 3 && events[1].daysAway == 1);
+
+    // In a leap year February 29 is its own day
+    nextEvents(index, 2024, 2, 28, events, 2);
+    CHECK(events[0].docId == 2 && events[0].daysAway == 1);
+    CHECK(events[1].docId == 3 && events[1].daysAway == 2);
+
+    // Across December 31 into a leap year: 12/31/2023 to 02/29/2024 is 60 days
+    nextEvents(index, 2023, 12, 31, events, 6);
+    CHECK(events[4].docId == 2 && events[4].daysAway == 60);
+    CHECK(events[5].docId == 3 && events[5].daysAway == 61);
+
+    // Removing a card takes out both its events; re-adding puts them back
+    calendarRemoveCard(index, 1);
+    CHECK(calendarSize(index) == 5);
+    CHECK(calendarCount(index, 12, 20, 1, 10) == 2);
+    n = calendarRange(index, 12, 20, 1, 10, events, 8);
+    CHECK(n == 2 && events[0].docId == 0 && events[1].docId == 4);
+    calendarRemoveCard(index, 1);
+    CHECK(calendarSize(index) == 5);
+
+    CHECK(calendarAddCard(index, cards[1], 1) == OK);
+    CHECK(calendarSize(index) == 7);
+    n = calendarRange(index, 12, 20, 1, 10, events, 8);
+    CHECK(n == 4 && events[0].docId == 1 && events[2].docId == 1);
+
+    // An empty index has nothing to read
+    CalendarIndex* empty = createCalendarIndex();
+    CHECK(calendarCount(empty, 1, 1, 12, 31) == 0);
+    nextEvents(empty, 2024, 1, 1, events, 1);
+    CHECK(events[0].docId == -1);
+    deleteCalendarIndex(empty);
+
+    deleteCalendarIndex(index);
+    deleteCardCorpus(corpus);
+
+    printf("testCalendar: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
@@ -0,0 +1,149 @@
+/**
+ * @file testCards.h
+ * @author Kenny Adenuga, Student ID: 1304431
+ * @brief Shared helpers for the tests and benchmarks: building cards in memory without
+ *        files, a deterministic synthetic card generator, a timer and a check macro.
+ */
+
+#ifndef _TESTCARDS_H
+#define _TESTCARDS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "VCParser.h"
+#include "VCCorpus.h"
+
+//Defined in VCAssign3.c, which has no header of its own
+VCardErrorCode createMinimalCard(Card** card, char* fn);
+
+//Number of failed checks so far; a test returns non-zero if any failed
+static int testFailures __attribute__((unused)) = 0;
+
+//Records a failed check without stopping, so one run reports every failure
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+        fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+        testFailures++; \
+    } \
+} while (0)
+
+// ---------- Helper function: nowSeconds ----------
+// Monotonic clock in seconds, for timing benchmarks.
+static inline double nowSeconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// ---------- Helper function: makeProperty ----------
+// A property with one value and no group or parameters.
+static inline Property* makeProperty(const char* name, const char* value) {
+    Property* prop = malloc(sizeof(Property));
+    prop->name = strdup(name);
+    prop->group = strdup("");
+    prop->parameters = initializeList(parameterToString, deleteParameter, compareParameters);
+    prop->values = initializeList(valueToString, deleteValue, compareValues);
+    insertBack(prop->values, strdup(value));
+    return prop;
+}
+
+// ---------- Helper function: addProperty ----------
+static inline Property* addProperty(Card* card, const char* name, const char* value) {
+    Property* prop = makeProperty(name, value);
+    insertBack(card->optionalProperties, prop);
+    return prop;
+}
+
+// ---------- Helper function: addPropertyValues ----------
+// A property whose values are given as one string separated by semicolons, as they are
+// written in a card, e.g. "Perreault;Simon;;;" for N.
+static inline Property* addPropertyValues(Card* card, const char* name, const char* values) {
+    Property* prop = makeProperty(name, "");
+    clearList(prop->values);
+    const char* start = values;
+    while (true) {
+        const char* end = strchr(start, ';');
+        size_t len = end != NULL ? (size_t)(end - start) : strlen(start);
+        insertBack(prop->values, strndup(start, len));
+        if (end == NULL) break;
+        start = end + 1;
+    }
+    insertBack(card->optionalProperties, prop);
+    return prop;
+}
+
+// ---------- Helper function: addParameter ----------
+static inline void addParameter(Property* prop, const char* name, const char* value) {
+    Parameter* param = malloc(sizeof(Parameter));
+    param->name = strdup(name);
+    param->value = strdup(value);
+    insertBack(prop->parameters, param);
+}
+
+static const char* synthFirsts[] = {"Alice", "Bob", "Carol", "Dave", "Eve", "Frank", "Grace", "Heidi",
+                                    "Ivan", "Judy", "Mallory", "Niaj", "Olivia", "Peggy", "Rupert",
+                                    "Sybil", "Trent", "Victor", "Walter", "Zoe"};
+static const char* synthLasts[] = {"Smith", "Jones", "Brown", "Taylor", "Wilson", "Davies", "Evans",
+                                   "Thomas", "Roberts", "Johnson", "Lee", "Walker", "Wright", "Hall",
+                                   "Green", "Clarke", "Young", "King", "Baker", "Hill"};
+static const char* synthOrgs[] = {"Acme Corp", "Globex", "Initech", "Umbrella", "Hooli",
+                                  "Stark Industries", "Wayne Enterprises", "Acme Widgets"};
+static const char* synthCities[] = {"Guelph", "Toronto", "Ottawa", "Waterloo", "Kitchener",
+                                    "London", "Hamilton", "Montreal"};
+
+// ---------- Helper function: synthCard ----------
+// A card made up from its number alone, so every run sees the same cards: FN, ORG, ADR,
+// NOTE, TEL and EMAIL drawn from the tables above.
+static inline Card* synthCard(int i) {
+    char fn[128], buf[256];
+    unsigned r = (unsigned)i * 2654435761u;
+    const char* first = synthFirsts[r % 20];
+    const char* last = synthLasts[(r >> 5) % 20];
+
+    snprintf(fn, sizeof(fn), "%s %s%d", first, last, i % 97);
+    Card* card = NULL;
+    if (createMinimalCard(&card, fn) != OK) return NULL;
+
+    addProperty(card, "ORG", synthOrgs[(r >> 10) % 8]);
+    snprintf(buf, sizeof(buf), ";;%u King St;%s;ON;N1G 2W1;Canada", (r >> 3) % 900, synthCities[(r >> 13) % 8]);
+    addPropertyValues(card, "ADR", buf);
+    snprintf(buf, sizeof(buf), "Met at %s conference in %u, likes %s", synthCities[(r >> 16) % 8],
+             1990 + (r >> 19) % 30, synthOrgs[(r >> 22) % 8]);
+    addProperty(card, "NOTE", buf);
+    snprintf(buf, sizeof(buf), "+1 (519) %03u-%04u", (r >> 7) % 1000, (r >> 11) % 10000);
+    addProperty(card, "TEL", buf);
+    snprintf(buf, sizeof(buf), "%s.%s%d@%s.example.com", first, last, i % 97, (r >> 10) % 2 ? "mail" : "acme");
+    addProperty(card, "EMAIL", buf);
+    return card;
+}
+
+// ---------- Helper function: makeCorpus ----------
+// A corpus of the given cards, as if loaded from files named card<n>.vcf.  Takes
+// ownership of the cards; free it with deleteCardCorpus.
+static inline CardCorpus* makeCorpus(Card** cards, int count) {
+    CardCorpus* corpus = calloc(1, sizeof(CardCorpus));
+    corpus->count = count;
+    corpus->names = malloc((count + 1) * sizeof(char*));
+    corpus->cards = cards;
+    corpus->errors = calloc(count + 1, sizeof(int));
+    for (int i = 0; i < count; i++) {
+        char name[32];
+        snprintf(name, sizeof(name), "card%d.vcf", i);
+        corpus->names[i] = strdup(name);
+        corpus->errors[i] = cards[i] != NULL ? OK : OTHER_ERROR;
+    }
+    return corpus;
+}
+
+// ---------- Helper function: synthCorpus ----------
+static inline CardCorpus* synthCorpus(int count) {
+    Card** cards = malloc((count + 1) * sizeof(Card*));
+    for (int i = 0; i < count; i++) {
+        cards[i] = synthCard(i);
+    }
+    return makeCorpus(cards, count);
+}
+
+#endif
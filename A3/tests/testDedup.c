@@ -0,0 +1,83 @@
+// testDedup.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Smoke check for findDuplicates on a few planted duplicates: a reformatted
+//              TEL, a reordered name, and a namesake who is someone else.
+
+#include "testCards.h"
+#include "VCDedup.h"
+
+// ---------- Helper function: makePerson ----------
+static Card* makePerson(const char* fn, const char* n, const char* tel, const char* email, const char* adr) {
+    Card* card = NULL;
+    createMinimalCard(&card, (char*)fn);
+    addPropertyValues(card, "N", n);
+    if (tel != NULL) addProperty(card, "TEL", tel);
+    if (email != NULL) addProperty(card, "EMAIL", email);
+    if (adr != NULL) addPropertyValues(card, "ADR", adr);
+    return card;
+}
+
+int main(void) {
+    Card** cards = malloc(5 * sizeof(Card*));
+    cards[0] = makePerson("Simon Perreault", "Perreault;Simon;;;", "+1 (519) 555-0142",
+                          "simon.perreault@viagenie.ca", ";;2875 Laurier;Quebec;QC;G1V 2M2;Canada");
+    // The same card with the number written another way
+    cards[1] = makePerson("Simon Perreault", "Perreault;Simon;;;", "519.555.0142",
+                          "simon.perreault@viagenie.ca", ";;2875 Laurier;Quebec;QC;G1V 2M2;Canada");
+    // Family name first, address in capitals, no e-mail
+    cards[2] = makePerson("Perreault, Simon", "Perreault;Simon;;;", "tel:+1-519-555-0142", NULL,
+                          ";;2875 LAURIER;QUEBEC;QC;G1V 2M2;CANADA");
+    // Same name, but a different person
+    cards[3] = makePerson("Simon Perreault", "Perreault;Simon;;;", "+1 (416) 555-0199",
+                          "sperreault@example.com", ";;12 Bay St;Toronto;ON;M5J 2N8;Canada");
+    cards[4] = makePerson("Alice Smith", "Smith;Alice;;;", "+1 (519) 555-0100",
+                          "alice@example.com", NULL);
+    CardCorpus* corpus = makeCorpus(cards, 5);
+
+    double reformatted = cardSimilarity(cards[0], cards[1], "1");
+    double namesake = cardSimilarity(cards[0], cards[3], "1");
+    CHECK(reformatted >= 0.9);
+    CHECK(cardSimilarity(cards[0], cards[2], "1") >= 0.7);
+    CHECK(namesake < 0.7);
+    CHECK(cardSimilarity(cards[0], cards[4], "1") < 0.3);
+
+    DedupResult* result = findDuplicates(corpus, NULL);
+    CHECK(result != NULL);
+    if (result != NULL) {
+        CHECK(result->numClusters == 1);
+        if (result->numClusters == 1) {
+            DedupCluster* cluster = &result->clusters[0];
+            CHECK(cluster->count == 3);
+            CHECK(cluster->count == 3 && cluster->docIds[0] == 0 && cluster->docIds[1] == 1 &&
+                  cluster->docIds[2] == 2);
+        }
+    }
+    deleteDedupResult(result);
+    deleteCardCorpus(corpus);
+
+    // The same name and words but different numbers score 0.4 + 0.3 + 0, exactly the
+    // default threshold; the pair must still be found.
+    char note[4096];
+    int len = 0;
+    for (int i = 0; i < 600; i++) len += snprintf(note + len, sizeof(note) - len, "w%d ", i);
+    cards = malloc(2 * sizeof(Card*));
+    cards[0] = makePerson("Simon Perreault", "Perreault;Simon;;;", "+1 (519) 555-0142", NULL, NULL);
+    cards[1] = makePerson("Simon Perreault", "Perreault;Simon;;;", "+1 (416) 555-0199", NULL, NULL);
+    addProperty(cards[0], "NOTE", note);
+    addProperty(cards[1], "NOTE", note);
+    corpus = makeCorpus(cards, 2);
+
+    DedupOptions options;
+    defaultDedupOptions(&options);
+    double boundary = cardSimilarity(cards[0], cards[1], "1");
+    CHECK(boundary >= options.threshold);
+    result = findDuplicates(corpus, &options);
+    CHECK(result != NULL && result->numPairs == 1 && result->numClusters == 1);
+    CHECK(result != NULL && result->numPairs == 1 && result->pairs[0].score == boundary);
+    deleteDedupResult(result);
+    deleteCardCorpus(corpus);
+
+    printf("testDedup: %s (reformatted TEL %.3f, namesake %.3f, boundary %.3f)\n",
+           testFailures == 0 ? "passed" : "FAILED", reformatted, namesake, boundary);
+    return testFailures != 0;
+}
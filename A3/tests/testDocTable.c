@@ -0,0 +1,200 @@
+// testDocTable.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for the shared document table and the indexes kept in it: telephone
+//              numbers, e-mail addresses and UID sync keys are found after the table grows,
+//              and are gone after their card is removed and back after it is re-added.
+
+#include "testCards.h"
+#include "VCDocTable.h"
+#include "VCEmailIndex.h"
+#include "VCPhoneIndex.h"
+#include "VCUid.h"
+
+#define NUM_CARDS 2000
+
+// ---------- Helper function: hasDoc ----------
+// Whether docId is among the first n matches (PhoneMatch, EmailMatch and SyncMatch all
+// start with the document id and property position).
+static bool hasDoc(const void* matches, size_t size, int n, int docId) {
+    for (int i = 0; i < n; i++) {
+        if (*(const int*)((const char*)matches + i * size) == docId) return true;
+    }
+    return false;
+}
+
+// ---------- Helper function: findValue ----------
+static const char* findValue(const Card* card, const char* name) {
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (strcmp(prop->name, name) == 0) return getFromFront(prop->values);
+    }
+    return NULL;
+}
+
+// ---------- Helper function: checkTable ----------
+// Keys that share a hash, entries of many documents, and reuse of removed entries.
+static void checkTable(void) {
+    DocTable table;
+    CHECK(docTableInit(&table, sizeof(int)));
+    for (int i = 0; i < 1000; i++) {
+        // Every tenth key shares hash 7
+        int e = docTableAdd(&table, i % 10 == 0 ? 7 : fnvHash((char[]){ 'a' + i % 26, 'a' + i / 26, 0 }), i % 100);
+        CHECK(e >= 0);
+        if (e >= 0) *(int*)docTableItem(&table, e) = i;
+    }
+    CHECK(table.size == 1000 && table.numBuckets >= 1000);
+
+    int found = 0;
+    for (int e = docTableFind(&table, 7); e != -1; e = docTableNext(&table, e)) {
+        CHECK(*(int*)docTableItem(&table, e) % 10 == 0);
+        found++;
+    }
+    CHECK(found == 100);
+
+    // Document 0 holds keys 0, 100, ..., 900, all with hash 7
+    docTableRemoveDoc(&table, 0);
+    CHECK(table.size == 990 && table.docHeads[0] == -1);
+    found = 0;
+    for (int e = docTableFind(&table, 7); e != -1; e = docTableNext(&table, e)) found++;
+    CHECK(found == 90);
+
+    int e = docTableAdd(&table, 7, 0);
+    CHECK(e >= 0 && table.numEntries == 1000 && table.docHeads[0] == e);
+    docTableRemove(&table, table.docHeads[1]);
+    CHECK(table.size == 990);
+    docTableRemoveDoc(&table, 5000);
+    docTableFree(&table);
+}
+
+// ---------- Helper function: checkPhones ----------
+static void checkPhones(const CardCorpus* corpus) {
+    PhoneIndex* index = buildPhoneIndex(corpus, "1", 0);
+    CHECK(index != NULL && phoneIndexSize(index) == NUM_CARDS);
+    if (index == NULL) return;
+
+    PhoneMatch matches[64];
+    bool all = true;
+    for (int i = 0; i < NUM_CARDS; i++) {
+        int n = phoneIndexLookup(index, findValue(corpus->cards[i], "TEL"), matches, 64);
+        all = all && hasDoc(matches, sizeof(PhoneMatch), n, i);
+    }
+    CHECK(all);
+
+    const char* tel = findValue(corpus->cards[17], "TEL");
+    for (int i = 0; i < NUM_CARDS; i += 2) phoneIndexRemoveCard(index, i);
+    CHECK(phoneIndexSize(index) == NUM_CARDS / 2);
+    int n = phoneIndexLookup(index, tel, matches, 64);
+    CHECK(hasDoc(matches, sizeof(PhoneMatch), n, 17));
+    n = phoneIndexSuffix(index, tel + strlen(tel) - 8, matches, 64);
+    CHECK(hasDoc(matches, sizeof(PhoneMatch), n, 17));
+
+    tel = findValue(corpus->cards[16], "TEL");
+    n = phoneIndexLookup(index, tel, matches, 64);
+    CHECK(!hasDoc(matches, sizeof(PhoneMatch), n, 16));
+    n = phoneIndexSuffix(index, tel + strlen(tel) - 8, matches, 64);
+    CHECK(!hasDoc(matches, sizeof(PhoneMatch), n, 16));
+
+    CHECK(phoneIndexAddCard(index, corpus->cards[16], 16) == OK);
+    n = phoneIndexLookup(index, tel, matches, 64);
+    CHECK(hasDoc(matches, sizeof(PhoneMatch), n, 16) && matches[0].propIndex == 3);
+    deletePhoneIndex(index);
+}
+
+// ---------- Helper function: checkEmails ----------
+static void checkEmails(const CardCorpus* corpus) {
+    EmailIndex* index = buildEmailIndex(corpus);
+    CHECK(index != NULL && emailIndexSize(index) == NUM_CARDS);
+    if (index == NULL) return;
+
+    EmailMatch matches[64];
+    bool all = true;
+    for (int i = 0; i < NUM_CARDS; i++) {
+        int n = emailIndexLookup(index, findValue(corpus->cards[i], "EMAIL"), matches, 64);
+        all = all && hasDoc(matches, sizeof(EmailMatch), n, i);
+    }
+    CHECK(all);
+
+    const char* address = findValue(corpus->cards[16], "EMAIL");
+    emailIndexRemoveCard(index, 16);
+    emailIndexRemoveCard(index, 16);
+    CHECK(emailIndexSize(index) == NUM_CARDS - 1);
+    int n = emailIndexLookup(index, address, matches, 64);
+    CHECK(!hasDoc(matches, sizeof(EmailMatch), n, 16));
+
+    CHECK(emailIndexAddCard(index, corpus->cards[16], 16) == OK);
+    n = emailIndexLookup(index, address, matches, 64);
+    CHECK(hasDoc(matches, sizeof(EmailMatch), n, 16) && matches[0].propIndex == 4);
+    deleteEmailIndex(index);
+}
+
+// ---------- Helper function: uidCard ----------
+// A card with a UID and a TEL whose PID 1.1 maps to one client.
+static Card* uidCard(int i, const char* uid) {
+    Card* card = synthCard(i);
+    addProperty(card, "UID", uid);
+    addPropertyValues(card, "CLIENTPIDMAP", "1;urn:uuid:53e374d9-337e-4727-8803-a1e9c14e0556");
+    Property* tel = addProperty(card, "TEL", "+1 519 555 0100");
+    addParameter(tel, "PID", "1.1");
+    return card;
+}
+
+// ---------- Helper function: checkSyncKeys ----------
+static void checkSyncKeys(void) {
+    Card** cards = malloc(NUM_CARDS * sizeof(Card*));
+    for (int i = 0; i < NUM_CARDS; i++) {
+        char uid[32];
+        // Cards 1 and 2 share a UID, so their sync keys collide.
+        snprintf(uid, sizeof(uid), "card-%d", i == 2 ? 1 : i);
+        cards[i] = uidCard(i, uid);
+    }
+    CardCorpus* corpus = makeCorpus(cards, NUM_CARDS);
+    UidIndex* index = buildUidIndex(corpus);
+    CHECK(index != NULL);
+    if (index == NULL) {
+        deleteCardCorpus(corpus);
+        return;
+    }
+
+    const char* client = "urn:uuid:53E374D9-337E-4727-8803-A1E9C14E0556";
+    UidIndexStats stats;
+    uidIndexStats(index, &stats);
+    CHECK(stats.syncKeys == NUM_CARDS && stats.syncKeyCollisions == 1 && stats.duplicateUids == 1);
+
+    SyncMatch matches[4];
+    bool all = true;
+    for (int i = 3; i < NUM_CARDS; i++) {
+        char uid[32];
+        snprintf(uid, sizeof(uid), "card-%d", i);
+        int n = syncKeyLookup(index, uid, "tel", 1, client, matches, 4);
+        all = all && n == 1 && matches[0].docId == i && matches[0].propIndex == 7;
+    }
+    CHECK(all);
+    CHECK(syncKeyLookup(index, "card-1", "TEL", 1, client, matches, 4) == 2);
+    CHECK(syncKeyLookup(index, "card-5", "TEL", 2, client, matches, 4) == 0);
+    CHECK(syncKeyLookup(index, "card-5", "TEL", 1, NULL, matches, 4) == 0);
+
+    uidIndexRemoveCard(index, 2);
+    uidIndexStats(index, &stats);
+    CHECK(stats.syncKeys == NUM_CARDS - 1 && stats.syncKeyCollisions == 0);
+    CHECK(syncKeyLookup(index, "card-1", "TEL", 1, client, matches, 4) == 1 && matches[0].docId == 1);
+
+    CHECK(uidIndexAddCard(index, cards[2], 2) == OK);
+    uidIndexStats(index, &stats);
+    CHECK(stats.syncKeys == NUM_CARDS && stats.syncKeyCollisions == 1);
+    deleteUidIndex(index);
+    deleteCardCorpus(corpus);
+}
+
+int main(void) {
+    checkTable();
+
+    CardCorpus* corpus = synthCorpus(NUM_CARDS);
+    checkPhones(corpus);
+    checkEmails(corpus);
+    deleteCardCorpus(corpus);
+    checkSyncKeys();
+
+    printf("testDocTable: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
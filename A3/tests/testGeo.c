@@ -0,0 +1,55 @@
+// testGeo.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for the GEO index: radius, box and nearest queries, including
+//              ones that match nothing and boxes that cross the 180th meridian.
+
+#include "testCards.h"
+#include "VCGeo.h"
+
+int main(void) {
+    GeoMatch matches[8];
+    int ids[8];
+
+    // Nothing indexed yet
+    GeoIndex* index = createGeoIndex();
+    CHECK(index != NULL);
+    CHECK(geoRadius(index, 43.55, -80.25, 50, matches, 8) == 0);
+    CHECK(geoBox(index, 40, -90, 50, -70, ids, 8) == 0);
+    CHECK(geoNearest(index, 43.55, -80.25, 3, matches) == 0);
+    deleteGeoIndex(index);
+
+    Card** cards = malloc(4 * sizeof(Card*));
+    createMinimalCard(&cards[0], "Guelph");
+    addProperty(cards[0], "GEO", "geo:43.5448,-80.2482");
+    createMinimalCard(&cards[1], "Toronto");
+    addProperty(cards[1], "GEO", "geo:43.6532,-79.3832");
+    createMinimalCard(&cards[2], "Suva");
+    addProperty(cards[2], "GEO", "geo:-18.1248,178.4501");
+    createMinimalCard(&cards[3], "Apia");
+    addProperty(cards[3], "GEO", "geo:-13.8333,-171.7500");
+    CardCorpus* corpus = makeCorpus(cards, 4);
+    index = buildGeoIndex(corpus, 1);
+    CHECK(index != NULL && geoIndexSize(index) == 4);
+
+    int n = geoRadius(index, 43.55, -80.25, 100, matches, 8);
+    CHECK(n == 2 && matches[0].docId == 0 && matches[1].docId == 1);
+    CHECK(geoRadius(index, 0, 0, 100, matches, 8) == 0);
+
+    // Across the 180th meridian, west of east
+    n = geoBox(index, -20, 170, -10, -170, ids, 8);
+    CHECK(n == 2 && ids[0] == 2 && ids[1] == 3);
+    CHECK(geoBox(index, 10, 10, 20, 20, ids, 8) == 0);
+
+    n = geoNearest(index, -15, 179.9, 1, matches);
+    CHECK(n == 1 && matches[0].docId == 2);
+
+    geoIndexRemoveCard(index, 2);
+    n = geoNearest(index, -15, 179.9, 1, matches);
+    CHECK(n == 1 && matches[0].docId == 3);
+
+    deleteGeoIndex(index);
+    deleteCardCorpus(corpus);
+
+    printf("testGeo: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
@@ -0,0 +1,74 @@
+// testParser.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for createCard: a property group is split off only when its dot
+//              comes before the parameters, so PID=1.1 and TYPE=x.y stay parameters.
+
+#include "testCards.h"
+#include <unistd.h>
+
+// ---------- Helper function: findProperty ----------
+// The property with a name that comes after skip others with the same name.
+static Property* findProperty(const Card* card, const char* name, int skip) {
+    ListIterator iter = createIterator(card->optionalProperties);
+    Property* prop;
+    while ((prop = nextElement(&iter)) != NULL) {
+        if (strcmp(prop->name, name) == 0 && skip-- == 0) return prop;
+    }
+    return NULL;
+}
+
+// ---------- Helper function: parameterValue ----------
+static const char* parameterValue(const Property* prop, const char* name) {
+    ListIterator iter = createIterator(prop->parameters);
+    Parameter* param;
+    while ((param = nextElement(&iter)) != NULL) {
+        if (strcmp(param->name, name) == 0) return param->value;
+    }
+    return NULL;
+}
+
+int main(void) {
+    char fileName[] = "/tmp/testParserXXXXXX.vcf";
+    int fd = mkstemps(fileName, 4);
+    if (fd < 0) {
+        perror("mkstemps");
+        return 1;
+    }
+    FILE* fp = fdopen(fd, "w");
+    fprintf(fp, "BEGIN:VCARD\r\nVERSION:4.0\r\nFN:Simon Perreault\r\n");
+    fprintf(fp, "TEL;PID=1.1:tel:+1-418-656-9254\r\n");
+    fprintf(fp, "item1.TEL;TYPE=x.y:tel:+1-418-262-6501\r\n");
+    fprintf(fp, "item1.X-ABLabel:_$!<HomePage>!$_\r\n");
+    fprintf(fp, "CLIENTPIDMAP:1;urn:uuid:3df403f4-5924-4bb7-b077-3c711d9eb34b\r\n");
+    fprintf(fp, "END:VCARD\r\n");
+    fclose(fp);
+
+    Card* card = NULL;
+    CHECK(createCard(fileName, &card) == OK);
+    if (card != NULL) {
+        Property* tel = findProperty(card, "TEL", 0);
+        CHECK(tel != NULL);
+        if (tel != NULL) {
+            CHECK(strcmp(tel->group, "") == 0);
+            const char* pid = parameterValue(tel, "PID");
+            CHECK(pid != NULL && strcmp(pid, "1.1") == 0);
+            CHECK(strcmp(getFromFront(tel->values), "tel:+1-418-656-9254") == 0);
+        }
+
+        Property* grouped = findProperty(card, "TEL", 1);
+        CHECK(grouped != NULL);
+        if (grouped != NULL) {
+            CHECK(strcmp(grouped->group, "item1") == 0);
+            const char* type = parameterValue(grouped, "TYPE");
+            CHECK(type != NULL && strcmp(type, "x.y") == 0);
+        }
+
+        Property* label = findProperty(card, "X-ABLabel", 0);
+        CHECK(label != NULL && strcmp(label->group, "item1") == 0);
+        deleteCard(card);
+    }
+    unlink(fileName);
+
+    printf("testParser: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
@@ -0,0 +1,61 @@
+// testScan.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for scanCardDirectory: text birthdays and anniversaries of any
+//              length come back whole.
+
+#include "testCards.h"
+#include "VCScan.h"
+#include <unistd.h>
+
+// ---------- Helper function: writeDatedCard ----------
+static void writeDatedCard(const char* dirName, const char* fileName, const char* bday, const char* anniversary) {
+    char* path = joinPath(dirName, fileName);
+    FILE* fp = fopen(path, "w");
+    fprintf(fp, "BEGIN:VCARD\r\nVERSION:4.0\r\nFN:Simon Perreault\r\n");
+    fprintf(fp, "BDAY;VALUE=text:%s\r\n", bday);
+    fprintf(fp, "ANNIVERSARY:%s\r\n", anniversary);
+    fprintf(fp, "END:VCARD\r\n");
+    fclose(fp);
+    free(path);
+}
+
+int main(void) {
+    char dirName[] = "/tmp/testScanXXXXXX";
+    if (mkdtemp(dirName) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+
+    // Far longer than the buffer a date is first formatted into
+    char longText[301];
+    for (int i = 0; i < 300; i++) longText[i] = "circa the turn of the century, "[i % 31];
+    longText[300] = '\0';
+    writeDatedCard(dirName, "long.vcf", longText, "20090808T143000Z");
+    writeDatedCard(dirName, "short.vcf", "circa 1800", "19960415");
+
+    ScanTable* table = scanCardDirectory(dirName, 2);
+    CHECK(table != NULL && table->count == 2);
+    if (table != NULL && table->count == 2) {
+        // Sorted by name: long.vcf, then short.vcf
+        CHECK(table->error[0] == OK && table->error[1] == OK);
+        CHECK(strcmp(table->strings + table->fnOff[0], "Simon Perreault") == 0);
+        CHECK(strcmp(table->strings + table->bdayOff[0], longText) == 0);
+        CHECK(strcmp(table->strings + table->annOff[0], "2009-08-08T14:30:00Z") == 0);
+        CHECK(table->bdayYear[0] == -1);
+        CHECK(strcmp(table->strings + table->bdayOff[1], "circa 1800") == 0);
+        CHECK(strcmp(table->strings + table->annOff[1], "1996-04-15") == 0);
+        CHECK(table->annYear[1] == 1996 && table->annMonth[1] == 4 && table->annDay[1] == 15);
+    }
+    freeScanTable(table);
+
+    char* path = joinPath(dirName, "long.vcf");
+    unlink(path);
+    free(path);
+    path = joinPath(dirName, "short.vcf");
+    unlink(path);
+    free(path);
+    rmdir(dirName);
+
+    printf("testScan: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
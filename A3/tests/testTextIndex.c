@@ -0,0 +1,71 @@
+// testTextIndex.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for the inverted index: AND/OR and scoped queries, and terms
+//              made of many hyphenated words.
+
+#include "testCards.h"
+#include "VCTextIndex.h"
+
+// ---------- Helper function: queryCount ----------
+static int queryCount(const TextIndex* index, const char* query) {
+    int* ids = NULL;
+    int count = textIndexQuery(index, query, &ids);
+    free(ids);
+    return count;
+}
+
+// ---------- Helper function: repeatWord ----------
+// word joined to itself with hyphens, times times over, e.g. simon-simon-simon.
+static char* repeatWord(const char* word, int times) {
+    size_t len = strlen(word);
+    char* query = malloc(times * (len + 1) + 1);
+    char* at = query;
+    for (int i = 0; i < times; i++) {
+        if (i > 0) *at++ = '-';
+        memcpy(at, word, len);
+        at += len;
+    }
+    *at = '\0';
+    return query;
+}
+
+int main(void) {
+    Card** cards = malloc(3 * sizeof(Card*));
+    createMinimalCard(&cards[0], "Simon Perreault");
+    addProperty(cards[0], "ORG", "Viagenie");
+    createMinimalCard(&cards[1], "Simon Says");
+    addProperty(cards[1], "ORG", "Acme Corp");
+    createMinimalCard(&cards[2], "Alice Smith");
+    addProperty(cards[2], "ORG", "Acme Widgets");
+    CardCorpus* corpus = makeCorpus(cards, 3);
+
+    TextIndex* index = buildTextIndex(corpus);
+    CHECK(index != NULL);
+
+    CHECK(queryCount(index, "simon") == 2);
+    CHECK(queryCount(index, "ORG:acme") == 2);
+    CHECK(queryCount(index, "simon ORG:acme") == 1);
+    CHECK(queryCount(index, "perreault OR alice") == 2);
+    CHECK(queryCount(index, "ORG:acme-corp") == 1);
+
+    // A term holds one word per hyphen-separated part, far more than the number of terms
+    char* query = repeatWord("simon", 300);
+    CHECK(queryCount(index, query) == 2);
+    free(query);
+
+    query = repeatWord("acme", 1000);
+    char scoped[8192];
+    snprintf(scoped, sizeof(scoped), "simon %s OR nobody", query);
+    CHECK(queryCount(index, scoped) == 1);
+    free(query);
+
+    query = repeatWord("nobody", 300);
+    CHECK(queryCount(index, query) == 0);
+    free(query);
+
+    deleteTextIndex(index);
+    deleteCardCorpus(corpus);
+
+    printf("testTextIndex: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
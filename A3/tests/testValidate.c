@@ -0,0 +1,48 @@
+// testValidate.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for validateCard and validateCardReport: the allowed property
+//              names and the cardinality of the properties that may occur once.
+
+#include "testCards.h"
+#include "VCReport.h"
+
+// ---------- Helper function: reportResult ----------
+static VCardErrorCode reportResult(const Card* card) {
+    ValidationReport* report = validateCardReport(card);
+    VCardErrorCode result = report != NULL ? report->result : OTHER_ERROR;
+    deleteValidationReport(report);
+    return result;
+}
+
+int main(void) {
+    Card* card = NULL;
+
+    createMinimalCard(&card, "Simon Perreault");
+    addProperty(card, "NOTE", "one");
+    addProperty(card, "NOTE", "two");
+    addProperty(card, "UID", "urn:uuid:4fbe8971-0bc3-424c-9c26-36c3e1eff6b1");
+    CHECK(validateCard(card) == OK);
+    CHECK(reportResult(card) == OK);
+
+    // Only one UID is allowed
+    addProperty(card, "UID", "urn:uuid:0b3c2b4e-8e2e-4c6b-9a53-6a5b5a8c1e21");
+    CHECK(validateCard(card) == INV_PROP);
+    CHECK(reportResult(card) == INV_PROP);
+    deleteCard(card);
+
+    // Extended properties are not in the allowed list
+    createMinimalCard(&card, "Simon Perreault");
+    addProperty(card, "X-ABLABEL", "work");
+    CHECK(validateCard(card) == INV_PROP);
+    CHECK(reportResult(card) == INV_PROP);
+    deleteCard(card);
+
+    createMinimalCard(&card, "Simon Perreault");
+    addProperty(card, "FOO", "bar");
+    CHECK(validateCard(card) == INV_PROP);
+    CHECK(reportResult(card) == INV_PROP);
+    deleteCard(card);
+
+    printf("testValidate: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}
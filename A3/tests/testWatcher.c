@@ -0,0 +1,87 @@
+// testWatcher.c
+// Author: Kenny Adenuga, Student ID: 1304431
+// Description: Checks for the card watcher: after the directory is moved or deleted it is
+//              watched again at the same path, and -1 is returned once nothing is there.
+
+#include "testCards.h"
+#include "VCWatcher.h"
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ---------- Helper function: touchCard ----------
+static void touchCard(const char* dirName, const char* fileName) {
+    char* path = joinPath(dirName, fileName);
+    FILE* fp = fopen(path, "w");
+    if (fp != NULL) {
+        fprintf(fp, "BEGIN:VCARD\r\nVERSION:4.0\r\nFN:Simon Perreault\r\nEND:VCARD\r\n");
+        fclose(fp);
+    }
+    free(path);
+}
+
+// ---------- Helper function: removeCard ----------
+static void removeCard(const char* dirName, const char* fileName) {
+    char* path = joinPath(dirName, fileName);
+    unlink(path);
+    free(path);
+}
+
+// ---------- Helper function: expectCreated ----------
+// Checks that the next batch is exactly one WATCH_CREATED for fileName.
+static bool expectCreated(CardWatcher* w, const char* fileName) {
+    WatchEvent events[8];
+    int n = pollCardWatcher(w, 2000, events, 8);
+    return n == 1 && events[0].kind == WATCH_CREATED && strcmp(events[0].name, fileName) == 0;
+}
+
+// ---------- Helper function: expectRescan ----------
+static bool expectRescan(CardWatcher* w) {
+    WatchEvent events[8];
+    int n = pollCardWatcher(w, 2000, events, 8);
+    return n == 1 && events[0].kind == WATCH_RESCAN;
+}
+
+int main(void) {
+    char dirName[] = "/tmp/testWatcherXXXXXX";
+    if (mkdtemp(dirName) == NULL) {
+        perror("mkdtemp");
+        return 1;
+    }
+    char movedName[64];
+    snprintf(movedName, sizeof(movedName), "%s.moved", dirName);
+
+    CardWatcher* w = createCardWatcher(dirName, 20);
+    CHECK(w != NULL);
+    if (w == NULL) return 1;
+
+    touchCard(dirName, "a.vcf");
+    CHECK(expectCreated(w, "a.vcf"));
+
+    // Moved away and back: the watch must follow the path, not the moved directory
+    rename(dirName, movedName);
+    rename(movedName, dirName);
+    CHECK(expectRescan(w));
+    touchCard(dirName, "b.vcf");
+    CHECK(expectCreated(w, "b.vcf"));
+
+    // Deleted and recreated
+    removeCard(dirName, "a.vcf");
+    removeCard(dirName, "b.vcf");
+    rmdir(dirName);
+    mkdir(dirName, 0700);
+    CHECK(expectRescan(w));
+    touchCard(dirName, "c.vcf");
+    CHECK(expectCreated(w, "c.vcf"));
+
+    // Deleted for good: nothing left to watch
+    removeCard(dirName, "c.vcf");
+    rmdir(dirName);
+    WatchEvent events[8];
+    int n = 0;
+    for (int i = 0; i < 4 && n >= 0; i++) n = pollCardWatcher(w, 500, events, 8);
+    CHECK(n == -1);
+    deleteCardWatcher(w);
+
+    printf("testWatcher: %s\n", testFailures == 0 ? "passed" : "FAILED");
+    return testFailures != 0;
+}